@@ -0,0 +1,209 @@
+#ifndef ALIGNED_MEMORY_C
+#define ALIGNED_MEMORY_C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#endif
+#ifdef linux
+#include <sys/mman.h>
+#endif
+
+/**
+ * Cache-line aligned allocation, for the matrices the library owns. Every row of such a matrix starts on a MATRIX_ALIGNMENT boundary, so a
+ * SIMD load of a row never straddles two cache lines, and no two rows share one (which keeps threads that write neighbouring rows from
+ * invalidating each other's caches).
+ */
+
+// The alignment of the values the library allocates: a cache line, and a whole AVX-512 vector.
+#define MATRIX_ALIGNMENT 64
+// Rows this many bytes apart map to the same cache sets, so padded strides avoid multiples of it.
+#define MATRIX_ALIASING_STRIDE 4096
+// The size of a huge page (2 MiB on x86-64). Huge page mappings are rounded up to, and start on, a multiple of it.
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/**
+ * @brief Allocate memory that starts on a MATRIX_ALIGNMENT boundary. It must be freed with free_aligned.
+ *
+ * @param num_bytes: size_t
+ *      How many bytes to allocate.
+ * @param is_zeroed: int
+ *      1 to fill the memory with zeros.
+ *
+ * @return memory: void[ptr]
+ *      The memory, or NULL if it could not be allocated.
+ */
+static void *allocate_aligned(size_t num_bytes, int is_zeroed)
+{
+    // Neither allocator promises anything for 0 bytes
+    size_t num_allocated_bytes = num_bytes ? num_bytes : 1;
+#ifdef _WIN32
+    void *memory = _aligned_malloc(num_allocated_bytes, MATRIX_ALIGNMENT);
+#else
+    void *memory = NULL;
+    if (posix_memalign(&memory, MATRIX_ALIGNMENT, num_allocated_bytes) != 0)
+    {
+        memory = NULL;
+    }
+#endif
+    if (memory && is_zeroed)
+    {
+        memset(memory, 0, num_allocated_bytes);
+    }
+    return memory;
+}
+
+/**
+ * @brief Free memory from allocate_aligned. Passing NULL does nothing.
+ */
+static void free_aligned(void *memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+/**
+ * @brief Map memory for a large matrix in huge pages, so a sweep over it needs one TLB entry per HUGE_PAGE_SIZE instead of one per 4 KiB page.
+ *        On linux, reserved huge pages (MAP_HUGETLB) are used when there are any; otherwise the memory is mapped with normal pages and
+ *        madvise asks for it to be backed by transparent huge pages. On Windows, large pages need the "Lock pages in memory" privilege,
+ *        without which normal pages are used. Other platforms map nothing. The memory is zeroed, and no page is placed until it is first written (see touch_first_pages).
+ *        It must be freed with unmap_huge_pages.
+ *
+ * @param num_bytes: size_t
+ *      How many bytes to map.
+ * @param num_mapped_bytes: size_t[ptr]
+ *      Receives how many bytes were mapped, which unmap_huge_pages needs.
+ *
+ * @return memory: void[ptr]
+ *      The memory, starting on a HUGE_PAGE_SIZE boundary, or NULL if it could not be mapped.
+ */
+static void *map_huge_pages(size_t num_bytes, size_t *num_mapped_bytes)
+{
+    size_t num_rounded_bytes = ((num_bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+    if (num_rounded_bytes == 0)
+    {
+        num_rounded_bytes = HUGE_PAGE_SIZE;
+    }
+    void *memory = NULL;
+#ifdef _WIN32
+    SIZE_T large_page_size = GetLargePageMinimum();
+    if (large_page_size > 0)
+    {
+        SIZE_T num_large_page_bytes = ((num_bytes + large_page_size - 1) / large_page_size) * large_page_size;
+        memory = VirtualAlloc(NULL, num_large_page_bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (memory)
+        {
+            num_rounded_bytes = num_large_page_bytes;
+        }
+    }
+    if (!memory)
+    {
+        memory = VirtualAlloc(NULL, num_rounded_bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    if (!memory)
+    {
+        return NULL;
+    }
+#elif defined(linux)
+    memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    memory = mmap(NULL, num_rounded_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (memory == MAP_FAILED)
+    {
+        // Transparent huge pages only back whole, aligned huge pages, so one extra huge page is mapped and the ends are trimmed to align it
+        char *mapping = (char *)mmap(NULL, num_rounded_bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return NULL;
+        }
+        size_t num_leading_bytes = (HUGE_PAGE_SIZE - ((uintptr_t)mapping % HUGE_PAGE_SIZE)) % HUGE_PAGE_SIZE;
+        if (num_leading_bytes > 0)
+        {
+            munmap(mapping, num_leading_bytes);
+        }
+        munmap(&mapping[num_leading_bytes + num_rounded_bytes], HUGE_PAGE_SIZE - num_leading_bytes);
+        memory = &mapping[num_leading_bytes];
+#ifdef MADV_HUGEPAGE
+        madvise(memory, num_rounded_bytes, MADV_HUGEPAGE);
+#endif
+    }
+#else
+    // No way to map pages on other platforms, so the caller falls back to allocate_aligned
+    return NULL;
+#endif
+    *num_mapped_bytes = num_rounded_bytes;
+    return memory;
+}
+
+/**
+ * @brief Free memory from map_huge_pages.
+ *
+ * @param memory: void[ptr]
+ *      The memory.
+ * @param num_mapped_bytes: size_t
+ *      How many bytes map_huge_pages said it mapped.
+ *
+ * @return None
+ */
+static void unmap_huge_pages(void *memory, size_t num_mapped_bytes)
+{
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#endif
+#ifdef linux
+    munmap(memory, num_mapped_bytes);
+#endif
+}
+
+/**
+ * @brief The distance between the starts of two rows (or columns) of an aligned matrix: the length of one rounded up to whole cache lines,
+ *        plus one more cache line if that is a multiple of MATRIX_ALIASING_STRIDE bytes.
+ *
+ * @param num_values: int
+ *      The number of values in a row (or column).
+ * @param value_size: int
+ *      The size of a value, in bytes. Must divide MATRIX_ALIGNMENT.
+ *
+ * @return stride: int
+ *      The padded stride, in values.
+ */
+static inline int get_padded_stride(int num_values, int value_size)
+{
+    int values_per_line = MATRIX_ALIGNMENT / value_size;
+    int stride = ((num_values + values_per_line - 1) / values_per_line) * values_per_line;
+    if (stride > 0 && ((int64_t)stride * value_size) % MATRIX_ALIASING_STRIDE == 0)
+    {
+        stride += values_per_line;
+    }
+    return (stride > 0) ? stride : values_per_line;
+}
+
+/**
+ * @brief Take the next part of a workspace: a caller-provided block that a solver carves all of its temporaries out of, instead of allocating them.
+ *        Each part starts a whole number of MATRIX_ALIGNMENT bytes after the start of the block. Running the same sequence of calls with a NULL
+ *        workspace first measures how big the block has to be.
+ *
+ * @param workspace: char[ptr]
+ *      The block, or NULL to only measure.
+ * @param offset: int64_t[ptr]
+ *      How many bytes of the block are taken. Advanced past the new part.
+ * @param num_bytes: int64_t
+ *      The size of the part.
+ *
+ * @return part: void[ptr]
+ *      The part, or NULL if workspace is NULL.
+ */
+static inline void *take_workspace_part(char *workspace, int64_t *offset, int64_t num_bytes)
+{
+    void *part = workspace ? &workspace[*offset] : NULL;
+    *offset += ((num_bytes + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT) * MATRIX_ALIGNMENT;
+    return part;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,1384 @@
+#ifndef LU_FACTORIZATION_C
+#define LU_FACTORIZATION_C
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ThreadPool.c"
+#include "TaskScheduler.c"
+#include "MatrixMultiply.c"
+
+// The number of columns factored together as one panel by the blocked LU engines.
+#define LU_PANEL_WIDTH 32
+// The number of rows and columns in a tile of the tiled LU engine.
+#define LU_TILE_SIZE 64
+// The recursive LU engine stops splitting column ranges (and triangular solves) at this width.
+#define LU_RECURSIVE_BASE_WIDTH 8
+// The number of rows the blocked triangular solves substitute at a time before handing the rest to a matrix product.
+#define LU_TRSM_BLOCK_SIZE 64
+// The blocked triangular solves give each thread at least this many right-hand sides.
+#define LU_TRSM_MIN_RHS_PER_TASK 16
+
+/**
+ * Kernels for the LU engines. They work on row-major matrices addressed with a leading dimension (the distance, in doubles,
+ * between the starts of two consecutive rows), so they can run on a block of a bigger matrix (e.g., the A part of an augmented matrix) in place.
+ *
+ * The factorizations are P*A = L*U with L unit lower triangular. Both factors overwrite A, and the row interchanges are
+ * recorded LAPACK style: at step i, row i was swapped with row pivots[i] (which is >= i).
+ */
+
+/**
+ * @brief Swap two rows of a matrix in memory.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param row_a: int
+ *      The first row to swap.
+ * @param row_b: int
+ *      The second row to swap.
+ * @param num_cols: int
+ *      The number of columns (from the start of each row) to swap.
+ *
+ * @return None
+ */
+static inline void swap_matrix_rows(double *matrix, int leading_dimension, int row_a, int row_b, int num_cols)
+{
+    double *row_one = &matrix[(int64_t)row_a * leading_dimension];
+    double *row_two = &matrix[(int64_t)row_b * leading_dimension];
+    for (int col = 0; col < num_cols; col++)
+    {
+        double temp = row_one[col];
+        row_one[col] = row_two[col];
+        row_two[col] = temp;
+    }
+}
+
+/**
+ * @brief Split [0, count) into num_parts nearly equal ranges and get the start of one of them.
+ *
+ * @param count: int
+ *      The number of items being split.
+ * @param num_parts: int
+ *      The number of ranges.
+ * @param part: int
+ *      Which range to get the start of. Passing num_parts gives count.
+ *
+ * @return start: int
+ *      The first item of the range.
+ */
+static inline int get_partition_start(int count, int num_parts, int part)
+{
+    return (int)(((int64_t)count * part) / num_parts);
+}
+
+/**
+ * @brief Gaussian elimination with partial pivoting on a small block, done only to rank its rows as pivot candidates.
+ *        The block is destroyed, and row_ids is permuted the same way as its rows, so the first entries of row_ids are the winners.
+ *
+ * @param block: double[ptr]
+ *      The num_rows x num_cols block, stored contiguously.
+ * @param row_ids: int[ptr]
+ *      The (global) row each row of the block came from.
+ * @param num_rows: int
+ *      The number of rows in the block.
+ * @param num_cols: int
+ *      The number of columns in the block.
+ *
+ * @return None
+ */
+static void rank_pivot_candidates(double *block, int *row_ids, int num_rows, int num_cols)
+{
+    int num_steps = (num_rows < num_cols) ? num_rows : num_cols;
+    for (int step = 0; step < num_steps; step++)
+    {
+        int max_row = step;
+        double max_abs_value = fabs(block[step * num_cols + step]);
+        for (int row = step + 1; row < num_rows; row++)
+        {
+            double abs_value = fabs(block[row * num_cols + step]);
+            if (abs_value > max_abs_value)
+            {
+                max_abs_value = abs_value;
+                max_row = row;
+            }
+        }
+        if (max_row != step)
+        {
+            swap_matrix_rows(block, num_cols, step, max_row, num_cols);
+            int temp = row_ids[step];
+            row_ids[step] = row_ids[max_row];
+            row_ids[max_row] = temp;
+        }
+        if (max_abs_value == 0)
+        {
+            continue;
+        }
+        const double *pivot_row = &block[step * num_cols];
+        for (int row = step + 1; row < num_rows; row++)
+        {
+            double *row_to_modify = &block[row * num_cols];
+            double scalar = row_to_modify[step] / pivot_row[step];
+            for (int col = step + 1; col < num_cols; col++)
+            {
+                row_to_modify[col] -= scalar * pivot_row[col];
+            }
+        }
+    }
+}
+
+/**
+ * @brief The shared state of a tournament for the pivot rows of one panel.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix being factored.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ * @param first_row: int
+ *      The first row taking part in the tournament (the panel's diagonal row).
+ * @param first_col: int
+ *      The panel's first column.
+ * @param panel_width: int
+ *      The number of columns in the panel, which is also the number of winners.
+ * @param num_rows: int
+ *      The number of rows taking part in the tournament.
+ * @param num_leaves: int
+ *      The number of row blocks the first round is played on.
+ * @param scratch: double[ptr]
+ *      num_rows x panel_width doubles. Each leaf (and later, each match) works in the part that belongs to its first leaf.
+ * @param candidate_ids: int[ptr]
+ *      num_rows row ids, split up the same way as scratch.
+ * @param num_candidates: int[ptr]
+ *      The number of candidates each leaf's part currently holds.
+ * @param stride: int
+ *      During the later rounds, the distance (in leaves) between the two sides of a match.
+ */
+struct PivotTournament
+{
+    double *matrix;
+    int leading_dimension;
+    int first_row;
+    int first_col;
+    int panel_width;
+    int num_rows;
+    int num_leaves;
+    double *scratch;
+    int *candidate_ids;
+    int *num_candidates;
+    int stride;
+};
+
+/**
+ * @brief Copy the panel columns of the given rows into a block of scratch and rank them.
+ *
+ * @param tournament: struct PivotTournament[ptr]
+ *      The tournament being played.
+ * @param leaf: int
+ *      The leaf whose part of scratch to use. Its candidate_ids must already hold the row ids to rank.
+ * @param num_rows: int
+ *      The number of rows to rank.
+ *
+ * @return None
+ */
+static void play_pivot_match(struct PivotTournament *tournament, int leaf, int num_rows)
+{
+    int offset = get_partition_start(tournament->num_rows, tournament->num_leaves, leaf);
+    double *block = &tournament->scratch[(int64_t)offset * tournament->panel_width];
+    int *row_ids = &tournament->candidate_ids[offset];
+    for (int row = 0; row < num_rows; row++)
+    {
+        memcpy(&block[row * tournament->panel_width], &tournament->matrix[(int64_t)row_ids[row] * tournament->leading_dimension + tournament->first_col], sizeof(double) * tournament->panel_width);
+    }
+    rank_pivot_candidates(block, row_ids, num_rows, tournament->panel_width);
+    tournament->num_candidates[leaf] = (num_rows < tournament->panel_width) ? num_rows : tournament->panel_width;
+}
+
+/**
+ * @brief The first round: every leaf ranks its own contiguous block of rows.
+ */
+static void play_pivot_tournament_leaf(void *context, int leaf)
+{
+    struct PivotTournament *tournament = (struct PivotTournament *)context;
+    int start = get_partition_start(tournament->num_rows, tournament->num_leaves, leaf);
+    int end = get_partition_start(tournament->num_rows, tournament->num_leaves, leaf + 1);
+    for (int row = start; row < end; row++)
+    {
+        tournament->candidate_ids[row] = tournament->first_row + row;
+    }
+    play_pivot_match(tournament, leaf, end - start);
+}
+
+/**
+ * @brief The later rounds: the winners of two leaves are stacked and ranked again. The result goes to the left leaf.
+ */
+static void play_pivot_tournament_round(void *context, int match)
+{
+    struct PivotTournament *tournament = (struct PivotTournament *)context;
+    int left_leaf = match * 2 * tournament->stride;
+    int right_leaf = left_leaf + tournament->stride;
+    if (right_leaf >= tournament->num_leaves)
+    {
+        return;
+    }
+    int left_offset = get_partition_start(tournament->num_rows, tournament->num_leaves, left_leaf);
+    int right_offset = get_partition_start(tournament->num_rows, tournament->num_leaves, right_leaf);
+    int num_left_candidates = tournament->num_candidates[left_leaf];
+    int num_right_candidates = tournament->num_candidates[right_leaf];
+    memcpy(&tournament->candidate_ids[left_offset + num_left_candidates], &tournament->candidate_ids[right_offset], sizeof(int) * num_right_candidates);
+    play_pivot_match(tournament, left_leaf, num_left_candidates + num_right_candidates);
+}
+
+/**
+ * @brief Choose the pivot rows of a panel with a tournament (the panel factorization of CALU, communication-avoiding LU).
+ *        The rows are split into blocks that each pick their best panel_width candidates in parallel, and then the candidates
+ *        are paired off and ranked again, level by level, until one set is left. Unlike partial pivoting there is no
+ *        synchronization per column, only one per level of the reduction tree.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix being factored. It is only read.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param first_row: int
+ *      The panel's diagonal row. Rows [first_row, num_rows) take part.
+ * @param num_rows: int
+ *      The number of rows in the matrix.
+ * @param first_col: int
+ *      The panel's first column.
+ * @param panel_width: int
+ *      The number of columns in the panel.
+ * @param num_threads: int
+ *      The number of threads to play the first rounds on.
+ * @param winners: int[ptr]
+ *      Receives the panel_width winning rows, best first.
+ *
+ * @return None
+ */
+static void select_tournament_pivots(double *matrix, int leading_dimension, int first_row, int num_rows, int first_col, int panel_width, int num_threads, int *winners)
+{
+    struct PivotTournament tournament;
+    tournament.matrix = matrix;
+    tournament.leading_dimension = leading_dimension;
+    tournament.first_row = first_row;
+    tournament.first_col = first_col;
+    tournament.panel_width = panel_width;
+    tournament.num_rows = num_rows - first_row;
+    // Every leaf needs room for two sets of candidates, since the left side of a match reuses it
+    tournament.num_leaves = tournament.num_rows / (2 * panel_width);
+    if (tournament.num_leaves > num_threads)
+    {
+        tournament.num_leaves = num_threads;
+    }
+    if (tournament.num_leaves < 1)
+    {
+        tournament.num_leaves = 1;
+    }
+    tournament.scratch = (double *)malloc(sizeof(double) * tournament.num_rows * panel_width);
+    tournament.candidate_ids = (int *)malloc(sizeof(int) * tournament.num_rows);
+    tournament.num_candidates = (int *)malloc(sizeof(int) * tournament.num_leaves);
+
+    parallel_for(tournament.num_leaves, play_pivot_tournament_leaf, &tournament);
+    for (tournament.stride = 1; tournament.stride < tournament.num_leaves; tournament.stride *= 2)
+    {
+        int num_matches = (tournament.num_leaves + (2 * tournament.stride) - 1) / (2 * tournament.stride);
+        parallel_for(num_matches, play_pivot_tournament_round, &tournament);
+    }
+    memcpy(winners, tournament.candidate_ids, sizeof(int) * panel_width);
+
+    free(tournament.num_candidates);
+    free(tournament.candidate_ids);
+    free(tournament.scratch);
+}
+
+/**
+ * @brief The shared state of the parallel parts of one step of a blocked LU factorization.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix being factored.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ * @param num_rows: int
+ *      The number of rows in the matrix (which is also the number of columns the factorization covers).
+ * @param num_cols: int
+ *      The total number of columns updated. Any columns past num_rows (e.g., an augment) are carried along like the trailing matrix.
+ * @param first: int
+ *      The panel's diagonal row and column.
+ * @param panel_width: int
+ *      The number of columns in the panel.
+ * @param num_tasks: int
+ *      The number of tasks the work was split into.
+ */
+struct LUStep
+{
+    double *matrix;
+    int leading_dimension;
+    int num_rows;
+    int num_cols;
+    int first;
+    int panel_width;
+    int num_tasks;
+};
+
+/**
+ * @brief Compute the rows of L below a panel's diagonal block, one block of rows per task: each row is solved against U11 on its own.
+ */
+static void compute_panel_lower_rows(void *context, int task_index)
+{
+    struct LUStep *step = (struct LUStep *)context;
+    int first_row = step->first + step->panel_width;
+    int start = first_row + get_partition_start(step->num_rows - first_row, step->num_tasks, task_index);
+    int end = first_row + get_partition_start(step->num_rows - first_row, step->num_tasks, task_index + 1);
+    for (int row = start; row < end; row++)
+    {
+        double *row_to_modify = &step->matrix[(int64_t)row * step->leading_dimension + step->first];
+        for (int col = 0; col < step->panel_width; col++)
+        {
+            const double *pivot_row = &step->matrix[(int64_t)(step->first + col) * step->leading_dimension + step->first];
+            double scalar = row_to_modify[col] / pivot_row[col];
+            row_to_modify[col] = scalar;
+            for (int later_col = col + 1; later_col < step->panel_width; later_col++)
+            {
+                row_to_modify[later_col] -= scalar * pivot_row[later_col];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute U12 = inverse(L11) * A12, one block of columns per task.
+ */
+static void compute_panel_upper_cols(void *context, int task_index)
+{
+    struct LUStep *step = (struct LUStep *)context;
+    int first_col = step->first + step->panel_width;
+    int start = first_col + get_partition_start(step->num_cols - first_col, step->num_tasks, task_index);
+    int end = first_col + get_partition_start(step->num_cols - first_col, step->num_tasks, task_index + 1);
+    for (int diagonal = 0; diagonal < step->panel_width; diagonal++)
+    {
+        const double *source_row = &step->matrix[(int64_t)(step->first + diagonal) * step->leading_dimension];
+        for (int row = diagonal + 1; row < step->panel_width; row++)
+        {
+            double *row_to_modify = &step->matrix[(int64_t)(step->first + row) * step->leading_dimension];
+            double scalar = row_to_modify[step->first + diagonal];
+            for (int col = start; col < end; col++)
+            {
+                row_to_modify[col] -= scalar * source_row[col];
+            }
+        }
+    }
+}
+
+/**
+ * @brief C = C - A * B with the packed matrix product. Used for the trailing (Schur complement) updates.
+ *
+ * @param c: double[ptr]
+ *      The m x n matrix to update.
+ * @param ldc: int
+ *      The leading dimension of c.
+ * @param a: double[ptr]
+ *      The m x k left factor.
+ * @param lda: int
+ *      The leading dimension of a.
+ * @param b: double[ptr]
+ *      The k x n right factor.
+ * @param ldb: int
+ *      The leading dimension of b.
+ * @param m: int
+ *      The number of rows of c.
+ * @param n: int
+ *      The number of columns of c.
+ * @param k: int
+ *      The inner dimension.
+ * @param num_threads: int
+ *      The most threads to split the product across.
+ *
+ * @return None
+ */
+static void multiply_subtract(double *c, int ldc, const double *a, int lda, const double *b, int ldb, int m, int n, int k, int num_threads)
+{
+    if (m <= 0 || n <= 0 || k <= 0)
+    {
+        return;
+    }
+    multiply_matrices_blocked(m, n, k, -1.0, a, lda, b, ldb, 1.0, c, ldc, num_threads);
+}
+
+/**
+ * @brief Split a part of the matrix (rows or columns) into at most num_threads tasks, without making tasks smaller than min_per_task.
+ */
+static inline int get_num_tasks(int count, int num_threads, int min_per_task)
+{
+    int num_tasks = count / min_per_task;
+    if (num_tasks > num_threads)
+    {
+        num_tasks = num_threads;
+    }
+    return (num_tasks < 1) ? 1 : num_tasks;
+}
+
+/**
+ * @brief Blocked right-looking LU factorization with tournament pivoting (CALU).
+ *        Each panel's pivot rows are chosen up front by select_tournament_pivots and swapped into place, after which the panel, the
+ *        block row of U and the trailing matrix are updated without any more pivoting, all split across threads.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to factor, in place. The first num_rows columns are factored; the rest (up to num_cols) are carried along,
+ *      so an augment [A | B] comes out as [L\U | inverse(L) * P * B].
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param num_rows: int
+ *      The number of rows (and factored columns).
+ * @param num_cols: int
+ *      The total number of columns.
+ * @param pivots: int[ptr]
+ *      Receives the row interchanges. Must hold num_rows values.
+ * @param num_threads: int
+ *      The number of threads to use.
+ *
+ * @return is_nonsingular: int
+ *      1 if every pivot is nonzero. If 0 is returned, the factorization stopped at the first zero pivot.
+ */
+static int factor_lu_calu(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    int *winners = (int *)malloc(sizeof(int) * LU_PANEL_WIDTH);
+    int *row_at = (int *)malloc(sizeof(int) * num_rows);
+    int *position_of = (int *)malloc(sizeof(int) * num_rows);
+    int is_nonsingular = 1;
+    for (int first = 0; first < num_rows && is_nonsingular; first += LU_PANEL_WIDTH)
+    {
+        int panel_width = ((num_rows - first) < LU_PANEL_WIDTH) ? (num_rows - first) : LU_PANEL_WIDTH;
+        select_tournament_pivots(matrix, leading_dimension, first, num_rows, first, panel_width, num_threads, winners);
+
+        // The winners are named by the rows they were in when the panel started, so keep track of where swaps move them
+        for (int row = first; row < num_rows; row++)
+        {
+            row_at[row] = row;
+            position_of[row] = row;
+        }
+        for (int diagonal = 0; diagonal < panel_width; diagonal++)
+        {
+            int target = first + diagonal;
+            int source = position_of[winners[diagonal]];
+            pivots[target] = source;
+            if (source != target)
+            {
+                swap_matrix_rows(matrix, leading_dimension, target, source, num_cols);
+                int displaced_row = row_at[target];
+                row_at[source] = displaced_row;
+                position_of[displaced_row] = source;
+                row_at[target] = winners[diagonal];
+                position_of[winners[diagonal]] = target;
+            }
+        }
+
+        // Factor the diagonal block without pivoting: the tournament already picked its rows
+        for (int diagonal = 0; diagonal < panel_width; diagonal++)
+        {
+            const double *pivot_row = &matrix[(int64_t)(first + diagonal) * leading_dimension + first];
+            if (pivot_row[diagonal] == 0)
+            {
+                is_nonsingular = 0;
+                break;
+            }
+            for (int row = diagonal + 1; row < panel_width; row++)
+            {
+                double *row_to_modify = &matrix[(int64_t)(first + row) * leading_dimension + first];
+                double scalar = row_to_modify[diagonal] / pivot_row[diagonal];
+                row_to_modify[diagonal] = scalar;
+                for (int col = diagonal + 1; col < panel_width; col++)
+                {
+                    row_to_modify[col] -= scalar * pivot_row[col];
+                }
+            }
+        }
+        if (!is_nonsingular)
+        {
+            break;
+        }
+
+        struct LUStep step = {matrix, leading_dimension, num_rows, num_cols, first, panel_width, 1};
+        step.num_tasks = get_num_tasks(num_rows - first - panel_width, num_threads, 16);
+        parallel_for(step.num_tasks, compute_panel_lower_rows, &step);
+        step.num_tasks = get_num_tasks(num_cols - first - panel_width, num_threads, 64);
+        parallel_for(step.num_tasks, compute_panel_upper_cols, &step);
+        int trailing_first = first + panel_width;
+        multiply_subtract(&matrix[(int64_t)trailing_first * leading_dimension + trailing_first], leading_dimension,
+                          &matrix[(int64_t)trailing_first * leading_dimension + first], leading_dimension,
+                          &matrix[(int64_t)first * leading_dimension + trailing_first], leading_dimension,
+                          num_rows - trailing_first, num_cols - trailing_first, panel_width, num_threads);
+    }
+    free(position_of);
+    free(row_at);
+    free(winners);
+    return is_nonsingular;
+}
+
+/**
+ * @brief The kinds of task in the tiled LU factorization's graph. For step k, row tile i and column tile j:
+ * @param TILED_LU_PANEL:
+ *      PANEL(k) factors column tile k from row tile k down, with partial pivoting.
+ * @param TILED_LU_TRIANGULAR_SOLVE:
+ *      SOLVE(k, j) applies PANEL(k)'s row interchanges to column tile j and computes the U tile (k, j).
+ * @param TILED_LU_UPDATE:
+ *      UPDATE(k, i, j) subtracts L(i, k) * U(k, j) from tile (i, j).
+ */
+enum TiledLUTaskType
+{
+    TILED_LU_PANEL = 0,
+    TILED_LU_TRIANGULAR_SOLVE = 1,
+    TILED_LU_UPDATE = 2
+};
+
+/**
+ * @brief The shared state of a tiled LU factorization.
+ *
+ *        Column tiles [0, num_row_tiles) cover the square part of the matrix and line up with the row tiles. Any columns after it
+ *        (an augment) get column tiles of their own, so no tile straddles the two.
+ *
+ * @param panel_dependencies: int[ptr]
+ *      For each step, the number of updates of its column tile that PANEL(k) still waits on.
+ * @param solve_dependencies: int[ptr]
+ *      For each step and column tile, the number of tasks SOLVE(k, j) still waits on (PANEL(k) and the updates of the tile column).
+ * @param is_singular: int
+ *      Set when a panel finds no nonzero pivot. The remaining tasks then skip their work, so the graph still drains.
+ */
+struct TiledLU
+{
+    double *matrix;
+    int leading_dimension;
+    int num_rows;
+    int num_cols;
+    int num_row_tiles;
+    int num_col_tiles;
+    int *pivots;
+    volatile int *panel_dependencies;
+    volatile int *solve_dependencies;
+    volatile int is_singular;
+};
+
+static inline int get_tile_col_start(const struct TiledLU *lu, int tile)
+{
+    return (tile < lu->num_row_tiles) ? (tile * LU_TILE_SIZE) : (lu->num_rows + (tile - lu->num_row_tiles) * LU_TILE_SIZE);
+}
+
+static inline int get_tile_col_end(const struct TiledLU *lu, int tile)
+{
+    int end = get_tile_col_start(lu, tile) + LU_TILE_SIZE;
+    int limit = (tile < lu->num_row_tiles) ? lu->num_rows : lu->num_cols;
+    return (end < limit) ? end : limit;
+}
+
+/**
+ * @brief PANEL(k): partial pivoting over the whole column tile, so the pivots are the same as an unblocked factorization would pick.
+ *        Rows are only interchanged inside the panel here; SOLVE(k, j) does the same for the columns to its right, and the L columns
+ *        to its left are fixed up once at the end.
+ */
+static void factor_tiled_lu_panel(struct TiledLU *lu, int k)
+{
+    int first_row = k * LU_TILE_SIZE;
+    int first_col = get_tile_col_start(lu, k);
+    int end_col = get_tile_col_end(lu, k);
+    for (int col = first_col; col < end_col; col++)
+    {
+        int diagonal_row = first_row + (col - first_col);
+        int max_row = diagonal_row;
+        double max_abs_value = 0.0;
+        for (int row = diagonal_row; row < lu->num_rows; row++)
+        {
+            double abs_value = fabs(lu->matrix[(int64_t)row * lu->leading_dimension + col]);
+            if (abs_value > max_abs_value)
+            {
+                max_abs_value = abs_value;
+                max_row = row;
+            }
+        }
+        lu->pivots[diagonal_row] = max_row;
+        if (max_abs_value == 0)
+        {
+            lu->is_singular = 1;
+            return;
+        }
+        if (max_row != diagonal_row)
+        {
+            swap_matrix_rows(&lu->matrix[first_col], lu->leading_dimension, diagonal_row, max_row, end_col - first_col);
+        }
+        const double *pivot_row = &lu->matrix[(int64_t)diagonal_row * lu->leading_dimension];
+        for (int row = diagonal_row + 1; row < lu->num_rows; row++)
+        {
+            double *row_to_modify = &lu->matrix[(int64_t)row * lu->leading_dimension];
+            double scalar = row_to_modify[col] / pivot_row[col];
+            row_to_modify[col] = scalar;
+            for (int later_col = col + 1; later_col < end_col; later_col++)
+            {
+                row_to_modify[later_col] -= scalar * pivot_row[later_col];
+            }
+        }
+    }
+}
+
+/**
+ * @brief SOLVE(k, j): interchange the rows of column tile j like PANEL(k) did, then U(k, j) = inverse(L(k, k)) * A(k, j).
+ */
+static void solve_tiled_lu_row(struct TiledLU *lu, int k, int j)
+{
+    int first_row = k * LU_TILE_SIZE;
+    int panel_width = get_tile_col_end(lu, k) - get_tile_col_start(lu, k);
+    int first_col = get_tile_col_start(lu, j);
+    int num_cols = get_tile_col_end(lu, j) - first_col;
+    for (int row = first_row; row < first_row + panel_width; row++)
+    {
+        if (lu->pivots[row] != row)
+        {
+            swap_matrix_rows(&lu->matrix[first_col], lu->leading_dimension, row, lu->pivots[row], num_cols);
+        }
+    }
+    for (int diagonal = 0; diagonal < panel_width; diagonal++)
+    {
+        const double *source_row = &lu->matrix[(int64_t)(first_row + diagonal) * lu->leading_dimension];
+        for (int row = diagonal + 1; row < panel_width; row++)
+        {
+            double *row_to_modify = &lu->matrix[(int64_t)(first_row + row) * lu->leading_dimension];
+            double scalar = row_to_modify[first_row + diagonal];
+            for (int col = first_col; col < first_col + num_cols; col++)
+            {
+                row_to_modify[col] -= scalar * source_row[col];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Satisfy one dependency of a task, and spawn it if that was the last one.
+ */
+static inline void release_tiled_lu_dependency(struct TaskScheduler *scheduler, int worker, volatile int *dependencies, struct ScheduledTask task)
+{
+    if (ATOMIC_FETCH_ADD(dependencies, -1) == 1)
+    {
+        spawn_scheduled_task(scheduler, worker, task);
+    }
+}
+
+/**
+ * @brief Run one task of the tiled LU graph, then release the tasks that depend on it.
+ */
+static void run_tiled_lu_task(void *context, struct TaskScheduler *scheduler, int worker, struct ScheduledTask task)
+{
+    struct TiledLU *lu = (struct TiledLU *)context;
+    int skip_work = ATOMIC_LOAD_ACQUIRE(&lu->is_singular);
+    if (task.type == TILED_LU_PANEL)
+    {
+        if (!skip_work)
+        {
+            factor_tiled_lu_panel(lu, task.k);
+        }
+        for (int j = task.k + 1; j < lu->num_col_tiles; j++)
+        {
+            struct ScheduledTask solve = {TILED_LU_TRIANGULAR_SOLVE, task.k, task.k, j};
+            release_tiled_lu_dependency(scheduler, worker, &lu->solve_dependencies[task.k * lu->num_col_tiles + j], solve);
+        }
+    }
+    else if (task.type == TILED_LU_TRIANGULAR_SOLVE)
+    {
+        if (!skip_work)
+        {
+            solve_tiled_lu_row(lu, task.k, task.j);
+        }
+        for (int i = task.k + 1; i < lu->num_row_tiles; i++)
+        {
+            struct ScheduledTask update = {TILED_LU_UPDATE, task.k, i, task.j};
+            spawn_scheduled_task(scheduler, worker, update);
+        }
+    }
+    else
+    {
+        if (!skip_work)
+        {
+            int first_row = task.i * LU_TILE_SIZE;
+            int end_row = (first_row + LU_TILE_SIZE < lu->num_rows) ? (first_row + LU_TILE_SIZE) : lu->num_rows;
+            int panel_first = task.k * LU_TILE_SIZE;
+            int panel_width = get_tile_col_end(lu, task.k) - get_tile_col_start(lu, task.k);
+            int first_col = get_tile_col_start(lu, task.j);
+            int num_cols = get_tile_col_end(lu, task.j) - first_col;
+            multiply_subtract(&lu->matrix[(int64_t)first_row * lu->leading_dimension + first_col], lu->leading_dimension,
+                              &lu->matrix[(int64_t)first_row * lu->leading_dimension + panel_first], lu->leading_dimension,
+                              &lu->matrix[(int64_t)panel_first * lu->leading_dimension + first_col], lu->leading_dimension,
+                              end_row - first_row, num_cols, panel_width, 1);
+        }
+        int next_step = task.k + 1;
+        if (task.j == next_step)
+        {
+            struct ScheduledTask panel = {TILED_LU_PANEL, next_step, next_step, next_step};
+            release_tiled_lu_dependency(scheduler, worker, &lu->panel_dependencies[next_step], panel);
+        }
+        else
+        {
+            struct ScheduledTask solve = {TILED_LU_TRIANGULAR_SOLVE, next_step, next_step, task.j};
+            release_tiled_lu_dependency(scheduler, worker, &lu->solve_dependencies[next_step * lu->num_col_tiles + task.j], solve);
+        }
+    }
+}
+
+/**
+ * @brief Tiled LU factorization with partial pivoting, run as a task graph on the work-stealing scheduler.
+ *        Panels, triangular solves and trailing updates are separate tasks that each wait only on the tiles they read, so the next
+ *        panel starts as soon as its own column is updated, while the rest of the trailing update is still running (lookahead).
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to factor, in place. The first num_rows columns are factored; the rest (up to num_cols) are carried along,
+ *      so an augment [A | B] comes out as [L\U | inverse(L) * P * B].
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param num_rows: int
+ *      The number of rows (and factored columns).
+ * @param num_cols: int
+ *      The total number of columns.
+ * @param pivots: int[ptr]
+ *      Receives the row interchanges. Must hold num_rows values.
+ * @param num_threads: int
+ *      The number of workers.
+ *
+ * @return is_nonsingular: int
+ *      1 if every pivot is nonzero (and the scheduler could be started).
+ */
+static int factor_lu_tiled(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    struct TiledLU lu;
+    lu.matrix = matrix;
+    lu.leading_dimension = leading_dimension;
+    lu.num_rows = num_rows;
+    lu.num_cols = num_cols;
+    lu.num_row_tiles = (num_rows + LU_TILE_SIZE - 1) / LU_TILE_SIZE;
+    lu.num_col_tiles = lu.num_row_tiles + ((num_cols - num_rows) + LU_TILE_SIZE - 1) / LU_TILE_SIZE;
+    lu.pivots = pivots;
+    lu.is_singular = 0;
+    lu.panel_dependencies = (volatile int *)malloc(sizeof(int) * lu.num_row_tiles);
+    lu.solve_dependencies = (volatile int *)malloc(sizeof(int) * lu.num_row_tiles * lu.num_col_tiles);
+    int num_tasks = 0;
+    for (int k = 0; k < lu.num_row_tiles; k++)
+    {
+        int num_later_row_tiles = lu.num_row_tiles - k - 1;
+        int num_later_col_tiles = lu.num_col_tiles - k - 1;
+        lu.panel_dependencies[k] = (k == 0) ? 0 : (lu.num_row_tiles - k);
+        for (int j = k + 1; j < lu.num_col_tiles; j++)
+        {
+            lu.solve_dependencies[k * lu.num_col_tiles + j] = 1 + ((k == 0) ? 0 : (lu.num_row_tiles - k));
+        }
+        num_tasks += 1 + num_later_col_tiles + (num_later_row_tiles * num_later_col_tiles);
+    }
+    struct ScheduledTask first_panel = {TILED_LU_PANEL, 0, 0, 0};
+    if (!run_task_scheduler(num_threads, num_tasks, (lu.num_row_tiles + 1) * lu.num_col_tiles, &first_panel, 1, run_tiled_lu_task, &lu))
+    {
+        // Report the failed allocation like a singular matrix, so the caller falls back to the Gauss-Jordan loop
+        lu.is_singular = 1;
+    }
+
+    // Finally interchange the rows of the L columns to the left of each panel, which the tasks left alone
+    for (int k = 1; k < lu.num_row_tiles && !lu.is_singular; k++)
+    {
+        int first_row = k * LU_TILE_SIZE;
+        int end_row = get_tile_col_end(&lu, k);
+        for (int row = first_row; row < end_row; row++)
+        {
+            if (pivots[row] != row)
+            {
+                swap_matrix_rows(matrix, leading_dimension, row, pivots[row], first_row);
+            }
+        }
+    }
+    free((void *)lu.solve_dependencies);
+    free((void *)lu.panel_dependencies);
+    return !lu.is_singular;
+}
+
+/**
+ * @brief Solve L * X = B in place, where L is the unit lower triangle of rows/columns [first, first + size) of a factored matrix and B is the
+ *        block of those rows in columns [first_rhs_col, first_rhs_col + num_rhs). Recursive: the top half is solved, subtracted from the bottom
+ *        half with a matrix product, and then the bottom half is solved, so every level of the cache is used without a tuned block size.
+ *
+ * @param matrix: double[ptr]
+ *      The factored matrix, which also holds B.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param first: int
+ *      The first row (and column) of L.
+ * @param size: int
+ *      The size of L.
+ * @param first_rhs_col: int
+ *      The first column of B.
+ * @param num_rhs: int
+ *      The number of columns of B.
+ * @param num_threads: int
+ *      The number of threads for the matrix products.
+ *
+ * @return None
+ */
+static void solve_unit_lower_triangular_recursive(double *matrix, int leading_dimension, int first, int size, int first_rhs_col, int num_rhs, int num_threads)
+{
+    if (num_rhs <= 0)
+    {
+        return;
+    }
+    if (size <= LU_RECURSIVE_BASE_WIDTH)
+    {
+        for (int diagonal = 1; diagonal < size; diagonal++)
+        {
+            double *row_to_modify = &matrix[(int64_t)(first + diagonal) * leading_dimension];
+            for (int col = 0; col < diagonal; col++)
+            {
+                double scalar = row_to_modify[first + col];
+                const double *source_row = &matrix[(int64_t)(first + col) * leading_dimension + first_rhs_col];
+                for (int rhs_col = 0; rhs_col < num_rhs; rhs_col++)
+                {
+                    row_to_modify[first_rhs_col + rhs_col] -= scalar * source_row[rhs_col];
+                }
+            }
+        }
+        return;
+    }
+    int top_size = size / 2;
+    solve_unit_lower_triangular_recursive(matrix, leading_dimension, first, top_size, first_rhs_col, num_rhs, num_threads);
+    multiply_subtract(&matrix[(int64_t)(first + top_size) * leading_dimension + first_rhs_col], leading_dimension,
+                      &matrix[(int64_t)(first + top_size) * leading_dimension + first], leading_dimension,
+                      &matrix[(int64_t)first * leading_dimension + first_rhs_col], leading_dimension,
+                      size - top_size, num_rhs, top_size, num_threads);
+    solve_unit_lower_triangular_recursive(matrix, leading_dimension, first + top_size, size - top_size, first_rhs_col, num_rhs, num_threads);
+}
+
+/**
+ * @brief Interchange rows of a range of columns, following the pivots recorded for rows [first_pivot, end_pivot).
+ */
+static inline void apply_row_interchanges(double *matrix, int leading_dimension, const int *pivots, int first_pivot, int end_pivot, int first_col, int num_cols)
+{
+    if (num_cols <= 0)
+    {
+        return;
+    }
+    for (int row = first_pivot; row < end_pivot; row++)
+    {
+        if (pivots[row] != row)
+        {
+            swap_matrix_rows(&matrix[first_col], leading_dimension, row, pivots[row], num_cols);
+        }
+    }
+}
+
+/**
+ * @brief Factor the columns [first, first + width) of rows [first, num_rows), recursively (Toledo's recursive LU).
+ *        The left half of the columns is factored, its interchanges and L are applied to the right half, the right half's Schur complement is
+ *        updated with a matrix product, the right half is factored, and its interchanges are applied back to the left half.
+ *        Row interchanges only ever touch columns [first, first + width); the caller applies them to the rest of the matrix.
+ *
+ * @return is_nonsingular: int
+ *      1 if every pivot is nonzero. The factorization stops at the first zero pivot.
+ */
+static int factor_lu_recursive_columns(double *matrix, int leading_dimension, int num_rows, int first, int width, int *pivots, int num_threads)
+{
+    if (width <= LU_RECURSIVE_BASE_WIDTH)
+    {
+        for (int col = first; col < first + width; col++)
+        {
+            int max_row = col;
+            double max_abs_value = 0.0;
+            for (int row = col; row < num_rows; row++)
+            {
+                double abs_value = fabs(matrix[(int64_t)row * leading_dimension + col]);
+                if (abs_value > max_abs_value)
+                {
+                    max_abs_value = abs_value;
+                    max_row = row;
+                }
+            }
+            pivots[col] = max_row;
+            if (max_abs_value == 0)
+            {
+                return 0;
+            }
+            if (max_row != col)
+            {
+                swap_matrix_rows(&matrix[first], leading_dimension, col, max_row, width);
+            }
+            const double *pivot_row = &matrix[(int64_t)col * leading_dimension];
+            for (int row = col + 1; row < num_rows; row++)
+            {
+                double *row_to_modify = &matrix[(int64_t)row * leading_dimension];
+                double scalar = row_to_modify[col] / pivot_row[col];
+                row_to_modify[col] = scalar;
+                for (int later_col = col + 1; later_col < first + width; later_col++)
+                {
+                    row_to_modify[later_col] -= scalar * pivot_row[later_col];
+                }
+            }
+        }
+        return 1;
+    }
+    int left_width = width / 2;
+    int right_first = first + left_width;
+    int right_width = width - left_width;
+    if (!factor_lu_recursive_columns(matrix, leading_dimension, num_rows, first, left_width, pivots, num_threads))
+    {
+        return 0;
+    }
+    apply_row_interchanges(matrix, leading_dimension, pivots, first, right_first, right_first, right_width);
+    solve_unit_lower_triangular_recursive(matrix, leading_dimension, first, left_width, right_first, right_width, num_threads);
+    multiply_subtract(&matrix[(int64_t)right_first * leading_dimension + right_first], leading_dimension,
+                      &matrix[(int64_t)right_first * leading_dimension + first], leading_dimension,
+                      &matrix[(int64_t)first * leading_dimension + right_first], leading_dimension,
+                      num_rows - right_first, right_width, left_width, num_threads);
+    if (!factor_lu_recursive_columns(matrix, leading_dimension, num_rows, right_first, right_width, pivots, num_threads))
+    {
+        return 0;
+    }
+    apply_row_interchanges(matrix, leading_dimension, pivots, right_first, first + width, first, left_width);
+    return 1;
+}
+
+/**
+ * @brief Cache-oblivious recursive LU factorization with partial pivoting. Instead of a fixed tile size, the column range is halved until it is
+ *        LU_RECURSIVE_BASE_WIDTH wide, so the matrix products in between come in every size and each one fits some level of the cache.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to factor, in place. The first num_rows columns are factored; the rest (up to num_cols) are carried along,
+ *      so an augment [A | B] comes out as [L\U | inverse(L) * P * B].
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param num_rows: int
+ *      The number of rows (and factored columns).
+ * @param num_cols: int
+ *      The total number of columns.
+ * @param pivots: int[ptr]
+ *      Receives the row interchanges. Must hold num_rows values.
+ * @param num_threads: int
+ *      The number of threads for the matrix products.
+ *
+ * @return is_nonsingular: int
+ *      1 if every pivot is nonzero.
+ */
+static int factor_lu_recursive(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    if (!factor_lu_recursive_columns(matrix, leading_dimension, num_rows, 0, num_rows, pivots, num_threads))
+    {
+        return 0;
+    }
+    apply_row_interchanges(matrix, leading_dimension, pivots, 0, num_rows, num_rows, num_cols - num_rows);
+    solve_unit_lower_triangular_recursive(matrix, leading_dimension, 0, num_rows, num_rows, num_cols - num_rows, num_threads);
+    return 1;
+}
+
+/**
+ * @brief Solve L * X = B in place by forward substitution, where L is the unit lower triangle of a factored matrix. Blocked: each
+ *        LU_TRSM_BLOCK_SIZE rows of X are solved against their diagonal block of L, and then subtracted from the rows below with a matrix product.
+ *
+ * @param lu: double[ptr]
+ *      The factored matrix.
+ * @param lu_leading_dimension: int
+ *      The distance between the starts of two rows of lu.
+ * @param rhs: double[ptr]
+ *      B on entry and X on return.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param size: int
+ *      The size of L.
+ * @param num_rhs: int
+ *      The number of columns of B.
+ * @param num_threads: int
+ *      The number of threads for the matrix products.
+ *
+ * @return None
+ */
+static void solve_unit_lower_triangular_blocked(const double *lu, int lu_leading_dimension, double *rhs, int rhs_leading_dimension, int size, int num_rhs, int num_threads)
+{
+    for (int block_start = 0; block_start < size; block_start += LU_TRSM_BLOCK_SIZE)
+    {
+        int block_end = (block_start + LU_TRSM_BLOCK_SIZE < size) ? (block_start + LU_TRSM_BLOCK_SIZE) : size;
+        for (int row = block_start + 1; row < block_end; row++)
+        {
+            const double *lu_row = &lu[(int64_t)row * lu_leading_dimension];
+            double *rhs_row = &rhs[(int64_t)row * rhs_leading_dimension];
+            for (int col = block_start; col < row; col++)
+            {
+                double scalar = lu_row[col];
+                const double *solved_row = &rhs[(int64_t)col * rhs_leading_dimension];
+                for (int rhs_col = 0; rhs_col < num_rhs; rhs_col++)
+                {
+                    rhs_row[rhs_col] -= scalar * solved_row[rhs_col];
+                }
+            }
+        }
+        multiply_subtract(&rhs[(int64_t)block_end * rhs_leading_dimension], rhs_leading_dimension,
+                          &lu[(int64_t)block_end * lu_leading_dimension + block_start], lu_leading_dimension,
+                          &rhs[(int64_t)block_start * rhs_leading_dimension], rhs_leading_dimension,
+                          size - block_end, num_rhs, block_end - block_start, num_threads);
+    }
+}
+
+/**
+ * @brief Solve U * X = Y in place by back substitution, where U is the upper triangle of a factored matrix. Blocked like
+ *        solve_unit_lower_triangular_blocked, from the bottom block up.
+ *
+ * @return None
+ */
+static void solve_upper_triangular_blocked(const double *lu, int lu_leading_dimension, double *rhs, int rhs_leading_dimension, int size, int num_rhs, int num_threads)
+{
+    for (int block_end = size; block_end > 0; block_end -= LU_TRSM_BLOCK_SIZE)
+    {
+        int block_start = (block_end - LU_TRSM_BLOCK_SIZE > 0) ? (block_end - LU_TRSM_BLOCK_SIZE) : 0;
+        for (int row = block_end - 1; row >= block_start; row--)
+        {
+            const double *lu_row = &lu[(int64_t)row * lu_leading_dimension];
+            double *rhs_row = &rhs[(int64_t)row * rhs_leading_dimension];
+            for (int col = row + 1; col < block_end; col++)
+            {
+                double scalar = lu_row[col];
+                const double *solved_row = &rhs[(int64_t)col * rhs_leading_dimension];
+                for (int rhs_col = 0; rhs_col < num_rhs; rhs_col++)
+                {
+                    rhs_row[rhs_col] -= scalar * solved_row[rhs_col];
+                }
+            }
+            double reciprocal = 1.0 / lu_row[row];
+            for (int rhs_col = 0; rhs_col < num_rhs; rhs_col++)
+            {
+                rhs_row[rhs_col] *= reciprocal;
+            }
+        }
+        multiply_subtract(rhs, rhs_leading_dimension,
+                          &lu[block_start], lu_leading_dimension,
+                          &rhs[(int64_t)block_start * rhs_leading_dimension], rhs_leading_dimension,
+                          block_start, num_rhs, block_end - block_start, num_threads);
+    }
+}
+
+/**
+ * @brief The shared state of a triangular solve with many right-hand sides, split across threads by columns of the right-hand sides.
+ *
+ * @param pivots: int[ptr]
+ *      The row interchanges to apply to the right-hand sides first, or NULL for none.
+ * @param solve_lower: int
+ *      1 to solve with the unit lower triangle (after the interchanges).
+ * @param solve_upper: int
+ *      1 to solve with the upper triangle (last).
+ * @param threads_per_task: int
+ *      The threads each task may use for its matrix products (more than one only when there are fewer tasks than threads).
+ */
+struct TriangularSolve
+{
+    const double *lu;
+    int lu_leading_dimension;
+    const int *pivots;
+    double *rhs;
+    int rhs_leading_dimension;
+    int size;
+    int num_rhs;
+    int solve_lower;
+    int solve_upper;
+    int num_tasks;
+    int threads_per_task;
+};
+
+/**
+ * @brief One block of columns of the right-hand sides. The columns are independent, so each task runs the whole solve on its own columns.
+ */
+static void solve_triangular_rhs_columns(void *context, int task_index)
+{
+    struct TriangularSolve *solve = (struct TriangularSolve *)context;
+    int start = get_partition_start(solve->num_rhs, solve->num_tasks, task_index);
+    int num_rhs = get_partition_start(solve->num_rhs, solve->num_tasks, task_index + 1) - start;
+    double *rhs = &solve->rhs[start];
+    if (num_rhs <= 0)
+    {
+        return;
+    }
+    if (solve->pivots)
+    {
+        for (int row = 0; row < solve->size; row++)
+        {
+            if (solve->pivots[row] != row)
+            {
+                swap_matrix_rows(rhs, solve->rhs_leading_dimension, row, solve->pivots[row], num_rhs);
+            }
+        }
+    }
+    if (solve->solve_lower)
+    {
+        solve_unit_lower_triangular_blocked(solve->lu, solve->lu_leading_dimension, rhs, solve->rhs_leading_dimension, solve->size, num_rhs, solve->threads_per_task);
+    }
+    if (solve->solve_upper)
+    {
+        solve_upper_triangular_blocked(solve->lu, solve->lu_leading_dimension, rhs, solve->rhs_leading_dimension, solve->size, num_rhs, solve->threads_per_task);
+    }
+}
+
+/**
+ * @brief Solve with the factors of P*A = L*U for many right-hand sides at once (TRSM), with the columns of the right-hand sides split across threads.
+ *
+ * @param lu: double[ptr]
+ *      The factored matrix (L below the diagonal, U on and above it).
+ * @param lu_leading_dimension: int
+ *      The distance between the starts of two rows of lu.
+ * @param size: int
+ *      The number of rows (and columns) of the factors.
+ * @param pivots: int[ptr]
+ *      The row interchanges (see the factorizations), applied to the right-hand sides first. NULL skips them.
+ * @param rhs: double[ptr]
+ *      The right-hand sides on entry, and the solutions on return. May be columns of lu itself (e.g., the augment of an augmented matrix).
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param solve_lower: int
+ *      1 to solve with L. 0 if the right-hand sides already hold inverse(L)*P*B (e.g., carried through the factorization).
+ * @param solve_upper: int
+ *      1 to solve with U.
+ * @param num_threads: int
+ *      The most threads to use.
+ *
+ * @return None
+ */
+static void solve_with_lu_factors(const double *lu, int lu_leading_dimension, int size, const int *pivots, double *rhs, int rhs_leading_dimension, int num_rhs, int solve_lower, int solve_upper, int num_threads)
+{
+    if (size <= 0 || num_rhs <= 0)
+    {
+        return;
+    }
+    struct TriangularSolve solve = {lu, lu_leading_dimension, pivots, rhs, rhs_leading_dimension, size, num_rhs, solve_lower, solve_upper, 1, 1};
+    // Splitting the columns only pays off when every task still has enough of them to fill the matrix products
+    solve.num_tasks = get_num_tasks(num_rhs, num_threads, LU_TRSM_MIN_RHS_PER_TASK);
+    solve.threads_per_task = (num_threads / solve.num_tasks > 1) ? (num_threads / solve.num_tasks) : 1;
+    parallel_for(solve.num_tasks, solve_triangular_rhs_columns, &solve);
+}
+
+/**
+ * @brief Solve U * X = Y in place by back substitution, where U is the upper triangle of a factored matrix and Y sits in the columns after it.
+ *
+ * @param matrix: double[ptr]
+ *      The factored matrix. Its columns [num_rows, num_rows + num_rhs) hold Y on entry and X on return.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param num_rows: int
+ *      The size of U.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param num_threads: int
+ *      The most threads to split the right-hand sides across.
+ *
+ * @return None
+ */
+static void solve_upper_triangular_in_place(double *matrix, int leading_dimension, int num_rows, int num_rhs, int num_threads)
+{
+    solve_with_lu_factors(matrix, leading_dimension, num_rows, NULL, &matrix[num_rows], leading_dimension, num_rhs, 0, 1, num_threads);
+}
+
+/**
+ * @brief "Factor" a triangular matrix: it already is one of its factors, so only the augment columns need work. An upper triangular matrix is its
+ *        own U (with L the identity). A lower triangular matrix is scaled in place to L = A * inverse(D), with D its diagonal, and U = D, and the
+ *        augment is forward-substituted through L like the other factorizations carry it.
+ *
+ * Same parameters and results as factor_lu_calu.
+ *
+ * @return is_nonsingular: int
+ *      1 if the matrix is triangular with no zero on its diagonal.
+ */
+static int factor_triangular(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    int is_upper_triangular = 1;
+    for (int row = 0; row < num_rows; row++)
+    {
+        pivots[row] = row;
+        if (matrix[(int64_t)row * leading_dimension + row] == 0.0)
+        {
+            return 0;
+        }
+        for (int col = 0; col < row && is_upper_triangular; col++)
+        {
+            is_upper_triangular = matrix[(int64_t)row * leading_dimension + col] == 0.0;
+        }
+    }
+    if (is_upper_triangular)
+    {
+        return 1;
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        double *row_values = &matrix[(int64_t)row * leading_dimension];
+        for (int col = row + 1; col < num_rows; col++)
+        {
+            if (row_values[col] != 0.0)
+            {
+                // Neither upper nor lower triangular
+                return 0;
+            }
+        }
+        for (int col = 0; col < row; col++)
+        {
+            row_values[col] /= matrix[(int64_t)col * leading_dimension + col];
+        }
+    }
+    solve_with_lu_factors(matrix, leading_dimension, num_rows, NULL, &matrix[num_rows], leading_dimension, num_cols - num_rows, 1, 0, num_threads);
+    return 1;
+}
+
+/**
+ * @brief Factor a banded matrix with partial pivoting, touching only the band. The bandwidths are measured first. A pivot comes from at most
+ *        lower_bandwidth rows below the diagonal, so L keeps the lower bandwidth and U grows to at most the sum of the two: each step updates a
+ *        (lower_bandwidth) x (lower_bandwidth + upper_bandwidth) block plus the augment columns, instead of the whole trailing matrix.
+ *
+ * Same parameters and results as factor_lu_calu. Runs on the calling thread: the blocks are too small to split.
+ */
+static int factor_lu_banded(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    (void)num_threads;
+    int lower_bandwidth = 0;
+    int upper_bandwidth = 0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        const double *row_values = &matrix[(int64_t)row * leading_dimension];
+        for (int col = 0; col < row - lower_bandwidth; col++)
+        {
+            if (row_values[col] != 0.0)
+            {
+                lower_bandwidth = row - col;
+                break;
+            }
+        }
+        for (int col = num_rows - 1; col > row + upper_bandwidth; col--)
+        {
+            if (row_values[col] != 0.0)
+            {
+                upper_bandwidth = col - row;
+                break;
+            }
+        }
+    }
+    int num_rhs = num_cols - num_rows;
+    for (int k = 0; k < num_rows; k++)
+    {
+        int last_row = (k + lower_bandwidth < num_rows - 1) ? (k + lower_bandwidth) : (num_rows - 1);
+        // Columns past this are still 0 in every row of the step, even after the interchanges
+        int end_col = (k + lower_bandwidth + upper_bandwidth + 1 < num_rows) ? (k + lower_bandwidth + upper_bandwidth + 1) : num_rows;
+        int pivot_row = k;
+        double max_abs_value = fabs(matrix[(int64_t)k * leading_dimension + k]);
+        for (int row = k + 1; row <= last_row; row++)
+        {
+            double abs_value = fabs(matrix[(int64_t)row * leading_dimension + k]);
+            if (abs_value > max_abs_value)
+            {
+                max_abs_value = abs_value;
+                pivot_row = row;
+            }
+        }
+        pivots[k] = pivot_row;
+        if (max_abs_value == 0.0)
+        {
+            return 0;
+        }
+        if (pivot_row != k)
+        {
+            // The multipliers already stored in either row start at most lower_bandwidth columns left of the diagonal
+            int first_col = (k - lower_bandwidth > 0) ? (k - lower_bandwidth) : 0;
+            swap_matrix_rows(&matrix[first_col], leading_dimension, k, pivot_row, end_col - first_col);
+            swap_matrix_rows(&matrix[num_rows], leading_dimension, k, pivot_row, num_rhs);
+        }
+        const double *pivot_values = &matrix[(int64_t)k * leading_dimension];
+        double pivot_reciprocal = 1.0 / pivot_values[k];
+        for (int row = k + 1; row <= last_row; row++)
+        {
+            double *row_values = &matrix[(int64_t)row * leading_dimension];
+            double scalar = row_values[k] * pivot_reciprocal;
+            if (scalar == 0.0)
+            {
+                continue;
+            }
+            row_values[k] = scalar;
+            for (int col = k + 1; col < end_col; col++)
+            {
+                row_values[col] -= scalar * pivot_values[col];
+            }
+            for (int col = num_rows; col < num_cols; col++)
+            {
+                row_values[col] -= scalar * pivot_values[col];
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Eliminate within rows [first, end) of a symmetric matrix, using only the upper triangle: the multiplier of row i for pivot row k is
+ *        U[k][i] / U[k][k], because the part of column k that is still to be eliminated mirrors row k. Updates every column from the diagonal on,
+ *        the augment included.
+ */
+static int eliminate_symmetric_rows(double *matrix, int leading_dimension, int first, int end, int num_cols)
+{
+    for (int k = first; k < end; k++)
+    {
+        const double *pivot_values = &matrix[(int64_t)k * leading_dimension];
+        if (!(pivot_values[k] > 0.0))
+        {
+            return 0;
+        }
+        double pivot_reciprocal = 1.0 / pivot_values[k];
+        for (int row = k + 1; row < end; row++)
+        {
+            double *row_values = &matrix[(int64_t)row * leading_dimension];
+            double scalar = pivot_values[row] * pivot_reciprocal;
+            for (int col = row; col < num_cols; col++)
+            {
+                row_values[col] -= scalar * pivot_values[col];
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Factor a symmetric positive definite matrix as A = L * D * transpose(L) without pivoting, in blocks of LU_TILE_SIZE rows. Each block of
+ *        rows is eliminated on its own, and then subtracted from the rows below with matrix products that only cover the upper triangle (block by
+ *        block), which is half the work of LU. U = D * transpose(L) ends up in the upper triangle and the augment holds inverse(L) * B, like the
+ *        other factorizations (the strict lower triangle is left as it is).
+ *
+ * Same parameters and results as factor_lu_calu.
+ *
+ * @return is_positive_definite: int
+ *      1 if every pivot was positive. 0 otherwise (or if the scratch could not be allocated), and the matrix is then undefined.
+ */
+static int factor_symmetric_positive_definite(double *matrix, int leading_dimension, int num_rows, int num_cols, int *pivots, int num_threads)
+{
+    for (int row = 0; row < num_rows; row++)
+    {
+        pivots[row] = row;
+    }
+    double *multipliers = (double *)malloc(sizeof(double) * (int64_t)num_rows * LU_TILE_SIZE);
+    if (!multipliers)
+    {
+        return 0;
+    }
+    for (int first = 0; first < num_rows; first += LU_TILE_SIZE)
+    {
+        int end = (first + LU_TILE_SIZE < num_rows) ? (first + LU_TILE_SIZE) : num_rows;
+        int width = end - first;
+        if (!eliminate_symmetric_rows(matrix, leading_dimension, first, end, num_cols))
+        {
+            free(multipliers);
+            return 0;
+        }
+        // The multipliers of the rows below for this block's pivots: L[i][k] = U[k][i] / U[k][k]
+        for (int row = end; row < num_rows; row++)
+        {
+            for (int k = first; k < end; k++)
+            {
+                multipliers[(int64_t)(row - end) * width + (k - first)] = matrix[(int64_t)k * leading_dimension + row] / matrix[(int64_t)k * leading_dimension + k];
+            }
+        }
+        for (int block_first = end; block_first < num_rows; block_first += LU_TILE_SIZE)
+        {
+            int block_end = (block_first + LU_TILE_SIZE < num_rows) ? (block_first + LU_TILE_SIZE) : num_rows;
+            multiply_subtract(&matrix[(int64_t)block_first * leading_dimension + block_first], leading_dimension,
+                              &multipliers[(int64_t)(block_first - end) * width], width,
+                              &matrix[(int64_t)first * leading_dimension + block_first], leading_dimension,
+                              block_end - block_first, num_cols - block_first, width, num_threads);
+        }
+    }
+    free(multipliers);
+    return 1;
+}
+
+#endif
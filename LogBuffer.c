@@ -0,0 +1,304 @@
+#ifndef LOG_BUFFER_C
+#define LOG_BUFFER_C
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.c"
+
+// The number of bytes held by each chunk of a LogBuffer.
+#define LOG_CHUNK_CAPACITY 4096
+
+/**
+ * @brief One fixed-size piece of a LogBuffer. Chunks are linked in the order they were written.
+ * @param next: struct LogChunk[ptr]
+ *      The chunk that follows this one, or NULL if this is the last chunk allocated.
+ * @param length: int64_t
+ *      The number of bytes written to this chunk. Only kept up to date once the chunk has been filled (sealed).
+ * @param bytes: char[LOG_CHUNK_CAPACITY]
+ *      The bytes of the chunk.
+ */
+struct LogChunk
+{
+    struct LogChunk *next;
+    int64_t length;
+    char bytes[LOG_CHUNK_CAPACITY];
+};
+
+/**
+ * @brief A C-owned message buffer that grows by chaining fixed-size chunks, so it never has to truncate the step log.
+ *        Filling a chunk links a new one onto the end, meaning earlier chunks are never reallocated or copied.
+ *
+ *        NOTE: The String is the first member so that a LogBuffer pointer can be passed wherever a struct String pointer (message_buffer) is expected.
+ *
+ * @param string: struct String
+ *      The String the solver writes into. Its bytes always point at the current chunk, and its length is the length of the current chunk.
+ * @param first_chunk: struct LogChunk[ptr]
+ *      The first chunk in the chain.
+ * @param current_chunk: struct LogChunk[ptr]
+ *      The chunk currently being written to.
+ * @param sealed_length: int64_t
+ *      The number of bytes held by all of the chunks before current_chunk.
+ */
+struct LogBuffer
+{
+    struct String string;
+    struct LogChunk *first_chunk;
+    struct LogChunk *current_chunk;
+    int64_t sealed_length;
+};
+
+/**
+ * @brief Allocate an empty chunk.
+ *
+ * @return chunk: struct LogChunk[ptr]
+ *      The new chunk, or NULL if the allocation failed.
+ */
+static inline struct LogChunk *allocate_log_chunk(void)
+{
+    struct LogChunk *chunk = (struct LogChunk *)malloc(sizeof(struct LogChunk));
+    if (chunk)
+    {
+        chunk->next = NULL;
+        chunk->length = 0;
+    }
+    return chunk;
+}
+
+/**
+ * @brief Point the LogBuffer's String at the start of the given chunk.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to update.
+ * @param chunk: struct LogChunk[ptr]
+ *      The chunk to write into next.
+ *
+ * @return None
+ */
+static inline void use_log_chunk(struct LogBuffer *log_buffer, struct LogChunk *chunk)
+{
+    log_buffer->current_chunk = chunk;
+    log_buffer->string.bytes = chunk->bytes;
+    log_buffer->string.capacity = LOG_CHUNK_CAPACITY;
+    log_buffer->string.length = 0;
+}
+
+/**
+ * @brief The String grow callback of a LogBuffer. Seals the current chunk and moves on to the next one, allocating it if it does not exist yet.
+ *        Chunks left over from before a reset are reused instead of being allocated again.
+ *
+ * @param s: struct String[ptr]
+ *      The String that ran out of capacity. Its growContext is the LogBuffer that owns it.
+ *
+ * @return grew: int
+ *      1 if the String can continue writing, 0 if a new chunk could not be allocated.
+ */
+static int grow_log_buffer(struct String *s)
+{
+    struct LogBuffer *log_buffer = (struct LogBuffer *)s->growContext;
+    struct LogChunk *next_chunk = log_buffer->current_chunk->next;
+    if (!next_chunk)
+    {
+        next_chunk = allocate_log_chunk();
+        if (!next_chunk)
+        {
+            return 0;
+        }
+        log_buffer->current_chunk->next = next_chunk;
+    }
+    log_buffer->current_chunk->length = s->length;
+    log_buffer->sealed_length += s->length;
+    use_log_chunk(log_buffer, next_chunk);
+    return 1;
+}
+
+/**
+ * @brief Create an empty LogBuffer. It must be released with python_destroy_log_buffer.
+ *
+ * @return log_buffer: struct LogBuffer[ptr]
+ *      The new LogBuffer, or NULL if the allocation failed.
+ */
+EXPORT struct LogBuffer *python_create_log_buffer(void)
+{
+    struct LogBuffer *log_buffer = (struct LogBuffer *)malloc(sizeof(struct LogBuffer));
+    if (!log_buffer)
+    {
+        return NULL;
+    }
+    log_buffer->first_chunk = allocate_log_chunk();
+    if (!log_buffer->first_chunk)
+    {
+        free(log_buffer);
+        return NULL;
+    }
+    log_buffer->string = String(NULL, 0);
+    log_buffer->string.grow = grow_log_buffer;
+    log_buffer->string.growContext = log_buffer;
+    log_buffer->sealed_length = 0;
+    use_log_chunk(log_buffer, log_buffer->first_chunk);
+    return log_buffer;
+}
+
+/**
+ * @brief Free a LogBuffer and all of its chunks.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to free. Passing NULL does nothing.
+ *
+ * @return None
+ */
+EXPORT void python_destroy_log_buffer(struct LogBuffer *log_buffer)
+{
+    if (!log_buffer)
+    {
+        return;
+    }
+    struct LogChunk *chunk = log_buffer->first_chunk;
+    while (chunk)
+    {
+        struct LogChunk *next_chunk = chunk->next;
+        free(chunk);
+        chunk = next_chunk;
+    }
+    free(log_buffer);
+}
+
+/**
+ * @brief Empty a LogBuffer. The chunks stay allocated and are reused by later writes.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to empty.
+ *
+ * @return None
+ */
+EXPORT void python_reset_log_buffer(struct LogBuffer *log_buffer)
+{
+    log_buffer->sealed_length = 0;
+    log_buffer->string.attemptedToWriteMoreThanCapacity = 0;
+    log_buffer->string.lineStart = 0;
+    use_log_chunk(log_buffer, log_buffer->first_chunk);
+}
+
+/**
+ * @brief Make sure a LogBuffer can hold at least num_bytes in total without allocating during a solve.
+ *        Pairs with the python_measure_*_log functions, which give the exact size of a step log.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to grow.
+ * @param num_bytes: int64_t
+ *      The number of bytes the LogBuffer should be able to hold.
+ *
+ * @return reserved: int
+ *      1 if enough chunks are allocated, 0 if an allocation failed.
+ */
+EXPORT int python_reserve_log_buffer(struct LogBuffer *log_buffer, int64_t num_bytes)
+{
+    struct LogChunk *chunk = log_buffer->first_chunk;
+    int64_t num_bytes_reserved = LOG_CHUNK_CAPACITY;
+    while (num_bytes_reserved < num_bytes)
+    {
+        if (!chunk->next)
+        {
+            chunk->next = allocate_log_chunk();
+            if (!chunk->next)
+            {
+                return 0;
+            }
+        }
+        chunk = chunk->next;
+        num_bytes_reserved += LOG_CHUNK_CAPACITY;
+    }
+    return 1;
+}
+
+/**
+ * @brief Get the total number of bytes written to a LogBuffer since it was created or last reset.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to measure.
+ *
+ * @return length: int64_t
+ *      The number of bytes in the LogBuffer.
+ */
+EXPORT int64_t python_get_log_buffer_length(struct LogBuffer *log_buffer)
+{
+    return log_buffer->sealed_length + log_buffer->string.length;
+}
+
+/**
+ * @brief Copy bytes out of a LogBuffer into memory owned by the caller, so nothing allocated by the library is handed over.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to read from.
+ * @param offset: int64_t
+ *      The position (in bytes from the start of the log) to start reading at.
+ * @param destination: char[ptr]
+ *      The memory to copy the bytes into.
+ * @param destination_capacity: int64_t
+ *      The maximum number of bytes to copy.
+ *
+ * @return num_bytes_read: int64_t
+ *      The number of bytes copied into destination.
+ */
+EXPORT int64_t python_read_log_buffer(struct LogBuffer *log_buffer, int64_t offset, char *destination, int64_t destination_capacity)
+{
+    int64_t num_bytes_read = 0;
+    int64_t chunk_start = 0;
+    for (struct LogChunk *chunk = log_buffer->first_chunk; chunk && num_bytes_read < destination_capacity; chunk = chunk->next)
+    {
+        int64_t chunk_length = (chunk == log_buffer->current_chunk) ? log_buffer->string.length : chunk->length;
+        int64_t chunk_end = chunk_start + chunk_length;
+        if (offset < chunk_end)
+        {
+            int64_t start_in_chunk = (offset > chunk_start) ? (offset - chunk_start) : 0;
+            int64_t num_bytes_to_copy = chunk_length - start_in_chunk;
+            if (num_bytes_to_copy > destination_capacity - num_bytes_read)
+            {
+                num_bytes_to_copy = destination_capacity - num_bytes_read;
+            }
+            memcpy(&destination[num_bytes_read], &chunk->bytes[start_in_chunk], (size_t)num_bytes_to_copy);
+            num_bytes_read += num_bytes_to_copy;
+        }
+        if (chunk == log_buffer->current_chunk)
+        {
+            break;
+        }
+        chunk_start = chunk_end;
+    }
+    return num_bytes_read;
+}
+
+/**
+ * @brief Append everything written to a LogBuffer to another message buffer, e.g., to splice a log written on another thread into the step log.
+ *
+ * @param log_buffer: struct LogBuffer[ptr]
+ *      The LogBuffer to copy from.
+ * @param message_buffer: struct String[ptr]
+ *      The message buffer to append to. If NULL, the bytes are printed instead.
+ *
+ * @return None
+ */
+static void append_log_buffer(struct LogBuffer *log_buffer, struct String *message_buffer)
+{
+    for (struct LogChunk *chunk = log_buffer->first_chunk; chunk; chunk = chunk->next)
+    {
+        int64_t chunk_length = (chunk == log_buffer->current_chunk) ? log_buffer->string.length : chunk->length;
+        if (!message_buffer)
+        {
+            fwrite(chunk->bytes, 1, (size_t)chunk_length, stdout);
+        }
+        else
+        {
+            for (int64_t byte = 0; byte < chunk_length; byte++)
+            {
+                writeChar(chunk->bytes[byte], message_buffer);
+            }
+        }
+        if (chunk == log_buffer->current_chunk)
+        {
+            break;
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,243 @@
+#ifndef LOG_RING_C
+#define LOG_RING_C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.c"
+#ifdef _WIN32
+#include <windows.h>
+// Interlocked operations are full barriers, which covers the acquire/release ordering the ring needs.
+#define LOG_RING_LOAD_ACQUIRE(pointer) InterlockedCompareExchange64((volatile LONG64 *)(pointer), 0, 0)
+#define LOG_RING_STORE_RELEASE(pointer, value) InterlockedExchange64((volatile LONG64 *)(pointer), (LONG64)(value))
+#define LOG_RING_YIELD() SwitchToThread()
+#endif
+#ifdef linux
+#include <sched.h>
+#define LOG_RING_LOAD_ACQUIRE(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define LOG_RING_STORE_RELEASE(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+#define LOG_RING_YIELD() sched_yield()
+#endif
+
+// The number of bytes of a line the producer stages before publishing it. Longer lines are published in pieces.
+#define LOG_RING_LINE_CAPACITY 1024
+// Used to keep the producer's and the consumer's indices on separate cache lines.
+#define LOG_RING_CACHE_LINE_SIZE 64
+
+/**
+ * @brief A single-producer/single-consumer ring buffer that the solver publishes complete lines of its step log into.
+ *        The storage is shared with the reader (the Python GUI), which reads new bytes in place and then hands them back by advancing the tail.
+ *
+ *        The head and tail are byte counters that only ever increase; their position in the storage is the counter masked by (capacity - 1).
+ *        Only the producer writes head (with release ordering, after the bytes are in place), and only the consumer writes tail (after it is done with the bytes).
+ *
+ *        NOTE: The String is the first member so that a LogRing pointer can be passed wherever a struct String pointer (message_buffer) is expected.
+ *
+ * @param string: struct String
+ *      The producer's staging String. The solver writes into it, and every complete line is copied into the ring and published.
+ * @param storage: char[ptr]
+ *      The ring's bytes. Shared with the consumer.
+ * @param capacity: int64_t
+ *      The number of bytes in storage. Always a power of two.
+ * @param block_when_full: int
+ *      If nonzero, the producer waits for the consumer to make room. Otherwise the line is dropped and the String's attemptedToWriteMoreThanCapacity flag is set.
+ *      Blocking must only be used when the consumer runs on a different thread than the solver.
+ * @param head: int64_t
+ *      The total number of bytes published by the producer.
+ * @param tail: int64_t
+ *      The total number of bytes released by the consumer.
+ * @param line: char[LOG_RING_LINE_CAPACITY]
+ *      The bytes of the staging String.
+ */
+struct LogRing
+{
+    struct String string;
+    char *storage;
+    int64_t capacity;
+    int block_when_full;
+    char padding_before_head[LOG_RING_CACHE_LINE_SIZE];
+    volatile int64_t head;
+    char padding_before_tail[LOG_RING_CACHE_LINE_SIZE - sizeof(int64_t)];
+    volatile int64_t tail;
+    char padding_after_tail[LOG_RING_CACHE_LINE_SIZE - sizeof(int64_t)];
+    char line[LOG_RING_LINE_CAPACITY];
+};
+
+/**
+ * @brief Copy the staged bytes into the ring and publish them to the consumer.
+ *
+ * @param log_ring: struct LogRing[ptr]
+ *      The ring to publish into. Must only be called by the producer.
+ *
+ * @return None
+ */
+static void publish_log_ring(struct LogRing *log_ring)
+{
+    int64_t num_bytes = log_ring->string.length;
+    if (num_bytes == 0)
+    {
+        return;
+    }
+    // Only the producer writes head, so a plain read is enough here.
+    int64_t head = log_ring->head;
+    while ((head + num_bytes) - LOG_RING_LOAD_ACQUIRE(&log_ring->tail) > log_ring->capacity)
+    {
+        if (!log_ring->block_when_full)
+        {
+            log_ring->string.attemptedToWriteMoreThanCapacity = 1;
+            log_ring->string.lineStart -= num_bytes;
+            log_ring->string.length = 0;
+            return;
+        }
+        LOG_RING_YIELD();
+    }
+    int64_t start = head & (log_ring->capacity - 1);
+    int64_t num_bytes_before_wrap = log_ring->capacity - start;
+    if (num_bytes <= num_bytes_before_wrap)
+    {
+        memcpy(&log_ring->storage[start], log_ring->line, (size_t)num_bytes);
+    }
+    else
+    {
+        memcpy(&log_ring->storage[start], log_ring->line, (size_t)num_bytes_before_wrap);
+        memcpy(&log_ring->storage[0], &log_ring->line[num_bytes_before_wrap], (size_t)(num_bytes - num_bytes_before_wrap));
+    }
+    LOG_RING_STORE_RELEASE(&log_ring->head, head + num_bytes);
+    // A flush in the middle of a line keeps its column
+    log_ring->string.lineStart -= num_bytes;
+    log_ring->string.length = 0;
+}
+
+/**
+ * @brief The String lineWritten callback of a LogRing. Publishes the line that was just finished.
+ */
+static void log_ring_line_written(struct String *s)
+{
+    publish_log_ring((struct LogRing *)s->growContext);
+}
+
+/**
+ * @brief The String grow callback of a LogRing. A line longer than the staging String is published in pieces.
+ */
+static int grow_log_ring(struct String *s)
+{
+    publish_log_ring((struct LogRing *)s->growContext);
+    return s->length < s->capacity;
+}
+
+/**
+ * @brief Create an empty LogRing. It must be released with python_destroy_log_ring.
+ *
+ * @param capacity: int64_t
+ *      The minimum number of bytes the ring should hold. It is rounded up to a power of two of at least LOG_RING_LINE_CAPACITY.
+ * @param block_when_full: int
+ *      Whether the producer should wait for the consumer when the ring is full. See struct LogRing.
+ *
+ * @return log_ring: struct LogRing[ptr]
+ *      The new LogRing, or NULL if the allocation failed.
+ */
+EXPORT struct LogRing *python_create_log_ring(int64_t capacity, int block_when_full)
+{
+    int64_t rounded_capacity = LOG_RING_LINE_CAPACITY;
+    while (rounded_capacity < capacity)
+    {
+        rounded_capacity *= 2;
+    }
+    struct LogRing *log_ring = (struct LogRing *)malloc(sizeof(struct LogRing));
+    if (!log_ring)
+    {
+        return NULL;
+    }
+    log_ring->storage = (char *)malloc((size_t)rounded_capacity);
+    if (!log_ring->storage)
+    {
+        free(log_ring);
+        return NULL;
+    }
+    log_ring->capacity = rounded_capacity;
+    log_ring->block_when_full = block_when_full;
+    log_ring->head = 0;
+    log_ring->tail = 0;
+    log_ring->string = String(log_ring->line, LOG_RING_LINE_CAPACITY);
+    log_ring->string.grow = grow_log_ring;
+    log_ring->string.growContext = log_ring;
+    log_ring->string.lineWritten = log_ring_line_written;
+    return log_ring;
+}
+
+/**
+ * @brief Free a LogRing and its storage. Neither side may be using it anymore.
+ *
+ * @param log_ring: struct LogRing[ptr]
+ *      The LogRing to free. Passing NULL does nothing.
+ *
+ * @return None
+ */
+EXPORT void python_destroy_log_ring(struct LogRing *log_ring)
+{
+    if (!log_ring)
+    {
+        return;
+    }
+    free(log_ring->storage);
+    free(log_ring);
+}
+
+/**
+ * @brief Publish whatever the producer has staged, even if it is not a complete line. Must be called from the producer's side (e.g. once the solver returns).
+ *
+ * @param log_ring: struct LogRing[ptr]
+ *      The LogRing to flush.
+ *
+ * @return None
+ */
+EXPORT void python_flush_log_ring(struct LogRing *log_ring)
+{
+    publish_log_ring(log_ring);
+}
+
+/**
+ * @brief Get the ring's storage so the consumer can read it in place.
+ */
+EXPORT char *python_get_log_ring_storage(struct LogRing *log_ring)
+{
+    return log_ring->storage;
+}
+
+/**
+ * @brief Get the number of bytes in the ring's storage.
+ */
+EXPORT int64_t python_get_log_ring_capacity(struct LogRing *log_ring)
+{
+    return log_ring->capacity;
+}
+
+/**
+ * @brief Get the total number of bytes published so far. Every byte before this counter is safe for the consumer to read.
+ *
+ * @param log_ring: struct LogRing[ptr]
+ *      The LogRing to check.
+ *
+ * @return head: int64_t
+ *      The head counter, loaded with acquire ordering.
+ */
+EXPORT int64_t python_get_log_ring_head(struct LogRing *log_ring)
+{
+    return LOG_RING_LOAD_ACQUIRE(&log_ring->head);
+}
+
+/**
+ * @brief Hand bytes back to the producer once the consumer is done reading them.
+ *
+ * @param log_ring: struct LogRing[ptr]
+ *      The LogRing being read.
+ * @param new_tail: int64_t
+ *      The total number of bytes consumed so far. Must not go past the head.
+ *
+ * @return None
+ */
+EXPORT void python_consume_log_ring(struct LogRing *log_ring, int64_t new_tail)
+{
+    LOG_RING_STORE_RELEASE(&log_ring->tail, new_tail);
+}
+
+#endif
@@ -0,0 +1,358 @@
+#ifndef MATRIX_MULTIPLY_C
+#define MATRIX_MULTIPLY_C
+#include <stdint.h>
+#include <stdlib.h>
+#include "ThreadPool.c"
+#if defined(__AVX__)
+#include <immintrin.h>
+#if defined(__FMA__)
+#define GEMM_MULTIPLY_ADD_256(a, b, sum) _mm256_fmadd_pd((a), (b), (sum))
+#else
+#define GEMM_MULTIPLY_ADD_256(a, b, sum) _mm256_add_pd((sum), _mm256_mul_pd((a), (b)))
+#endif
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEMM_USE_SSE2
+#endif
+
+/**
+ * A packed, register-blocked matrix product C = alpha * A * B + beta * C on row-major matrices with leading dimensions (DGEMM).
+ *
+ * The loops follow the usual blocking: B is packed KC x NC at a time into panels GEMM_NR columns wide, A is packed MC x KC at a time
+ * into panels GEMM_MR rows tall, and the micro-kernel multiplies one A panel by one B panel into a GEMM_MR x GEMM_NR block of
+ * accumulators that lives in registers for the whole of the KC loop. The packed B block is shared by every thread, and each thread
+ * packs its own blocks of A (when C is short and wide, threads that share row blocks pack the same A, which is cheap next to the product).
+ */
+
+// The rows and columns of C the micro-kernel computes at once.
+#define GEMM_MR 4
+#define GEMM_NR 8
+// The blocks of A (MC x KC) and B (KC x NC) that are packed at a time. A block of A is sized for the L2 cache, a panel of B for L1.
+#define GEMM_MC 128
+#define GEMM_KC 256
+#define GEMM_NC 2048
+// Products with fewer multiply-adds than this skip the packing, which would cost more than it saves.
+#define GEMM_MIN_PACKED_WORK 32768
+// Products with fewer multiply-adds than this run on the calling thread.
+#define GEMM_MIN_PARALLEL_WORK 262144
+
+/**
+ * @brief Pack an m x k block of A into panels of GEMM_MR rows. Within a panel the GEMM_MR values of each column are contiguous, in the order the
+ *        micro-kernel reads them. Rows past m are zero.
+ */
+static void pack_gemm_a(const double *a, int lda, int m, int k, double *packed)
+{
+    for (int panel_row = 0; panel_row < m; panel_row += GEMM_MR)
+    {
+        for (int inner = 0; inner < k; inner++)
+        {
+            for (int row = 0; row < GEMM_MR; row++)
+            {
+                *packed++ = (panel_row + row < m) ? a[(int64_t)(panel_row + row) * lda + inner] : 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Pack a k x n block of B into panels of GEMM_NR columns. Within a panel the GEMM_NR values of each row are contiguous. Columns past n are zero.
+ */
+static void pack_gemm_b(const double *b, int ldb, int k, int n, double *packed)
+{
+    for (int panel_col = 0; panel_col < n; panel_col += GEMM_NR)
+    {
+        int num_cols = (n - panel_col < GEMM_NR) ? (n - panel_col) : GEMM_NR;
+        for (int inner = 0; inner < k; inner++)
+        {
+            const double *b_row = &b[(int64_t)inner * ldb + panel_col];
+            int col = 0;
+            for (; col < num_cols; col++)
+            {
+                *packed++ = b_row[col];
+            }
+            for (; col < GEMM_NR; col++)
+            {
+                *packed++ = 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief C[GEMM_MR x GEMM_NR] += alpha * (packed A panel) * (packed B panel), writing back only the num_rows x num_cols that are inside C.
+ *        The GEMM_MR x GEMM_NR accumulators stay in vector registers for the whole inner loop: 8 AVX registers, or 8 SSE2 registers for
+ *        each half of the block. Each step broadcasts one value of A per row and multiplies it by one row of the B panel. The scalar version is for
+ *        targets without either.
+ */
+static inline void gemm_micro_kernel(int k, double alpha, const double *a_panel, const double *b_panel, double *c, int ldc, int num_rows, int num_cols)
+{
+    double accumulators[GEMM_MR][GEMM_NR];
+#if defined(__AVX__)
+    // Named rather than an array, so that the compiler keeps them in registers without having to unroll the loop over the rows
+    __m256d sum_0_low = _mm256_setzero_pd(), sum_0_high = _mm256_setzero_pd();
+    __m256d sum_1_low = _mm256_setzero_pd(), sum_1_high = _mm256_setzero_pd();
+    __m256d sum_2_low = _mm256_setzero_pd(), sum_2_high = _mm256_setzero_pd();
+    __m256d sum_3_low = _mm256_setzero_pd(), sum_3_high = _mm256_setzero_pd();
+    for (int inner = 0; inner < k; inner++)
+    {
+        const double *a_values = &a_panel[inner * GEMM_MR];
+        __m256d b_low = _mm256_loadu_pd(&b_panel[inner * GEMM_NR]);
+        __m256d b_high = _mm256_loadu_pd(&b_panel[inner * GEMM_NR + 4]);
+        __m256d a_value = _mm256_broadcast_sd(&a_values[0]);
+        sum_0_low = GEMM_MULTIPLY_ADD_256(a_value, b_low, sum_0_low);
+        sum_0_high = GEMM_MULTIPLY_ADD_256(a_value, b_high, sum_0_high);
+        a_value = _mm256_broadcast_sd(&a_values[1]);
+        sum_1_low = GEMM_MULTIPLY_ADD_256(a_value, b_low, sum_1_low);
+        sum_1_high = GEMM_MULTIPLY_ADD_256(a_value, b_high, sum_1_high);
+        a_value = _mm256_broadcast_sd(&a_values[2]);
+        sum_2_low = GEMM_MULTIPLY_ADD_256(a_value, b_low, sum_2_low);
+        sum_2_high = GEMM_MULTIPLY_ADD_256(a_value, b_high, sum_2_high);
+        a_value = _mm256_broadcast_sd(&a_values[3]);
+        sum_3_low = GEMM_MULTIPLY_ADD_256(a_value, b_low, sum_3_low);
+        sum_3_high = GEMM_MULTIPLY_ADD_256(a_value, b_high, sum_3_high);
+    }
+    _mm256_storeu_pd(&accumulators[0][0], sum_0_low);
+    _mm256_storeu_pd(&accumulators[0][4], sum_0_high);
+    _mm256_storeu_pd(&accumulators[1][0], sum_1_low);
+    _mm256_storeu_pd(&accumulators[1][4], sum_1_high);
+    _mm256_storeu_pd(&accumulators[2][0], sum_2_low);
+    _mm256_storeu_pd(&accumulators[2][4], sum_2_high);
+    _mm256_storeu_pd(&accumulators[3][0], sum_3_low);
+    _mm256_storeu_pd(&accumulators[3][4], sum_3_high);
+#elif defined(GEMM_USE_SSE2)
+    // Two columns per register. All of the 4 x 8 block would take all 16 registers and leave none for A and B, so it is done in two
+    // 4 x 4 halves, each a pass over the (L1-resident) panels. Named for the same reason as above.
+    for (int half = 0; half < GEMM_NR; half += 4)
+    {
+        __m128d sum_0_low = _mm_setzero_pd(), sum_0_high = _mm_setzero_pd();
+        __m128d sum_1_low = _mm_setzero_pd(), sum_1_high = _mm_setzero_pd();
+        __m128d sum_2_low = _mm_setzero_pd(), sum_2_high = _mm_setzero_pd();
+        __m128d sum_3_low = _mm_setzero_pd(), sum_3_high = _mm_setzero_pd();
+        for (int inner = 0; inner < k; inner++)
+        {
+            const double *a_values = &a_panel[inner * GEMM_MR];
+            __m128d b_low = _mm_loadu_pd(&b_panel[inner * GEMM_NR + half]);
+            __m128d b_high = _mm_loadu_pd(&b_panel[inner * GEMM_NR + half + 2]);
+            __m128d a_value = _mm_set1_pd(a_values[0]);
+            sum_0_low = _mm_add_pd(sum_0_low, _mm_mul_pd(a_value, b_low));
+            sum_0_high = _mm_add_pd(sum_0_high, _mm_mul_pd(a_value, b_high));
+            a_value = _mm_set1_pd(a_values[1]);
+            sum_1_low = _mm_add_pd(sum_1_low, _mm_mul_pd(a_value, b_low));
+            sum_1_high = _mm_add_pd(sum_1_high, _mm_mul_pd(a_value, b_high));
+            a_value = _mm_set1_pd(a_values[2]);
+            sum_2_low = _mm_add_pd(sum_2_low, _mm_mul_pd(a_value, b_low));
+            sum_2_high = _mm_add_pd(sum_2_high, _mm_mul_pd(a_value, b_high));
+            a_value = _mm_set1_pd(a_values[3]);
+            sum_3_low = _mm_add_pd(sum_3_low, _mm_mul_pd(a_value, b_low));
+            sum_3_high = _mm_add_pd(sum_3_high, _mm_mul_pd(a_value, b_high));
+        }
+        _mm_storeu_pd(&accumulators[0][half], sum_0_low);
+        _mm_storeu_pd(&accumulators[0][half + 2], sum_0_high);
+        _mm_storeu_pd(&accumulators[1][half], sum_1_low);
+        _mm_storeu_pd(&accumulators[1][half + 2], sum_1_high);
+        _mm_storeu_pd(&accumulators[2][half], sum_2_low);
+        _mm_storeu_pd(&accumulators[2][half + 2], sum_2_high);
+        _mm_storeu_pd(&accumulators[3][half], sum_3_low);
+        _mm_storeu_pd(&accumulators[3][half + 2], sum_3_high);
+    }
+#else
+    for (int row = 0; row < GEMM_MR; row++)
+    {
+        for (int col = 0; col < GEMM_NR; col++)
+        {
+            accumulators[row][col] = 0.0;
+        }
+    }
+    for (int inner = 0; inner < k; inner++)
+    {
+        const double *a_values = &a_panel[inner * GEMM_MR];
+        const double *b_values = &b_panel[inner * GEMM_NR];
+        for (int row = 0; row < GEMM_MR; row++)
+        {
+            double a_value = a_values[row];
+            for (int col = 0; col < GEMM_NR; col++)
+            {
+                accumulators[row][col] += a_value * b_values[col];
+            }
+        }
+    }
+#endif
+    for (int row = 0; row < num_rows; row++)
+    {
+        double *c_row = &c[(int64_t)row * ldc];
+        for (int col = 0; col < num_cols; col++)
+        {
+            c_row[col] += alpha * accumulators[row][col];
+        }
+    }
+}
+
+/**
+ * @brief The shared state of one packed block of B, which the threads multiply their blocks of A against.
+ */
+struct GemmBlock
+{
+    int m;
+    int n;
+    int k;
+    double alpha;
+    const double *a;
+    int lda;
+    double *c;
+    int ldc;
+    const double *packed_b;
+    double *packed_a_buffers;
+    int num_row_parts;
+    int num_col_parts;
+};
+
+/**
+ * @brief One thread's share of C for the current block of B: a range of MC row blocks times a range of GEMM_NR column panels.
+ *        Packs each MC x KC block of A in the range and runs the micro-kernel over it.
+ */
+static void multiply_gemm_block_part(void *context, int task_index)
+{
+    struct GemmBlock *block = (struct GemmBlock *)context;
+    int row_part = task_index / block->num_col_parts;
+    int col_part = task_index % block->num_col_parts;
+    int num_row_blocks = (block->m + GEMM_MC - 1) / GEMM_MC;
+    int num_col_panels = (block->n + GEMM_NR - 1) / GEMM_NR;
+    int first_row_block = (int)(((int64_t)num_row_blocks * row_part) / block->num_row_parts);
+    int end_row_block = (int)(((int64_t)num_row_blocks * (row_part + 1)) / block->num_row_parts);
+    int first_panel_col = GEMM_NR * (int)(((int64_t)num_col_panels * col_part) / block->num_col_parts);
+    int end_panel_col = GEMM_NR * (int)(((int64_t)num_col_panels * (col_part + 1)) / block->num_col_parts);
+    double *packed_a = &block->packed_a_buffers[(int64_t)task_index * GEMM_MC * GEMM_KC];
+    for (int row_block = first_row_block; row_block < end_row_block; row_block++)
+    {
+        int first_row = row_block * GEMM_MC;
+        int num_rows = (block->m - first_row < GEMM_MC) ? (block->m - first_row) : GEMM_MC;
+        pack_gemm_a(&block->a[(int64_t)first_row * block->lda], block->lda, num_rows, block->k, packed_a);
+        for (int panel_col = first_panel_col; panel_col < end_panel_col; panel_col += GEMM_NR)
+        {
+            const double *b_panel = &block->packed_b[(int64_t)panel_col * block->k];
+            int num_cols = (block->n - panel_col < GEMM_NR) ? (block->n - panel_col) : GEMM_NR;
+            for (int panel_row = 0; panel_row < num_rows; panel_row += GEMM_MR)
+            {
+                int num_panel_rows = (num_rows - panel_row < GEMM_MR) ? (num_rows - panel_row) : GEMM_MR;
+                gemm_micro_kernel(block->k, block->alpha, &packed_a[(int64_t)panel_row * block->k], b_panel,
+                                  &block->c[(int64_t)(first_row + panel_row) * block->ldc + panel_col], block->ldc, num_panel_rows, num_cols);
+            }
+        }
+    }
+}
+
+/**
+ * @brief C = alpha * A * B + beta * C for row-major matrices with leading dimensions.
+ *
+ * @param m: int
+ *      The number of rows of A and C.
+ * @param n: int
+ *      The number of columns of B and C.
+ * @param k: int
+ *      The number of columns of A and rows of B.
+ * @param alpha: double
+ *      The scale of the product.
+ * @param a: double[ptr]
+ *      The m x k matrix A.
+ * @param lda: int
+ *      The leading dimension of A.
+ * @param b: double[ptr]
+ *      The k x n matrix B.
+ * @param ldb: int
+ *      The leading dimension of B.
+ * @param beta: double
+ *      The scale of C before the product is added. With 0, C does not have to be initialized.
+ * @param c: double[ptr]
+ *      The m x n matrix C. Must not overlap A or B.
+ * @param ldc: int
+ *      The leading dimension of C.
+ * @param num_threads: int
+ *      The most threads to split C across. Blocks of rows are split first, and column panels only when there are fewer row blocks than threads.
+ *
+ * @return None
+ */
+static void multiply_matrices_blocked(int m, int n, int k, double alpha, const double *a, int lda, const double *b, int ldb, double beta, double *c, int ldc, int num_threads)
+{
+    if (m <= 0 || n <= 0)
+    {
+        return;
+    }
+    if (beta != 1.0)
+    {
+        for (int row = 0; row < m; row++)
+        {
+            double *c_row = &c[(int64_t)row * ldc];
+            for (int col = 0; col < n; col++)
+            {
+                c_row[col] = (beta == 0.0) ? 0.0 : (beta * c_row[col]);
+            }
+        }
+    }
+    if (k <= 0 || alpha == 0.0)
+    {
+        return;
+    }
+    int64_t work = (int64_t)m * n * k;
+    double *packed_b = (work < GEMM_MIN_PACKED_WORK) ? NULL : (double *)malloc(sizeof(double) * GEMM_KC * (GEMM_NC + GEMM_NR));
+    int num_row_blocks = (m + GEMM_MC - 1) / GEMM_MC;
+    int num_col_panels = (((n < GEMM_NC) ? n : GEMM_NC) + GEMM_NR - 1) / GEMM_NR;
+    if (work < GEMM_MIN_PARALLEL_WORK || num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    int num_row_parts = (num_row_blocks < num_threads) ? num_row_blocks : num_threads;
+    int num_col_parts = num_threads / num_row_parts;
+    if (num_col_parts > num_col_panels)
+    {
+        num_col_parts = num_col_panels;
+    }
+    int num_tasks = num_row_parts * num_col_parts;
+    double *packed_a_buffers = packed_b ? (double *)malloc(sizeof(double) * GEMM_MC * GEMM_KC * num_tasks) : NULL;
+    if (!packed_b || !packed_a_buffers)
+    {
+        // Small (or out of memory): multiply directly, a row of C at a time
+        for (int row = 0; row < m; row++)
+        {
+            double *c_row = &c[(int64_t)row * ldc];
+            const double *a_row = &a[(int64_t)row * lda];
+            for (int inner = 0; inner < k; inner++)
+            {
+                double scalar = alpha * a_row[inner];
+                const double *b_row = &b[(int64_t)inner * ldb];
+                for (int col = 0; col < n; col++)
+                {
+                    c_row[col] += scalar * b_row[col];
+                }
+            }
+        }
+        free(packed_a_buffers);
+        free(packed_b);
+        return;
+    }
+
+    struct GemmBlock block;
+    block.m = m;
+    block.alpha = alpha;
+    block.lda = lda;
+    block.ldc = ldc;
+    block.packed_b = packed_b;
+    block.packed_a_buffers = packed_a_buffers;
+    block.num_row_parts = num_row_parts;
+    block.num_col_parts = num_col_parts;
+    for (int first_col = 0; first_col < n; first_col += GEMM_NC)
+    {
+        block.n = (n - first_col < GEMM_NC) ? (n - first_col) : GEMM_NC;
+        for (int first_inner = 0; first_inner < k; first_inner += GEMM_KC)
+        {
+            block.k = (k - first_inner < GEMM_KC) ? (k - first_inner) : GEMM_KC;
+            pack_gemm_b(&b[(int64_t)first_inner * ldb + first_col], ldb, block.k, block.n, packed_b);
+            block.a = &a[first_inner];
+            block.c = &c[first_col];
+            parallel_for(num_tasks, multiply_gemm_block_part, &block);
+        }
+    }
+    free(packed_a_buffers);
+    free(packed_b);
+}
+
+#endif
@@ -0,0 +1,448 @@
+#ifndef MATRIX_STRUCTURE_C
+#define MATRIX_STRUCTURE_C
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Analysis of the structure of a matrix in a single row-major sweep, and a planner that picks the cheapest solver for that structure.
+ */
+
+/**
+ * @brief The structure profile of a matrix.
+ *
+ * @param num_rows: int
+ *      The number of rows.
+ * @param num_cols: int
+ *      The number of columns.
+ * @param num_zero_rows: int
+ *      The number of rows whose values are all within the zero tolerance.
+ * @param num_zero_cols: int
+ *      The number of columns whose values are all within the zero tolerance.
+ * @param num_nonzeros: int64_t
+ *      The number of values that are not exactly 0. Everything below this is exact as well.
+ * @param density: double
+ *      num_nonzeros over the number of values.
+ * @param lower_bandwidth: int
+ *      The furthest any nonzero value is below the diagonal (0 if the matrix is upper triangular).
+ * @param upper_bandwidth: int
+ *      The furthest any nonzero value is above the diagonal (0 if the matrix is lower triangular).
+ * @param is_symmetric: int
+ *      1 if the matrix is square and equal to its transpose.
+ * @param is_upper_triangular: int
+ *      1 if every value below the diagonal is 0.
+ * @param is_lower_triangular: int
+ *      1 if every value above the diagonal is 0.
+ * @param has_nonzero_diagonal: int
+ *      1 if no value on the diagonal is 0.
+ * @param has_positive_diagonal: int
+ *      1 if every value on the diagonal is positive.
+ * @param is_diagonally_dominant: int
+ *      1 if every diagonal value is bigger (in absolute value) than the sum of the absolute values of the rest of its row.
+ * @param is_identity: int
+ *      1 if the matrix is the identity.
+ * @param is_rref: int
+ *      1 if the matrix is already in reduced row echelon form.
+ * @param is_toeplitz: int
+ *      1 if the matrix is square and every diagonal is constant (A[i][j] only depends on i - j).
+ * @param is_circulant: int
+ *      1 if the matrix is Toeplitz and every row is the one above it rotated right by one (A[i][j] only depends on (i - j) mod n).
+ */
+struct MatrixStructure
+{
+    int num_rows;
+    int num_cols;
+    int num_zero_rows;
+    int num_zero_cols;
+    int64_t num_nonzeros;
+    double density;
+    int lower_bandwidth;
+    int upper_bandwidth;
+    int is_symmetric;
+    int is_upper_triangular;
+    int is_lower_triangular;
+    int has_nonzero_diagonal;
+    int has_positive_diagonal;
+    int is_diagonally_dominant;
+    int is_identity;
+    int is_rref;
+    int is_toeplitz;
+    int is_circulant;
+};
+
+/**
+ * @brief The solvers the planner can route a system to.
+ *
+ * @param SOLVER_PLAN_GAUSS_JORDAN: 0
+ *      The general Gauss-Jordan loop. For non-square systems, and for systems with zero rows or columns (which are singular, and which it
+ *      reports on properly).
+ * @param SOLVER_PLAN_TRIANGULAR: 1
+ *      Substitution only, for upper or lower triangular systems with a nonzero diagonal (including diagonal matrices and the identity).
+ * @param SOLVER_PLAN_BANDED_LU: 2
+ *      LU with partial pivoting that only touches the band, for systems whose bandwidths are small next to their size.
+ * @param SOLVER_PLAN_SYMMETRIC_POSITIVE_DEFINITE: 3
+ *      Symmetric elimination (half the work of LU, no pivoting), for symmetric, diagonally dominant systems with a positive diagonal, which
+ *      are positive definite.
+ * @param SOLVER_PLAN_DENSE_LU: 4
+ *      The recursive LU engine, for everything else that is square.
+ * @param SOLVER_PLAN_TOEPLITZ: 5
+ *      The Levinson recursion (O(n^2)), for Toeplitz systems that are not cheaper to solve as banded ones.
+ * @param SOLVER_PLAN_CIRCULANT: 6
+ *      Diagonalization with the FFT (O(n log n)), for circulant systems.
+ */
+enum SolverPlan
+{
+    SOLVER_PLAN_GAUSS_JORDAN = 0,
+    SOLVER_PLAN_TRIANGULAR = 1,
+    SOLVER_PLAN_BANDED_LU = 2,
+    SOLVER_PLAN_SYMMETRIC_POSITIVE_DEFINITE = 3,
+    SOLVER_PLAN_DENSE_LU = 4,
+    SOLVER_PLAN_TOEPLITZ = 5,
+    SOLVER_PLAN_CIRCULANT = 6
+};
+
+// A system is banded when its lower and upper bandwidths together are less than this fraction of its size.
+#define BANDED_MAX_BANDWIDTH_FRACTION 0.25
+// A Toeplitz system goes to the Levinson recursion unless lower_bandwidth * (lower_bandwidth + upper_bandwidth) is below this many times its size
+#define TOEPLITZ_MIN_BANDED_WORK_FRACTION 2.0
+
+/**
+ * @brief Profile the structure of a matrix in one pass over its rows. The inner loop over each row is branch-free apart from the symmetry check,
+ *        which compares the row with the matching column, and the Toeplitz check, which compares it with the row above. Each stops being made once
+ *        the matrix is known not to have that structure.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix, in a 1-D row-major format.
+ * @param num_rows: int
+ *      The number of rows.
+ * @param num_cols: int
+ *      The number of columns.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param zero_tolerance: double
+ *      Values within this of 0 count as 0 for num_zero_rows and num_zero_cols (so they agree with the rank checks).
+ * @param structure: struct MatrixStructure[ptr]
+ *      Receives the profile.
+ *
+ * @return analyzed: int
+ *      1 on success, 0 if the per-column counters could not be allocated.
+ */
+static int analyze_matrix_structure(const double *matrix, int num_rows, int num_cols, int leading_dimension, double zero_tolerance, struct MatrixStructure *structure)
+{
+    int *col_nonzeros = (int *)calloc(num_cols > 0 ? num_cols : 1, sizeof(int));
+    int *col_significant = (int *)calloc(num_cols > 0 ? num_cols : 1, sizeof(int));
+    if (!col_nonzeros || !col_significant)
+    {
+        free(col_nonzeros);
+        free(col_significant);
+        return 0;
+    }
+    int is_square = num_rows == num_cols;
+    structure->num_rows = num_rows;
+    structure->num_cols = num_cols;
+    structure->num_zero_rows = 0;
+    structure->num_zero_cols = 0;
+    structure->num_nonzeros = 0;
+    structure->lower_bandwidth = 0;
+    structure->upper_bandwidth = 0;
+    structure->is_symmetric = is_square;
+    structure->has_nonzero_diagonal = 1;
+    structure->has_positive_diagonal = 1;
+    structure->is_diagonally_dominant = is_square;
+    structure->is_identity = is_square;
+    structure->is_toeplitz = is_square;
+    structure->is_circulant = is_square;
+    // Reduced row echelon form is checked row by row: each leading value must be a 1 to the right of the previous one, and zero rows come last
+    structure->is_rref = 1;
+    int previous_leading_col = -1;
+    int seen_zero_row = 0;
+    int *leading_cols = (int *)malloc(sizeof(int) * (num_rows > 0 ? num_rows : 1));
+    if (!leading_cols)
+    {
+        free(col_nonzeros);
+        free(col_significant);
+        return 0;
+    }
+
+    for (int row = 0; row < num_rows; row++)
+    {
+        const double *row_values = &matrix[(int64_t)row * leading_dimension];
+        int row_nonzeros = 0;
+        int row_significant = 0;
+        double row_abs_sum = 0.0;
+        for (int col = 0; col < num_cols; col++)
+        {
+            double abs_value = fabs(row_values[col]);
+            int is_nonzero = row_values[col] != 0.0;
+            int is_significant = abs_value > zero_tolerance;
+            row_nonzeros += is_nonzero;
+            row_significant |= is_significant;
+            col_nonzeros[col] += is_nonzero;
+            col_significant[col] |= is_significant;
+            row_abs_sum += abs_value;
+        }
+        structure->num_nonzeros += row_nonzeros;
+        structure->num_zero_rows += !row_significant;
+
+        int first_nonzero_col = 0;
+        while (first_nonzero_col < num_cols && row_values[first_nonzero_col] == 0.0)
+        {
+            first_nonzero_col++;
+        }
+        int last_nonzero_col = num_cols - 1;
+        while (last_nonzero_col > first_nonzero_col && row_values[last_nonzero_col] == 0.0)
+        {
+            last_nonzero_col--;
+        }
+        leading_cols[row] = first_nonzero_col;
+        if (row_nonzeros > 0)
+        {
+            if (row - first_nonzero_col > structure->lower_bandwidth)
+            {
+                structure->lower_bandwidth = row - first_nonzero_col;
+            }
+            if (last_nonzero_col - row > structure->upper_bandwidth)
+            {
+                structure->upper_bandwidth = last_nonzero_col - row;
+            }
+            if (seen_zero_row || first_nonzero_col <= previous_leading_col || row_values[first_nonzero_col] != 1.0)
+            {
+                structure->is_rref = 0;
+            }
+            previous_leading_col = first_nonzero_col;
+        }
+        else
+        {
+            seen_zero_row = 1;
+        }
+
+        if (row < num_cols)
+        {
+            double diagonal_value = row_values[row];
+            structure->has_nonzero_diagonal &= diagonal_value != 0.0;
+            structure->has_positive_diagonal &= diagonal_value > 0.0;
+            structure->is_diagonally_dominant &= fabs(diagonal_value) > (row_abs_sum - fabs(diagonal_value));
+            structure->is_identity &= (diagonal_value == 1.0) && (row_nonzeros == 1);
+        }
+        if (structure->is_toeplitz && row > 0)
+        {
+            // Every value must match the one up and to the left of it, and for a circulant matrix the first must match the end of the row above
+            const double *previous_row = row_values - leading_dimension;
+            for (int col = 1; col < num_cols; col++)
+            {
+                if (row_values[col] != previous_row[col - 1])
+                {
+                    structure->is_toeplitz = 0;
+                    break;
+                }
+            }
+            structure->is_circulant &= row_values[0] == previous_row[num_cols - 1];
+        }
+        if (structure->is_symmetric)
+        {
+            for (int col = 0; col < row; col++)
+            {
+                if (row_values[col] != matrix[(int64_t)col * leading_dimension + row])
+                {
+                    structure->is_symmetric = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int col = 0; col < num_cols; col++)
+    {
+        structure->num_zero_cols += !col_significant[col];
+    }
+    // The column of every leading 1 must be 0 everywhere else
+    for (int row = 0; row < num_rows && structure->is_rref; row++)
+    {
+        if (leading_cols[row] < num_cols && col_nonzeros[leading_cols[row]] != 1)
+        {
+            structure->is_rref = 0;
+        }
+    }
+    if (num_rows > num_cols)
+    {
+        structure->has_nonzero_diagonal = 0;
+        structure->has_positive_diagonal = 0;
+    }
+    structure->is_circulant &= structure->is_toeplitz;
+    structure->is_upper_triangular = structure->lower_bandwidth == 0;
+    structure->is_lower_triangular = structure->upper_bandwidth == 0;
+    structure->density = (num_rows > 0 && num_cols > 0) ? ((double)structure->num_nonzeros / ((double)num_rows * num_cols)) : 0.0;
+    free(leading_cols);
+    free(col_significant);
+    free(col_nonzeros);
+    return 1;
+}
+
+/**
+ * @brief Pick the cheapest solver that suits a structure profile (see enum SolverPlan).
+ *
+ * @param structure: struct MatrixStructure[ptr]
+ *      The profile of the matrix A of Ax = B.
+ *
+ * @return plan: int
+ *      One of the SOLVER_PLAN_* values.
+ */
+static int choose_solver_plan(const struct MatrixStructure *structure)
+{
+    if (structure->num_rows != structure->num_cols || structure->num_rows < 1 || structure->num_zero_rows > 0 || structure->num_zero_cols > 0)
+    {
+        return SOLVER_PLAN_GAUSS_JORDAN;
+    }
+    if ((structure->is_upper_triangular || structure->is_lower_triangular) && structure->has_nonzero_diagonal)
+    {
+        return SOLVER_PLAN_TRIANGULAR;
+    }
+    if (structure->is_circulant)
+    {
+        return SOLVER_PLAN_CIRCULANT;
+    }
+    // Banded LU takes about n * kl * (kl + ku) steps to the Levinson recursion's n^2, so narrow Toeplitz bands stay with the banded plan
+    if (structure->is_toeplitz && (double)structure->lower_bandwidth * (structure->lower_bandwidth + structure->upper_bandwidth) >= TOEPLITZ_MIN_BANDED_WORK_FRACTION * structure->num_rows)
+    {
+        return SOLVER_PLAN_TOEPLITZ;
+    }
+    // A square matrix in reduced row echelon form with no zero rows is the identity, so the triangular plan has taken it by now
+    if (structure->is_symmetric && structure->has_positive_diagonal && structure->is_diagonally_dominant)
+    {
+        return SOLVER_PLAN_SYMMETRIC_POSITIVE_DEFINITE;
+    }
+    if ((double)(structure->lower_bandwidth + structure->upper_bandwidth) < BANDED_MAX_BANDWIDTH_FRACTION * structure->num_rows)
+    {
+        return SOLVER_PLAN_BANDED_LU;
+    }
+    return SOLVER_PLAN_DENSE_LU;
+}
+
+/**
+ * @brief Find the root of a node of a union-find forest, halving the path to it on the way.
+ *
+ * @param parents: int[ptr]
+ *      The parent of every node. Roots are their own parent.
+ * @param node: int
+ *      The node whose root to find.
+ *
+ * @return root: int
+ *      The root of the node's tree.
+ */
+static inline int find_block_root(int *parents, int node)
+{
+    while (parents[node] != node)
+    {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    return node;
+}
+
+/**
+ * @brief Split a matrix into independent diagonal blocks: the connected components of the graph that links row i to column j whenever A[i][j] is
+ *        not 0. Permuting the rows and columns of every block together gives a block-diagonal matrix, so each block is a system of its own.
+ *        Blocks are numbered in the order of their first row, so the numbering is the same from run to run.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix, in a 1-D row-major format.
+ * @param num_rows: int
+ *      The number of rows.
+ * @param num_cols: int
+ *      The number of columns.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows.
+ * @param row_blocks: int[ptr]
+ *      Receives the block of every row, or -1 for rows that are all 0. Must hold num_rows values.
+ * @param col_blocks: int[ptr]
+ *      Receives the block of every column, or -1 for columns that are all 0. Must hold num_cols values.
+ *
+ * @return num_blocks: int
+ *      The number of blocks (each has at least one row and one column), or -1 if the union-find forest could not be allocated.
+ */
+static int find_diagonal_blocks(const double *matrix, int num_rows, int num_cols, int leading_dimension, int *row_blocks, int *col_blocks)
+{
+    // Rows are nodes 0 to num_rows - 1, and columns follow them
+    int *parents = (int *)malloc(sizeof(int) * ((num_rows + num_cols) > 0 ? (num_rows + num_cols) : 1));
+    int *root_blocks = (int *)malloc(sizeof(int) * ((num_rows + num_cols) > 0 ? (num_rows + num_cols) : 1));
+    if (!parents || !root_blocks)
+    {
+        free(parents);
+        free(root_blocks);
+        return -1;
+    }
+    for (int node = 0; node < num_rows + num_cols; node++)
+    {
+        parents[node] = node;
+        root_blocks[node] = -1;
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        const double *row_values = &matrix[(int64_t)row * leading_dimension];
+        int row_root = find_block_root(parents, row);
+        for (int col = 0; col < num_cols; col++)
+        {
+            if (row_values[col] != 0.0)
+            {
+                int col_root = find_block_root(parents, num_rows + col);
+                if (col_root != row_root)
+                {
+                    // Keeping the smaller node as the root keeps a row at the root of every block that has one
+                    if (col_root < row_root)
+                    {
+                        parents[row_root] = col_root;
+                        row_root = col_root;
+                    }
+                    else
+                    {
+                        parents[col_root] = row_root;
+                    }
+                }
+            }
+        }
+    }
+
+    int num_blocks = 0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        row_blocks[row] = -1;
+    }
+    for (int col = 0; col < num_cols; col++)
+    {
+        int root = find_block_root(parents, num_rows + col);
+        if (root >= num_rows)
+        {
+            // A column with no nonzero values is still its own root
+            col_blocks[col] = -1;
+            continue;
+        }
+        row_blocks[root] = 0;
+        col_blocks[col] = root;
+    }
+    // Number the blocks by their first row. Only rows that share a block with some column were marked above.
+    for (int row = 0; row < num_rows; row++)
+    {
+        int root = find_block_root(parents, row);
+        if (root == row && row_blocks[row] == -1)
+        {
+            continue;
+        }
+        if (root_blocks[root] == -1)
+        {
+            root_blocks[root] = num_blocks++;
+        }
+        row_blocks[row] = root_blocks[root];
+    }
+    for (int col = 0; col < num_cols; col++)
+    {
+        if (col_blocks[col] != -1)
+        {
+            col_blocks[col] = root_blocks[col_blocks[col]];
+        }
+    }
+    free(root_blocks);
+    free(parents);
+    return num_blocks;
+}
+
+#endif
\ No newline at end of file
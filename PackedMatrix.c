@@ -0,0 +1,309 @@
+#ifndef PACKED_MATRIX_C
+#define PACKED_MATRIX_C
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ThreadPool.c"
+#include "TypedKernels.c"
+
+/**
+ * Kernels for triangular and symmetric matrices in packed storage, where only one triangle is kept, row after row, so an n x n matrix takes
+ * n * (n + 1) / 2 values instead of n * n. Upper packing stores each row from the diagonal to the end (row i holds n - i values), and lower
+ * packing stores each row from the start to the diagonal (row i holds i + 1 values). These are numpy's A[np.triu_indices(n)] and
+ * A[np.tril_indices(n)], and are LAPACK's lower and upper packed formats read column-major.
+ *
+ * Every row of a triangle is consecutive in both packings, so the kernels work on the packed values directly: substitution and elimination run
+ * the same contiguous (SIMD) row updates they would on a full matrix, over half the bytes. A symmetric matrix is eliminated in upper packing,
+ * where the pivot row of each step is consecutive too; a lower one is repacked while it is copied for the elimination.
+ */
+
+// Packed elimination steps that update fewer values than this run on the calling thread.
+#define PACKED_MIN_PARALLEL_WORK 32768
+// How many pivots of the packed symmetric elimination are applied to a row at once. Their rows (at most 32 * n values) stay in cache.
+#define PACKED_PANEL_SIZE 32
+
+/**
+ * @brief The number of values in a packed triangle of the given size.
+ */
+static inline int64_t get_packed_size(int size)
+{
+    return ((int64_t)size * (size + 1)) / 2;
+}
+
+/**
+ * @brief Where a row starts in a packed triangle. Value (row, col) is at this plus col - row when upper packed, and plus col when lower packed.
+ *
+ * @param row: int
+ *      The row.
+ * @param size: int
+ *      The number of rows (and columns) of the matrix.
+ * @param is_upper: int
+ *      1 for upper packing, 0 for lower packing.
+ *
+ * @return offset: int64_t
+ *      The index of the first stored value of the row.
+ */
+static inline int64_t get_packed_row_offset(int row, int size, int is_upper)
+{
+    if (is_upper)
+    {
+        return (int64_t)row * size - ((int64_t)row * (row - 1)) / 2;
+    }
+    return ((int64_t)row * (row + 1)) / 2;
+}
+
+/**
+ * @brief Expand a packed triangle into a full matrix with any strides.
+ *
+ * @param packed: double[ptr]
+ *      The packed triangle.
+ * @param size: int
+ *      The number of rows (and columns) of the matrix.
+ * @param is_upper: int
+ *      1 if packed holds the upper triangle, 0 if it holds the lower one.
+ * @param is_symmetric: int
+ *      1 to mirror the triangle into the other half, 0 to fill the other half with zeros.
+ * @param matrix: double[ptr]
+ *      Receives the full matrix.
+ * @param row_stride: int
+ *      The distance between the starts of two rows of matrix.
+ * @param col_stride: int
+ *      The distance between two neighbouring values of a row of matrix.
+ *
+ * @return None
+ */
+static void unpack_packed_matrix(const double *packed, int size, int is_upper, int is_symmetric, double *matrix, int row_stride, int col_stride)
+{
+    for (int row = 0; row < size; row++)
+    {
+        const double *packed_row = &packed[get_packed_row_offset(row, size, is_upper)];
+        int first_col = is_upper ? row : 0;
+        int end_col = is_upper ? size : row + 1;
+        double *matrix_row = &matrix[(int64_t)row * row_stride];
+        // A symmetric matrix's other half is all mirrored values; a triangle's is zeros
+        for (int col = 0; col < size && !is_symmetric; col++)
+        {
+            if (col < first_col || col >= end_col)
+            {
+                matrix_row[(int64_t)col * col_stride] = 0.0;
+            }
+        }
+        for (int col = first_col; col < end_col; col++)
+        {
+            double value = packed_row[col - first_col];
+            matrix_row[(int64_t)col * col_stride] = value;
+            if (is_symmetric)
+            {
+                matrix[(int64_t)col * row_stride + (int64_t)row * col_stride] = value;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solve T * X = B in place by substitution, where T is a packed triangle: back substitution for an upper one, forward substitution for
+ *        a lower one. Each row of T is subtracted from with one SIMD row update per value of the triangle.
+ *
+ * @param packed: double[ptr]
+ *      The packed triangle. Its diagonal must not hold a 0.
+ * @param size: int
+ *      The number of rows (and columns) of T.
+ * @param is_upper: int
+ *      1 if packed holds an upper triangle, 0 if it holds a lower one.
+ * @param rhs: double[ptr]
+ *      B on entry and X on return, row after row.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides (columns of rhs).
+ *
+ * @return None
+ */
+static void solve_packed_triangular(const double *packed, int size, int is_upper, double *rhs, int rhs_leading_dimension, int num_rhs)
+{
+    for (int step = 0; step < size; step++)
+    {
+        int row = is_upper ? (size - 1 - step) : step;
+        const double *packed_row = &packed[get_packed_row_offset(row, size, is_upper)];
+        double *solution_row = &rhs[(int64_t)row * rhs_leading_dimension];
+        // The solved rows are the ones after row (upper) or before it (lower)
+        int first_col = is_upper ? row + 1 : 0;
+        int end_col = is_upper ? size : row;
+        int diagonal_index = is_upper ? 0 : row;
+        for (int col = first_col; col < end_col; col++)
+        {
+            double value = packed_row[is_upper ? col - row : col];
+            if (value != 0.0)
+            {
+                subtract_scaled_row_float64(solution_row, &rhs[(int64_t)col * rhs_leading_dimension], num_rhs, value, 0.0);
+            }
+        }
+        double reciprocal = 1.0 / packed_row[diagonal_index];
+        for (int col = 0; col < num_rhs; col++)
+        {
+            solution_row[col] *= reciprocal;
+        }
+    }
+}
+
+/**
+ * @brief Copy a packed symmetric matrix into upper packing, which is what solve_packed_symmetric_positive_definite factors. A lower triangle's row i
+ *        is column i of the upper one, so it is scattered down that column.
+ *
+ * @param packed: double[ptr]
+ *      The packed triangle.
+ * @param size: int
+ *      The number of rows (and columns) of the matrix.
+ * @param is_upper: int
+ *      1 if packed holds the upper triangle, 0 if it holds the lower one.
+ * @param upper: double[ptr]
+ *      Receives the upper triangle, get_packed_size(size) values. Must not overlap packed.
+ *
+ * @return None
+ */
+static void copy_packed_symmetric_to_upper(const double *packed, int size, int is_upper, double *upper)
+{
+    if (is_upper)
+    {
+        memcpy(upper, packed, sizeof(double) * get_packed_size(size));
+        return;
+    }
+    for (int row = 0; row < size; row++)
+    {
+        const double *packed_row = &packed[get_packed_row_offset(row, size, 0)];
+        for (int col = 0; col <= row; col++)
+        {
+            upper[get_packed_row_offset(col, size, 1) + (row - col)] = packed_row[col];
+        }
+    }
+}
+
+/**
+ * @brief One panel of the packed symmetric elimination: subtract the pivots of an already eliminated panel from the rows below it.
+ *
+ * @param packed: double[ptr]
+ *      The upper triangle being factored.
+ * @param size: int
+ *      The number of rows (and columns) of the matrix.
+ * @param panel_start: int
+ *      The first pivot row of the panel.
+ * @param panel_end: int
+ *      One past its last pivot row. The rows below it are the ones updated.
+ * @param rhs: double[ptr]
+ *      The right-hand sides, carried through the elimination.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param num_tasks: int
+ *      The number of parts the rows below the panel are dealt into, cyclically, so each part gets long and short rows alike.
+ */
+struct PackedSymmetricStep
+{
+    double *packed;
+    int size;
+    int panel_start;
+    int panel_end;
+    double *rhs;
+    int rhs_leading_dimension;
+    int num_rhs;
+    int num_tasks;
+};
+
+/**
+ * @brief Eliminate the pivots k of a panel from every num_tasks-th row i below it. By symmetry the multiplier of row i is U[k][i] / U[k][k], from
+ *        the pivot row itself, so the whole panel is applied to row i while it is in cache, and the triangle is read once per panel instead of
+ *        once per pivot.
+ */
+static void eliminate_packed_symmetric_rows(void *context, int task_index)
+{
+    struct PackedSymmetricStep *step = (struct PackedSymmetricStep *)context;
+    for (int row = step->panel_end + task_index; row < step->size; row += step->num_tasks)
+    {
+        double *packed_row = &step->packed[get_packed_row_offset(row, step->size, 1)];
+        for (int pivot = step->panel_start; pivot < step->panel_end; pivot++)
+        {
+            const double *pivot_row = &step->packed[get_packed_row_offset(pivot, step->size, 1)];
+            double multiplier = pivot_row[row - pivot] / pivot_row[0];
+            if (multiplier == 0.0)
+            {
+                continue;
+            }
+            subtract_scaled_row_float64(packed_row, &pivot_row[row - pivot], step->size - row, multiplier, 0.0);
+            if (step->num_rhs > 0)
+            {
+                subtract_scaled_row_float64(&step->rhs[(int64_t)row * step->rhs_leading_dimension], &step->rhs[(int64_t)pivot * step->rhs_leading_dimension], step->num_rhs, multiplier, 0.0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solve A * X = B for a symmetric positive definite A stored as its packed upper triangle, eliminating in place without pivoting (the
+ *        packed counterpart of factor_symmetric_positive_definite). Each pivot's elimination touches one triangle only, half the work of LU.
+ *        The pivots are taken PACKED_PANEL_SIZE at a time: a panel is eliminated within itself, and then from the rows below it, which are
+ *        split across threads. On return the triangle holds U = D * transpose(L) and the right-hand sides inverse(L) * B, and X follows by back
+ *        substitution.
+ *
+ * @param packed: double[ptr]
+ *      The upper triangle of A on entry (see copy_packed_symmetric_to_upper), and U on return.
+ * @param size: int
+ *      The number of rows (and columns) of A.
+ * @param rhs: double[ptr]
+ *      B on entry and X on return, row after row. May be NULL when num_rhs is 0, to only factor A.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param determinant: double[ptr]
+ *      Receives the determinant of A, the product of the pivots.
+ * @param num_threads: int
+ *      The most threads to use.
+ *
+ * @return is_positive_definite: int
+ *      1 if every pivot was positive and X was found. 0 otherwise; packed and rhs are then undefined.
+ */
+static int solve_packed_symmetric_positive_definite(double *packed, int size, double *rhs, int rhs_leading_dimension, int num_rhs, double *determinant, int num_threads)
+{
+    struct PackedSymmetricStep step = {packed, size, 0, 0, rhs, rhs_leading_dimension, num_rhs, 1};
+    *determinant = 1.0;
+    for (int panel_start = 0; panel_start < size; panel_start += PACKED_PANEL_SIZE)
+    {
+        int panel_end = (panel_start + PACKED_PANEL_SIZE < size) ? panel_start + PACKED_PANEL_SIZE : size;
+        for (int pivot = panel_start; pivot < panel_end; pivot++)
+        {
+            const double *pivot_row = &packed[get_packed_row_offset(pivot, size, 1)];
+            if (!(pivot_row[0] > 0.0))
+            {
+                return 0;
+            }
+            *determinant *= pivot_row[0];
+            for (int row = pivot + 1; row < panel_end; row++)
+            {
+                double multiplier = pivot_row[row - pivot] / pivot_row[0];
+                subtract_scaled_row_float64(&packed[get_packed_row_offset(row, size, 1)], &pivot_row[row - pivot], size - row, multiplier, 0.0);
+                if (num_rhs > 0)
+                {
+                    subtract_scaled_row_float64(&rhs[(int64_t)row * rhs_leading_dimension], &rhs[(int64_t)pivot * rhs_leading_dimension], num_rhs, multiplier, 0.0);
+                }
+            }
+        }
+        int num_rows_below = size - panel_end;
+        int64_t work = (int64_t)num_rows_below * (panel_end - panel_start) * (num_rows_below + 2 * num_rhs) / 2;
+        step.panel_start = panel_start;
+        step.panel_end = panel_end;
+        step.num_tasks = (work >= PACKED_MIN_PARALLEL_WORK && num_threads > 1) ? ((num_threads < num_rows_below) ? num_threads : num_rows_below) : 1;
+        if (num_rows_below > 0)
+        {
+            parallel_for(step.num_tasks, eliminate_packed_symmetric_rows, &step);
+        }
+    }
+    if (num_rhs > 0)
+    {
+        solve_packed_triangular(packed, size, 1, rhs, rhs_leading_dimension, num_rhs);
+    }
+    return 1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,395 @@
+#ifndef SMALL_MATRIX_C
+#define SMALL_MATRIX_C
+#include <stdint.h>
+#include <stdlib.h>
+#include "ThreadPool.c"
+
+/**
+ * Closed-form inverses and determinants of batches of 2x2, 3x3 and 4x4 matrices (adjugate over determinant), without pivoting, allocation or logging.
+ *
+ * The matrices are handled SMALL_MATRIX_LANES at a time: each group is transposed so that one vector holds the same value of every matrix in the
+ * group, and the cofactor formulas (written once, in terms of the SMALL_MATRIX_* vector macros) then work on all of them at once. The macros map
+ * to AVX, SSE2 or plain doubles, whichever the compiler targets.
+ */
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SMALL_MATRIX_LANES 4
+typedef __m256d SmallMatrixVector;
+#define SMALL_MATRIX_LOAD(pointer) _mm256_loadu_pd(pointer)
+#define SMALL_MATRIX_STORE(pointer, value) _mm256_storeu_pd((pointer), (value))
+#define SMALL_MATRIX_SET1(value) _mm256_set1_pd(value)
+#define SMALL_MATRIX_ADD(a, b) _mm256_add_pd((a), (b))
+#define SMALL_MATRIX_SUB(a, b) _mm256_sub_pd((a), (b))
+#define SMALL_MATRIX_MUL(a, b) _mm256_mul_pd((a), (b))
+#define SMALL_MATRIX_DIV(a, b) _mm256_div_pd((a), (b))
+#define SMALL_MATRIX_MAX(a, b) _mm256_max_pd((a), (b))
+#define SMALL_MATRIX_ABS(a) _mm256_andnot_pd(_mm256_set1_pd(-0.0), (a))
+#define SMALL_MATRIX_LESS_EQUAL(a, b) _mm256_cmp_pd((a), (b), _CMP_LE_OQ)
+#define SMALL_MATRIX_ZERO_WHERE(mask, value) _mm256_andnot_pd((mask), (value))
+#define SMALL_MATRIX_MASK_BITS(mask) _mm256_movemask_pd(mask)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SMALL_MATRIX_LANES 2
+typedef __m128d SmallMatrixVector;
+#define SMALL_MATRIX_LOAD(pointer) _mm_loadu_pd(pointer)
+#define SMALL_MATRIX_STORE(pointer, value) _mm_storeu_pd((pointer), (value))
+#define SMALL_MATRIX_SET1(value) _mm_set1_pd(value)
+#define SMALL_MATRIX_ADD(a, b) _mm_add_pd((a), (b))
+#define SMALL_MATRIX_SUB(a, b) _mm_sub_pd((a), (b))
+#define SMALL_MATRIX_MUL(a, b) _mm_mul_pd((a), (b))
+#define SMALL_MATRIX_DIV(a, b) _mm_div_pd((a), (b))
+#define SMALL_MATRIX_MAX(a, b) _mm_max_pd((a), (b))
+#define SMALL_MATRIX_ABS(a) _mm_andnot_pd(_mm_set1_pd(-0.0), (a))
+#define SMALL_MATRIX_LESS_EQUAL(a, b) _mm_cmple_pd((a), (b))
+#define SMALL_MATRIX_ZERO_WHERE(mask, value) _mm_andnot_pd((mask), (value))
+#define SMALL_MATRIX_MASK_BITS(mask) _mm_movemask_pd(mask)
+#else
+#include <math.h>
+#define SMALL_MATRIX_LANES 1
+// Without SIMD a "vector" is one double, and a mask is 1.0 (set) or 0.0
+typedef double SmallMatrixVector;
+#define SMALL_MATRIX_LOAD(pointer) (*(pointer))
+#define SMALL_MATRIX_STORE(pointer, value) (*(pointer) = (value))
+#define SMALL_MATRIX_SET1(value) (value)
+#define SMALL_MATRIX_ADD(a, b) ((a) + (b))
+#define SMALL_MATRIX_SUB(a, b) ((a) - (b))
+#define SMALL_MATRIX_MUL(a, b) ((a) * (b))
+#define SMALL_MATRIX_DIV(a, b) ((a) / (b))
+#define SMALL_MATRIX_MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define SMALL_MATRIX_ABS(a) fabs(a)
+#define SMALL_MATRIX_LESS_EQUAL(a, b) (((a) <= (b)) ? 1.0 : 0.0)
+#define SMALL_MATRIX_ZERO_WHERE(mask, value) (((mask) != 0.0) ? 0.0 : (value))
+#define SMALL_MATRIX_MASK_BITS(mask) ((mask) != 0.0)
+#endif
+
+// A matrix is singular when |det| is at most this times (its largest absolute value)^n, which does not change when the matrix is scaled
+#define SMALL_MATRIX_SINGULAR_TOLERANCE 1e-12
+// Batches are split across threads in tasks of at least this many matrices
+#define SMALL_MATRIX_MIN_MATRICES_PER_TASK 4096
+
+// a*b - c*d on vectors, the building block of every cofactor
+#define SMALL_MATRIX_CROSS(a, b, c, d) SMALL_MATRIX_SUB(SMALL_MATRIX_MUL((a), (b)), SMALL_MATRIX_MUL((c), (d)))
+
+/**
+ * @brief The inverse of a group of matrices, one of invert_2x2_lanes, invert_3x3_lanes or invert_4x4_lanes. Value k of lane l is at
+ *        values[k * SMALL_MATRIX_LANES + l], for the input and the inverse alike.
+ *
+ * @param values: double[ptr]
+ *      The matrices of the group, transposed into lanes.
+ * @param inverses: double[ptr]
+ *      Receives their inverses, in the same layout. Singular matrices get all zeros.
+ * @param determinants: double[ptr]
+ *      Receives their determinants, one per lane.
+ *
+ * @return singular_bits: int
+ *      Bit l is set if the matrix in lane l is singular.
+ */
+typedef int (*SmallMatrixLaneKernel)(const double *values, double *inverses, double *determinants);
+
+/**
+ * @brief Load value k of every matrix of the group.
+ */
+#define SMALL_MATRIX_VALUE(values, k) SMALL_MATRIX_LOAD(&(values)[(k) * SMALL_MATRIX_LANES])
+
+/**
+ * @brief Find which matrices of the group are singular, and the factor to scale their adjugates by (1 / det, or 0 if singular).
+ *
+ * @param values: double[ptr]
+ *      The matrices of the group, transposed into lanes.
+ * @param size: int
+ *      The number of rows (and columns) of the matrices.
+ * @param determinant: SmallMatrixVector
+ *      Their determinants.
+ * @param inverse_determinant: SmallMatrixVector[ptr]
+ *      Receives the factor to scale their adjugates by.
+ *
+ * @return singular_bits: int
+ *      Bit l is set if the matrix in lane l is singular.
+ */
+static inline int find_singular_lanes(const double *values, int size, SmallMatrixVector determinant, SmallMatrixVector *inverse_determinant)
+{
+    SmallMatrixVector largest = SMALL_MATRIX_SET1(0.0);
+    for (int value = 0; value < size * size; value++)
+    {
+        largest = SMALL_MATRIX_MAX(largest, SMALL_MATRIX_ABS(SMALL_MATRIX_VALUE(values, value)));
+    }
+    SmallMatrixVector limit = SMALL_MATRIX_SET1(SMALL_MATRIX_SINGULAR_TOLERANCE);
+    for (int power = 0; power < size; power++)
+    {
+        limit = SMALL_MATRIX_MUL(limit, largest);
+    }
+    SmallMatrixVector is_singular = SMALL_MATRIX_LESS_EQUAL(SMALL_MATRIX_ABS(determinant), limit);
+    // 1 / 0 is infinite, but it is zeroed before it is used
+    *inverse_determinant = SMALL_MATRIX_ZERO_WHERE(is_singular, SMALL_MATRIX_DIV(SMALL_MATRIX_SET1(1.0), determinant));
+    return SMALL_MATRIX_MASK_BITS(is_singular);
+}
+
+/**
+ * @brief Invert a group of 2x2 matrices: inverse([a b; c d]) = [d -b; -c a] / (ad - bc).
+ */
+static int invert_2x2_lanes(const double *values, double *inverses, double *determinants)
+{
+    SmallMatrixVector a00 = SMALL_MATRIX_VALUE(values, 0);
+    SmallMatrixVector a01 = SMALL_MATRIX_VALUE(values, 1);
+    SmallMatrixVector a10 = SMALL_MATRIX_VALUE(values, 2);
+    SmallMatrixVector a11 = SMALL_MATRIX_VALUE(values, 3);
+    SmallMatrixVector determinant = SMALL_MATRIX_CROSS(a00, a11, a01, a10);
+    SmallMatrixVector scale;
+    int singular_bits = find_singular_lanes(values, 2, determinant, &scale);
+    SmallMatrixVector negative_scale = SMALL_MATRIX_SUB(SMALL_MATRIX_SET1(0.0), scale);
+    SMALL_MATRIX_STORE(&inverses[0 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(a11, scale));
+    SMALL_MATRIX_STORE(&inverses[1 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(a01, negative_scale));
+    SMALL_MATRIX_STORE(&inverses[2 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(a10, negative_scale));
+    SMALL_MATRIX_STORE(&inverses[3 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(a00, scale));
+    SMALL_MATRIX_STORE(determinants, determinant);
+    return singular_bits;
+}
+
+/**
+ * @brief Invert a group of 3x3 matrices. The first row of cofactors gives the determinant (expanding along the first row), and the inverse is the
+ *        transposed matrix of cofactors (the adjugate) over the determinant.
+ */
+static int invert_3x3_lanes(const double *values, double *inverses, double *determinants)
+{
+    SmallMatrixVector a00 = SMALL_MATRIX_VALUE(values, 0);
+    SmallMatrixVector a01 = SMALL_MATRIX_VALUE(values, 1);
+    SmallMatrixVector a02 = SMALL_MATRIX_VALUE(values, 2);
+    SmallMatrixVector a10 = SMALL_MATRIX_VALUE(values, 3);
+    SmallMatrixVector a11 = SMALL_MATRIX_VALUE(values, 4);
+    SmallMatrixVector a12 = SMALL_MATRIX_VALUE(values, 5);
+    SmallMatrixVector a20 = SMALL_MATRIX_VALUE(values, 6);
+    SmallMatrixVector a21 = SMALL_MATRIX_VALUE(values, 7);
+    SmallMatrixVector a22 = SMALL_MATRIX_VALUE(values, 8);
+    SmallMatrixVector cofactor00 = SMALL_MATRIX_CROSS(a11, a22, a12, a21);
+    SmallMatrixVector cofactor01 = SMALL_MATRIX_CROSS(a12, a20, a10, a22);
+    SmallMatrixVector cofactor02 = SMALL_MATRIX_CROSS(a10, a21, a11, a20);
+    SmallMatrixVector determinant = SMALL_MATRIX_ADD(SMALL_MATRIX_ADD(SMALL_MATRIX_MUL(a00, cofactor00), SMALL_MATRIX_MUL(a01, cofactor01)), SMALL_MATRIX_MUL(a02, cofactor02));
+    SmallMatrixVector scale;
+    int singular_bits = find_singular_lanes(values, 3, determinant, &scale);
+    SMALL_MATRIX_STORE(&inverses[0 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(cofactor00, scale));
+    SMALL_MATRIX_STORE(&inverses[1 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a02, a21, a01, a22), scale));
+    SMALL_MATRIX_STORE(&inverses[2 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a01, a12, a02, a11), scale));
+    SMALL_MATRIX_STORE(&inverses[3 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(cofactor01, scale));
+    SMALL_MATRIX_STORE(&inverses[4 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a00, a22, a02, a20), scale));
+    SMALL_MATRIX_STORE(&inverses[5 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a02, a10, a00, a12), scale));
+    SMALL_MATRIX_STORE(&inverses[6 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(cofactor02, scale));
+    SMALL_MATRIX_STORE(&inverses[7 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a01, a20, a00, a21), scale));
+    SMALL_MATRIX_STORE(&inverses[8 * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_CROSS(a00, a11, a01, a10), scale));
+    SMALL_MATRIX_STORE(determinants, determinant);
+    return singular_bits;
+}
+
+/**
+ * @brief Invert a group of 4x4 matrices with the Laplace expansion along the top two rows: the six 2x2 determinants of the top two rows
+ *        (top_minor*) times the complementary six of the bottom two rows (bottom_minor*) give the determinant, and every cofactor is a row of
+ *        the matrix against three of them.
+ */
+static int invert_4x4_lanes(const double *values, double *inverses, double *determinants)
+{
+    SmallMatrixVector a00 = SMALL_MATRIX_VALUE(values, 0);
+    SmallMatrixVector a01 = SMALL_MATRIX_VALUE(values, 1);
+    SmallMatrixVector a02 = SMALL_MATRIX_VALUE(values, 2);
+    SmallMatrixVector a03 = SMALL_MATRIX_VALUE(values, 3);
+    SmallMatrixVector a10 = SMALL_MATRIX_VALUE(values, 4);
+    SmallMatrixVector a11 = SMALL_MATRIX_VALUE(values, 5);
+    SmallMatrixVector a12 = SMALL_MATRIX_VALUE(values, 6);
+    SmallMatrixVector a13 = SMALL_MATRIX_VALUE(values, 7);
+    SmallMatrixVector a20 = SMALL_MATRIX_VALUE(values, 8);
+    SmallMatrixVector a21 = SMALL_MATRIX_VALUE(values, 9);
+    SmallMatrixVector a22 = SMALL_MATRIX_VALUE(values, 10);
+    SmallMatrixVector a23 = SMALL_MATRIX_VALUE(values, 11);
+    SmallMatrixVector a30 = SMALL_MATRIX_VALUE(values, 12);
+    SmallMatrixVector a31 = SMALL_MATRIX_VALUE(values, 13);
+    SmallMatrixVector a32 = SMALL_MATRIX_VALUE(values, 14);
+    SmallMatrixVector a33 = SMALL_MATRIX_VALUE(values, 15);
+    // The 2x2 determinants of columns (i, j) of the top two rows, and of the bottom two
+    SmallMatrixVector top_minor01 = SMALL_MATRIX_CROSS(a00, a11, a10, a01);
+    SmallMatrixVector top_minor02 = SMALL_MATRIX_CROSS(a00, a12, a10, a02);
+    SmallMatrixVector top_minor03 = SMALL_MATRIX_CROSS(a00, a13, a10, a03);
+    SmallMatrixVector top_minor12 = SMALL_MATRIX_CROSS(a01, a12, a11, a02);
+    SmallMatrixVector top_minor13 = SMALL_MATRIX_CROSS(a01, a13, a11, a03);
+    SmallMatrixVector top_minor23 = SMALL_MATRIX_CROSS(a02, a13, a12, a03);
+    SmallMatrixVector bottom_minor01 = SMALL_MATRIX_CROSS(a20, a31, a30, a21);
+    SmallMatrixVector bottom_minor02 = SMALL_MATRIX_CROSS(a20, a32, a30, a22);
+    SmallMatrixVector bottom_minor03 = SMALL_MATRIX_CROSS(a20, a33, a30, a23);
+    SmallMatrixVector bottom_minor12 = SMALL_MATRIX_CROSS(a21, a32, a31, a22);
+    SmallMatrixVector bottom_minor13 = SMALL_MATRIX_CROSS(a21, a33, a31, a23);
+    SmallMatrixVector bottom_minor23 = SMALL_MATRIX_CROSS(a22, a33, a32, a23);
+    SmallMatrixVector determinant = SMALL_MATRIX_ADD(SMALL_MATRIX_SUB(SMALL_MATRIX_MUL(top_minor01, bottom_minor23), SMALL_MATRIX_MUL(top_minor02, bottom_minor13)),
+                                                     SMALL_MATRIX_ADD(SMALL_MATRIX_MUL(top_minor03, bottom_minor12), SMALL_MATRIX_MUL(top_minor12, bottom_minor03)));
+    determinant = SMALL_MATRIX_ADD(determinant, SMALL_MATRIX_SUB(SMALL_MATRIX_MUL(top_minor23, bottom_minor01), SMALL_MATRIX_MUL(top_minor13, bottom_minor02)));
+    SmallMatrixVector scale;
+    int singular_bits = find_singular_lanes(values, 4, determinant, &scale);
+
+    SmallMatrixVector negative_scale = SMALL_MATRIX_SUB(SMALL_MATRIX_SET1(0.0), scale);
+// Every cofactor is +-(x*p - y*q + z*r); store it times +-1/det as value k of the inverse
+#define SMALL_MATRIX_STORE_COFACTOR(k, x, p, y, q, z, r, signed_scale) \
+    SMALL_MATRIX_STORE(&inverses[(k) * SMALL_MATRIX_LANES], SMALL_MATRIX_MUL(SMALL_MATRIX_ADD(SMALL_MATRIX_SUB(SMALL_MATRIX_MUL((x), (p)), SMALL_MATRIX_MUL((y), (q))), SMALL_MATRIX_MUL((z), (r))), (signed_scale)))
+    SMALL_MATRIX_STORE_COFACTOR(0, a11, bottom_minor23, a12, bottom_minor13, a13, bottom_minor12, scale);
+    SMALL_MATRIX_STORE_COFACTOR(1, a01, bottom_minor23, a02, bottom_minor13, a03, bottom_minor12, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(2, a31, top_minor23, a32, top_minor13, a33, top_minor12, scale);
+    SMALL_MATRIX_STORE_COFACTOR(3, a21, top_minor23, a22, top_minor13, a23, top_minor12, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(4, a10, bottom_minor23, a12, bottom_minor03, a13, bottom_minor02, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(5, a00, bottom_minor23, a02, bottom_minor03, a03, bottom_minor02, scale);
+    SMALL_MATRIX_STORE_COFACTOR(6, a30, top_minor23, a32, top_minor03, a33, top_minor02, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(7, a20, top_minor23, a22, top_minor03, a23, top_minor02, scale);
+    SMALL_MATRIX_STORE_COFACTOR(8, a10, bottom_minor13, a11, bottom_minor03, a13, bottom_minor01, scale);
+    SMALL_MATRIX_STORE_COFACTOR(9, a00, bottom_minor13, a01, bottom_minor03, a03, bottom_minor01, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(10, a30, top_minor13, a31, top_minor03, a33, top_minor01, scale);
+    SMALL_MATRIX_STORE_COFACTOR(11, a20, top_minor13, a21, top_minor03, a23, top_minor01, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(12, a10, bottom_minor12, a11, bottom_minor02, a12, bottom_minor01, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(13, a00, bottom_minor12, a01, bottom_minor02, a02, bottom_minor01, scale);
+    SMALL_MATRIX_STORE_COFACTOR(14, a30, top_minor12, a31, top_minor02, a32, top_minor01, negative_scale);
+    SMALL_MATRIX_STORE_COFACTOR(15, a20, top_minor12, a21, top_minor02, a22, top_minor01, scale);
+#undef SMALL_MATRIX_STORE_COFACTOR
+    SMALL_MATRIX_STORE(determinants, determinant);
+    return singular_bits;
+}
+
+/**
+ * @brief A batch of small matrices, split across threads.
+ *
+ * @param matrices: double[ptr]
+ *      The matrices, one after another, each in a 1-D row-major format.
+ * @param inverses: double[ptr]
+ *      Receives the inverses in the same layout. May be NULL.
+ * @param determinants: double[ptr]
+ *      Receives the determinants. May be NULL.
+ * @param singular_mask: int[ptr]
+ *      Receives 1 for every singular matrix and 0 for the rest. May be NULL.
+ * @param size: int
+ *      The number of rows (and columns) of every matrix.
+ * @param num_matrices: int
+ *      The number of matrices.
+ * @param num_tasks: int
+ *      The number of parts the batch is split into.
+ * @param kernel: SmallMatrixLaneKernel
+ *      The kernel for matrices of this size.
+ * @param num_singular: int
+ *      The number of singular matrices found so far. Added to atomically by every task.
+ */
+struct SmallMatrixBatch
+{
+    const double *matrices;
+    double *inverses;
+    double *determinants;
+    int *singular_mask;
+    int size;
+    int num_matrices;
+    int num_tasks;
+    SmallMatrixLaneKernel kernel;
+    volatile int num_singular;
+};
+
+/**
+ * @brief Invert matrices [first, end) of a batch, SMALL_MATRIX_LANES at a time. A last group that is not full is padded with identity matrices.
+ *
+ * @return num_singular: int
+ *      The number of singular matrices in the range.
+ */
+static int invert_small_matrix_range(const struct SmallMatrixBatch *batch, int first, int end)
+{
+    int size = batch->size;
+    int num_values = size * size;
+    double values[16 * SMALL_MATRIX_LANES];
+    double inverses[16 * SMALL_MATRIX_LANES];
+    double determinants[SMALL_MATRIX_LANES];
+    int num_singular = 0;
+    for (int group = first; group < end; group += SMALL_MATRIX_LANES)
+    {
+        int num_lanes = (end - group < SMALL_MATRIX_LANES) ? (end - group) : SMALL_MATRIX_LANES;
+        for (int value = 0; value < num_values; value++)
+        {
+            for (int lane = 0; lane < SMALL_MATRIX_LANES; lane++)
+            {
+                values[value * SMALL_MATRIX_LANES + lane] = (lane < num_lanes) ? batch->matrices[(int64_t)(group + lane) * num_values + value] : ((value % (size + 1) == 0) ? 1.0 : 0.0);
+            }
+        }
+        int singular_bits = batch->kernel(values, inverses, determinants);
+        for (int lane = 0; lane < num_lanes; lane++)
+        {
+            int is_singular = (singular_bits >> lane) & 1;
+            if (batch->inverses)
+            {
+                double *inverse = &batch->inverses[(int64_t)(group + lane) * num_values];
+                for (int value = 0; value < num_values; value++)
+                {
+                    inverse[value] = inverses[value * SMALL_MATRIX_LANES + lane];
+                }
+            }
+            if (batch->determinants)
+            {
+                batch->determinants[group + lane] = determinants[lane];
+            }
+            if (batch->singular_mask)
+            {
+                batch->singular_mask[group + lane] = is_singular;
+            }
+            num_singular += is_singular;
+        }
+    }
+    return num_singular;
+}
+
+/**
+ * @brief One part of a batch.
+ */
+static void invert_small_matrix_part(void *context, int task_index)
+{
+    struct SmallMatrixBatch *batch = (struct SmallMatrixBatch *)context;
+    int first = (int)(((int64_t)batch->num_matrices * task_index) / batch->num_tasks);
+    int end = (int)(((int64_t)batch->num_matrices * (task_index + 1)) / batch->num_tasks);
+    int num_singular = invert_small_matrix_range(batch, first, end);
+    ATOMIC_FETCH_ADD(&batch->num_singular, num_singular);
+}
+
+/**
+ * @brief Invert a batch of 2x2, 3x3 or 4x4 matrices and take their determinants in closed form. Singular matrices (see find_singular_lanes) are
+ *        flagged in the mask, and get all zeros for an inverse.
+ *
+ * @param matrices: double[ptr]
+ *      The matrices, one after another, each in a 1-D row-major format (e.g., a C-contiguous num_matrices x size x size array).
+ * @param size: int
+ *      The number of rows (and columns) of every matrix: 2, 3 or 4.
+ * @param num_matrices: int
+ *      The number of matrices.
+ * @param inverses: double[ptr]
+ *      Receives the inverses, in the same layout as matrices. May be NULL to only take determinants. May be matrices itself.
+ * @param determinants: double[ptr]
+ *      Receives the determinants, one per matrix. May be NULL.
+ * @param singular_mask: int[ptr]
+ *      Receives 1 for every singular matrix and 0 for the rest. May be NULL.
+ * @param num_threads: int
+ *      The most threads to use.
+ *
+ * @return num_singular: int
+ *      The number of singular matrices, or -1 if size is not 2, 3 or 4.
+ */
+static int invert_small_matrices(const double *matrices, int size, int num_matrices, double *inverses, double *determinants, int *singular_mask, int num_threads)
+{
+    SmallMatrixLaneKernel kernel = NULL;
+    if (size == 2)
+    {
+        kernel = invert_2x2_lanes;
+    }
+    else if (size == 3)
+    {
+        kernel = invert_3x3_lanes;
+    }
+    else if (size == 4)
+    {
+        kernel = invert_4x4_lanes;
+    }
+    if (!kernel)
+    {
+        return -1;
+    }
+    struct SmallMatrixBatch batch = {matrices, inverses, determinants, singular_mask, size, num_matrices, 1, kernel, 0};
+    batch.num_tasks = num_matrices / SMALL_MATRIX_MIN_MATRICES_PER_TASK;
+    batch.num_tasks = (batch.num_tasks > num_threads) ? num_threads : batch.num_tasks;
+    batch.num_tasks = (batch.num_tasks < 1) ? 1 : batch.num_tasks;
+    parallel_for(batch.num_tasks, invert_small_matrix_part, &batch);
+    return batch.num_singular;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+#ifndef TASK_SCHEDULER_C
+#define TASK_SCHEDULER_C
+#include <stdint.h>
+#include <stdlib.h>
+#include "ThreadPool.c"
+
+/**
+ * A work-stealing scheduler for graphs of small tasks with explicit dependencies (e.g., the tiles of a factorization).
+ *
+ * The graph is implicit: the caller describes a task with a few integers, and the task function itself spawns the tasks whose
+ * last dependency it satisfied. Every worker has its own deque. It pushes and pops the tasks it spawns at the bottom (newest
+ * first, so a task that was just made ready, like the next panel, runs right away on a warm cache), and a worker that runs out
+ * steals from the top of another worker's deque (oldest first, which tends to be the biggest piece of remaining work).
+ */
+
+/**
+ * @brief One task. What the fields mean is up to the task function.
+ */
+struct ScheduledTask
+{
+    int type;
+    int k;
+    int i;
+    int j;
+};
+
+/**
+ * @brief A worker's double-ended queue of ready tasks, stored as a ring.
+ *
+ * @param mutex: Mutex
+ *      Taken by the owner and by thieves. Tasks are coarse enough that a lock per push/pop does not show up.
+ * @param tasks: struct ScheduledTask[ptr]
+ *      The ring. Its capacity is a power of two.
+ * @param top: int64_t
+ *      Where thieves take from. Only ever increases.
+ * @param bottom: int64_t
+ *      Where the owner pushes and pops.
+ */
+struct TaskDeque
+{
+    Mutex mutex;
+    struct ScheduledTask *tasks;
+    int64_t capacity;
+    int64_t top;
+    int64_t bottom;
+    char padding[64];
+};
+
+struct TaskScheduler;
+typedef void (*ScheduledTaskFunction)(void *context, struct TaskScheduler *scheduler, int worker, struct ScheduledTask task);
+
+/**
+ * @brief The state of one run of the scheduler.
+ *
+ * @param num_workers: int
+ *      The number of workers (and deques).
+ * @param deques: struct TaskDeque[ptr]
+ *      One deque per worker.
+ * @param num_remaining_tasks: int
+ *      The number of tasks that have not finished yet. The run ends when it reaches 0.
+ * @param function: ScheduledTaskFunction
+ *      Runs a task.
+ * @param context: void[ptr]
+ *      Passed to function.
+ */
+struct TaskScheduler
+{
+    int num_workers;
+    struct TaskDeque *deques;
+    volatile int num_remaining_tasks;
+    ScheduledTaskFunction function;
+    void *context;
+};
+
+/**
+ * @brief Make a task ready. Called from inside a task function, with the worker that is running it.
+ *
+ * @param scheduler: struct TaskScheduler[ptr]
+ *      The running scheduler.
+ * @param worker: int
+ *      The worker spawning the task. It goes on this worker's deque.
+ * @param task: struct ScheduledTask
+ *      The task.
+ *
+ * @return None
+ */
+static void spawn_scheduled_task(struct TaskScheduler *scheduler, int worker, struct ScheduledTask task)
+{
+    struct TaskDeque *deque = &scheduler->deques[worker];
+    lock_mutex(&deque->mutex);
+    deque->tasks[deque->bottom & (deque->capacity - 1)] = task;
+    deque->bottom++;
+    unlock_mutex(&deque->mutex);
+}
+
+/**
+ * @brief Take the newest task from a worker's own deque.
+ *
+ * @return found: int
+ *      1 if a task was taken.
+ */
+static inline int pop_scheduled_task(struct TaskDeque *deque, struct ScheduledTask *task)
+{
+    int found = 0;
+    lock_mutex(&deque->mutex);
+    if (deque->bottom > deque->top)
+    {
+        deque->bottom--;
+        *task = deque->tasks[deque->bottom & (deque->capacity - 1)];
+        found = 1;
+    }
+    unlock_mutex(&deque->mutex);
+    return found;
+}
+
+/**
+ * @brief Take the oldest task from another worker's deque.
+ *
+ * @return found: int
+ *      1 if a task was taken.
+ */
+static inline int steal_scheduled_task(struct TaskDeque *deque, struct ScheduledTask *task)
+{
+    int found = 0;
+    lock_mutex(&deque->mutex);
+    if (deque->bottom > deque->top)
+    {
+        *task = deque->tasks[deque->top & (deque->capacity - 1)];
+        deque->top++;
+        found = 1;
+    }
+    unlock_mutex(&deque->mutex);
+    return found;
+}
+
+/**
+ * @brief The loop each worker runs: work through its own deque, steal when it is empty, and stop once every task has finished. The
+ *        worker index is the parallel_for task index, so each worker gets its own deque.
+ */
+static void run_task_scheduler_worker(void *context, int task_index)
+{
+    struct TaskScheduler *scheduler = (struct TaskScheduler *)context;
+    int worker = task_index;
+    // Cheap per-worker random numbers, to spread out which deques thieves try first
+    uint32_t random_state = 2654435761u * (uint32_t)(worker + 1);
+    struct ScheduledTask task;
+    while (ATOMIC_LOAD_ACQUIRE(&scheduler->num_remaining_tasks) > 0)
+    {
+        int found = pop_scheduled_task(&scheduler->deques[worker], &task);
+        for (int attempt = 0; !found && attempt < scheduler->num_workers; attempt++)
+        {
+            random_state = random_state * 1664525u + 1013904223u;
+            int victim = (int)((random_state >> 16) % (uint32_t)scheduler->num_workers);
+            if (victim != worker)
+            {
+                found = steal_scheduled_task(&scheduler->deques[victim], &task);
+            }
+        }
+        if (!found)
+        {
+            THREAD_YIELD();
+            continue;
+        }
+        scheduler->function(scheduler->context, scheduler, worker, task);
+        ATOMIC_FETCH_ADD(&scheduler->num_remaining_tasks, -1);
+    }
+}
+
+/**
+ * @brief Run a task graph to completion on up to num_workers threads of the thread pool.
+ *
+ * @param num_workers: int
+ *      The number of workers.
+ * @param num_tasks: int
+ *      The total number of tasks that will run, counting the initial ones.
+ * @param max_ready_tasks: int
+ *      The most tasks that can be ready at the same time. Sizes the deques.
+ * @param initial_tasks: struct ScheduledTask[ptr]
+ *      The tasks that have no dependencies. They are dealt out across the deques.
+ * @param num_initial_tasks: int
+ *      The number of initial tasks.
+ * @param function: ScheduledTaskFunction
+ *      Runs a task, and spawns the tasks it makes ready with spawn_scheduled_task.
+ * @param context: void[ptr]
+ *      Passed to function.
+ *
+ * @return ran: int
+ *      1 if the graph ran, 0 if the deques could not be allocated.
+ */
+static int run_task_scheduler(int num_workers, int num_tasks, int max_ready_tasks, const struct ScheduledTask *initial_tasks, int num_initial_tasks, ScheduledTaskFunction function, void *context)
+{
+    struct TaskScheduler scheduler;
+    scheduler.num_workers = (num_workers < 1) ? 1 : num_workers;
+    scheduler.num_remaining_tasks = num_tasks;
+    scheduler.function = function;
+    scheduler.context = context;
+    scheduler.deques = (struct TaskDeque *)calloc(scheduler.num_workers, sizeof(struct TaskDeque));
+    if (!scheduler.deques)
+    {
+        return 0;
+    }
+    int64_t capacity = 16;
+    while (capacity < (int64_t)max_ready_tasks + num_initial_tasks)
+    {
+        capacity *= 2;
+    }
+    int ran = 1;
+    for (int worker = 0; worker < scheduler.num_workers; worker++)
+    {
+        initialize_mutex(&scheduler.deques[worker].mutex);
+        scheduler.deques[worker].capacity = capacity;
+        scheduler.deques[worker].tasks = (struct ScheduledTask *)malloc(sizeof(struct ScheduledTask) * capacity);
+        ran = ran && scheduler.deques[worker].tasks;
+    }
+    if (ran)
+    {
+        for (int task = 0; task < num_initial_tasks; task++)
+        {
+            spawn_scheduled_task(&scheduler, task % scheduler.num_workers, initial_tasks[task]);
+        }
+        parallel_for(scheduler.num_workers, run_task_scheduler_worker, &scheduler);
+    }
+    for (int worker = 0; worker < scheduler.num_workers; worker++)
+    {
+        free(scheduler.deques[worker].tasks);
+        destroy_mutex(&scheduler.deques[worker].mutex);
+    }
+    free(scheduler.deques);
+    return ran;
+}
+
+#endif
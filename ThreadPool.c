@@ -0,0 +1,630 @@
+#ifndef THREAD_POOL_C
+#define THREAD_POOL_C
+#include <stdint.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#define THREAD_LOCAL __declspec(thread)
+#define ATOMIC_FETCH_ADD(pointer, value) InterlockedExchangeAdd((volatile LONG *)(pointer), (LONG)(value))
+#define ATOMIC_LOAD_ACQUIRE(pointer) InterlockedCompareExchange((volatile LONG *)(pointer), 0, 0)
+#define ATOMIC_STORE_RELEASE(pointer, value) InterlockedExchange((volatile LONG *)(pointer), (LONG)(value))
+#define THREAD_YIELD() SwitchToThread()
+#endif
+#ifdef linux
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+#define THREAD_LOCAL __thread
+#define ATOMIC_FETCH_ADD(pointer, value) __atomic_fetch_add((pointer), (value), __ATOMIC_ACQ_REL)
+#define ATOMIC_LOAD_ACQUIRE(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RELEASE(pointer, value) __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+#define THREAD_YIELD() sched_yield()
+#endif
+
+// The most threads the pool will ever start, no matter how many cores the machine reports.
+#define THREAD_POOL_MAX_THREADS 256
+// The most NUMA nodes the pool spreads its workers across. Nodes past it are not used by pinned workers.
+#define THREAD_POOL_MAX_NUMA_NODES 64
+
+/**********************************************************************************
+ *                                                                                *
+ *                         PORTABLE THREADING PRIMITIVES                          *
+ *                                                                                *
+ **********************************************************************************/
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE ConditionVariable;
+// The processors a thread may run on. Only the first processor group (64 processors) is used.
+typedef ULONGLONG ProcessorSet;
+#endif
+#ifdef linux
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t ConditionVariable;
+typedef cpu_set_t ProcessorSet;
+#endif
+
+typedef void (*ThreadFunction)(void *argument);
+
+/**
+ * @brief What a new thread is started with. The platform thread entry points unpack it and call the function.
+ */
+struct ThreadStart
+{
+    ThreadFunction function;
+    void *argument;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI thread_entry_point(LPVOID start_pointer)
+#endif
+#ifdef linux
+static void *thread_entry_point(void *start_pointer)
+#endif
+{
+    struct ThreadStart start = *(struct ThreadStart *)start_pointer;
+    free(start_pointer);
+    start.function(start.argument);
+    return 0;
+}
+
+/**
+ * @brief Start a thread.
+ *
+ * @param thread: Thread[ptr]
+ *      Receives the handle of the new thread.
+ * @param function: ThreadFunction
+ *      The function the thread runs.
+ * @param argument: void[ptr]
+ *      Passed to function.
+ *
+ * @return started: int
+ *      1 if the thread was started, 0 otherwise.
+ */
+static inline int start_thread(Thread *thread, ThreadFunction function, void *argument)
+{
+    struct ThreadStart *start = (struct ThreadStart *)malloc(sizeof(struct ThreadStart));
+    if (!start)
+    {
+        return 0;
+    }
+    start->function = function;
+    start->argument = argument;
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, thread_entry_point, start, 0, NULL);
+    if (*thread == NULL)
+#endif
+#ifdef linux
+    if (pthread_create(thread, NULL, thread_entry_point, start) != 0)
+#endif
+    {
+        free(start);
+        return 0;
+    }
+    return 1;
+}
+
+static inline void initialize_mutex(Mutex *mutex)
+{
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#endif
+#ifdef linux
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+static inline void destroy_mutex(Mutex *mutex)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#endif
+#ifdef linux
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+static inline void lock_mutex(Mutex *mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#endif
+#ifdef linux
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+static inline void unlock_mutex(Mutex *mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#endif
+#ifdef linux
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+static inline void initialize_condition_variable(ConditionVariable *condition_variable)
+{
+#ifdef _WIN32
+    InitializeConditionVariable(condition_variable);
+#endif
+#ifdef linux
+    pthread_cond_init(condition_variable, NULL);
+#endif
+}
+
+static inline void wait_condition_variable(ConditionVariable *condition_variable, Mutex *mutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(condition_variable, mutex, INFINITE);
+#endif
+#ifdef linux
+    pthread_cond_wait(condition_variable, mutex);
+#endif
+}
+
+static inline void wake_all_condition_variable(ConditionVariable *condition_variable)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(condition_variable);
+#endif
+#ifdef linux
+    pthread_cond_broadcast(condition_variable);
+#endif
+}
+
+/**
+ * @brief Get the number of hardware threads (logical cores) the machine has.
+ *
+ * @return num_threads: int
+ *      The number of hardware threads, at least 1 and at most THREAD_POOL_MAX_THREADS.
+ */
+static inline int get_hardware_thread_count(void)
+{
+    int num_threads = 1;
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    num_threads = (int)system_info.dwNumberOfProcessors;
+#endif
+#ifdef linux
+    num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > THREAD_POOL_MAX_THREADS)
+    {
+        num_threads = THREAD_POOL_MAX_THREADS;
+    }
+    return num_threads;
+}
+
+/**
+ * @brief Get the processors of each NUMA node that has any. A machine that is not NUMA (or does not say) is reported as one node.
+ *
+ * @param node_processors: ProcessorSet[THREAD_POOL_MAX_NUMA_NODES]
+ *      Receives the processors of each node.
+ *
+ * @return num_nodes: int
+ *      The number of nodes, at least 1, or 0 if not even the processors of the machine could be found.
+ */
+static int get_numa_node_processors(ProcessorSet *node_processors)
+{
+    int num_nodes = 0;
+#ifdef _WIN32
+    ULONG highest_node = 0;
+    if (GetNumaHighestNodeNumber(&highest_node))
+    {
+        for (ULONG node = 0; node <= highest_node && num_nodes < THREAD_POOL_MAX_NUMA_NODES; node++)
+        {
+            if (GetNumaNodeProcessorMask((UCHAR)node, &node_processors[num_nodes]) && node_processors[num_nodes] != 0)
+            {
+                num_nodes++;
+            }
+        }
+    }
+    if (num_nodes == 0)
+    {
+        DWORD_PTR process_processors, system_processors;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &process_processors, &system_processors))
+        {
+            return 0;
+        }
+        node_processors[0] = (ULONGLONG)process_processors;
+        num_nodes = 1;
+    }
+#endif
+#ifdef linux
+    // Each node lists its processors as ranges, e.g. "0-15,32-47". Nodes with memory but no processors list none.
+    for (int node = 0; node < THREAD_POOL_MAX_NUMA_NODES; node++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (!file)
+        {
+            continue;
+        }
+        CPU_ZERO(&node_processors[num_nodes]);
+        int first_processor, last_processor;
+        while (fscanf(file, "%d", &first_processor) == 1)
+        {
+            last_processor = first_processor;
+            int separator = fgetc(file);
+            if (separator == '-' && fscanf(file, "%d", &last_processor) == 1)
+            {
+                separator = fgetc(file);
+            }
+            for (int processor = first_processor; processor <= last_processor && processor < CPU_SETSIZE; processor++)
+            {
+                CPU_SET(processor, &node_processors[num_nodes]);
+            }
+            if (separator != ',')
+            {
+                break;
+            }
+        }
+        fclose(file);
+        if (CPU_COUNT(&node_processors[num_nodes]) > 0)
+        {
+            num_nodes++;
+        }
+    }
+    if (num_nodes == 0)
+    {
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &node_processors[0]) != 0)
+        {
+            return 0;
+        }
+        num_nodes = 1;
+    }
+#endif
+    return num_nodes;
+}
+
+/**
+ * @brief Restrict a thread to a set of processors.
+ *
+ * @return is_set: int
+ *      1 if the thread's processors were set, 0 otherwise.
+ */
+static inline int set_thread_processors(Thread thread, const ProcessorSet *processors)
+{
+#ifdef _WIN32
+    return SetThreadAffinityMask(thread, (DWORD_PTR)*processors) != 0;
+#endif
+#ifdef linux
+    return pthread_setaffinity_np(thread, sizeof(cpu_set_t), processors) == 0;
+#endif
+}
+
+/**********************************************************************************
+ *                                                                                *
+ *                                  THREAD POOL                                   *
+ *                                                                                *
+ **********************************************************************************/
+
+typedef void (*ParallelTaskFunction)(void *context, int task_index);
+
+/**
+ * @brief A set of worker threads that is started once and then reused by every parallel_for, so no solve pays for starting threads.
+ *        The thread that calls parallel_for works on the tasks too, so a pool of N threads has N - 1 workers.
+ *
+ * @param num_threads: int
+ *      The number of threads that work on a parallel_for, counting the caller.
+ * @param workers: Thread[THREAD_POOL_MAX_THREADS]
+ *      The worker threads.
+ * @param default_processors: ProcessorSet
+ *      The processors the workers may run on when they are not pinned: those of the thread that started the pool.
+ * @param num_pinned_nodes: int
+ *      The number of NUMA nodes the workers are pinned across, or 0 if they are not pinned. Written with both mutexes held.
+ * @param submit_mutex: Mutex
+ *      Held for the whole of a parallel_for, so parallel_for calls from different threads take turns.
+ * @param mutex: Mutex
+ *      Protects generation, num_busy_workers and the current job.
+ * @param work_available: ConditionVariable
+ *      Signalled when a new job is published.
+ * @param work_finished: ConditionVariable
+ *      Signalled when the last worker is done with a job.
+ * @param generation: int64_t
+ *      Incremented every time a job is published, so the workers can tell a new job from a spurious wake up.
+ * @param num_busy_workers: int
+ *      The number of workers that have not finished with the current job yet.
+ * @param function: ParallelTaskFunction
+ *      The current job's function.
+ * @param context: void[ptr]
+ *      The current job's context.
+ * @param num_tasks: int
+ *      The number of tasks in the current job.
+ * @param next_task: int
+ *      The next task index to hand out. Taken with an atomic increment, so handing out tasks does not need the mutex.
+ */
+struct ThreadPool
+{
+    int num_threads;
+    Thread workers[THREAD_POOL_MAX_THREADS];
+    ProcessorSet default_processors;
+    int num_pinned_nodes;
+    Mutex submit_mutex;
+    Mutex mutex;
+    ConditionVariable work_available;
+    ConditionVariable work_finished;
+    int64_t generation;
+    int num_busy_workers;
+    ParallelTaskFunction function;
+    void *context;
+    int num_tasks;
+    volatile int next_task;
+};
+
+// Set on every thread while it runs tasks, so that a parallel_for from inside a task runs inline instead of waiting on the pool it is part of.
+static THREAD_LOCAL int is_running_parallel_task = 0;
+
+/**
+ * @brief Hand out the tasks of the current job until there are none left.
+ *
+ * @param thread_pool: struct ThreadPool[ptr]
+ *      The pool whose job to work on.
+ *
+ * @return None
+ */
+static inline void run_parallel_tasks(struct ThreadPool *thread_pool)
+{
+    is_running_parallel_task = 1;
+    for (;;)
+    {
+        int task_index = ATOMIC_FETCH_ADD(&thread_pool->next_task, 1);
+        if (task_index >= thread_pool->num_tasks)
+        {
+            break;
+        }
+        thread_pool->function(thread_pool->context, task_index);
+    }
+    is_running_parallel_task = 0;
+}
+
+/**
+ * @brief The loop every worker thread runs: wait for a job, work on it, report back.
+ */
+static void thread_pool_worker(void *argument)
+{
+    struct ThreadPool *thread_pool = (struct ThreadPool *)argument;
+    int64_t last_generation = 0;
+    for (;;)
+    {
+        lock_mutex(&thread_pool->mutex);
+        while (thread_pool->generation == last_generation)
+        {
+            wait_condition_variable(&thread_pool->work_available, &thread_pool->mutex);
+        }
+        last_generation = thread_pool->generation;
+        unlock_mutex(&thread_pool->mutex);
+
+        run_parallel_tasks(thread_pool);
+
+        lock_mutex(&thread_pool->mutex);
+        thread_pool->num_busy_workers--;
+        if (thread_pool->num_busy_workers == 0)
+        {
+            wake_all_condition_variable(&thread_pool->work_finished);
+        }
+        unlock_mutex(&thread_pool->mutex);
+    }
+}
+
+static struct ThreadPool *global_thread_pool = NULL;
+
+/**
+ * @brief Start the pool's workers. Only called once, through get_thread_pool.
+ */
+static void create_global_thread_pool(void)
+{
+    struct ThreadPool *thread_pool = (struct ThreadPool *)calloc(1, sizeof(struct ThreadPool));
+    if (!thread_pool)
+    {
+        return;
+    }
+    initialize_mutex(&thread_pool->submit_mutex);
+    initialize_mutex(&thread_pool->mutex);
+    initialize_condition_variable(&thread_pool->work_available);
+    initialize_condition_variable(&thread_pool->work_finished);
+    // New threads run where the thread that starts them may, which is where unpinning puts the workers back
+#ifdef _WIN32
+    DWORD_PTR process_processors, system_processors;
+    thread_pool->default_processors = GetProcessAffinityMask(GetCurrentProcess(), &process_processors, &system_processors) ? (ULONGLONG)process_processors : ~(ULONGLONG)0;
+#endif
+#ifdef linux
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &thread_pool->default_processors) != 0)
+    {
+        CPU_ZERO(&thread_pool->default_processors);
+        for (int processor = 0; processor < CPU_SETSIZE; processor++)
+        {
+            CPU_SET(processor, &thread_pool->default_processors);
+        }
+    }
+#endif
+    int num_threads = get_hardware_thread_count();
+    thread_pool->num_threads = 1;
+    for (int worker = 0; worker < (num_threads - 1); worker++)
+    {
+        if (!start_thread(&thread_pool->workers[worker], thread_pool_worker, thread_pool))
+        {
+            break;
+        }
+        thread_pool->num_threads++;
+    }
+    global_thread_pool = thread_pool;
+}
+
+#ifdef _WIN32
+static INIT_ONCE global_thread_pool_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK create_global_thread_pool_once(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    create_global_thread_pool();
+    return TRUE;
+}
+#endif
+#ifdef linux
+static pthread_once_t global_thread_pool_once = PTHREAD_ONCE_INIT;
+#endif
+
+/**
+ * @brief Get the library's thread pool, starting it the first time it is needed.
+ *
+ * @return thread_pool: struct ThreadPool[ptr]
+ *      The thread pool, or NULL if it could not be created (parallel_for then runs everything on the calling thread).
+ */
+static inline struct ThreadPool *get_thread_pool(void)
+{
+#ifdef _WIN32
+    InitOnceExecuteOnce(&global_thread_pool_once, create_global_thread_pool_once, NULL, NULL);
+#endif
+#ifdef linux
+    pthread_once(&global_thread_pool_once, create_global_thread_pool);
+#endif
+    return global_thread_pool;
+}
+
+/**
+ * @brief Resolve a requested thread count (e.g., SolverOptions.num_threads) into the number of threads to split work across.
+ *
+ * @param requested_num_threads: int
+ *      The number of threads asked for. 0 or less means all of the pool's threads.
+ *
+ * @return num_threads: int
+ *      The number of threads to use, between 1 and the size of the pool.
+ */
+static inline int resolve_num_threads(int requested_num_threads)
+{
+    struct ThreadPool *thread_pool = get_thread_pool();
+    int num_threads = thread_pool ? thread_pool->num_threads : 1;
+    if (requested_num_threads > 0 && requested_num_threads < num_threads)
+    {
+        num_threads = requested_num_threads;
+    }
+    return num_threads;
+}
+
+/**
+ * @brief Run function(context, task_index) for every task_index in [0, num_tasks), spread across the thread pool, and wait for all of them.
+ *        Tasks are handed out one at a time, so uneven tasks still balance. To use fewer threads, split the work into fewer tasks.
+ *
+ *        NOTE: Calling parallel_for from inside a task runs the inner tasks on the calling thread.
+ *
+ * @param num_tasks: int
+ *      The number of tasks.
+ * @param function: ParallelTaskFunction
+ *      The function to run for each task.
+ * @param context: void[ptr]
+ *      Passed to every call of function.
+ *
+ * @return None
+ */
+static void parallel_for(int num_tasks, ParallelTaskFunction function, void *context)
+{
+    struct ThreadPool *thread_pool = (num_tasks > 1 && !is_running_parallel_task) ? get_thread_pool() : NULL;
+    if (!thread_pool || thread_pool->num_threads == 1)
+    {
+        for (int task_index = 0; task_index < num_tasks; task_index++)
+        {
+            function(context, task_index);
+        }
+        return;
+    }
+    lock_mutex(&thread_pool->submit_mutex);
+    lock_mutex(&thread_pool->mutex);
+    thread_pool->function = function;
+    thread_pool->context = context;
+    thread_pool->num_tasks = num_tasks;
+    ATOMIC_STORE_RELEASE(&thread_pool->next_task, 0);
+    thread_pool->num_busy_workers = thread_pool->num_threads - 1;
+    thread_pool->generation++;
+    wake_all_condition_variable(&thread_pool->work_available);
+    unlock_mutex(&thread_pool->mutex);
+
+    run_parallel_tasks(thread_pool);
+
+    lock_mutex(&thread_pool->mutex);
+    while (thread_pool->num_busy_workers > 0)
+    {
+        wait_condition_variable(&thread_pool->work_finished, &thread_pool->mutex);
+    }
+    unlock_mutex(&thread_pool->mutex);
+    unlock_mutex(&thread_pool->submit_mutex);
+}
+
+/**
+ * @brief Pin each of the pool's workers to the processors of one NUMA node, or let them run anywhere again. The workers are split into
+ *        contiguous groups, one per node, so every node gets a share of them. A pinned worker stays on its node, so the memory it touches
+ *        first (see touch_first_pages) is local to it. Waits for a parallel_for that is running to finish first, so must not be called from
+ *        one of its tasks.
+ *
+ * @param is_pinned: int
+ *      1 to pin the workers to nodes, 0 to give them back the processors they started with.
+ *
+ * @return num_nodes: int
+ *      The number of nodes the workers are pinned across, or 0 if they are not pinned.
+ */
+static int pin_thread_pool_workers(int is_pinned)
+{
+    struct ThreadPool *thread_pool = get_thread_pool();
+    if (!thread_pool)
+    {
+        return 0;
+    }
+    lock_mutex(&thread_pool->submit_mutex);
+    if (!is_pinned && thread_pool->num_pinned_nodes == 0)
+    {
+        unlock_mutex(&thread_pool->submit_mutex);
+        return 0;
+    }
+    int num_workers = thread_pool->num_threads - 1;
+    ProcessorSet *node_processors = is_pinned ? (ProcessorSet *)malloc(sizeof(ProcessorSet) * THREAD_POOL_MAX_NUMA_NODES) : NULL;
+    int num_nodes = node_processors ? get_numa_node_processors(node_processors) : 0;
+    int num_pinned_nodes = (num_nodes < num_workers) ? num_nodes : num_workers;
+    for (int worker = 0; worker < num_workers && num_pinned_nodes > 0; worker++)
+    {
+        if (!set_thread_processors(thread_pool->workers[worker], &node_processors[((int64_t)worker * num_pinned_nodes) / num_workers]))
+        {
+            num_pinned_nodes = 0;
+        }
+    }
+    free(node_processors);
+    // Not pinned, or a worker could not be pinned: put every worker back, so none is left on a node when 0 is reported.
+    for (int worker = 0; worker < num_workers && num_pinned_nodes == 0; worker++)
+    {
+        set_thread_processors(thread_pool->workers[worker], &thread_pool->default_processors);
+    }
+    lock_mutex(&thread_pool->mutex);
+    thread_pool->num_pinned_nodes = num_pinned_nodes;
+    unlock_mutex(&thread_pool->mutex);
+    unlock_mutex(&thread_pool->submit_mutex);
+    return num_pinned_nodes;
+}
+
+/**
+ * @brief Get the number of NUMA nodes the pool's workers are pinned across (see pin_thread_pool_workers).
+ *
+ * @return num_nodes: int
+ *      The number of nodes the workers are pinned across, or 0 if they are not pinned or there is no thread pool.
+ */
+static int get_thread_pool_pinned_node_count(void)
+{
+    struct ThreadPool *thread_pool = get_thread_pool();
+    if (!thread_pool)
+    {
+        return 0;
+    }
+    lock_mutex(&thread_pool->mutex);
+    int num_pinned_nodes = thread_pool->num_pinned_nodes;
+    unlock_mutex(&thread_pool->mutex);
+    return num_pinned_nodes;
+}
+
+#endif
@@ -0,0 +1,457 @@
+#ifndef TOEPLITZ_SOLVERS_C
+#define TOEPLITZ_SOLVERS_C
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Fast solvers for Toeplitz systems (every diagonal is constant, so the matrix is fixed by its first row and column): the Levinson recursion in
+ * O(n^2), and for circulant systems (every row is the one above rotated right by one) diagonalization with the FFT in O(n log n).
+ */
+
+#define TOEPLITZ_PI 3.14159265358979323846
+
+// A circulant matrix counts as singular when an eigenvalue is this small next to the largest one
+#define CIRCULANT_SINGULAR_TOLERANCE 1e-13
+
+/**
+ * @brief A precomputed discrete Fourier transform of one size. Powers of two use an iterative radix-2 FFT; every other size is turned into a
+ *        power-of-two convolution with Bluestein's chirp-z algorithm, so every size takes O(n log n).
+ *
+ * @param size: int
+ *      The size of the transform.
+ * @param padded_size: int
+ *      The size of the radix-2 FFT that does the work: size itself if it is a power of two, otherwise the smallest power of two of at least 2 * size - 1.
+ * @param twiddle_real: double[ptr]
+ *      The real parts of exp(-2 pi i k / padded_size), for k below padded_size / 2.
+ * @param twiddle_imag: double[ptr]
+ *      The imaginary parts of the same.
+ * @param chirp_real: double[ptr]
+ *      Bluestein only. The real parts of exp(-pi i k^2 / size), for k below size.
+ * @param chirp_imag: double[ptr]
+ *      Bluestein only. The imaginary parts of the same.
+ * @param chirp_filter_real: double[ptr]
+ *      Bluestein only. The real parts of the forward FFT of the conjugate chirp, wrapped around padded_size.
+ * @param chirp_filter_imag: double[ptr]
+ *      Bluestein only. The imaginary parts of the same.
+ * @param work_real: double[ptr]
+ *      Bluestein only. Scratch space for padded_size values.
+ * @param work_imag: double[ptr]
+ *      Bluestein only. Scratch space for padded_size values.
+ */
+struct FftPlan
+{
+    int size;
+    int padded_size;
+    double *twiddle_real;
+    double *twiddle_imag;
+    double *chirp_real;
+    double *chirp_imag;
+    double *chirp_filter_real;
+    double *chirp_filter_imag;
+    double *work_real;
+    double *work_imag;
+};
+
+/**
+ * @brief Run an in-place radix-2 FFT over padded_size values.
+ *
+ * @param plan: struct FftPlan[ptr]
+ *      The plan whose padded_size and twiddles to use.
+ * @param real: double[ptr]
+ *      The real parts, replaced by those of the transform.
+ * @param imag: double[ptr]
+ *      The imaginary parts, replaced by those of the transform.
+ * @param inverse: int
+ *      1 for the inverse transform (without the division by the size), 0 for the forward one.
+ *
+ * @return None
+ */
+static void run_radix2_fft(const struct FftPlan *plan, double *real, double *imag, int inverse)
+{
+    int size = plan->padded_size;
+    // Put the values in bit-reversed order, so the butterflies can work in place
+    for (int index = 1, reversed = 0; index < size; index++)
+    {
+        int bit = size >> 1;
+        for (; reversed & bit; bit >>= 1)
+        {
+            reversed ^= bit;
+        }
+        reversed ^= bit;
+        if (index < reversed)
+        {
+            double temp = real[index];
+            real[index] = real[reversed];
+            real[reversed] = temp;
+            temp = imag[index];
+            imag[index] = imag[reversed];
+            imag[reversed] = temp;
+        }
+    }
+    double imag_sign = inverse ? -1.0 : 1.0;
+    for (int length = 2; length <= size; length <<= 1)
+    {
+        int half_length = length >> 1;
+        int twiddle_step = size / length;
+        for (int start = 0; start < size; start += length)
+        {
+            for (int offset = 0; offset < half_length; offset++)
+            {
+                double twiddle_real = plan->twiddle_real[offset * twiddle_step];
+                double twiddle_imag = imag_sign * plan->twiddle_imag[offset * twiddle_step];
+                int top = start + offset;
+                int bottom = top + half_length;
+                double product_real = real[bottom] * twiddle_real - imag[bottom] * twiddle_imag;
+                double product_imag = real[bottom] * twiddle_imag + imag[bottom] * twiddle_real;
+                real[bottom] = real[top] - product_real;
+                imag[bottom] = imag[top] - product_imag;
+                real[top] += product_real;
+                imag[top] += product_imag;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Free an FFT plan.
+ *
+ * @param plan: struct FftPlan[ptr]
+ *      The plan to free. Passing NULL does nothing.
+ *
+ * @return None
+ */
+static void destroy_fft_plan(struct FftPlan *plan)
+{
+    if (!plan)
+    {
+        return;
+    }
+    free(plan->twiddle_real);
+    free(plan->twiddle_imag);
+    free(plan->chirp_real);
+    free(plan->chirp_imag);
+    free(plan->chirp_filter_real);
+    free(plan->chirp_filter_imag);
+    free(plan->work_real);
+    free(plan->work_imag);
+    free(plan);
+}
+
+/**
+ * @brief Precompute the FFT of one size.
+ *
+ * @param size: int
+ *      The size of the transform. Must be at least 1.
+ *
+ * @return plan: struct FftPlan[ptr]
+ *      The plan, to be freed with destroy_fft_plan, or NULL if it could not be allocated.
+ */
+static struct FftPlan *create_fft_plan(int size)
+{
+    struct FftPlan *plan = (struct FftPlan *)calloc(1, sizeof(struct FftPlan));
+    if (!plan)
+    {
+        return NULL;
+    }
+    int is_power_of_two = (size & (size - 1)) == 0;
+    int padded_size = 1;
+    while (padded_size < (is_power_of_two ? size : (2 * size - 1)))
+    {
+        padded_size <<= 1;
+    }
+    plan->size = size;
+    plan->padded_size = padded_size;
+    int num_twiddles = (padded_size > 1) ? (padded_size / 2) : 1;
+    plan->twiddle_real = (double *)malloc(sizeof(double) * num_twiddles);
+    plan->twiddle_imag = (double *)malloc(sizeof(double) * num_twiddles);
+    if (!plan->twiddle_real || !plan->twiddle_imag)
+    {
+        destroy_fft_plan(plan);
+        return NULL;
+    }
+    for (int index = 0; index < num_twiddles; index++)
+    {
+        double angle = -2.0 * TOEPLITZ_PI * index / padded_size;
+        plan->twiddle_real[index] = cos(angle);
+        plan->twiddle_imag[index] = sin(angle);
+    }
+    if (is_power_of_two)
+    {
+        return plan;
+    }
+
+    plan->chirp_real = (double *)malloc(sizeof(double) * size);
+    plan->chirp_imag = (double *)malloc(sizeof(double) * size);
+    plan->chirp_filter_real = (double *)calloc(padded_size, sizeof(double));
+    plan->chirp_filter_imag = (double *)calloc(padded_size, sizeof(double));
+    plan->work_real = (double *)malloc(sizeof(double) * padded_size);
+    plan->work_imag = (double *)malloc(sizeof(double) * padded_size);
+    if (!plan->chirp_real || !plan->chirp_imag || !plan->chirp_filter_real || !plan->chirp_filter_imag || !plan->work_real || !plan->work_imag)
+    {
+        destroy_fft_plan(plan);
+        return NULL;
+    }
+    for (int index = 0; index < size; index++)
+    {
+        // k^2 is reduced mod 2 * size first, so the angle stays accurate for large k
+        int64_t square = ((int64_t)index * index) % (2 * (int64_t)size);
+        double angle = -TOEPLITZ_PI * (double)square / size;
+        plan->chirp_real[index] = cos(angle);
+        plan->chirp_imag[index] = sin(angle);
+    }
+    plan->chirp_filter_real[0] = plan->chirp_real[0];
+    plan->chirp_filter_imag[0] = -plan->chirp_imag[0];
+    for (int index = 1; index < size; index++)
+    {
+        plan->chirp_filter_real[index] = plan->chirp_real[index];
+        plan->chirp_filter_imag[index] = -plan->chirp_imag[index];
+        plan->chirp_filter_real[padded_size - index] = plan->chirp_real[index];
+        plan->chirp_filter_imag[padded_size - index] = -plan->chirp_imag[index];
+    }
+    run_radix2_fft(plan, plan->chirp_filter_real, plan->chirp_filter_imag, 0);
+    return plan;
+}
+
+/**
+ * @brief Run the discrete Fourier transform in place: X_k = sum of x_j * exp(-2 pi i j k / size), or with +2 pi i for the inverse.
+ *
+ * @param plan: struct FftPlan[ptr]
+ *      The plan of the transform's size. Its scratch space is used, so a plan must not be run on two threads at once.
+ * @param real: double[ptr]
+ *      The real parts of the size values, replaced by those of the transform.
+ * @param imag: double[ptr]
+ *      The imaginary parts, replaced by those of the transform.
+ * @param inverse: int
+ *      1 for the inverse transform (without the division by the size), 0 for the forward one.
+ *
+ * @return None
+ */
+static void run_fft(struct FftPlan *plan, double *real, double *imag, int inverse)
+{
+    if (!plan->chirp_real)
+    {
+        run_radix2_fft(plan, real, imag, inverse);
+        return;
+    }
+    // Bluestein: j*k = (j^2 + k^2 - (k - j)^2) / 2 turns the transform into a convolution with the chirp, which the radix-2 FFT can do.
+    // The inverse transform is the forward transform of the conjugate, conjugated.
+    int size = plan->size;
+    int padded_size = plan->padded_size;
+    double imag_sign = inverse ? -1.0 : 1.0;
+    double *work_real = plan->work_real;
+    double *work_imag = plan->work_imag;
+    for (int index = 0; index < size; index++)
+    {
+        double value_imag = imag_sign * imag[index];
+        work_real[index] = real[index] * plan->chirp_real[index] - value_imag * plan->chirp_imag[index];
+        work_imag[index] = real[index] * plan->chirp_imag[index] + value_imag * plan->chirp_real[index];
+    }
+    memset(&work_real[size], 0, sizeof(double) * (padded_size - size));
+    memset(&work_imag[size], 0, sizeof(double) * (padded_size - size));
+    run_radix2_fft(plan, work_real, work_imag, 0);
+    for (int index = 0; index < padded_size; index++)
+    {
+        double product_real = work_real[index] * plan->chirp_filter_real[index] - work_imag[index] * plan->chirp_filter_imag[index];
+        double product_imag = work_real[index] * plan->chirp_filter_imag[index] + work_imag[index] * plan->chirp_filter_real[index];
+        work_real[index] = product_real;
+        work_imag[index] = product_imag;
+    }
+    run_radix2_fft(plan, work_real, work_imag, 1);
+    double scale = 1.0 / padded_size;
+    for (int index = 0; index < size; index++)
+    {
+        double convolved_real = work_real[index] * scale;
+        double convolved_imag = work_imag[index] * scale;
+        real[index] = convolved_real * plan->chirp_real[index] - convolved_imag * plan->chirp_imag[index];
+        imag[index] = imag_sign * (convolved_real * plan->chirp_imag[index] + convolved_imag * plan->chirp_real[index]);
+    }
+}
+
+/**
+ * @brief Solve C * X = B for a circulant matrix C. The FFT diagonalizes every circulant matrix: its eigenvalues are the FFT of its first column,
+ *        so X = IFFT(FFT(B) / FFT(c)), one O(n log n) transform pair per right-hand side.
+ *
+ * @param first_col: double[ptr]
+ *      The first column of C (C[i][j] = first_col[(i - j) mod size]).
+ * @param size: int
+ *      The number of rows (and columns) of C.
+ * @param rhs: double[ptr]
+ *      The right-hand sides on entry, and the solutions on return.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param determinant: double[ptr]
+ *      Receives the determinant of C, the product of its eigenvalues.
+ *
+ * @return solved: int
+ *      1 on success, 0 if C is singular (an eigenvalue is 0 next to the largest) or the FFT could not be allocated.
+ */
+static int solve_circulant_fft(const double *first_col, int size, double *rhs, int rhs_leading_dimension, int num_rhs, double *determinant)
+{
+    struct FftPlan *plan = create_fft_plan(size);
+    double *eigen_real = (double *)malloc(sizeof(double) * size);
+    double *eigen_imag = (double *)calloc(size, sizeof(double));
+    double *values_real = (double *)malloc(sizeof(double) * size);
+    double *values_imag = (double *)malloc(sizeof(double) * size);
+    int solved = plan && eigen_real && eigen_imag && values_real && values_imag;
+    if (solved)
+    {
+        memcpy(eigen_real, first_col, sizeof(double) * size);
+        run_fft(plan, eigen_real, eigen_imag, 0);
+        double largest_magnitude = 0.0;
+        double determinant_real = 1.0;
+        double determinant_imag = 0.0;
+        for (int index = 0; index < size; index++)
+        {
+            double magnitude = hypot(eigen_real[index], eigen_imag[index]);
+            largest_magnitude = (magnitude > largest_magnitude) ? magnitude : largest_magnitude;
+            double product_real = determinant_real * eigen_real[index] - determinant_imag * eigen_imag[index];
+            determinant_imag = determinant_real * eigen_imag[index] + determinant_imag * eigen_real[index];
+            determinant_real = product_real;
+        }
+        // The eigenvalues of a real matrix come in conjugate pairs, so the imaginary part of their product is only rounding error
+        *determinant = determinant_real;
+        for (int index = 0; index < size && solved; index++)
+        {
+            solved = hypot(eigen_real[index], eigen_imag[index]) > CIRCULANT_SINGULAR_TOLERANCE * largest_magnitude;
+        }
+    }
+    for (int col = 0; col < num_rhs && solved; col++)
+    {
+        for (int row = 0; row < size; row++)
+        {
+            values_real[row] = rhs[(int64_t)row * rhs_leading_dimension + col];
+            values_imag[row] = 0.0;
+        }
+        run_fft(plan, values_real, values_imag, 0);
+        for (int index = 0; index < size; index++)
+        {
+            // Divide by the eigenvalue, as a complex number
+            double denominator = eigen_real[index] * eigen_real[index] + eigen_imag[index] * eigen_imag[index];
+            double quotient_real = (values_real[index] * eigen_real[index] + values_imag[index] * eigen_imag[index]) / denominator;
+            double quotient_imag = (values_imag[index] * eigen_real[index] - values_real[index] * eigen_imag[index]) / denominator;
+            values_real[index] = quotient_real;
+            values_imag[index] = quotient_imag;
+        }
+        run_fft(plan, values_real, values_imag, 1);
+        for (int row = 0; row < size; row++)
+        {
+            rhs[(int64_t)row * rhs_leading_dimension + col] = values_real[row] / size;
+        }
+    }
+    free(values_imag);
+    free(values_real);
+    free(eigen_imag);
+    free(eigen_real);
+    destroy_fft_plan(plan);
+    return solved;
+}
+
+/**
+ * @brief Solve T * X = B for a Toeplitz matrix T with the Levinson recursion, in O(n^2) per right-hand side (plus O(n^2) once).
+ *        Step k grows the solutions of the leading k x k system by one row, using the forward and backward vectors f and b of that system
+ *        (T_k * f = e_1 and T_k * b = e_k), which grow the same way. There is no pivoting, so the recursion needs every leading principal minor
+ *        to be nonsingular; it reports a breakdown when one is not, and the caller should check the residual, as ill-conditioned minors lose accuracy.
+ *
+ * @param first_col: double[ptr]
+ *      The first column of T (T[i][0]).
+ * @param first_row: double[ptr]
+ *      The first row of T (T[0][j]). Its first value must equal that of first_col.
+ * @param size: int
+ *      The number of rows (and columns) of T.
+ * @param rhs: double[ptr]
+ *      The right-hand sides on entry, and the solutions on return.
+ * @param rhs_leading_dimension: int
+ *      The distance between the starts of two rows of rhs.
+ * @param num_rhs: int
+ *      The number of right-hand sides.
+ * @param determinant: double[ptr]
+ *      Receives the determinant of T: det(T_(k+1)) = det(T_k) / f_0 after step k, as the lower right k x k block of T_(k+1) is T_k again.
+ *
+ * @return solved: int
+ *      1 on success, 0 if the recursion broke down or its scratch space could not be allocated.
+ */
+static int solve_toeplitz_levinson(const double *first_col, const double *first_row, int size, double *rhs, int rhs_leading_dimension, int num_rhs, double *determinant)
+{
+    double *forward = (double *)malloc(sizeof(double) * size);
+    double *backward = (double *)malloc(sizeof(double) * size);
+    double *rhs_errors = (double *)malloc(sizeof(double) * num_rhs);
+    if (!forward || !backward || !rhs_errors || first_col[0] == 0.0)
+    {
+        free(rhs_errors);
+        free(backward);
+        free(forward);
+        return 0;
+    }
+    forward[0] = 1.0 / first_col[0];
+    backward[0] = forward[0];
+    *determinant = first_col[0];
+    for (int col = 0; col < num_rhs; col++)
+    {
+        rhs[col] *= forward[0];
+    }
+    for (int step = 1; step < size; step++)
+    {
+        // How far [f; 0] and [0; b] are from being solutions of the bigger system: the last row of T_(k+1) * [f; 0] and the first of T_(k+1) * [0; b]
+        double forward_error = 0.0;
+        double backward_error = 0.0;
+        for (int index = 0; index < step; index++)
+        {
+            forward_error += first_col[step - index] * forward[index];
+            backward_error += first_row[index + 1] * backward[index];
+        }
+        double denominator = 1.0 - forward_error * backward_error;
+        if (denominator == 0.0 || !isfinite(denominator))
+        {
+            free(rhs_errors);
+            free(backward);
+            free(forward);
+            return 0;
+        }
+        double inverse_denominator = 1.0 / denominator;
+        // Going backwards, backward[index - 1] has not been overwritten yet when it is needed
+        for (int index = step; index >= 0; index--)
+        {
+            double forward_value = (index < step) ? forward[index] : 0.0;
+            double backward_value = (index > 0) ? backward[index - 1] : 0.0;
+            forward[index] = (forward_value - forward_error * backward_value) * inverse_denominator;
+            backward[index] = (backward_value - backward_error * forward_value) * inverse_denominator;
+        }
+        *determinant /= forward[0];
+
+        // The rows of rhs above step hold the solutions so far, and row step still holds its right-hand sides
+        double *step_row = &rhs[(int64_t)step * rhs_leading_dimension];
+        memcpy(rhs_errors, step_row, sizeof(double) * num_rhs);
+        for (int index = 0; index < step; index++)
+        {
+            const double *solution_row = &rhs[(int64_t)index * rhs_leading_dimension];
+            double coefficient = first_col[step - index];
+            for (int col = 0; col < num_rhs; col++)
+            {
+                rhs_errors[col] -= coefficient * solution_row[col];
+            }
+        }
+        for (int index = 0; index < step; index++)
+        {
+            double *solution_row = &rhs[(int64_t)index * rhs_leading_dimension];
+            double coefficient = backward[index];
+            for (int col = 0; col < num_rhs; col++)
+            {
+                solution_row[col] += rhs_errors[col] * coefficient;
+            }
+        }
+        for (int col = 0; col < num_rhs; col++)
+        {
+            step_row[col] = rhs_errors[col] * backward[step];
+        }
+    }
+    free(rhs_errors);
+    free(backward);
+    free(forward);
+    return 1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#ifndef TRANSPOSE_C
+#define TRANSPOSE_C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ThreadPool.c"
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRANSPOSE_BLOCK 4
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRANSPOSE_USE_SSE2
+#define TRANSPOSE_BLOCK 2
+#else
+#define TRANSPOSE_BLOCK 1
+#endif
+
+/**
+ * Transposes of row-major matrices with leading dimensions.
+ *
+ * The out-of-place transpose walks the matrix in TRANSPOSE_TILE x TRANSPOSE_TILE tiles, so the rows it reads and the rows it writes both stay in
+ * cache, and transposes every tile TRANSPOSE_BLOCK x TRANSPOSE_BLOCK values at a time in registers (4x4 with AVX, 2x2 with SSE2). Square matrices
+ * are transposed in place by swapping mirrored blocks; other shapes are transposed in place by following the cycles of the permutation.
+ */
+
+// The side of the tiles. A tile of the source and one of the destination fit in L1 together.
+#define TRANSPOSE_TILE 32
+// Transposes with fewer values than this run on the calling thread.
+#define TRANSPOSE_MIN_PARALLEL_VALUES 262144
+
+/**
+ * @brief Transpose one TRANSPOSE_BLOCK x TRANSPOSE_BLOCK block from source into destination.
+ */
+static inline void transpose_block(const double *source, int source_leading_dimension, double *destination, int destination_leading_dimension)
+{
+#if defined(__AVX__)
+    __m256d row_0 = _mm256_loadu_pd(source);
+    __m256d row_1 = _mm256_loadu_pd(source + source_leading_dimension);
+    __m256d row_2 = _mm256_loadu_pd(source + 2 * (int64_t)source_leading_dimension);
+    __m256d row_3 = _mm256_loadu_pd(source + 3 * (int64_t)source_leading_dimension);
+    // Interleave pairs of rows, then swap the 128-bit halves across the pairs
+    __m256d even_01 = _mm256_unpacklo_pd(row_0, row_1);
+    __m256d odd_01 = _mm256_unpackhi_pd(row_0, row_1);
+    __m256d even_23 = _mm256_unpacklo_pd(row_2, row_3);
+    __m256d odd_23 = _mm256_unpackhi_pd(row_2, row_3);
+    _mm256_storeu_pd(destination, _mm256_permute2f128_pd(even_01, even_23, 0x20));
+    _mm256_storeu_pd(destination + destination_leading_dimension, _mm256_permute2f128_pd(odd_01, odd_23, 0x20));
+    _mm256_storeu_pd(destination + 2 * (int64_t)destination_leading_dimension, _mm256_permute2f128_pd(even_01, even_23, 0x31));
+    _mm256_storeu_pd(destination + 3 * (int64_t)destination_leading_dimension, _mm256_permute2f128_pd(odd_01, odd_23, 0x31));
+#elif defined(TRANSPOSE_USE_SSE2)
+    __m128d row_0 = _mm_loadu_pd(source);
+    __m128d row_1 = _mm_loadu_pd(source + source_leading_dimension);
+    _mm_storeu_pd(destination, _mm_unpacklo_pd(row_0, row_1));
+    _mm_storeu_pd(destination + destination_leading_dimension, _mm_unpackhi_pd(row_0, row_1));
+#else
+    (void)source_leading_dimension;
+    (void)destination_leading_dimension;
+    destination[0] = source[0];
+#endif
+}
+
+/**
+ * @brief Transpose a num_rows x num_cols tile of source into destination, one block at a time. The edges that do not fill a block are copied one value at a time.
+ */
+static void transpose_tile(const double *source, int source_leading_dimension, int num_rows, int num_cols, double *destination, int destination_leading_dimension)
+{
+    int num_block_rows = num_rows - num_rows % TRANSPOSE_BLOCK;
+    int num_block_cols = num_cols - num_cols % TRANSPOSE_BLOCK;
+    for (int row = 0; row < num_block_rows; row += TRANSPOSE_BLOCK)
+    {
+        for (int col = 0; col < num_block_cols; col += TRANSPOSE_BLOCK)
+        {
+            transpose_block(&source[(int64_t)row * source_leading_dimension + col], source_leading_dimension, &destination[(int64_t)col * destination_leading_dimension + row], destination_leading_dimension);
+        }
+        for (int col = num_block_cols; col < num_cols; col++)
+        {
+            for (int block_row = row; block_row < row + TRANSPOSE_BLOCK; block_row++)
+            {
+                destination[(int64_t)col * destination_leading_dimension + block_row] = source[(int64_t)block_row * source_leading_dimension + col];
+            }
+        }
+    }
+    for (int row = num_block_rows; row < num_rows; row++)
+    {
+        for (int col = 0; col < num_cols; col++)
+        {
+            destination[(int64_t)col * destination_leading_dimension + row] = source[(int64_t)row * source_leading_dimension + col];
+        }
+    }
+}
+
+/**
+ * @brief An out-of-place transpose, split across threads by rows of tiles.
+ *
+ * @param source: double[ptr]
+ *      The matrix to transpose.
+ * @param destination: double[ptr]
+ *      Receives the transpose.
+ * @param source_leading_dimension: int
+ *      The distance between the starts of two rows of source.
+ * @param destination_leading_dimension: int
+ *      The distance between the starts of two rows of destination.
+ * @param num_rows: int
+ *      The number of rows of source.
+ * @param num_cols: int
+ *      The number of columns of source.
+ * @param num_tasks: int
+ *      The number of parts the rows of tiles are split into.
+ */
+struct Transpose
+{
+    const double *source;
+    double *destination;
+    int source_leading_dimension;
+    int destination_leading_dimension;
+    int num_rows;
+    int num_cols;
+    int num_tasks;
+};
+
+/**
+ * @brief One part of an out-of-place transpose.
+ */
+static void transpose_tile_rows(void *context, int task_index)
+{
+    struct Transpose *transpose = (struct Transpose *)context;
+    int num_tile_rows = (transpose->num_rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    int first_tile_row = (int)(((int64_t)num_tile_rows * task_index) / transpose->num_tasks);
+    int end_tile_row = (int)(((int64_t)num_tile_rows * (task_index + 1)) / transpose->num_tasks);
+    for (int row = first_tile_row * TRANSPOSE_TILE; row < transpose->num_rows && row < end_tile_row * TRANSPOSE_TILE; row += TRANSPOSE_TILE)
+    {
+        int tile_rows = (transpose->num_rows - row < TRANSPOSE_TILE) ? (transpose->num_rows - row) : TRANSPOSE_TILE;
+        for (int col = 0; col < transpose->num_cols; col += TRANSPOSE_TILE)
+        {
+            int tile_cols = (transpose->num_cols - col < TRANSPOSE_TILE) ? (transpose->num_cols - col) : TRANSPOSE_TILE;
+            transpose_tile(&transpose->source[(int64_t)row * transpose->source_leading_dimension + col], transpose->source_leading_dimension, tile_rows, tile_cols,
+                           &transpose->destination[(int64_t)col * transpose->destination_leading_dimension + row], transpose->destination_leading_dimension);
+        }
+    }
+}
+
+/**
+ * @brief Transpose a matrix into another buffer, tile by tile.
+ *
+ * @param source: double[ptr]
+ *      The num_rows x num_cols matrix to transpose. Must not overlap destination.
+ * @param num_rows: int
+ *      The number of rows of source.
+ * @param num_cols: int
+ *      The number of columns of source.
+ * @param source_leading_dimension: int
+ *      The distance between the starts of two rows of source.
+ * @param destination: double[ptr]
+ *      Receives the num_cols x num_rows transpose.
+ * @param destination_leading_dimension: int
+ *      The distance between the starts of two rows of destination.
+ * @param num_threads: int
+ *      The most threads to use.
+ *
+ * @return None
+ */
+static void transpose_matrix_blocked(const double *source, int num_rows, int num_cols, int source_leading_dimension, double *destination, int destination_leading_dimension, int num_threads)
+{
+    struct Transpose transpose = {source, destination, source_leading_dimension, destination_leading_dimension, num_rows, num_cols, 1};
+    if ((int64_t)num_rows * num_cols >= TRANSPOSE_MIN_PARALLEL_VALUES)
+    {
+        int num_tile_rows = (num_rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+        transpose.num_tasks = (num_threads < num_tile_rows) ? num_threads : num_tile_rows;
+        transpose.num_tasks = (transpose.num_tasks < 1) ? 1 : transpose.num_tasks;
+    }
+    parallel_for(transpose.num_tasks, transpose_tile_rows, &transpose);
+}
+
+/**
+ * @brief Exchange two blocks of a square matrix with each other's transpose. Both blocks are loaded before either is stored, so a block on the
+ *        diagonal (upper == lower) is transposed in place.
+ */
+static inline void swap_transposed_blocks(double *upper, double *lower, int leading_dimension)
+{
+    double upper_values[TRANSPOSE_BLOCK * TRANSPOSE_BLOCK];
+    transpose_block(upper, leading_dimension, upper_values, TRANSPOSE_BLOCK);
+    transpose_block(lower, leading_dimension, upper, leading_dimension);
+    for (int row = 0; row < TRANSPOSE_BLOCK; row++)
+    {
+        memcpy(&lower[(int64_t)row * leading_dimension], &upper_values[row * TRANSPOSE_BLOCK], sizeof(double) * TRANSPOSE_BLOCK);
+    }
+}
+
+/**
+ * @brief A square in-place transpose, split across threads by rows of tiles. Each row of tiles swaps the tiles right of the diagonal with their
+ *        mirrors below it, so no two rows of tiles touch the same tile.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to transpose.
+ * @param size: int
+ *      The number of rows (and columns) of matrix.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ * @param num_tasks: int
+ *      The number of parts. Rows of tiles are dealt to them in turn, since the rows near the top have the most tiles.
+ */
+struct SquareTranspose
+{
+    double *matrix;
+    int size;
+    int leading_dimension;
+    int num_tasks;
+};
+
+/**
+ * @brief One row of tiles of a square in-place transpose.
+ */
+static void transpose_square_tile_row(const struct SquareTranspose *transpose, int tile_row)
+{
+    int leading_dimension = transpose->leading_dimension;
+    // The last size % TRANSPOSE_BLOCK rows and columns are left to the caller
+    int block_size = transpose->size - transpose->size % TRANSPOSE_BLOCK;
+    int first_row = tile_row * TRANSPOSE_TILE;
+    int end_row = (first_row + TRANSPOSE_TILE < block_size) ? first_row + TRANSPOSE_TILE : block_size;
+    for (int first_col = first_row; first_col < block_size; first_col += TRANSPOSE_TILE)
+    {
+        int end_col = (first_col + TRANSPOSE_TILE < block_size) ? first_col + TRANSPOSE_TILE : block_size;
+        for (int row = first_row; row < end_row; row += TRANSPOSE_BLOCK)
+        {
+            for (int col = (first_col == first_row) ? row : first_col; col < end_col; col += TRANSPOSE_BLOCK)
+            {
+                swap_transposed_blocks(&transpose->matrix[(int64_t)row * leading_dimension + col], &transpose->matrix[(int64_t)col * leading_dimension + row], leading_dimension);
+            }
+        }
+    }
+}
+
+/**
+ * @brief One part of a square in-place transpose.
+ */
+static void transpose_square_tile_rows(void *context, int task_index)
+{
+    struct SquareTranspose *transpose = (struct SquareTranspose *)context;
+    int num_tile_rows = (transpose->size - transpose->size % TRANSPOSE_BLOCK + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    for (int tile_row = task_index; tile_row < num_tile_rows; tile_row += transpose->num_tasks)
+    {
+        transpose_square_tile_row(transpose, tile_row);
+    }
+}
+
+/**
+ * @brief Transpose a matrix in place. A square matrix may have any leading dimension and is transposed by swapping mirrored blocks. Any other
+ *        matrix must be packed (leading_dimension == num_cols), and becomes a packed num_cols x num_rows matrix: every value is moved along the
+ *        cycles of the permutation, with one bit per value to mark the values that have been moved.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to transpose.
+ * @param num_rows: int
+ *      The number of rows of matrix.
+ * @param num_cols: int
+ *      The number of columns of matrix.
+ * @param leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ * @param num_threads: int
+ *      The most threads to use (square matrices only).
+ *
+ * @return is_transposed: int
+ *      1 if matrix was transposed. 0 if it is neither square nor packed, or the bits could not be allocated.
+ */
+static int transpose_matrix_in_place(double *matrix, int num_rows, int num_cols, int leading_dimension, int num_threads)
+{
+    if (num_rows == num_cols)
+    {
+        int size = num_rows;
+        int num_tile_rows = (size - size % TRANSPOSE_BLOCK + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+        struct SquareTranspose transpose = {matrix, size, leading_dimension, 1};
+        if ((int64_t)size * size >= TRANSPOSE_MIN_PARALLEL_VALUES)
+        {
+            transpose.num_tasks = (num_threads < num_tile_rows) ? num_threads : num_tile_rows;
+            transpose.num_tasks = (transpose.num_tasks < 1) ? 1 : transpose.num_tasks;
+        }
+        parallel_for(transpose.num_tasks, transpose_square_tile_rows, &transpose);
+        for (int row = size - size % TRANSPOSE_BLOCK; row < size; row++)
+        {
+            for (int col = 0; col < row; col++)
+            {
+                double value = matrix[(int64_t)row * leading_dimension + col];
+                matrix[(int64_t)row * leading_dimension + col] = matrix[(int64_t)col * leading_dimension + row];
+                matrix[(int64_t)col * leading_dimension + row] = value;
+            }
+        }
+        return 1;
+    }
+    if (leading_dimension != num_cols)
+    {
+        return 0;
+    }
+    int64_t num_values = (int64_t)num_rows * num_cols;
+    unsigned char *is_moved = (unsigned char *)calloc((size_t)((num_values + 7) / 8), 1);
+    if (!is_moved)
+    {
+        return 0;
+    }
+    // The first and last values never move
+    for (int64_t start = 1; start < num_values - 1; start++)
+    {
+        if (is_moved[start >> 3] & (1 << (start & 7)))
+        {
+            continue;
+        }
+        double carried_value = matrix[start];
+        int64_t index = start;
+        do
+        {
+            // The value at (row, col) of the num_rows x num_cols matrix goes to (col, row) of the num_cols x num_rows one
+            int64_t next_index = (index % num_cols) * num_rows + index / num_cols;
+            double next_value = matrix[next_index];
+            matrix[next_index] = carried_value;
+            carried_value = next_value;
+            is_moved[next_index >> 3] |= (unsigned char)(1 << (next_index & 7));
+            index = next_index;
+        } while (index != start);
+    }
+    free(is_moved);
+    return 1;
+}
+
+#endif
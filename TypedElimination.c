@@ -0,0 +1,323 @@
+/**
+ * The type-generic row reduction, instantiated once per element type by TypedKernels.c, which defines these before each #include:
+ *  TYPED_NAME(name)        The name of a function or struct for this type (e.g., name##_float32).
+ *  TYPED_REAL              The real type the values are made of (float or double).
+ *  TYPED_IS_COMPLEX        1 if every value is a (real, imaginary) pair of TYPED_REAL, 0 if it is a single TYPED_REAL.
+ *  TYPED_EPSILON           The machine epsilon of TYPED_REAL.
+ *  TYPED_VECTOR            A SIMD vector of TYPED_LANES reals (TYPED_LANES is 1 when there is no SIMD), and TYPED_SIMD(operation), which names
+ *                          its LOAD, STORE, SET1, ADD, SUB, MUL and SWAP_PAIRS (swap the reals of every pair) operations.
+ *
+ * NOTE: This file deliberately has no include guard, and #undefs all of the above at the end.
+ */
+
+// The number of reals in a value
+#define TYPED_WIDTH (1 + TYPED_IS_COMPLEX)
+
+#if TYPED_IS_COMPLEX && TYPED_LANES > 1
+// Multiplying the swapped pairs (d, c) of a vector of values by these gives (-d, c), the part of (c + di) that the imaginary part of a factor scales
+static const TYPED_REAL TYPED_NAME(alternating_signs)[8] = {-1, 1, -1, 1, -1, 1, -1, 1};
+#endif
+
+/**
+ * @brief The magnitude used to pick pivots: |x| for real values, |re(x)| + |im(x)| for complex ones (which is cheaper than the modulus, and
+ *        never off from it by more than a factor of sqrt(2)).
+ */
+static inline double TYPED_NAME(get_magnitude)(const TYPED_REAL *value)
+{
+#if TYPED_IS_COMPLEX
+    return fabs((double)value[0]) + fabs((double)value[1]);
+#else
+    return fabs((double)value[0]);
+#endif
+}
+
+/**
+ * @brief row[0, num_values) = row[0, num_values) - factor * source[0, num_values), SIMD across the reals of the rows.
+ *
+ * @param row: TYPED_REAL[ptr]
+ *      The values to subtract from.
+ * @param source: TYPED_REAL[ptr]
+ *      The values to subtract a multiple of.
+ * @param num_values: int
+ *      The number of values (not reals) in both.
+ * @param factor_real: TYPED_REAL
+ *      The real part of the factor.
+ * @param factor_imag: TYPED_REAL
+ *      The imaginary part of the factor. Ignored for real values.
+ *
+ * @return None
+ */
+static inline void TYPED_NAME(subtract_scaled_row)(TYPED_REAL *row, const TYPED_REAL *source, int num_values, TYPED_REAL factor_real, TYPED_REAL factor_imag)
+{
+    int num_reals = num_values * TYPED_WIDTH;
+    int index = 0;
+#if TYPED_LANES > 1
+    TYPED_VECTOR real_factor = TYPED_SIMD(SET1)(factor_real);
+#if TYPED_IS_COMPLEX
+    // (a + bi)(c + di) = a * (c, d) + b * (-d, c)
+    TYPED_VECTOR imag_factor = TYPED_SIMD(MUL)(TYPED_SIMD(SET1)(factor_imag), TYPED_SIMD(LOAD)(TYPED_NAME(alternating_signs)));
+#endif
+    for (; index + TYPED_LANES <= num_reals; index += TYPED_LANES)
+    {
+        TYPED_VECTOR source_values = TYPED_SIMD(LOAD)(&source[index]);
+        TYPED_VECTOR product = TYPED_SIMD(MUL)(real_factor, source_values);
+#if TYPED_IS_COMPLEX
+        product = TYPED_SIMD(ADD)(product, TYPED_SIMD(MUL)(imag_factor, TYPED_SIMD(SWAP_PAIRS)(source_values)));
+#endif
+        TYPED_SIMD(STORE)(&row[index], TYPED_SIMD(SUB)(TYPED_SIMD(LOAD)(&row[index]), product));
+    }
+#endif
+    for (; index < num_reals; index += TYPED_WIDTH)
+    {
+#if TYPED_IS_COMPLEX
+        TYPED_REAL source_real = source[index];
+        TYPED_REAL source_imag = source[index + 1];
+        row[index] -= factor_real * source_real - factor_imag * source_imag;
+        row[index + 1] -= factor_real * source_imag + factor_imag * source_real;
+#else
+        (void)factor_imag;
+        row[index] -= factor_real * source[index];
+#endif
+    }
+}
+
+/**
+ * @brief row[0, num_values) = factor * row[0, num_values).
+ */
+static inline void TYPED_NAME(scale_row)(TYPED_REAL *row, int num_values, double factor_real, double factor_imag)
+{
+    for (int index = 0; index < num_values * TYPED_WIDTH; index += TYPED_WIDTH)
+    {
+#if TYPED_IS_COMPLEX
+        double row_real = row[index];
+        double row_imag = row[index + 1];
+        row[index] = (TYPED_REAL)(factor_real * row_real - factor_imag * row_imag);
+        row[index + 1] = (TYPED_REAL)(factor_real * row_imag + factor_imag * row_real);
+#else
+        (void)factor_imag;
+        row[index] = (TYPED_REAL)(factor_real * row[index]);
+#endif
+    }
+}
+
+/**
+ * @brief The rows that one pivot row is subtracted from, split across threads.
+ *
+ * @param augmented: TYPED_REAL[ptr]
+ *      The augmented matrix.
+ * @param row_length: int64_t
+ *      The number of reals in a row of augmented.
+ * @param pivot_values: TYPED_REAL[ptr]
+ *      The pivot row, from the pivot column on.
+ * @param pivot_col: int
+ *      The pivot column.
+ * @param num_values: int
+ *      The number of values from the pivot column to the end of a row.
+ * @param inverse_real: double
+ *      The real part of 1 / pivot.
+ * @param inverse_imag: double
+ *      The imaginary part of 1 / pivot.
+ * @param first_row: int
+ *      The first row to eliminate the pivot column from.
+ * @param end_row: int
+ *      One past the last row to eliminate the pivot column from.
+ * @param num_tasks: int
+ *      The number of parts the rows are split into.
+ */
+struct TYPED_NAME(TypedEliminationStep)
+{
+    TYPED_REAL *augmented;
+    int64_t row_length;
+    const TYPED_REAL *pivot_values;
+    int pivot_col;
+    int num_values;
+    double inverse_real;
+    double inverse_imag;
+    int first_row;
+    int end_row;
+    int num_tasks;
+};
+
+/**
+ * @brief One part of an elimination step: zero the pivot column of its rows by subtracting multiples of the pivot row.
+ */
+static void TYPED_NAME(eliminate_typed_rows)(void *context, int task_index)
+{
+    struct TYPED_NAME(TypedEliminationStep) *step = (struct TYPED_NAME(TypedEliminationStep) *)context;
+    int num_rows = step->end_row - step->first_row;
+    int first_row = step->first_row + (int)(((int64_t)num_rows * task_index) / step->num_tasks);
+    int end_row = step->first_row + (int)(((int64_t)num_rows * (task_index + 1)) / step->num_tasks);
+    for (int row = first_row; row < end_row; row++)
+    {
+        TYPED_REAL *row_values = &step->augmented[row * step->row_length + (int64_t)step->pivot_col * TYPED_WIDTH];
+#if TYPED_IS_COMPLEX
+        double factor_real = row_values[0] * step->inverse_real - row_values[1] * step->inverse_imag;
+        double factor_imag = row_values[0] * step->inverse_imag + row_values[1] * step->inverse_real;
+#else
+        double factor_real = row_values[0] * step->inverse_real;
+        double factor_imag = 0.0;
+#endif
+        if (factor_real == 0.0 && factor_imag == 0.0)
+        {
+            continue;
+        }
+        TYPED_NAME(subtract_scaled_row)(row_values, step->pivot_values, step->num_values, (TYPED_REAL)factor_real, (TYPED_REAL)factor_imag);
+        // The pivot column is zero by construction, whatever the rounding
+        row_values[0] = 0;
+#if TYPED_IS_COMPLEX
+        row_values[1] = 0;
+#endif
+    }
+}
+
+/**
+ * @brief Zero the pivot column of rows [first_row, end_row), on several threads if there is enough work.
+ */
+static void TYPED_NAME(eliminate_typed_column)(struct TYPED_NAME(TypedEliminationStep) *step, int num_threads)
+{
+    int64_t work = (int64_t)(step->end_row - step->first_row) * step->num_values * TYPED_WIDTH;
+    step->num_tasks = 1;
+    if (work >= TYPED_MIN_PARALLEL_WORK)
+    {
+        step->num_tasks = (num_threads < step->end_row - step->first_row) ? num_threads : step->end_row - step->first_row;
+        step->num_tasks = (step->num_tasks < 1) ? 1 : step->num_tasks;
+    }
+    parallel_for(step->num_tasks, TYPED_NAME(eliminate_typed_rows), step);
+}
+
+/**
+ * @brief Reduce a packed augmented matrix [A | B] in place to reduced row echelon form with partial pivoting, or only to row echelon form, which
+ *        is all the determinant needs. Values whose magnitude is at most max(num_rows, num_cols) * TYPED_EPSILON times the largest in A are treated
+ *        as zero when looking for a pivot, and a column without a pivot is skipped.
+ *
+ * @param augmented: TYPED_REAL[ptr]
+ *      The num_rows x num_total_cols augmented matrix, packed row after row. Its first num_cols columns are A.
+ * @param num_rows: int
+ *      The number of rows.
+ * @param num_cols: int
+ *      The number of columns of A. Pivots are only taken from these.
+ * @param num_total_cols: int
+ *      The number of columns of [A | B].
+ * @param forward_only: int
+ *      1 to stop at row echelon form, 0 to go on to reduced row echelon form.
+ * @param row_permutation: int[ptr]
+ *      Receives, for every row of the result, the input row it came from. Must hold num_rows values.
+ * @param pivot_cols: int[ptr]
+ *      Receives the pivot column of each of the first rank rows. Must hold min(num_rows, num_cols) values.
+ * @param determinant_real: double[ptr]
+ *      Receives the real part of det(A), accumulated in double. 0 if A is singular or not square.
+ * @param determinant_imag: double[ptr]
+ *      Receives the imaginary part of det(A).
+ * @param num_threads: int
+ *      The most threads to use.
+ *
+ * @return rank: int
+ *      The number of pivots, i.e., the rank of A.
+ */
+static int TYPED_NAME(reduce_typed_rows)(TYPED_REAL *augmented, int num_rows, int num_cols, int num_total_cols, int forward_only, int *row_permutation, int *pivot_cols, double *determinant_real, double *determinant_imag, int num_threads)
+{
+    int64_t row_length = (int64_t)num_total_cols * TYPED_WIDTH;
+    double largest_magnitude = 0.0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        row_permutation[row] = row;
+        for (int col = 0; col < num_cols; col++)
+        {
+            largest_magnitude = fmax(largest_magnitude, TYPED_NAME(get_magnitude)(&augmented[row * row_length + (int64_t)col * TYPED_WIDTH]));
+        }
+    }
+    double zero_tolerance = largest_magnitude * ((num_rows > num_cols) ? num_rows : num_cols) * TYPED_EPSILON;
+    double product_real = 1.0;
+    double product_imag = 0.0;
+    int rank = 0;
+    for (int col = 0; col < num_cols && rank < num_rows; col++)
+    {
+        int pivot_row = rank;
+        double pivot_magnitude = -1.0;
+        for (int row = rank; row < num_rows; row++)
+        {
+            double magnitude = TYPED_NAME(get_magnitude)(&augmented[row * row_length + (int64_t)col * TYPED_WIDTH]);
+            if (magnitude > pivot_magnitude)
+            {
+                pivot_magnitude = magnitude;
+                pivot_row = row;
+            }
+        }
+        if (pivot_magnitude <= zero_tolerance)
+        {
+            continue;
+        }
+        if (pivot_row != rank)
+        {
+            // Both rows are zero left of col, so only the rest of them has to move
+            TYPED_REAL *row_one = &augmented[pivot_row * row_length];
+            TYPED_REAL *row_two = &augmented[rank * row_length];
+            for (int64_t index = (int64_t)col * TYPED_WIDTH; index < row_length; index++)
+            {
+                TYPED_REAL value = row_one[index];
+                row_one[index] = row_two[index];
+                row_two[index] = value;
+            }
+            int permuted_row = row_permutation[pivot_row];
+            row_permutation[pivot_row] = row_permutation[rank];
+            row_permutation[rank] = permuted_row;
+            product_real = -product_real;
+            product_imag = -product_imag;
+        }
+        const TYPED_REAL *pivot_value = &augmented[rank * row_length + (int64_t)col * TYPED_WIDTH];
+#if TYPED_IS_COMPLEX
+        double pivot_real = pivot_value[0];
+        double pivot_imag = pivot_value[1];
+#else
+        double pivot_real = pivot_value[0];
+        double pivot_imag = 0.0;
+#endif
+        double next_product_real = product_real * pivot_real - product_imag * pivot_imag;
+        product_imag = product_real * pivot_imag + product_imag * pivot_real;
+        product_real = next_product_real;
+        struct TYPED_NAME(TypedEliminationStep) step = {augmented, row_length, pivot_value, col, num_total_cols - col, 0.0, 0.0, rank + 1, num_rows, 1};
+        invert_typed_value(pivot_real, pivot_imag, &step.inverse_real, &step.inverse_imag);
+        TYPED_NAME(eliminate_typed_column)(&step, num_threads);
+        pivot_cols[rank++] = col;
+    }
+    if (rank < num_cols || num_rows != num_cols)
+    {
+        product_real = 0.0;
+        product_imag = 0.0;
+    }
+    *determinant_real = product_real;
+    *determinant_imag = product_imag;
+    if (forward_only)
+    {
+        return rank;
+    }
+    // Back substitution: scale each pivot to 1, then clear the column above it
+    for (int pivot = rank - 1; pivot >= 0; pivot--)
+    {
+        int col = pivot_cols[pivot];
+        TYPED_REAL *pivot_value = &augmented[pivot * row_length + (int64_t)col * TYPED_WIDTH];
+        double inverse_real, inverse_imag;
+#if TYPED_IS_COMPLEX
+        invert_typed_value(pivot_value[0], pivot_value[1], &inverse_real, &inverse_imag);
+#else
+        invert_typed_value(pivot_value[0], 0.0, &inverse_real, &inverse_imag);
+#endif
+        TYPED_NAME(scale_row)(pivot_value, num_total_cols - col, inverse_real, inverse_imag);
+        pivot_value[0] = 1;
+#if TYPED_IS_COMPLEX
+        pivot_value[1] = 0;
+#endif
+        struct TYPED_NAME(TypedEliminationStep) step = {augmented, row_length, pivot_value, col, num_total_cols - col, 1.0, 0.0, 0, pivot, 1};
+        TYPED_NAME(eliminate_typed_column)(&step, num_threads);
+    }
+    return rank;
+}
+
+#undef TYPED_WIDTH
+#undef TYPED_NAME
+#undef TYPED_REAL
+#undef TYPED_IS_COMPLEX
+#undef TYPED_EPSILON
+#undef TYPED_VECTOR
+#undef TYPED_LANES
+#undef TYPED_SIMD
@@ -0,0 +1,126 @@
+#ifndef TYPED_KERNELS_C
+#define TYPED_KERNELS_C
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include "ThreadPool.c"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TYPED_KERNELS_USE_SSE2
+#endif
+
+/**
+ * Row reduction for float32, float64, complex64 and complex128 matrices.
+ *
+ * TypedElimination.c holds a single implementation of the row operations, written against the TYPED_* macros, and is included here once for
+ * each element type, giving reduce_typed_rows_float32, reduce_typed_rows_float64, reduce_typed_rows_complex64 and reduce_typed_rows_complex128.
+ * Complex values are stored as (real, imaginary) pairs, as in numpy and C99, and the row updates run SIMD across those reals, so a vector holds
+ * twice as many float32 values as float64 ones. The determinant is accumulated in double whatever the element type.
+ */
+
+// Eliminations that touch fewer reals than this run on the calling thread.
+#define TYPED_MIN_PARALLEL_WORK 65536
+
+#if defined(__AVX__)
+#define FLOAT_SIMD_LANES 8
+typedef __m256 FloatSimdVector;
+#define FLOAT_SIMD_LOAD(pointer) _mm256_loadu_ps(pointer)
+#define FLOAT_SIMD_STORE(pointer, vector) _mm256_storeu_ps((pointer), (vector))
+#define FLOAT_SIMD_SET1(value) _mm256_set1_ps(value)
+#define FLOAT_SIMD_ADD(left, right) _mm256_add_ps((left), (right))
+#define FLOAT_SIMD_SUB(left, right) _mm256_sub_ps((left), (right))
+#define FLOAT_SIMD_MUL(left, right) _mm256_mul_ps((left), (right))
+#define FLOAT_SIMD_SWAP_PAIRS(vector) _mm256_permute_ps((vector), 0xB1)
+#define DOUBLE_SIMD_LANES 4
+typedef __m256d DoubleSimdVector;
+#define DOUBLE_SIMD_LOAD(pointer) _mm256_loadu_pd(pointer)
+#define DOUBLE_SIMD_STORE(pointer, vector) _mm256_storeu_pd((pointer), (vector))
+#define DOUBLE_SIMD_SET1(value) _mm256_set1_pd(value)
+#define DOUBLE_SIMD_ADD(left, right) _mm256_add_pd((left), (right))
+#define DOUBLE_SIMD_SUB(left, right) _mm256_sub_pd((left), (right))
+#define DOUBLE_SIMD_MUL(left, right) _mm256_mul_pd((left), (right))
+#define DOUBLE_SIMD_SWAP_PAIRS(vector) _mm256_permute_pd((vector), 0x5)
+#elif defined(TYPED_KERNELS_USE_SSE2)
+#define FLOAT_SIMD_LANES 4
+typedef __m128 FloatSimdVector;
+#define FLOAT_SIMD_LOAD(pointer) _mm_loadu_ps(pointer)
+#define FLOAT_SIMD_STORE(pointer, vector) _mm_storeu_ps((pointer), (vector))
+#define FLOAT_SIMD_SET1(value) _mm_set1_ps(value)
+#define FLOAT_SIMD_ADD(left, right) _mm_add_ps((left), (right))
+#define FLOAT_SIMD_SUB(left, right) _mm_sub_ps((left), (right))
+#define FLOAT_SIMD_MUL(left, right) _mm_mul_ps((left), (right))
+#define FLOAT_SIMD_SWAP_PAIRS(vector) _mm_shuffle_ps((vector), (vector), 0xB1)
+#define DOUBLE_SIMD_LANES 2
+typedef __m128d DoubleSimdVector;
+#define DOUBLE_SIMD_LOAD(pointer) _mm_loadu_pd(pointer)
+#define DOUBLE_SIMD_STORE(pointer, vector) _mm_storeu_pd((pointer), (vector))
+#define DOUBLE_SIMD_SET1(value) _mm_set1_pd(value)
+#define DOUBLE_SIMD_ADD(left, right) _mm_add_pd((left), (right))
+#define DOUBLE_SIMD_SUB(left, right) _mm_sub_pd((left), (right))
+#define DOUBLE_SIMD_MUL(left, right) _mm_mul_pd((left), (right))
+#define DOUBLE_SIMD_SWAP_PAIRS(vector) _mm_shuffle_pd((vector), (vector), 1)
+#else
+#define FLOAT_SIMD_LANES 1
+typedef float FloatSimdVector;
+#define DOUBLE_SIMD_LANES 1
+typedef double DoubleSimdVector;
+#endif
+
+/**
+ * @brief 1 / (real + imag i), computed in double. Both parts are scaled by their magnitude first, so squaring them cannot overflow.
+ */
+static inline void invert_typed_value(double real, double imag, double *inverse_real, double *inverse_imag)
+{
+    if (imag == 0.0)
+    {
+        *inverse_real = 1.0 / real;
+        *inverse_imag = 0.0;
+        return;
+    }
+    double scale = fabs(real) + fabs(imag);
+    double scaled_real = real / scale;
+    double scaled_imag = imag / scale;
+    double denominator = scale * (scaled_real * scaled_real + scaled_imag * scaled_imag);
+    *inverse_real = scaled_real / denominator;
+    *inverse_imag = -scaled_imag / denominator;
+}
+
+#define TYPED_NAME(name) name##_float32
+#define TYPED_REAL float
+#define TYPED_IS_COMPLEX 0
+#define TYPED_EPSILON FLT_EPSILON
+#define TYPED_VECTOR FloatSimdVector
+#define TYPED_LANES FLOAT_SIMD_LANES
+#define TYPED_SIMD(operation) FLOAT_SIMD_##operation
+#include "TypedElimination.c"
+
+#define TYPED_NAME(name) name##_float64
+#define TYPED_REAL double
+#define TYPED_IS_COMPLEX 0
+#define TYPED_EPSILON DBL_EPSILON
+#define TYPED_VECTOR DoubleSimdVector
+#define TYPED_LANES DOUBLE_SIMD_LANES
+#define TYPED_SIMD(operation) DOUBLE_SIMD_##operation
+#include "TypedElimination.c"
+
+#define TYPED_NAME(name) name##_complex64
+#define TYPED_REAL float
+#define TYPED_IS_COMPLEX 1
+#define TYPED_EPSILON FLT_EPSILON
+#define TYPED_VECTOR FloatSimdVector
+#define TYPED_LANES FLOAT_SIMD_LANES
+#define TYPED_SIMD(operation) FLOAT_SIMD_##operation
+#include "TypedElimination.c"
+
+#define TYPED_NAME(name) name##_complex128
+#define TYPED_REAL double
+#define TYPED_IS_COMPLEX 1
+#define TYPED_EPSILON DBL_EPSILON
+#define TYPED_VECTOR DoubleSimdVector
+#define TYPED_LANES DOUBLE_SIMD_LANES
+#define TYPED_SIMD(operation) DOUBLE_SIMD_##operation
+#include "TypedElimination.c"
+
+#endif
@@ -0,0 +1,386 @@
+#ifndef WORKSPACE_POOL_C
+#define WORKSPACE_POOL_C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ThreadPool.c"
+#include "AlignedMemory.c"
+
+/**
+ * A per-thread pool of solver temporaries (augmented matrices, workspaces, permutation and pivot vectors), for callers that do not pass in a
+ * workspace of their own. Blocks are rounded up to a power of two, and a freed block is kept by the thread that freed it, in the list of its
+ * size class, for the next solve on that thread to take instead of allocating. As a pool belongs to one thread, taking and returning blocks
+ * needs no locks. The blocks a thread holds are freed by trim_workspace_pool, or when the thread exits.
+ *
+ * Blocks of at least workspace_huge_page_min_bytes are mapped in huge pages (map_huge_pages), and when is_workspace_first_touch_enabled is set,
+ * a new one is first written by the thread pool, a band of huge pages per thread, so its pages are spread over the NUMA nodes the pool's threads
+ * run on (see pin_thread_pool_workers) instead of all landing on the node of the thread that allocated it. Both are set at runtime through
+ * python_set_memory_placement, under workspace_placement_mutex.
+ */
+
+// The smallest size class, as a power of two: smaller blocks are rounded up to 1 KiB.
+#define WORKSPACE_POOL_MIN_CLASS 10
+// The largest size class, as a power of two. Bigger blocks are allocated and freed every time, as the solve dwarfs the allocation.
+#define WORKSPACE_POOL_MAX_CLASS 26
+#define WORKSPACE_POOL_NUM_CLASSES (WORKSPACE_POOL_MAX_CLASS - WORKSPACE_POOL_MIN_CLASS + 1)
+// How many free blocks of one size class a thread keeps. A solve takes at most this many blocks of one class at once.
+#define WORKSPACE_POOL_BLOCKS_PER_CLASS 4
+// The most bytes of free blocks a thread keeps. Blocks freed past it go back to the allocator.
+#define WORKSPACE_POOL_MAX_CACHED_BYTES ((int64_t)1 << 27)
+// The default size from which blocks are mapped in huge pages: 32 MiB, i.e., a float64 matrix of about 2000 x 2000.
+#define WORKSPACE_HUGE_PAGE_MIN_BYTES ((int64_t)1 << 25)
+
+// Blocks of at least this many bytes are mapped in huge pages. 0 or less maps none.
+static int64_t workspace_huge_page_min_bytes = WORKSPACE_HUGE_PAGE_MIN_BYTES;
+// 1 to have the thread pool first touch new huge page blocks, 0 to leave it to whichever thread writes them first.
+static int is_workspace_first_touch_enabled = 1;
+// Protects workspace_huge_page_min_bytes and is_workspace_first_touch_enabled, which any thread may change while others allocate.
+static Mutex workspace_placement_mutex;
+
+static void initialize_workspace_placement_mutex(void)
+{
+    initialize_mutex(&workspace_placement_mutex);
+}
+
+#ifdef _WIN32
+static INIT_ONCE workspace_placement_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK initialize_workspace_placement_mutex_once(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    initialize_workspace_placement_mutex();
+    return TRUE;
+}
+#endif
+#ifdef linux
+static pthread_once_t workspace_placement_once = PTHREAD_ONCE_INIT;
+#endif
+
+/**
+ * @brief Lock workspace_placement_mutex, creating it the first time it is needed.
+ */
+static inline void lock_workspace_placement(void)
+{
+#ifdef _WIN32
+    InitOnceExecuteOnce(&workspace_placement_once, initialize_workspace_placement_mutex_once, NULL, NULL);
+#endif
+#ifdef linux
+    pthread_once(&workspace_placement_once, initialize_workspace_placement_mutex);
+#endif
+    lock_mutex(&workspace_placement_mutex);
+}
+
+/**
+ * @brief Read which blocks are mapped in huge pages and whether they are first touched by the thread pool.
+ *
+ * @param huge_page_min_bytes: int64_t[ptr]
+ *      Receives workspace_huge_page_min_bytes.
+ * @param is_first_touch_enabled: int[ptr]
+ *      Receives is_workspace_first_touch_enabled.
+ *
+ * @return None
+ */
+static void get_workspace_placement(int64_t *huge_page_min_bytes, int *is_first_touch_enabled)
+{
+    lock_workspace_placement();
+    *huge_page_min_bytes = workspace_huge_page_min_bytes;
+    *is_first_touch_enabled = is_workspace_first_touch_enabled;
+    unlock_mutex(&workspace_placement_mutex);
+}
+
+/**
+ * @brief Change which blocks are mapped in huge pages and whether they are first touched by the thread pool. Blocks already allocated keep
+ *        how they were placed.
+ *
+ * @param huge_page_min_bytes: int64_t
+ *      The new workspace_huge_page_min_bytes.
+ * @param is_first_touch_enabled: int
+ *      The new is_workspace_first_touch_enabled.
+ *
+ * @return None
+ */
+static void set_workspace_placement(int64_t huge_page_min_bytes, int is_first_touch_enabled)
+{
+    lock_workspace_placement();
+    workspace_huge_page_min_bytes = huge_page_min_bytes;
+    is_workspace_first_touch_enabled = is_first_touch_enabled;
+    unlock_mutex(&workspace_placement_mutex);
+}
+
+/**
+ * @brief The free blocks of one thread, by size class.
+ */
+struct WorkspacePool
+{
+    void *blocks[WORKSPACE_POOL_NUM_CLASSES][WORKSPACE_POOL_BLOCKS_PER_CLASS];
+    int num_blocks[WORKSPACE_POOL_NUM_CLASSES];
+    int64_t num_cached_bytes;
+    // 1 once the thread has asked to have the pool freed when it exits. Until then, nothing is cached.
+    int is_registered;
+};
+
+/**
+ * @brief What is stored in the MATRIX_ALIGNMENT bytes before a pooled block, so free_pooled knows where it goes back to.
+ */
+struct PooledBlockHeader
+{
+    // The size class, or -1 if the block is too big to be pooled
+    int size_class;
+    // The length of the mapping if the block was mapped with map_huge_pages, 0 if it came from allocate_aligned
+    size_t num_mapped_bytes;
+};
+
+static THREAD_LOCAL struct WorkspacePool thread_workspace_pool;
+
+/**
+ * @brief A block being first touched, split into num_tasks bands of whole huge pages.
+ */
+struct FirstTouch
+{
+    char *memory;
+    size_t num_pages;
+    int num_tasks;
+};
+
+/**
+ * @brief Write one band of a new block, so its pages are placed on the NUMA node of the thread that runs the task.
+ */
+static void touch_first_pages(void *context, int task_index)
+{
+    const struct FirstTouch *touch = (const struct FirstTouch *)context;
+    size_t first_page = (touch->num_pages * task_index) / touch->num_tasks;
+    size_t end_page = (touch->num_pages * (task_index + 1)) / touch->num_tasks;
+    memset(&touch->memory[first_page * HUGE_PAGE_SIZE], 0, (end_page - first_page) * HUGE_PAGE_SIZE);
+}
+
+/**
+ *  @brief Allocate a block and its header: in huge pages if it is big enough, from allocate_aligned otherwise.
+ *
+ *  @param num_bytes: size_t
+ *      The size of the block after the header.
+ *
+ *  @return block: char[ptr]
+ *      The block, starting with its header, or NULL if it could not be allocated.
+ *
+ */
+static char *allocate_pool_block(size_t num_bytes)
+{
+    size_t num_block_bytes = MATRIX_ALIGNMENT + num_bytes;
+    size_t num_mapped_bytes = 0;
+    char *block = NULL;
+    int64_t huge_page_min_bytes;
+    int is_first_touch_enabled;
+    get_workspace_placement(&huge_page_min_bytes, &is_first_touch_enabled);
+    if (huge_page_min_bytes > 0 && num_block_bytes >= (size_t)huge_page_min_bytes)
+    {
+        block = (char *)map_huge_pages(num_block_bytes, &num_mapped_bytes);
+        struct ThreadPool *thread_pool = (block && is_first_touch_enabled) ? get_thread_pool() : NULL;
+        if (thread_pool)
+        {
+            struct FirstTouch touch = {block, num_mapped_bytes / HUGE_PAGE_SIZE, thread_pool->num_threads};
+            if ((size_t)touch.num_tasks > touch.num_pages)
+            {
+                touch.num_tasks = (int)touch.num_pages;
+            }
+            parallel_for(touch.num_tasks, touch_first_pages, &touch);
+        }
+    }
+    if (!block)
+    {
+        num_mapped_bytes = 0;
+        block = (char *)allocate_aligned(num_block_bytes, 0);
+    }
+    if (block)
+    {
+        ((struct PooledBlockHeader *)block)->num_mapped_bytes = num_mapped_bytes;
+    }
+    return block;
+}
+
+/**
+ *  @brief Free a block from allocate_pool_block.
+ */
+static void free_pool_block(char *block)
+{
+    size_t num_mapped_bytes = ((struct PooledBlockHeader *)block)->num_mapped_bytes;
+    if (num_mapped_bytes > 0)
+    {
+        unmap_huge_pages(block, num_mapped_bytes);
+    }
+    else
+    {
+        free_aligned(block);
+    }
+}
+
+/**
+ *  @brief Free the blocks a pool holds.
+ *
+ *  @param pool: struct WorkspacePool[ptr]
+ *      The pool.
+ *
+ *  @return num_bytes: int64_t
+ *      How many bytes of blocks were freed.
+ *
+ */
+static int64_t release_workspace_pool(struct WorkspacePool *pool)
+{
+    int64_t num_released_bytes = pool->num_cached_bytes;
+    for (int size_class = 0; size_class < WORKSPACE_POOL_NUM_CLASSES; size_class++)
+    {
+        while (pool->num_blocks[size_class] > 0)
+        {
+            free_pool_block((char *)pool->blocks[size_class][--pool->num_blocks[size_class]]);
+        }
+    }
+    pool->num_cached_bytes = 0;
+    return num_released_bytes;
+}
+
+#ifdef _WIN32
+static DWORD workspace_pool_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE workspace_pool_key_once = INIT_ONCE_STATIC_INIT;
+static VOID WINAPI release_workspace_pool_at_exit(PVOID pool)
+{
+    if (pool)
+    {
+        release_workspace_pool((struct WorkspacePool *)pool);
+    }
+}
+static BOOL CALLBACK create_workspace_pool_key(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    workspace_pool_key = FlsAlloc(release_workspace_pool_at_exit);
+    return TRUE;
+}
+#endif
+#ifdef linux
+static pthread_key_t workspace_pool_key;
+static int is_workspace_pool_key_created = 0;
+static pthread_once_t workspace_pool_key_once = PTHREAD_ONCE_INIT;
+static void release_workspace_pool_at_exit(void *pool)
+{
+    release_workspace_pool((struct WorkspacePool *)pool);
+}
+static void create_workspace_pool_key(void)
+{
+    is_workspace_pool_key_created = (pthread_key_create(&workspace_pool_key, release_workspace_pool_at_exit) == 0);
+}
+#endif
+
+/**
+ *  @brief Get the calling thread's pool, the first time arranging for it to be freed when the thread exits.
+ *
+ *  @return pool: struct WorkspacePool[ptr]
+ *      The pool of the calling thread.
+ *
+ */
+static inline struct WorkspacePool *get_workspace_pool(void)
+{
+    struct WorkspacePool *pool = &thread_workspace_pool;
+    if (!pool->is_registered)
+    {
+#ifdef _WIN32
+        InitOnceExecuteOnce(&workspace_pool_key_once, create_workspace_pool_key, NULL, NULL);
+        pool->is_registered = (workspace_pool_key != FLS_OUT_OF_INDEXES) && FlsSetValue(workspace_pool_key, pool);
+#endif
+#ifdef linux
+        pthread_once(&workspace_pool_key_once, create_workspace_pool_key);
+        pool->is_registered = is_workspace_pool_key_created && (pthread_setspecific(workspace_pool_key, pool) == 0);
+#endif
+    }
+    return pool;
+}
+
+/**
+ *  @brief The size class of a block: the power of two it is rounded up to, counted from WORKSPACE_POOL_MIN_CLASS.
+ *
+ *  @return size_class: int
+ *      The size class, or -1 if the block is bigger than the largest one.
+ *
+ */
+static inline int get_workspace_size_class(size_t num_bytes)
+{
+    int size_class = 0;
+    while (((size_t)1 << (size_class + WORKSPACE_POOL_MIN_CLASS)) < num_bytes)
+    {
+        if (++size_class == WORKSPACE_POOL_NUM_CLASSES)
+        {
+            return -1;
+        }
+    }
+    return size_class;
+}
+
+/**
+ *  @brief Allocate a solver temporary from the calling thread's pool, or from the allocator if the pool has no block of its size class. It starts
+ *         on a MATRIX_ALIGNMENT boundary, and must be freed with free_pooled.
+ *
+ *  @param num_bytes: size_t
+ *      How many bytes to allocate.
+ *
+ *  @return memory: void[ptr]
+ *      The memory, or NULL if it could not be allocated.
+ *
+ */
+static void *allocate_pooled(size_t num_bytes)
+{
+    int size_class = get_workspace_size_class(num_bytes);
+    char *block = NULL;
+    if (size_class >= 0)
+    {
+        struct WorkspacePool *pool = get_workspace_pool();
+        if (pool->num_blocks[size_class] > 0)
+        {
+            block = (char *)pool->blocks[size_class][--pool->num_blocks[size_class]];
+            pool->num_cached_bytes -= (int64_t)1 << (size_class + WORKSPACE_POOL_MIN_CLASS);
+        }
+        else
+        {
+            block = allocate_pool_block((size_t)1 << (size_class + WORKSPACE_POOL_MIN_CLASS));
+        }
+    }
+    else
+    {
+        block = allocate_pool_block(num_bytes);
+    }
+    if (!block)
+    {
+        return NULL;
+    }
+    ((struct PooledBlockHeader *)block)->size_class = size_class;
+    return &block[MATRIX_ALIGNMENT];
+}
+
+/**
+ *  @brief Free memory from allocate_pooled, keeping it in the calling thread's pool if there is room. Passing NULL does nothing.
+ */
+static void free_pooled(void *memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+    char *block = (char *)memory - MATRIX_ALIGNMENT;
+    int size_class = ((struct PooledBlockHeader *)block)->size_class;
+    int64_t num_block_bytes = (size_class >= 0) ? ((int64_t)1 << (size_class + WORKSPACE_POOL_MIN_CLASS)) : 0;
+    struct WorkspacePool *pool = (size_class >= 0) ? get_workspace_pool() : NULL;
+    if (pool && pool->is_registered && pool->num_blocks[size_class] < WORKSPACE_POOL_BLOCKS_PER_CLASS && pool->num_cached_bytes + num_block_bytes <= WORKSPACE_POOL_MAX_CACHED_BYTES)
+    {
+        pool->blocks[size_class][pool->num_blocks[size_class]++] = block;
+        pool->num_cached_bytes += num_block_bytes;
+        return;
+    }
+    free_pool_block(block);
+}
+
+/**
+ *  @brief Free the blocks the calling thread's pool holds. Blocks other threads hold are theirs to trim.
+ *
+ *  @return num_bytes: int64_t
+ *      How many bytes of blocks were freed.
+ *
+ */
+static inline int64_t trim_workspace_pool(void)
+{
+    return release_workspace_pool(&thread_workspace_pool);
+}
+
+#endif
\ No newline at end of file
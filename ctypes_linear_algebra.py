@@ -1,247 +1,1569 @@
-"""
-    Python code that serves as the middle-man between the GUI and the C code.
-    Handles the data marshalling and Python definition of functions to ensure
-    functions match their C counterpart.
-"""
-
-import ctypes
-import os
-from sys import platform as sys_platform
-from typing import *
-from memory_profiler import profile
-
-###############################################################################
-#                                                                             #
-#                                                                             #
-#              CTYPES_LINEAR_ALGEBRA CLASSES AND CLASS FUNCTIONS              #
-#                                                                             #
-#                                                                             #
-###############################################################################
-
-
-class MatrixMetadata(ctypes.Structure):
-    """
-        A ctypes structure that holds metadata information about a given matrix (and its augmented form).
-
-        Fields/Attributes
-        -----------------
-        num_rows: int
-            The number of rows in the matrix.
-        num_cols: int
-            The number of columns in the matrix.
-        is_consistent: int
-            A 0/1 integer flag that indicates whether the matrix is consistent. In essence, it determines whether a System of Linear Equations is solvable.
-            When initializing, the default value should be -1 to indicate an 'Unknown' value.
-        matrix_determinant: double
-            A value that represents the determinant of the matrix. Has many uses, including determining whether a matrix is invertible.
-            When initializing, the default value should be -1 to indicate an 'Unknown' value (although this could be a valid determinant as well).
-
-        How To Initialize
-        -----------------
-        Initialization of a ctypes.Structure object is actually exactly the same as any custom Python class that has an __init__ function.
-        The reason it might be unintuitive is that, unlike most Python classes, you do not have to write an __init__ function for whatever reason.
-        
-        Example of initializing a MatrixMetadata structure and accessing its attributes:
-            >>> matrix_metadata = MatrixMetadata(num_rows=3, num_cols=3, is_consistent=-1, matrix_determinant=-1)
-            >>> print(f"Number of Rows in Matrix: {matrix_metadata.num_rows}")
-            >>> print(f"Number of Columns in Matrix: {matrix_metadata.num_cols}")
-
-
-    """
-
-    _fields_ = [
-        ("num_rows", ctypes.c_int),
-        ("num_cols", ctypes.c_int),
-        ("matrix_rank", ctypes.c_int),
-        ("is_consistent", ctypes.c_int),
-        ("matrix_determinant", ctypes.c_double),
-    ]
-
-
-class String(ctypes.Structure):
-    """
-        A ctypes structure that functions similarly to the str class in Python.
-
-        Fields/Attributes
-        -----------------
-        length: int64
-            An integer representing the current length of the String structure, in bytes. Bear in mind that one char in C is one byte.
-        capacity: int64
-            An integer representing the total length of the String structure, in bytes. Used to avoid buffer overflow errors.
-        attempted_to_write_more_than_capacity: int
-            A 0/1 integer flag that indicates whether the most recent write operation that was performed attempted to write more characters
-            to the string than its capacity. Essentially a simpler way to check if a buffer overflow may have occurred.
-        buffer: void*
-            A void pointer to some memory that can be written to. SHould house the bytes of string data and have at least capacity bytes of
-            memory allocated to it (if this structure is created on the C side.) The reason it is void* instead of char* is to avoid type mismatches, though
-            it may be possible to use a char* instead.
-
-        How To Initialize
-        -----------------
-        Initialization of a ctypes.Structure object is actually exactly the same as any custom Python class that has an __init__ function.
-        The reason it might be unintuitive is that, unlike most Python classes, you do not have to write an __init__ function for whatever reason.
-        
-        Example of initializing a String structure and accessing its attributes:
-            >>> buffer_string = String(0, 4096, 0, b"")
-            >>> print(f"Length of String: {buffer_string.length}")
-            >>> print(f"Capacity of String: {buffer_string.capacity}")
-            >>> print(f"String Contents: {str(buffer_string.buffer, 'utf-8')}")
-    """
-
-    _fields_ = [
-        ("length", ctypes.c_int64),
-        ("capacity", ctypes.c_int64),
-        ("attempted_to_write_more_than_capacity", ctypes.c_int),
-        ("buffer", ctypes.c_char_p),
-    ]
-
-
-def get_dict(struct: ctypes.Structure) -> dict:
-    """
-        Convert a ctypes Structure into a Python dictionary.
-
-        Attempts to convert all fields from ctypes-specific objects
-        to Python types. This function does work recursively, so nested
-        structures should not be an issue.
-
-        NOTE: This function does NOT convert pointers into arrays.
-
-        Parameters
-        ----------
-        struct (ctypes.Structure):
-            The struct you wish to convert into a dictionary.
-
-        Returns
-        -------
-        result:
-            The resulting dictionary. Keys are taken from the field names,
-            and values are converted into Python objects.
-    """
-
-    result = {}
-    for field, _ in struct._fields_:
-        value = getattr(struct, field)
-        # If it's not a primitive type and it evaluates to false then we assume it's a null pointer/value
-        if (type(value) not in [int, float, bool, bytes]) and not bool(value):
-            value = None
-        # If it's an array, pass for now. We might be able to convert it into a Numpy array later
-        elif hasattr(value, "_type_"):
-            pass
-        # If it is has fields then it is probably a ctypes Structure, so we recursively call get_dict.
-        elif hasattr(value, "_fields_"):
-            value = get_dict(value)
-        result[field] = value
-    return result
-
-
-# @profile
-def string_read_line(
-    buffer: Union[bytearray, bytes], start_index: int = 0
-) -> Tuple[bytearray, int]:
-    """
-        Read a line from a buffer.
-
-        Read characters from a buffer of bytes, starting either from the start_index value provided
-        until either a newline is hit or None is hit. Once this happens, it returns the characters that
-        have been appended so far, along with the index of where the next call to the function should start.
-
-        NOTE: This function does not append return carriage ('\\r') tokens, effectively stripping them out.
-
-        Parameters
-        ----------
-        buffer: bytes
-            A buffer of characters to be read. The implicit assumption of the buffer is that the characters
-            fall within the UTF-8 encoding (ASCII probably works too).
-        start_index: int, default 0
-            The index to start from when enumerating. It is used to create a slice copy of the buffer.
-
-        Returns
-        -------
-        ret: Tuple[bytearray, int]
-            A tuple that contains the following pieces:
-            byte_array_to_display: bytearray
-                A mutable form of the characters that were read from the buffer.
-            index: int
-                The index of the last character present in byte_array_to_display.
-    """
-    byte_array_to_display: bytearray = bytearray()
-    for index, byte in enumerate(buffer[start_index:]):
-        if byte is not None:
-            if byte != ord("\r") and byte != ord("\n"):
-                byte_array_to_display.append(byte)
-            # If a newline is reached then a complete chunk of data is ready to process
-            if byte == ord("\n"):
-                # print(f"Record to return (hit newline): {byte_array_to_display}")
-                return byte_array_to_display, index + 1
-        else:
-            # print(f"Record to return (none byte): {byte_array_to_display}")
-            if isinstance(buffer, bytearray):
-                buffer.clear()
-            return byte_array_to_display, index
-    # If somehow the buffer is either empty or reaching the end of it doesn't trigger the other return statements
-    if start_index >= len(buffer) and isinstance(buffer, bytearray):
-        buffer.clear()
-    return bytearray("", "utf-8"), 0
-
-
-def find_library_file() -> ctypes.CDLL:
-    """A small helper function to find and load the shared object file for elevation parsing.
-
-    Raises:
-        ValueError: If the shared object file is not in the same directory as this file, then
-        an error is raised to inform the developer that they need to place it there manually.
-        This is because I cannot be certain of what any new data directory structure looks like.
-
-    Returns:
-        ctypes.CDLL: The Dynamic Loaded Library (DLL) or Shared Object (SO) file.
-    """
-    current_directory = os.getcwd()
-    current_system = sys_platform
-    file_to_load: str = ""
-    if current_system == "win32":
-        file_to_load = os.path.join(current_directory, "row_reduction.dll")
-    else:
-        file_to_load = os.path.join(current_directory, "row_reduction.so")
-    print(f"Platform: {current_system}\tLoading File: {file_to_load}")
-    if os.path.exists(file_to_load):
-        return ctypes.cdll.LoadLibrary(file_to_load)
-    else:
-        raise ValueError(
-            f"{file_to_load} cannot be found in current directory {current_directory}. Please make sure this file is in the same location as {__name__}.py"
-        )
-
-
-###############################################################################
-#                                                                             #
-#                                                                             #
-#               CTYPES_LINEAR_ALGEBRA CODE THAT RUNS ON STARTUP               #
-#                                                                             #
-#                                                                             #
-###############################################################################
-
-linear_algebra_dll = find_library_file()
-perform_gauss_jordan_reduction = (
-    linear_algebra_dll.python_perform_gauss_jordan_reduction
-)
-# While I am not certain that the order of the arguments matters, I do it anyway to potentially avoid any bugs.
-perform_gauss_jordan_reduction.argtypes = (
-    ctypes.POINTER(ctypes.c_double),  # matrix_to_reduce
-    ctypes.POINTER(ctypes.c_double),  # matrix_augment
-    ctypes.POINTER(String),  # String *message_buffer
-    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
-    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *augment_metadata
-)
-# The restype is None because the function on the C side of the code is void
-perform_gauss_jordan_reduction.restype = None
-
-perform_square_matrix_inversion = (
-    linear_algebra_dll.python_perform_square_matrix_inversion_gaussian_reduction
-)
-# While I am not certain that the order of the arguments matters, I do it anyway to potentially avoid any bugs.
-perform_square_matrix_inversion.argtypes = (
-    ctypes.POINTER(ctypes.c_double),  # *matrix_to_invert
-    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_to_invert_metadata
-    ctypes.POINTER(String),  # String *message_buffer
-)
-# The restype is None because the function on the C side of the code is void
-perform_square_matrix_inversion.restype = None
+"""
+    Python code that serves as the middle-man between the GUI and the C code.
+    Handles the data marshalling and Python definition of functions to ensure
+    functions match their C counterpart.
+"""
+
+import codecs
+import ctypes
+import os
+from sys import platform as sys_platform
+from typing import *
+from memory_profiler import profile
+
+###############################################################################
+#                                                                             #
+#                                                                             #
+#              CTYPES_LINEAR_ALGEBRA CLASSES AND CLASS FUNCTIONS              #
+#                                                                             #
+#                                                                             #
+###############################################################################
+
+
+class MatrixMetadata(ctypes.Structure):
+    """
+        A ctypes structure that holds metadata information about a given matrix (and its augmented form).
+
+        Fields/Attributes
+        -----------------
+        num_rows: int
+            The number of rows in the matrix.
+        num_cols: int
+            The number of columns in the matrix.
+        is_consistent: int
+            A 0/1 integer flag that indicates whether the matrix is consistent. In essence, it determines whether a System of Linear Equations is solvable.
+            When initializing, the default value should be -1 to indicate an 'Unknown' value.
+        matrix_determinant: double
+            A value that represents the determinant of the matrix. Has many uses, including determining whether a matrix is invertible.
+            When initializing, the default value should be -1 to indicate an 'Unknown' value (although this could be a valid determinant as well).
+        row_stride: int
+            The distance, in values (not bytes), between the starts of two neighbouring rows. 0 (the default) means packed: num_cols for a
+            row-major layout, 1 for a column-major one.
+        col_stride: int
+            The distance, in values, between two neighbouring values of a row. 0 (the default) means packed: 1 for a row-major layout,
+            num_rows for a column-major one.
+            Together with row_stride, this lets slices, transposes and padded buffers be passed without copying them (see from_array).
+        layout: int
+            One of the MATRIX_LAYOUT_* values (row-major by default). Decides what strides of 0 mean, so column-major (Fortran) data
+            can be described by its dimensions alone. The MATRIX_LAYOUT_PACKED_* values say only one triangle of a square float64 matrix
+            is stored (see pack_matrix); the automatic engine solves those on the packed values.
+        dtype: int
+            One of the MATRIX_DTYPE_* values (float64 by default), i.e., the type of the values. Strides count values of this type.
+            The Gauss-Jordan engine, the inversions and compute_determinant handle every type; the other engines hand non-float64
+            systems over to the Gauss-Jordan engine, and the multiplication, transpose and LU factor/solve only take float64.
+        matrix_determinant_imag: double
+            The imaginary part of the determinant of a complex matrix (0 otherwise).
+
+        How To Initialize
+        -----------------
+        Initialization of a ctypes.Structure object is actually exactly the same as any custom Python class that has an __init__ function.
+        The reason it might be unintuitive is that, unlike most Python classes, you do not have to write an __init__ function for whatever reason.
+        
+        Example of initializing a MatrixMetadata structure and accessing its attributes:
+            >>> matrix_metadata = MatrixMetadata(num_rows=3, num_cols=3, is_consistent=-1, matrix_determinant=-1)
+            >>> print(f"Number of Rows in Matrix: {matrix_metadata.num_rows}")
+            >>> print(f"Number of Columns in Matrix: {matrix_metadata.num_cols}")
+
+
+    """
+
+    _fields_ = [
+        ("num_rows", ctypes.c_int),
+        ("num_cols", ctypes.c_int),
+        ("matrix_rank", ctypes.c_int),
+        ("is_consistent", ctypes.c_int),
+        ("matrix_determinant", ctypes.c_double),
+        ("row_stride", ctypes.c_int),
+        ("col_stride", ctypes.c_int),
+        ("layout", ctypes.c_int),
+        ("dtype", ctypes.c_int),
+        ("matrix_determinant_imag", ctypes.c_double),
+    ]
+
+    @classmethod
+    def from_array(cls, array) -> "MatrixMetadata":
+        """
+            Describe a 2-D float32, float64, complex64 or complex128 Numpy array, including any view of one (a slice, a transpose, ...), so it
+            can be passed as it is.
+
+            Raises
+            ------
+            ValueError
+                If the array is not a 2-D array of one of those types, its strides are not whole numbers of values, or it is broadcast (a stride
+                of 0 means 'packed' to the library).
+        """
+        if array.ndim != 2 or array.dtype.name not in MATRIX_DTYPES:
+            raise ValueError("Expected a 2-D float32, float64, complex64 or complex128 array.")
+        if any(stride % array.itemsize for stride in array.strides):
+            raise ValueError("The strides of the array are not whole numbers of values.")
+        row_stride, col_stride = (stride // array.itemsize for stride in array.strides)
+        if (row_stride == 0 and array.shape[0] > 1) or (col_stride == 0 and array.shape[1] > 1):
+            raise ValueError("Broadcast arrays must be copied first.")
+        return cls(
+            *array.shape,
+            -1,
+            -1,
+            -1,
+            row_stride,
+            col_stride,
+            MATRIX_LAYOUT_ROW_MAJOR,
+            MATRIX_DTYPES[array.dtype.name],
+        )
+
+    @classmethod
+    def from_packed(cls, packed, size: int, layout: int) -> "MatrixMetadata":
+        """
+            Describe a packed triangle of a size x size float64 matrix (see pack_matrix).
+
+            Raises
+            ------
+            ValueError
+                If packed is not a contiguous float64 array of size * (size + 1) / 2 values, or layout is not one of the packed layouts.
+        """
+        if layout not in MATRIX_LAYOUTS_PACKED:
+            raise ValueError("Expected one of the MATRIX_LAYOUT_PACKED_* layouts.")
+        if packed.dtype.name != "float64" or packed.size != size * (size + 1) // 2 or not packed.flags["C_CONTIGUOUS"]:
+            raise ValueError("Expected a contiguous float64 array of size * (size + 1) / 2 values.")
+        return cls(size, size, -1, -1, -1, 0, 0, layout, MATRIX_DTYPE_FLOAT64)
+
+
+# The values of enum MatrixLayout, i.e., how the values of a matrix are laid out when its strides are not given.
+MATRIX_LAYOUT_ROW_MAJOR = 0
+MATRIX_LAYOUT_COLUMN_MAJOR = 1
+MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR = 2
+MATRIX_LAYOUT_PACKED_LOWER_TRIANGULAR = 3
+MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC = 4
+MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC = 5
+MATRIX_LAYOUTS_PACKED = (
+    MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR,
+    MATRIX_LAYOUT_PACKED_LOWER_TRIANGULAR,
+    MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC,
+    MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC,
+)
+
+# The values of enum MatrixDtype, i.e., the type of the values of a matrix, and the Numpy dtype names they stand for.
+MATRIX_DTYPE_FLOAT64 = 0
+MATRIX_DTYPE_FLOAT32 = 1
+MATRIX_DTYPE_COMPLEX64 = 2
+MATRIX_DTYPE_COMPLEX128 = 3
+MATRIX_DTYPES = {
+    "float64": MATRIX_DTYPE_FLOAT64,
+    "float32": MATRIX_DTYPE_FLOAT32,
+    "complex64": MATRIX_DTYPE_COMPLEX64,
+    "complex128": MATRIX_DTYPE_COMPLEX128,
+}
+MATRIX_DTYPE_NAMES = {value: name for name, value in MATRIX_DTYPES.items()}
+
+# The values of enum LogVerbosity, i.e., how much of the step log the solver writes.
+LOG_VERBOSITY_SUMMARY = 0
+LOG_VERBOSITY_STEPS = 1
+LOG_VERBOSITY_MATRICES = 2
+
+# The values of enum PivotStrategy, i.e., how the solver picks the pivot element of each column.
+PIVOT_STRATEGY_NONE = 0
+PIVOT_STRATEGY_PARTIAL = 1
+PIVOT_STRATEGY_ROOK = 2
+PIVOT_STRATEGY_COMPLETE = 3
+
+
+class SolverOptions(ctypes.Structure):
+    """
+        A ctypes structure that holds options that change how the solver runs. Passing None instead uses the defaults.
+
+        Fields/Attributes
+        -----------------
+        verbosity: int
+            How much of the step log to write. One of LOG_VERBOSITY_SUMMARY, LOG_VERBOSITY_STEPS or LOG_VERBOSITY_MATRICES (the default).
+        pivot_strategy: int
+            How pivot elements are chosen. One of PIVOT_STRATEGY_NONE (the default, only swaps when the pivot is exactly 0),
+            PIVOT_STRATEGY_PARTIAL, PIVOT_STRATEGY_ROOK or PIVOT_STRATEGY_COMPLETE. The LU engines pick their own pivots and ignore it,
+            and types other than float64 are always reduced with partial pivoting.
+        num_threads: int
+            The most threads a parallel engine may use. 0 (the default) means one per hardware thread.
+
+        How To Initialize
+        -----------------
+            >>> solver_options = SolverOptions(verbosity=LOG_VERBOSITY_STEPS, pivot_strategy=PIVOT_STRATEGY_PARTIAL)
+    """
+
+    _fields_ = [
+        ("verbosity", ctypes.c_int),
+        ("pivot_strategy", ctypes.c_int),
+        ("num_threads", ctypes.c_int),
+    ]
+
+
+class MemoryPlacementOptions(ctypes.Structure):
+    """
+        A ctypes structure that says where the library places the memory and threads of large solves. Read it with get_memory_placement and
+        change it with set_memory_placement, from any thread. A change applies to the temporaries allocated after it.
+
+        Fields/Attributes
+        -----------------
+        huge_page_min_bytes: int
+            Solver temporaries of at least this many bytes are mapped in huge pages. 0 or less maps none. The default is 32 MiB.
+        is_first_touch_enabled: int
+            1 (the default) to have the thread pool write new huge page temporaries first, so their pages are spread over its NUMA nodes.
+        is_pinned_to_numa_nodes: int
+            1 to pin each worker thread to one NUMA node, splitting the workers evenly between the nodes. 0 (the default) leaves them unpinned.
+
+        How To Initialize
+        -----------------
+            >>> placement = MemoryPlacementOptions()
+            >>> get_memory_placement(ctypes.byref(placement))
+            >>> placement.is_pinned_to_numa_nodes = 1
+            >>> num_nodes = set_memory_placement(ctypes.byref(placement))
+    """
+
+    _fields_ = [
+        ("huge_page_min_bytes", ctypes.c_int64),
+        ("is_first_touch_enabled", ctypes.c_int),
+        ("is_pinned_to_numa_nodes", ctypes.c_int),
+    ]
+
+
+class SolverOutputs(ctypes.Structure):
+    """
+        A ctypes structure of caller-provided buffers that the solver copies its results into.
+        Any field may be left as NULL to skip that result, and None can be passed instead of the whole structure.
+
+        Fields/Attributes
+        -----------------
+        reduced_matrix: double*
+            Receives the reduced row echelon form of the matrix (without the augment). Must hold num_rows * num_cols values of the matrix's dtype.
+        solution: double*
+            Receives the augment after reduction, i.e., the solution of Ax = b, or the inverse when inverting. Must hold num_rows * num_augment_cols
+            values of the matrix's dtype.
+        pivot_permutation: int*
+            Receives the row permutation applied by pivoting: row i of the results came from row pivot_permutation[i] of the input. Must hold num_rows ints.
+        elapsed_seconds: double
+            Set to how long the reduction took.
+        pivot_search_seconds: double
+            Set to how much of elapsed_seconds was spent searching for pivots.
+
+        How To Initialize
+        -----------------
+        The easiest way is from Numpy arrays, which the solver then writes into directly (no copies, nothing to parse):
+            >>> solution = np.empty((num_rows, num_augment_cols))
+            >>> pivot_permutation = np.empty(num_rows, dtype=np.intc)
+            >>> solver_outputs = SolverOutputs.from_arrays(solution=solution, pivot_permutation=pivot_permutation)
+    """
+
+    _fields_ = [
+        ("reduced_matrix", ctypes.POINTER(ctypes.c_double)),
+        ("solution", ctypes.POINTER(ctypes.c_double)),
+        ("pivot_permutation", ctypes.POINTER(ctypes.c_int)),
+        ("elapsed_seconds", ctypes.c_double),
+        ("pivot_search_seconds", ctypes.c_double),
+    ]
+
+    @classmethod
+    def from_arrays(
+        cls, reduced_matrix=None, solution=None, pivot_permutation=None
+    ) -> "SolverOutputs":
+        """
+            Build a SolverOutputs that points at the memory of the given Numpy arrays.
+
+            The arrays must be C-contiguous, the matrices must have the dtype of the matrix being solved (any of MATRIX_DTYPES) and the
+            permutation must be np.intc. References to the arrays are kept on the returned structure so they outlive the call.
+        """
+
+        def pointer_to(array, ctype, name):
+            if array is None:
+                return None
+            if ctype is ctypes.c_double:
+                is_valid_type = array.dtype.name in MATRIX_DTYPES
+            else:
+                is_valid_type = array.dtype.itemsize == ctypes.sizeof(ctype)
+            if not array.flags["C_CONTIGUOUS"] or not is_valid_type:
+                raise ValueError(f"{name} must be a C-contiguous array of {ctype.__name__}.")
+            return array.ctypes.data_as(ctypes.POINTER(ctype))
+
+        solver_outputs = cls(
+            pointer_to(reduced_matrix, ctypes.c_double, "reduced_matrix"),
+            pointer_to(solution, ctypes.c_double, "solution"),
+            pointer_to(pivot_permutation, ctypes.c_int, "pivot_permutation"),
+        )
+        solver_outputs.arrays = (reduced_matrix, solution, pivot_permutation)
+        return solver_outputs
+
+
+# The values of enum SolverPlan, i.e., which solver the automatic dispatcher routes a system to.
+SOLVER_PLAN_GAUSS_JORDAN = 0
+SOLVER_PLAN_TRIANGULAR = 1
+SOLVER_PLAN_BANDED_LU = 2
+SOLVER_PLAN_SYMMETRIC_POSITIVE_DEFINITE = 3
+SOLVER_PLAN_DENSE_LU = 4
+SOLVER_PLAN_TOEPLITZ = 5
+SOLVER_PLAN_CIRCULANT = 6
+
+
+class MatrixStructure(ctypes.Structure):
+    """
+        A ctypes structure that holds the structure profile of a matrix, as filled in by analyze_matrix_structure.
+
+        Fields/Attributes
+        -----------------
+        num_zero_rows, num_zero_cols: int
+            The number of rows/columns whose values are all (within a small tolerance of) 0.
+        num_nonzeros: int
+            The number of values that are not exactly 0. density is the same as a fraction of all values.
+        lower_bandwidth, upper_bandwidth: int
+            The furthest any nonzero value is below/above the diagonal.
+        is_symmetric, is_upper_triangular, is_lower_triangular, has_nonzero_diagonal, has_positive_diagonal,
+        is_diagonally_dominant, is_identity, is_rref, is_toeplitz, is_circulant: int
+            0/1 flags.
+    """
+
+    _fields_ = [
+        ("num_rows", ctypes.c_int),
+        ("num_cols", ctypes.c_int),
+        ("num_zero_rows", ctypes.c_int),
+        ("num_zero_cols", ctypes.c_int),
+        ("num_nonzeros", ctypes.c_int64),
+        ("density", ctypes.c_double),
+        ("lower_bandwidth", ctypes.c_int),
+        ("upper_bandwidth", ctypes.c_int),
+        ("is_symmetric", ctypes.c_int),
+        ("is_upper_triangular", ctypes.c_int),
+        ("is_lower_triangular", ctypes.c_int),
+        ("has_nonzero_diagonal", ctypes.c_int),
+        ("has_positive_diagonal", ctypes.c_int),
+        ("is_diagonally_dominant", ctypes.c_int),
+        ("is_identity", ctypes.c_int),
+        ("is_rref", ctypes.c_int),
+        ("is_toeplitz", ctypes.c_int),
+        ("is_circulant", ctypes.c_int),
+    ]
+
+
+class String(ctypes.Structure):
+    """
+        A ctypes structure that functions similarly to the str class in Python.
+
+        Fields/Attributes
+        -----------------
+        length: int64
+            An integer representing the current length of the String structure, in bytes. Bear in mind that one char in C is one byte.
+        capacity: int64
+            An integer representing the total length of the String structure, in bytes. Used to avoid buffer overflow errors.
+        attempted_to_write_more_than_capacity: int
+            A 0/1 integer flag that indicates whether the most recent write operation that was performed attempted to write more characters
+            to the string than its capacity. Essentially a simpler way to check if a buffer overflow may have occurred.
+        buffer: void*
+            A void pointer to some memory that can be written to. SHould house the bytes of string data and have at least capacity bytes of
+            memory allocated to it (if this structure is created on the C side.) The reason it is void* instead of char* is to avoid type mismatches, though
+            it may be possible to use a char* instead.
+        grow: void*
+            An optional C callback that gives the String more memory once it runs out of capacity. Strings created on the Python side should leave this as NULL.
+        grow_context: void*
+            Data used by the grow callback. Strings created on the Python side should leave this as NULL.
+        line_written: void*
+            An optional C callback run after every newline that is written. Strings created on the Python side should leave this as NULL.
+        line_start: int64
+            The offset of the start of the current line in buffer, which the C side keeps up to date. Strings created on the Python side should leave this as 0.
+
+        How To Initialize
+        -----------------
+        Initialization of a ctypes.Structure object is actually exactly the same as any custom Python class that has an __init__ function.
+        The reason it might be unintuitive is that, unlike most Python classes, you do not have to write an __init__ function for whatever reason.
+        
+        Example of initializing a String structure and accessing its attributes:
+            >>> buffer_string = String(0, 4096, 0, b"")
+            >>> print(f"Length of String: {buffer_string.length}")
+            >>> print(f"Capacity of String: {buffer_string.capacity}")
+            >>> print(f"String Contents: {str(buffer_string.buffer, 'utf-8')}")
+    """
+
+    _fields_ = [
+        ("length", ctypes.c_int64),
+        ("capacity", ctypes.c_int64),
+        ("attempted_to_write_more_than_capacity", ctypes.c_int),
+        ("buffer", ctypes.c_char_p),
+        ("grow", ctypes.c_void_p),
+        ("grow_context", ctypes.c_void_p),
+        ("line_written", ctypes.c_void_p),
+        ("line_start", ctypes.c_int64),
+    ]
+
+
+class LogBuffer:
+    """
+        A Python handle to a growable, C-owned message buffer (struct LogBuffer).
+
+        Unlike the String structure, the memory of a LogBuffer belongs to the C library and grows in fixed-size chunks,
+        so the step log is never truncated. Bytes are read back by copying them into Python-owned memory, meaning
+        nothing allocated by the library is ever handed to Python.
+
+        Attributes
+        ----------
+        handle: ctypes.c_void_p
+            The pointer to the struct LogBuffer on the C side.
+        read_offset: int
+            The number of bytes that have already been returned by read_new().
+
+        How To Initialize
+        -----------------
+            >>> log_buffer = LogBuffer()
+            >>> perform_gauss_jordan_reduction(..., log_buffer.as_string_pointer(), ...)
+            >>> print(log_buffer.read_new().decode("utf-8"))
+            >>> log_buffer.close()
+    """
+
+    def __init__(self) -> None:
+        self.handle = create_log_buffer()
+        if not self.handle:
+            raise MemoryError("Could not allocate a LogBuffer.")
+        self.read_offset = 0
+
+    def as_string_pointer(self) -> "ctypes._Pointer[String]":
+        """
+            Get the LogBuffer as a String pointer, which is what the solver functions take as their message_buffer.
+            This works because the String is the first member of struct LogBuffer.
+        """
+        return ctypes.cast(self.handle, ctypes.POINTER(String))
+
+    def __len__(self) -> int:
+        return get_log_buffer_length(self.handle)
+
+    def read_new(self) -> bytes:
+        """
+            Read every byte written since the last call to read_new().
+
+            Returns
+            -------
+            new_bytes: bytes
+                The newly written bytes. Empty if nothing new was written.
+        """
+        num_new_bytes = len(self) - self.read_offset
+        if num_new_bytes <= 0:
+            return b""
+        destination = ctypes.create_string_buffer(num_new_bytes)
+        num_bytes_read = read_log_buffer(
+            self.handle, self.read_offset, destination, num_new_bytes
+        )
+        self.read_offset += num_bytes_read
+        return destination.raw[:num_bytes_read]
+
+    def reserve(self, num_bytes: int) -> None:
+        """
+            Allocate enough chunks up front to hold num_bytes in total, e.g. the size given by measure_gauss_jordan_reduction_log,
+            so the solve itself never has to allocate.
+        """
+        if not reserve_log_buffer(self.handle, num_bytes):
+            raise MemoryError(f"Could not reserve {num_bytes} bytes for a LogBuffer.")
+
+    def reset(self) -> None:
+        """Empty the buffer. The C side keeps its chunks around so they can be reused."""
+        reset_log_buffer(self.handle)
+        self.read_offset = 0
+
+    def close(self) -> None:
+        """Free the C-side memory. Safe to call more than once."""
+        if self.handle:
+            destroy_log_buffer(self.handle)
+            self.handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+class LogRing:
+    """
+        A Python handle to a single-producer/single-consumer ring buffer (struct LogRing) that the solver publishes complete lines into.
+
+        The ring's storage is shared with the C library, so new bytes are read in place through a memoryview instead of being copied
+        into a new buffer on every poll. The solver is the only producer and this object is the only consumer, meaning the solver should
+        run on a different thread than the one calling read_new() whenever block_when_full is set.
+
+        Attributes
+        ----------
+        handle: ctypes.c_void_p
+            The pointer to the struct LogRing on the C side.
+        storage: memoryview
+            A view of the ring's bytes.
+        tail: int
+            The total number of bytes consumed so far.
+        decoder: codecs.IncrementalDecoder
+            Decodes the consumed bytes, holding back a UTF-8 sequence cut off at the end of one read until the next read completes it.
+
+        How To Initialize
+        -----------------
+            >>> log_ring = LogRing(1 << 16)
+            >>> # On the solver thread
+            >>> perform_gauss_jordan_reduction(..., log_ring.as_string_pointer(), ...)
+            >>> log_ring.flush()
+            >>> # On the reading thread
+            >>> print(log_ring.read_new())
+    """
+
+    def __init__(self, capacity: int = 1 << 16, block_when_full: bool = True) -> None:
+        self.handle = create_log_ring(capacity, int(block_when_full))
+        if not self.handle:
+            raise MemoryError("Could not allocate a LogRing.")
+        self.capacity = get_log_ring_capacity(self.handle)
+        self.storage = memoryview(
+            (ctypes.c_char * self.capacity).from_address(
+                get_log_ring_storage(self.handle)
+            )
+        ).cast("B")
+        self.tail = 0
+        self.decoder = codecs.getincrementaldecoder("utf-8")("replace")
+
+    def as_string_pointer(self) -> "ctypes._Pointer[String]":
+        """
+            Get the LogRing as a String pointer, which is what the solver functions take as their message_buffer.
+            This works because the String is the first member of struct LogRing.
+        """
+        return ctypes.cast(self.handle, ctypes.POINTER(String))
+
+    def flush(self) -> None:
+        """Publish any unfinished line. Must be called from the producer's (solver's) thread."""
+        flush_log_ring(self.handle)
+
+    def read_new(self) -> str:
+        """
+            Read every byte published since the last call and hand the space back to the producer. If the bytes end partway through a
+            multi-byte character, the start of it is held back and returned with the rest of it by the next call.
+
+            Returns
+            -------
+            text: str
+                The newly published text. Empty if nothing new was published.
+        """
+        head = get_log_ring_head(self.handle)
+        if head == self.tail:
+            return ""
+        start = self.tail & (self.capacity - 1)
+        end = start + (head - self.tail)
+        if end <= self.capacity:
+            text = self.decoder.decode(self.storage[start:end])
+        else:
+            # Join the two halves first, so a character split by the wrap is decoded whole
+            text = self.decoder.decode(
+                bytes(self.storage[start:]) + bytes(self.storage[: end - self.capacity])
+            )
+        self.tail = head
+        consume_log_ring(self.handle, self.tail)
+        return text
+
+    def close(self) -> None:
+        """Free the C-side memory. Safe to call more than once."""
+        if self.handle:
+            self.storage.release()
+            destroy_log_ring(self.handle)
+            self.handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+class Matrix:
+    """
+        A Python handle to a matrix held by the library (struct Matrix): its values and their MatrixMetadata in one object, so the two cannot
+        disagree, plus a cache of its structure so the automatic engine only analyzes it once.
+
+        A Matrix made with the constructor (or from_array) owns 64-byte aligned values, with every row padded to whole cache lines. One made
+        with view wraps an existing array without copying it, and keeps a reference to it.
+
+        Attributes
+        ----------
+        handle: ctypes.c_void_p
+            The pointer to the struct Matrix on the C side.
+        base: np.ndarray
+            The array a view wraps (None if the library owns the values).
+
+        How To Initialize
+        -----------------
+            >>> matrix = Matrix.from_array(np.random.rand(100, 100))  # Copied into aligned storage
+            >>> augment = Matrix.view(np.random.rand(100, 1))  # Not copied
+            >>> solution = matrix.solve(augment)
+            >>> matrix.array[0, 0] = 2.0
+            >>> matrix.invalidate_structure()  # The values changed, so the cached structure is stale
+            >>> matrix.close()
+    """
+
+    def __init__(
+        self, num_rows: int, num_cols: int, dtype: str = "float64", layout: int = MATRIX_LAYOUT_ROW_MAJOR
+    ) -> None:
+        if dtype not in MATRIX_DTYPES:
+            raise ValueError(f"Expected one of {tuple(MATRIX_DTYPES)}.")
+        self.base = None
+        self.handle = create_matrix(num_rows, num_cols, MATRIX_DTYPES[dtype], layout)
+        if not self.handle:
+            raise MemoryError(
+                f"Could not create a {num_rows}x{num_cols} {dtype} matrix with layout {layout} (packed layouts must be square float64)."
+            )
+
+    @classmethod
+    def from_array(cls, array, layout: int = MATRIX_LAYOUT_ROW_MAJOR) -> "Matrix":
+        """Copy a 2-D array of one of the MATRIX_DTYPES into a new, aligned Matrix with the given (unpacked) layout."""
+        if layout in MATRIX_LAYOUTS_PACKED:
+            raise ValueError("Use pack_matrix for packed layouts.")
+        matrix = cls(*array.shape, array.dtype.name, layout)
+        matrix.array[...] = array
+        return matrix
+
+    @classmethod
+    def view(cls, array) -> "Matrix":
+        """Wrap an array (any view that MatrixMetadata.from_array accepts) without copying it."""
+        metadata = MatrixMetadata.from_array(array)
+        matrix = cls.__new__(cls)
+        matrix.base = array
+        matrix.handle = view_matrix(array.ctypes.data_as(ctypes.c_void_p), ctypes.byref(metadata))
+        if not matrix.handle:
+            raise MemoryError("Could not create a Matrix view.")
+        return matrix
+
+    @property
+    def metadata(self) -> MatrixMetadata:
+        """The matrix's own metadata, read and written in place (the solvers write the rank, consistency and determinant to it)."""
+        return get_matrix_metadata(self.handle).contents
+
+    @property
+    def values(self) -> ctypes.c_void_p:
+        """The pointer to the first value, for the functions that take a bare matrix and its metadata."""
+        return ctypes.c_void_p(get_matrix_values(self.handle))
+
+    @property
+    def array(self):
+        """
+            A Numpy view of the values, with the padded strides (packed layouts give the 1-D packed values). Writing to it changes the
+            matrix; call invalidate_structure afterwards.
+        """
+        import numpy as np
+
+        metadata = self.metadata
+        dtype = np.dtype(MATRIX_DTYPE_NAMES[metadata.dtype])
+        if metadata.layout in MATRIX_LAYOUTS_PACKED:
+            shape = (metadata.num_rows * (metadata.num_rows + 1) // 2,)
+            strides = (dtype.itemsize,)
+        else:
+            row_stride = metadata.row_stride or (1 if metadata.layout == MATRIX_LAYOUT_COLUMN_MAJOR else metadata.num_cols)
+            col_stride = metadata.col_stride or (metadata.num_rows if metadata.layout == MATRIX_LAYOUT_COLUMN_MAJOR else 1)
+            shape = (metadata.num_rows, metadata.num_cols)
+            strides = (row_stride * dtype.itemsize, col_stride * dtype.itemsize)
+        # A view of a reversed array has negative strides, so the values span from the lowest offset to the highest, not from the first value
+        last_offsets = [max(extent - 1, 0) * stride for extent, stride in zip(shape, strides)]
+        lowest_offset = sum(min(offset, 0) for offset in last_offsets)
+        highest_offset = sum(max(offset, 0) for offset in last_offsets)
+        buffer = (ctypes.c_char * (highest_offset - lowest_offset + dtype.itemsize)).from_address(
+            get_matrix_values(self.handle) + lowest_offset
+        )
+        return np.ndarray(shape, dtype=dtype, buffer=buffer, offset=-lowest_offset, strides=strides)
+
+    def structure(self) -> Tuple[MatrixStructure, int]:
+        """
+            The structure profile of the matrix and the solver plan the automatic engine would pick (see analyze_matrix_structure). It is
+            analyzed once and then cached.
+        """
+        structure = MatrixStructure()
+        plan = get_matrix_structure(self.handle, ctypes.byref(structure))
+        if plan < 0:
+            raise ValueError("Only float64 matrices can be analyzed.")
+        return structure, plan
+
+    def invalidate_structure(self) -> None:
+        """Forget the cached structure. Must be called after the values are changed."""
+        invalidate_matrix_structure(self.handle)
+
+    def solve(self, augment: "Matrix", num_threads: int = 0):
+        """
+            Solve self @ X = augment with the automatic engine, reusing the cached structure. Nothing is logged.
+
+            Returns
+            -------
+            solution: np.ndarray
+                X, with the dtype of the matrix (meaningful only if metadata.is_consistent is 1).
+        """
+        import numpy as np
+
+        metadata = self.metadata
+        augment_metadata = augment.metadata
+        solution = np.zeros(
+            (metadata.num_rows, augment_metadata.num_cols), dtype=MATRIX_DTYPE_NAMES[metadata.dtype]
+        )
+        solve_matrices(
+            self.handle,
+            augment.handle,
+            ctypes.byref(String(0, 0, 0, None)),
+            ctypes.byref(SolverOptions(verbosity=LOG_VERBOSITY_SUMMARY, num_threads=num_threads)),
+            ctypes.byref(SolverOutputs.from_arrays(solution=solution)),
+        )
+        return solution
+
+    def close(self) -> None:
+        """Free the C-side matrix (and its values, if the library owns them). Safe to call more than once."""
+        if self.handle:
+            destroy_matrix(self.handle)
+            self.handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def get_dict(struct: ctypes.Structure) -> dict:
+    """
+        Convert a ctypes Structure into a Python dictionary.
+
+        Attempts to convert all fields from ctypes-specific objects
+        to Python types. This function does work recursively, so nested
+        structures should not be an issue.
+
+        NOTE: This function does NOT convert pointers into arrays.
+
+        Parameters
+        ----------
+        struct (ctypes.Structure):
+            The struct you wish to convert into a dictionary.
+
+        Returns
+        -------
+        result:
+            The resulting dictionary. Keys are taken from the field names,
+            and values are converted into Python objects.
+    """
+
+    result = {}
+    for field, _ in struct._fields_:
+        value = getattr(struct, field)
+        # If it's not a primitive type and it evaluates to false then we assume it's a null pointer/value
+        if (type(value) not in [int, float, bool, bytes]) and not bool(value):
+            value = None
+        # If it's an array, pass for now. We might be able to convert it into a Numpy array later
+        elif hasattr(value, "_type_"):
+            pass
+        # If it is has fields then it is probably a ctypes Structure, so we recursively call get_dict.
+        elif hasattr(value, "_fields_"):
+            value = get_dict(value)
+        result[field] = value
+    return result
+
+
+# @profile
+def string_read_line(
+    buffer: Union[bytearray, bytes], start_index: int = 0
+) -> Tuple[bytearray, int]:
+    """
+        Read a line from a buffer.
+
+        Read characters from a buffer of bytes, starting either from the start_index value provided
+        until either a newline is hit or None is hit. Once this happens, it returns the characters that
+        have been appended so far, along with the index of where the next call to the function should start.
+
+        NOTE: This function does not append return carriage ('\\r') tokens, effectively stripping them out.
+
+        Parameters
+        ----------
+        buffer: bytes
+            A buffer of characters to be read. The implicit assumption of the buffer is that the characters
+            fall within the UTF-8 encoding (ASCII probably works too).
+        start_index: int, default 0
+            The index to start from when enumerating. It is used to create a slice copy of the buffer.
+
+        Returns
+        -------
+        ret: Tuple[bytearray, int]
+            A tuple that contains the following pieces:
+            byte_array_to_display: bytearray
+                A mutable form of the characters that were read from the buffer.
+            index: int
+                The index of the last character present in byte_array_to_display.
+    """
+    byte_array_to_display: bytearray = bytearray()
+    for index, byte in enumerate(buffer[start_index:]):
+        if byte is not None:
+            if byte != ord("\r") and byte != ord("\n"):
+                byte_array_to_display.append(byte)
+            # If a newline is reached then a complete chunk of data is ready to process
+            if byte == ord("\n"):
+                # print(f"Record to return (hit newline): {byte_array_to_display}")
+                return byte_array_to_display, index + 1
+        else:
+            # print(f"Record to return (none byte): {byte_array_to_display}")
+            if isinstance(buffer, bytearray):
+                buffer.clear()
+            return byte_array_to_display, index
+    # If somehow the buffer is either empty or reaching the end of it doesn't trigger the other return statements
+    if start_index >= len(buffer) and isinstance(buffer, bytearray):
+        buffer.clear()
+    return bytearray("", "utf-8"), 0
+
+
+def time_solver(
+    solver, matrix_to_reduce, matrix_augment, solver_options, repeats: int = 5
+) -> Tuple[float, float, float]:
+    """
+        Solve a system several times with one solver and report the fastest run. Nothing is logged, whatever the verbosity in solver_options
+        (the message buffer is a zero-capacity String).
+
+        Parameters
+        ----------
+        solver: ctypes function
+            perform_gauss_jordan_reduction, or one of the engines with the same arguments (e.g., perform_recursive_lu_reduction).
+        matrix_to_reduce: np.ndarray
+            The matrix A of Ax = b, of any of the MATRIX_DTYPES. Any view is passed as it is (see MatrixMetadata.from_array). It is not modified.
+        matrix_augment: np.ndarray
+            The augment b of Ax = b, with one column per right-hand side and the dtype of A. Any view is passed as it is. It is not modified.
+        solver_options: SolverOptions
+            The options to solve with.
+        repeats: int, default 5
+            How many times to solve.
+
+        Returns
+        -------
+        timing: Tuple[float, float, float]
+            The elapsed seconds, the seconds spent searching for pivots, and the largest absolute residual of A @ x - b
+            (NaN if the system is inconsistent or has more columns than rows).
+    """
+    import numpy as np
+
+    num_rows, num_cols = matrix_to_reduce.shape
+    num_augment_cols = matrix_augment.shape[1]
+    discard_log = String(0, 0, 0, None)
+    solution = np.empty((num_rows, num_augment_cols), dtype=matrix_to_reduce.dtype)
+    best_elapsed_seconds = best_pivot_search_seconds = float("inf")
+    for _ in range(repeats):
+        metadata = MatrixMetadata.from_array(matrix_to_reduce)
+        augment_metadata = MatrixMetadata.from_array(matrix_augment)
+        solver_outputs = SolverOutputs.from_arrays(solution=solution)
+        solver(
+            matrix_to_reduce.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+            matrix_augment.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+            ctypes.byref(discard_log),
+            ctypes.byref(metadata),
+            ctypes.byref(augment_metadata),
+            ctypes.byref(solver_options),
+            ctypes.byref(solver_outputs),
+        )
+        if solver_outputs.elapsed_seconds < best_elapsed_seconds:
+            best_elapsed_seconds = solver_outputs.elapsed_seconds
+            best_pivot_search_seconds = solver_outputs.pivot_search_seconds
+    residual = float("nan")
+    if num_rows >= num_cols and metadata.is_consistent == 1:
+        residual = float(
+            np.max(np.abs(matrix_to_reduce @ solution[:num_cols] - matrix_augment))
+        )
+    return best_elapsed_seconds, best_pivot_search_seconds, residual
+
+
+def compare_pivot_strategies(
+    matrix_to_reduce, matrix_augment, repeats: int = 5
+) -> Dict[int, Tuple[float, float, float]]:
+    """
+        Solve the same system with every pivot strategy, to find the cheapest one that is still stable for a workload.
+
+        Returns
+        -------
+        timings: Dict[int, Tuple[float, float, float]]
+            For each PIVOT_STRATEGY_* value, the result of time_solver with the Gauss-Jordan engine.
+    """
+    return {
+        pivot_strategy: time_solver(
+            perform_gauss_jordan_reduction,
+            matrix_to_reduce,
+            matrix_augment,
+            SolverOptions(verbosity=LOG_VERBOSITY_SUMMARY, pivot_strategy=pivot_strategy),
+            repeats,
+        )
+        for pivot_strategy in (
+            PIVOT_STRATEGY_NONE,
+            PIVOT_STRATEGY_PARTIAL,
+            PIVOT_STRATEGY_ROOK,
+            PIVOT_STRATEGY_COMPLETE,
+        )
+    }
+
+
+def compare_engines(
+    matrix_to_reduce, matrix_augment, repeats: int = 5, num_threads: int = 0
+) -> Dict[str, Tuple[float, float, float]]:
+    """
+        Solve the same system with the Gauss-Jordan loop (with partial pivoting) and with every LU engine, to benchmark them head to head.
+
+        Returns
+        -------
+        timings: Dict[str, Tuple[float, float, float]]
+            For each engine's name, the result of time_solver.
+    """
+    solver_options = SolverOptions(
+        verbosity=LOG_VERBOSITY_SUMMARY,
+        pivot_strategy=PIVOT_STRATEGY_PARTIAL,
+        num_threads=num_threads,
+    )
+    engines = {
+        "gauss_jordan": perform_gauss_jordan_reduction,
+        "calu": perform_calu_reduction,
+        "tiled_lu": perform_tiled_lu_reduction,
+        "recursive_lu": perform_recursive_lu_reduction,
+        "automatic": perform_automatic_reduction,
+        "block_diagonal": perform_block_diagonal_reduction,
+    }
+    return {
+        name: time_solver(engine, matrix_to_reduce, matrix_augment, solver_options, repeats)
+        for name, engine in engines.items()
+    }
+
+
+def multiply_matrices(matrix_one, matrix_two, num_threads: int = 0):
+    """
+        Multiply two matrices with the library's packed, threaded matrix product.
+
+        Parameters
+        ----------
+        matrix_one: np.ndarray
+            The left-hand side, with dimensions MxK. A float64 view (a slice, a transpose, ...) is read in place.
+        matrix_two: np.ndarray
+            The right-hand side, with dimensions KxN. A float64 view is read in place.
+        num_threads: int, default 0
+            The number of threads. 0 uses every hardware thread.
+
+        Returns
+        -------
+        product: np.ndarray
+            The MxN product.
+    """
+    import numpy as np
+
+    matrix_one = np.asarray(matrix_one, dtype=np.float64)
+    matrix_two = np.asarray(matrix_two, dtype=np.float64)
+    num_rows, num_inner = matrix_one.shape
+    if matrix_two.shape[0] != num_inner:
+        raise ValueError(
+            f"Cannot multiply a {matrix_one.shape} matrix by a {matrix_two.shape} matrix"
+        )
+    product = np.empty((num_rows, matrix_two.shape[1]))
+    product_metadata = MatrixMetadata(-1, -1, -1, -1, -1)
+    multiply_matrices_ctypes(
+        matrix_one.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        matrix_two.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        product.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(MatrixMetadata.from_array(matrix_one)),
+        ctypes.byref(MatrixMetadata.from_array(matrix_two)),
+        ctypes.byref(product_metadata),
+        ctypes.byref(SolverOptions(num_threads=num_threads)),
+    )
+    return product
+
+
+def factor_lu(matrix_to_factor, num_threads: int = 0):
+    """
+        Factor a square matrix once as P*A = L*U, to solve it against many right-hand sides later with solve_lu.
+
+        Parameters
+        ----------
+        matrix_to_factor: np.ndarray
+            The (C-contiguous, float64) square matrix. It is not modified.
+        num_threads: int, default 0
+            The number of threads. 0 uses every hardware thread.
+
+        Returns
+        -------
+        factors: Tuple[np.ndarray, np.ndarray]
+            The factored matrix (L below the diagonal, U on and above it) and the row interchanges.
+
+        Raises
+        ------
+        ValueError
+            If the matrix is not square or is singular.
+    """
+    import numpy as np
+
+    num_rows, num_cols = matrix_to_factor.shape
+    lu_matrix = np.array(matrix_to_factor, dtype=np.float64, order="C")
+    pivots = np.empty(num_rows, dtype=np.intc)
+    metadata = MatrixMetadata(num_rows, num_cols, -1, -1, -1)
+    if not factor_lu_ctypes(
+        lu_matrix.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(metadata),
+        pivots.ctypes.data_as(ctypes.POINTER(ctypes.c_int)),
+        ctypes.byref(SolverOptions(num_threads=num_threads)),
+    ):
+        raise ValueError("The matrix provided is not square or is singular")
+    return lu_matrix, pivots
+
+
+def solve_lu(lu_matrix, pivots, matrix_augment, num_threads: int = 0):
+    """
+        Solve A @ x = b with the factors from factor_lu, for every column of b at once (split across threads).
+
+        Returns
+        -------
+        solution: np.ndarray
+            x, with the same shape as matrix_augment (which is not modified).
+    """
+    import numpy as np
+
+    solution = np.array(matrix_augment, dtype=np.float64, order="C")
+    solution_2d = solution.reshape(solution.shape[0], -1)
+    solve_lu_ctypes(
+        lu_matrix.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        pivots.ctypes.data_as(ctypes.POINTER(ctypes.c_int)),
+        ctypes.byref(MatrixMetadata(*lu_matrix.shape, -1, -1, -1)),
+        solution_2d.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(MatrixMetadata(*solution_2d.shape, -1, -1, -1)),
+        ctypes.byref(SolverOptions(num_threads=num_threads)),
+    )
+    return solution
+
+
+def analyze_matrix_structure(matrix_to_analyze) -> Tuple[MatrixStructure, int]:
+    """
+        Profile the structure of a matrix in one pass, and find out which solver perform_automatic_reduction would route it to.
+
+        Returns
+        -------
+        analysis: Tuple[MatrixStructure, int]
+            The structure profile, and one of the SOLVER_PLAN_* values (-1 if the matrix could not be analyzed).
+    """
+    import numpy as np
+
+    matrix = np.asarray(matrix_to_analyze, dtype=np.float64)
+    structure = MatrixStructure()
+    plan = analyze_matrix_structure_ctypes(
+        matrix.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(MatrixMetadata.from_array(matrix)),
+        ctypes.byref(structure),
+    )
+    return structure, plan
+
+
+def invert_small_matrices(matrices, num_threads: int = 0):
+    """
+        Invert a batch of 2x2, 3x3 or 4x4 matrices and take their determinants at once, with the closed-form SIMD kernels.
+
+        Raises
+        ------
+        ValueError
+            If matrices is not an (N, n, n) array with n in (2, 3, 4).
+
+        Returns
+        -------
+        results: Tuple[np.ndarray, np.ndarray, np.ndarray]
+            The (N, n, n) inverses (all zeros for singular matrices), the N determinants, and an N boolean mask of the singular matrices.
+    """
+    import numpy as np
+
+    batch = np.ascontiguousarray(matrices, dtype=np.float64)
+    if batch.ndim != 3 or batch.shape[1] != batch.shape[2] or batch.shape[1] not in (2, 3, 4):
+        raise ValueError("Expected an (N, n, n) array of matrices with n = 2, 3 or 4")
+    inverses = np.empty_like(batch)
+    determinants = np.empty(batch.shape[0], dtype=np.float64)
+    singular_mask = np.empty(batch.shape[0], dtype=np.intc)
+    invert_small_matrices_ctypes(
+        batch.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        batch.shape[1],
+        batch.shape[0],
+        inverses.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        determinants.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        singular_mask.ctypes.data_as(ctypes.POINTER(ctypes.c_int)),
+        ctypes.byref(SolverOptions(num_threads=num_threads)),
+    )
+    return inverses, determinants, singular_mask.astype(bool)
+
+
+def transpose_matrix(matrix, in_place: bool = False, num_threads: int = 0):
+    """
+        Transpose a 2-D float64 array with the library's blocked, SIMD transpose.
+
+        Parameters
+        ----------
+        matrix: np.ndarray
+            The matrix, in any layout (see MatrixMetadata.from_array).
+        in_place: bool, default False
+            Transpose the values of matrix itself. It must be C- or Fortran-contiguous, or square with a unit column (or row) stride.
+        num_threads: int, default 0
+            The number of threads. 0 uses every hardware thread.
+
+        Raises
+        ------
+        ValueError
+            If matrix is not float64, or cannot be transposed in place.
+
+        Returns
+        -------
+        transpose: np.ndarray
+            A new C-contiguous array, or (in place) a view of the memory of matrix with the transposed shape and the same layout.
+    """
+    import numpy as np
+
+    metadata = MatrixMetadata.from_array(matrix)
+    if metadata.dtype != MATRIX_DTYPE_FLOAT64:
+        raise ValueError("Only float64 matrices can be transposed.")
+    options = ctypes.byref(SolverOptions(num_threads=num_threads))
+    if not in_place:
+        transpose = np.empty((matrix.shape[1], matrix.shape[0]))
+        transpose_matrix_ctypes(
+            matrix.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+            ctypes.byref(metadata),
+            transpose.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+            ctypes.byref(MatrixMetadata(*transpose.shape, -1, -1, -1)),
+            options,
+        )
+        return transpose
+    if not transpose_matrix_ctypes(
+        matrix.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(metadata),
+        None,
+        None,
+        options,
+    ):
+        raise ValueError("Only square or contiguous matrices can be transposed in place.")
+    return np.lib.stride_tricks.as_strided(
+        matrix,
+        shape=(metadata.num_rows, metadata.num_cols),
+        strides=(metadata.row_stride * matrix.itemsize, metadata.col_stride * matrix.itemsize),
+    )
+
+
+def compute_determinant(matrix, num_threads: int = 0):
+    """
+        Compute the determinant and rank of a square matrix with the type-generic forward elimination, in the matrix's own arithmetic.
+
+        Parameters
+        ----------
+        matrix: np.ndarray
+            A square float32, float64, complex64 or complex128 matrix, in any layout (see MatrixMetadata.from_array). It is not modified.
+        num_threads: int, default 0
+            The number of threads. 0 uses every hardware thread.
+
+        Raises
+        ------
+        ValueError
+            If matrix is not square.
+
+        Returns
+        -------
+        result: Tuple[Union[float, complex], int]
+            The determinant (complex for complex matrices) and the rank.
+    """
+    metadata = MatrixMetadata.from_array(matrix)
+    if not compute_determinant_ctypes(
+        matrix.ctypes.data_as(ctypes.c_void_p),
+        ctypes.byref(metadata),
+        ctypes.byref(SolverOptions(num_threads=num_threads)),
+    ):
+        raise ValueError("Expected a square matrix.")
+    if metadata.dtype in (MATRIX_DTYPE_COMPLEX64, MATRIX_DTYPE_COMPLEX128):
+        return complex(metadata.matrix_determinant, metadata.matrix_determinant_imag), metadata.matrix_rank
+    return metadata.matrix_determinant, metadata.matrix_rank
+
+
+def pack_matrix(matrix, layout: int):
+    """
+        Keep only one triangle of a square matrix, row after row, which is what the MATRIX_LAYOUT_PACKED_* layouts describe. It takes about half
+        the memory, and can be passed to any engine in place of the full matrix.
+
+        Parameters
+        ----------
+        matrix: np.ndarray
+            A square matrix. Only the triangle the layout names is read, so the other one need not be filled in.
+        layout: int
+            One of the MATRIX_LAYOUT_PACKED_* values.
+
+        Raises
+        ------
+        ValueError
+            If matrix is not square, or layout is not one of the packed layouts.
+
+        Returns
+        -------
+        result: Tuple[np.ndarray, MatrixMetadata]
+            The packed float64 values (matrix[np.triu_indices(n)] or matrix[np.tril_indices(n)]) and their metadata.
+    """
+    import numpy as np
+
+    if matrix.ndim != 2 or matrix.shape[0] != matrix.shape[1]:
+        raise ValueError("Expected a square matrix.")
+    size = matrix.shape[0]
+    is_upper = layout in (MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR, MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC)
+    indices = np.triu_indices(size) if is_upper else np.tril_indices(size)
+    packed = np.ascontiguousarray(matrix[indices], dtype=np.float64)
+    return packed, MatrixMetadata.from_packed(packed, size, layout)
+
+
+def find_library_file() -> ctypes.CDLL:
+    """A small helper function to find and load the shared object file for elevation parsing.
+
+    Raises:
+        ValueError: If the shared object file is not in the same directory as this file, then
+        an error is raised to inform the developer that they need to place it there manually.
+        This is because I cannot be certain of what any new data directory structure looks like.
+
+    Returns:
+        ctypes.CDLL: The Dynamic Loaded Library (DLL) or Shared Object (SO) file.
+    """
+    current_directory = os.getcwd()
+    current_system = sys_platform
+    file_to_load: str = ""
+    if current_system == "win32":
+        file_to_load = os.path.join(current_directory, "row_reduction.dll")
+    else:
+        file_to_load = os.path.join(current_directory, "row_reduction.so")
+    print(f"Platform: {current_system}\tLoading File: {file_to_load}")
+    if os.path.exists(file_to_load):
+        return ctypes.cdll.LoadLibrary(file_to_load)
+    else:
+        raise ValueError(
+            f"{file_to_load} cannot be found in current directory {current_directory}. Please make sure this file is in the same location as {__name__}.py"
+        )
+
+
+###############################################################################
+#                                                                             #
+#                                                                             #
+#               CTYPES_LINEAR_ALGEBRA CODE THAT RUNS ON STARTUP               #
+#                                                                             #
+#                                                                             #
+###############################################################################
+
+linear_algebra_dll = find_library_file()
+perform_gauss_jordan_reduction = (
+    linear_algebra_dll.python_perform_gauss_jordan_reduction
+)
+# While I am not certain that the order of the arguments matters, I do it anyway to potentially avoid any bugs.
+perform_gauss_jordan_reduction.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix_to_reduce
+    ctypes.POINTER(ctypes.c_double),  # matrix_augment
+    ctypes.POINTER(String),  # String *message_buffer
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *augment_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+    ctypes.POINTER(SolverOutputs),  # SolverOutputs *outputs
+)
+# The restype is None because the function on the C side of the code is void
+perform_gauss_jordan_reduction.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but A and b are reduced where they are instead of in a combined copy:
+# on return A holds its reduced row echelon form and b the solution. Both must be float64 and not packed.
+perform_gauss_jordan_reduction_in_place = (
+    linear_algebra_dll.python_perform_gauss_jordan_reduction_in_place
+)
+perform_gauss_jordan_reduction_in_place.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_gauss_jordan_reduction_in_place.restype = None
+
+# Workspace sizes in bytes for the *_with_workspace variants below, or -1 if the system cannot be solved in a workspace.
+get_gauss_jordan_workspace_size = linear_algebra_dll.python_get_gauss_jordan_workspace_size
+get_gauss_jordan_workspace_size.argtypes = (
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *augment_metadata
+)
+get_gauss_jordan_workspace_size.restype = ctypes.c_int64
+get_gauss_jordan_in_place_workspace_size = (
+    linear_algebra_dll.python_get_gauss_jordan_in_place_workspace_size
+)
+get_gauss_jordan_in_place_workspace_size.argtypes = get_gauss_jordan_workspace_size.argtypes
+get_gauss_jordan_in_place_workspace_size.restype = ctypes.c_int64
+
+# Same as perform_gauss_jordan_reduction(_in_place), with two more arguments: a workspace of at least the size above (e.g., a numpy uint8
+# array allocated once and reused across solves) and its size. They make no heap allocations, and return 0 without solving if the workspace
+# is too small.
+perform_gauss_jordan_reduction_with_workspace = (
+    linear_algebra_dll.python_perform_gauss_jordan_reduction_with_workspace
+)
+perform_gauss_jordan_reduction_with_workspace.argtypes = perform_gauss_jordan_reduction.argtypes + (
+    ctypes.c_void_p,  # void *workspace
+    ctypes.c_int64,  # int64_t workspace_size
+)
+perform_gauss_jordan_reduction_with_workspace.restype = ctypes.c_int
+perform_gauss_jordan_reduction_in_place_with_workspace = (
+    linear_algebra_dll.python_perform_gauss_jordan_reduction_in_place_with_workspace
+)
+perform_gauss_jordan_reduction_in_place_with_workspace.argtypes = perform_gauss_jordan_reduction_with_workspace.argtypes
+perform_gauss_jordan_reduction_in_place_with_workspace.restype = ctypes.c_int
+
+# The solvers without a workspace reuse per-thread temporaries between calls. This frees the calling thread's and returns how many bytes it freed.
+trim_workspace_pool = linear_algebra_dll.python_trim_workspace_pool
+trim_workspace_pool.argtypes = ()
+trim_workspace_pool.restype = ctypes.c_int64
+
+# Where large solves place their memory and threads (see MemoryPlacementOptions). set_memory_placement returns how many NUMA nodes the
+# worker threads are pinned across, or 0 if they are not pinned.
+set_memory_placement = linear_algebra_dll.python_set_memory_placement
+set_memory_placement.argtypes = (ctypes.POINTER(MemoryPlacementOptions),)  # MemoryPlacementOptions *options
+set_memory_placement.restype = ctypes.c_int
+get_memory_placement = linear_algebra_dll.python_get_memory_placement
+get_memory_placement.argtypes = (ctypes.POINTER(MemoryPlacementOptions),)  # MemoryPlacementOptions *options
+get_memory_placement.restype = None
+
+perform_square_matrix_inversion = (
+    linear_algebra_dll.python_perform_square_matrix_inversion_gaussian_reduction
+)
+# While I am not certain that the order of the arguments matters, I do it anyway to potentially avoid any bugs.
+perform_square_matrix_inversion.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # *matrix_to_invert
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_to_invert_metadata
+    ctypes.POINTER(String),  # String *message_buffer
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+    ctypes.POINTER(SolverOutputs),  # SolverOutputs *outputs
+)
+# The restype is None because the function on the C side of the code is void. A singular matrix leaves the outputs untouched, which
+# MatrixMetadata.matrix_rank reports by not being the size of the matrix.
+perform_square_matrix_inversion.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but factors square systems with tournament-pivoted LU (CALU) on several threads.
+perform_calu_reduction = linear_algebra_dll.python_perform_calu_reduction
+perform_calu_reduction.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_calu_reduction.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but factors square systems with a tiled LU run as a work-stealing task graph.
+perform_tiled_lu_reduction = linear_algebra_dll.python_perform_tiled_lu_reduction
+perform_tiled_lu_reduction.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_tiled_lu_reduction.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but factors square systems with a cache-oblivious recursive LU.
+perform_recursive_lu_reduction = linear_algebra_dll.python_perform_recursive_lu_reduction
+perform_recursive_lu_reduction.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_recursive_lu_reduction.restype = None
+
+# C = A*B with the packed, register-blocked matrix product the LU engines use for their trailing updates.
+multiply_matrices_ctypes = linear_algebra_dll.python_multiply_matrices
+multiply_matrices_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix_one
+    ctypes.POINTER(ctypes.c_double),  # matrix_two
+    ctypes.POINTER(ctypes.c_double),  # result_matrix
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_one_metadata
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_two_metadata
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *result_matrix_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+multiply_matrices_ctypes.restype = None
+
+# Same arguments and results as perform_square_matrix_inversion, but factors once with the recursive LU engine and solves for the columns
+# of the inverse with the blocked, multithreaded triangular solves.
+perform_square_matrix_inversion_lu = (
+    linear_algebra_dll.python_perform_square_matrix_inversion_lu
+)
+perform_square_matrix_inversion_lu.argtypes = perform_square_matrix_inversion.argtypes
+perform_square_matrix_inversion_lu.restype = None
+
+# The workspace size and the allocation-free variant of perform_square_matrix_inversion, as for perform_gauss_jordan_reduction_with_workspace.
+get_square_matrix_inversion_workspace_size = (
+    linear_algebra_dll.python_get_square_matrix_inversion_workspace_size
+)
+get_square_matrix_inversion_workspace_size.argtypes = (
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_to_invert_metadata
+)
+get_square_matrix_inversion_workspace_size.restype = ctypes.c_int64
+perform_square_matrix_inversion_with_workspace = (
+    linear_algebra_dll.python_perform_square_matrix_inversion_gaussian_reduction_with_workspace
+)
+perform_square_matrix_inversion_with_workspace.argtypes = perform_square_matrix_inversion.argtypes + (
+    ctypes.c_void_p,  # void *workspace
+    ctypes.c_int64,  # int64_t workspace_size
+)
+perform_square_matrix_inversion_with_workspace.restype = ctypes.c_int
+
+factor_lu_ctypes = linear_algebra_dll.python_factor_lu
+factor_lu_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(ctypes.c_int),  # int *pivots
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+# 1 if the matrix was factored, 0 if it is not square or is singular
+factor_lu_ctypes.restype = ctypes.c_int
+
+solve_lu_ctypes = linear_algebra_dll.python_solve_lu
+solve_lu_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # lu_matrix
+    ctypes.POINTER(ctypes.c_int),  # int *pivots
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(ctypes.c_double),  # matrix_augment
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_augment_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+solve_lu_ctypes.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but routes the system to the cheapest solver for the structure of A.
+perform_automatic_reduction = linear_algebra_dll.python_perform_automatic_reduction
+perform_automatic_reduction.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_automatic_reduction.restype = None
+
+# Same arguments and results as perform_gauss_jordan_reduction, but splits A into independent diagonal blocks and solves them concurrently.
+# Also writes the rank of A to MatrixMetadata.matrix_rank.
+perform_block_diagonal_reduction = linear_algebra_dll.python_perform_block_diagonal_reduction
+perform_block_diagonal_reduction.argtypes = perform_gauss_jordan_reduction.argtypes
+perform_block_diagonal_reduction.restype = None
+
+analyze_matrix_structure_ctypes = linear_algebra_dll.python_analyze_matrix_structure
+analyze_matrix_structure_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix_to_analyze
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(MatrixStructure),  # MatrixStructure *structure
+)
+# One of the SOLVER_PLAN_* values, or -1 if the matrix could not be analyzed
+analyze_matrix_structure_ctypes.restype = ctypes.c_int
+
+invert_small_matrices_ctypes = linear_algebra_dll.python_invert_small_matrices
+invert_small_matrices_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrices
+    ctypes.c_int,  # int size
+    ctypes.c_int,  # int num_matrices
+    ctypes.POINTER(ctypes.c_double),  # inverses
+    ctypes.POINTER(ctypes.c_double),  # determinants
+    ctypes.POINTER(ctypes.c_int),  # int *singular_mask
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+# The number of singular matrices, or -1 if size is not 2, 3 or 4
+invert_small_matrices_ctypes.restype = ctypes.c_int
+
+transpose_matrix_ctypes = linear_algebra_dll.python_transpose_matrix
+transpose_matrix_ctypes.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(ctypes.c_double),  # result_matrix (None to transpose in place)
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *result_matrix_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+# 1 if the matrix was transposed, 0 if it could not be transposed in place
+transpose_matrix_ctypes.restype = ctypes.c_int
+
+compute_determinant_ctypes = linear_algebra_dll.python_compute_determinant
+compute_determinant_ctypes.argtypes = (
+    ctypes.c_void_p,  # matrix (values of metadata.dtype)
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+# 1 if the determinant was computed, 0 if the matrix is not square or its dtype is not supported
+compute_determinant_ctypes.restype = ctypes.c_int
+
+measure_gauss_jordan_reduction_log = (
+    linear_algebra_dll.python_measure_gauss_jordan_reduction_log
+)
+measure_gauss_jordan_reduction_log.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # matrix_to_reduce
+    ctypes.POINTER(ctypes.c_double),  # matrix_augment
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *augment_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+measure_gauss_jordan_reduction_log.restype = ctypes.c_int64
+
+measure_square_matrix_inversion_log = (
+    linear_algebra_dll.python_measure_square_matrix_inversion_log
+)
+measure_square_matrix_inversion_log.argtypes = (
+    ctypes.POINTER(ctypes.c_double),  # *matrix_to_invert
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *matrix_to_invert_metadata
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+)
+measure_square_matrix_inversion_log.restype = ctypes.c_int64
+
+create_matrix = linear_algebra_dll.python_create_matrix
+create_matrix.argtypes = (
+    ctypes.c_int,  # int num_rows
+    ctypes.c_int,  # int num_cols
+    ctypes.c_int,  # int dtype
+    ctypes.c_int,  # int layout
+)
+create_matrix.restype = ctypes.c_void_p  # struct Matrix *
+
+view_matrix = linear_algebra_dll.python_view_matrix
+view_matrix.argtypes = (
+    ctypes.c_void_p,  # values
+    ctypes.POINTER(MatrixMetadata),  # MatrixMetadata *metadata
+)
+view_matrix.restype = ctypes.c_void_p  # struct Matrix *
+
+destroy_matrix = linear_algebra_dll.python_destroy_matrix
+destroy_matrix.argtypes = (ctypes.c_void_p,)  # struct Matrix *matrix
+destroy_matrix.restype = None
+
+get_matrix_values = linear_algebra_dll.python_get_matrix_values
+get_matrix_values.argtypes = (ctypes.c_void_p,)  # struct Matrix *matrix
+get_matrix_values.restype = ctypes.c_void_p
+
+get_matrix_metadata = linear_algebra_dll.python_get_matrix_metadata
+get_matrix_metadata.argtypes = (ctypes.c_void_p,)  # struct Matrix *matrix
+get_matrix_metadata.restype = ctypes.POINTER(MatrixMetadata)
+
+invalidate_matrix_structure = linear_algebra_dll.python_invalidate_matrix_structure
+invalidate_matrix_structure.argtypes = (ctypes.c_void_p,)  # struct Matrix *matrix
+invalidate_matrix_structure.restype = None
+
+get_matrix_structure = linear_algebra_dll.python_get_matrix_structure
+get_matrix_structure.argtypes = (
+    ctypes.c_void_p,  # struct Matrix *matrix
+    ctypes.POINTER(MatrixStructure),  # MatrixStructure *structure
+)
+# One of the SOLVER_PLAN_* values, or -1 if the matrix could not be analyzed
+get_matrix_structure.restype = ctypes.c_int
+
+# Same results as perform_automatic_reduction, for A and B held in two struct Matrix (A's structure is cached between solves)
+solve_matrices = linear_algebra_dll.python_solve_matrices
+solve_matrices.argtypes = (
+    ctypes.c_void_p,  # struct Matrix *matrix
+    ctypes.c_void_p,  # struct Matrix *augment
+    ctypes.POINTER(String),  # String *message_buffer
+    ctypes.POINTER(SolverOptions),  # SolverOptions *options
+    ctypes.POINTER(SolverOutputs),  # SolverOutputs *outputs
+)
+solve_matrices.restype = None
+
+create_log_buffer = linear_algebra_dll.python_create_log_buffer
+create_log_buffer.argtypes = ()
+create_log_buffer.restype = ctypes.c_void_p  # struct LogBuffer *
+
+destroy_log_buffer = linear_algebra_dll.python_destroy_log_buffer
+destroy_log_buffer.argtypes = (ctypes.c_void_p,)  # struct LogBuffer *log_buffer
+destroy_log_buffer.restype = None
+
+reset_log_buffer = linear_algebra_dll.python_reset_log_buffer
+reset_log_buffer.argtypes = (ctypes.c_void_p,)  # struct LogBuffer *log_buffer
+reset_log_buffer.restype = None
+
+reserve_log_buffer = linear_algebra_dll.python_reserve_log_buffer
+reserve_log_buffer.argtypes = (
+    ctypes.c_void_p,  # struct LogBuffer *log_buffer
+    ctypes.c_int64,  # int64_t num_bytes
+)
+reserve_log_buffer.restype = ctypes.c_int
+
+get_log_buffer_length = linear_algebra_dll.python_get_log_buffer_length
+get_log_buffer_length.argtypes = (ctypes.c_void_p,)  # struct LogBuffer *log_buffer
+get_log_buffer_length.restype = ctypes.c_int64
+
+read_log_buffer = linear_algebra_dll.python_read_log_buffer
+read_log_buffer.argtypes = (
+    ctypes.c_void_p,  # struct LogBuffer *log_buffer
+    ctypes.c_int64,  # int64_t offset
+    ctypes.c_char_p,  # char *destination
+    ctypes.c_int64,  # int64_t destination_capacity
+)
+read_log_buffer.restype = ctypes.c_int64
+
+create_log_ring = linear_algebra_dll.python_create_log_ring
+create_log_ring.argtypes = (
+    ctypes.c_int64,  # int64_t capacity
+    ctypes.c_int,  # int block_when_full
+)
+create_log_ring.restype = ctypes.c_void_p  # struct LogRing *
+
+destroy_log_ring = linear_algebra_dll.python_destroy_log_ring
+destroy_log_ring.argtypes = (ctypes.c_void_p,)  # struct LogRing *log_ring
+destroy_log_ring.restype = None
+
+flush_log_ring = linear_algebra_dll.python_flush_log_ring
+flush_log_ring.argtypes = (ctypes.c_void_p,)  # struct LogRing *log_ring
+flush_log_ring.restype = None
+
+get_log_ring_storage = linear_algebra_dll.python_get_log_ring_storage
+get_log_ring_storage.argtypes = (ctypes.c_void_p,)  # struct LogRing *log_ring
+# c_void_p rather than c_char_p, otherwise ctypes would copy the storage into a bytes object
+get_log_ring_storage.restype = ctypes.c_void_p
+
+get_log_ring_capacity = linear_algebra_dll.python_get_log_ring_capacity
+get_log_ring_capacity.argtypes = (ctypes.c_void_p,)  # struct LogRing *log_ring
+get_log_ring_capacity.restype = ctypes.c_int64
+
+get_log_ring_head = linear_algebra_dll.python_get_log_ring_head
+get_log_ring_head.argtypes = (ctypes.c_void_p,)  # struct LogRing *log_ring
+get_log_ring_head.restype = ctypes.c_int64
+
+consume_log_ring = linear_algebra_dll.python_consume_log_ring
+consume_log_ring.argtypes = (
+    ctypes.c_void_p,  # struct LogRing *log_ring
+    ctypes.c_int64,  # int64_t new_tail
+)
+consume_log_ring.restype = None
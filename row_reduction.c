@@ -1,959 +1,5259 @@
-#include <stdint.h>
-#include <stdio.h>
-#include <fcntl.h>
-#include "String.c"
-#include "stdlib.h"
-#ifdef _WIN32
-#define EXPORT __declspec(dllexport)
-#endif
-#ifdef linux
-#include <unistd.h>
-#define EXPORT
-#endif
-
-// This is used for mitigating non-zero values caused by floating point error.
-const double MARGIN_OF_ERROR = 1e-6;
-
-/**
- * @brief The metadata associated with a given matrix.
- * @param num_rows: int
- *      The number of rows in the matrix.
- * @param num_cols: int
- *      The number of columns in the matrix.
- * @param matrix_rank: int
- *      The rank of the matrix, or the number of linearly independent variables present in the matrix.
- * @param is_consistent: int
- *      A boolean flag that indicates whether the matrix is consistent, meaning there exists some set of values that satisfy all equations in the matrix.
- * @param matrix_determinant: double
- *      The determinant of the matrix. A nonzero determinant indicates the matrix is invertible.
- */
-struct MatrixMetadata
-{
-    int num_rows;
-    int num_cols;
-    int matrix_rank;
-    int is_consistent;
-    double matrix_determinant;
-} MatrixMetadata;
-
-/**
- * @brief Stack two arrays vertically like the diagram below:
- *  ------------------
- *  |                |                     ------------------
- *  |   ARRAY ONE    |                     |                |
- *  |                |                     |                |
- *  ------------------                     | COMBINED ARRAY |
- *          +                 =====>       |                |
- *  ------------------                     |                |
- *  |                |                     |                |
- *  |   ARRAY TWO    |                     ------------------
- *  |                |
- *  ------------------
- *
- *  @param matrix_one: double[ptr]
- *      The data structure of the left-hand side of the vstack operation, and should have dimensions MxN.
- *  @param matrix_two: double[ptr]
- *      The data structure of the right-hand side of the vstack operation, and should have dimensions QxN.
- *  @param result_matrix: double[ptr]
- *      The data structure of the combination of matrix_one and matrix_two. It should have dimensions (Q+M)xN.
- *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the matrix_one data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the matrix_two data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the result_matrix data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *
- *  @returns None
- *
- **/
-void vstack(double *matrix_one, double *matrix_two, double *result_matrix, struct MatrixMetadata *matrix_one_metadata, struct MatrixMetadata *matrix_two_metadata, struct MatrixMetadata *result_matrix_metadata)
-{
-    int num_cols_total = matrix_one_metadata->num_cols;
-    int num_rows_total = matrix_one_metadata->num_rows + matrix_two_metadata->num_rows;
-    int num_elements_per_row[2];
-    num_elements_per_row[0] = (matrix_one_metadata->num_cols);
-    num_elements_per_row[1] = (matrix_two_metadata->num_cols);
-    result_matrix_metadata->num_rows = num_rows_total;
-    result_matrix_metadata->num_cols = num_cols_total;
-    memcpy(&result_matrix[0], &matrix_one[0], sizeof(double) * (matrix_one_metadata->num_rows * matrix_one_metadata->num_cols));
-    memcpy(&result_matrix[(matrix_one_metadata->num_rows * matrix_one_metadata->num_cols)], &matrix_two[0], sizeof(double) * ((matrix_two_metadata->num_rows) * matrix_two_metadata->num_cols));
-}
-
-/**
- * @brief Stack two arrays horizontally like the diagram below:
- *  ------------------             ------------------               ------------------------------------
- *  |                |             |                |               |                                  |
- *  |   ARRAY ONE    |      +      |   ARRAY TWO    |     =====>    |          COMBINED ARRAY          |
- *  |                |             |                |               |                                  |
- *  ------------------             ------------------               ------------------------------------
- *
- *  @param matrix_one: double[ptr]
- *      The data structure of the left-hand side of the hstack operation, and should have dimensions MxN.
- *  @param matrix_two: double[ptr]
- *      The data structure of the right-hand side of the hstack operation, and should have dimensions QxN.
- *  @param result_matrix: double[ptr]
- *      The data structure of the combination of matrix_one and matrix_two. It should have dimensions (Q+M)xN.
- *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the matrix_one data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *  @param matrix_two_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the matrix_two data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *  @param result_matrix_metadata: struct MatrixMetadata[ptr]
- *      The metadata of the result_matrix data structure.
- *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
- *      For more information, consult the MatrixMetadata documentation.
- *
- *  @returns None
- *
- **/
-void hstack(double *matrix_one, double *matrix_two, double *result_matrix, struct MatrixMetadata *matrix_one_metadata, struct MatrixMetadata *matrix_two_metadata, struct MatrixMetadata *result_matrix_metadata)
-{
-    int num_rows_total = matrix_one_metadata->num_rows;
-    int num_elements_per_row[2];
-    num_elements_per_row[0] = matrix_one_metadata->num_cols;
-    num_elements_per_row[1] = matrix_two_metadata->num_cols;
-    int num_cols_total = num_elements_per_row[0] + num_elements_per_row[1];
-    if (num_rows_total < 1 || num_cols_total < 1)
-    {
-        // This array cannot exist
-        result_matrix_metadata->num_cols = -1;
-        result_matrix_metadata->num_rows = -1;
-        return;
-    }
-    result_matrix_metadata->num_rows = num_rows_total;
-    result_matrix_metadata->num_cols = num_cols_total;
-    for (int i = 0; i < num_rows_total; i++)
-    {
-        memcpy(&result_matrix[(i * result_matrix_metadata->num_cols)], &matrix_one[(i * num_elements_per_row[0])], sizeof(double) * num_elements_per_row[0]);
-        memcpy(&result_matrix[(i * result_matrix_metadata->num_cols) + num_elements_per_row[0]], &matrix_two[(i * num_elements_per_row[1])], sizeof(double) * num_elements_per_row[1]);
-    }
-}
-
-/**
- * @brief Generate a square Identity matrix (i.e., 1 along main diagonal elements, 0 otherwise).
- *
- * @param num_rows: int
- *      The number of rows that the identity matrix should have. This must be equal to the num_cols value provided.
- * @param num_cols: int
- *      The number of columns that the identity matrix should have. This must be equal to the num_cols value provided.
- * @return identity_matrix: double[ptr]
- *      The identity matrix, as a 1-D array.
- */
-static inline double *generate_square_identity_matrix(int num_rows, int num_cols)
-{
-    double *identity_matrix = (double *)malloc(sizeof(double) * (num_rows * num_cols));
-    for (int row = 0; row < num_rows; row++)
-    {
-        for (int col = 0; col < num_cols; col++)
-        {
-            if (row == col)
-            {
-                identity_matrix[(row * num_cols) + col] = 1;
-            }
-            else
-            {
-                identity_matrix[(row * num_cols) + col] = 0;
-            }
-        }
-    }
-    return identity_matrix;
-}
-
-/**
- * @brief Check if a row in a matrix contains only zeros. This is used for determining things like matrix rank, linear independence, etc.
- *
- * @param matrix_to_check: double[ptr]
- *      The matrix of values to check.
- * @param row_to_check: int
- *      The row (0-indexed) to check for all-zeros. Obviously should be in the range [0, (N-1)] where N is the number of rows in matrix_to_check.
- * @param num_cols: int
- *      The number of columns in matrix_to_check. Used for indexing the matrix_to_check data structure, as it is in a 1-D array format.
- * @param not_augmented_matrix: int
- *
- * @return contains_all_zeros: int
- *      A boolean flag indicating whether or not the row contains all zeros.
- */
-static inline int row_has_all_zeros(const double *matrix_to_check, int row_to_check, int num_cols)
-{
-    // The minus one is to account for the augmented matrix
-    for (int col = 0; col < num_cols; ++col)
-    {
-        double value_to_check = matrix_to_check[(row_to_check * num_cols) + col];
-        // The second condition is to try and ameliorate floating point errors.
-        if (value_to_check != 0 && (value_to_check < (-1 * MARGIN_OF_ERROR) || value_to_check > MARGIN_OF_ERROR))
-        {
-            return 0;
-        }
-    }
-    return 1;
-}
-
-/**
- * @brief Check if a column in a matrix contains only zeros. This is used for determining things like matrix rank, linear independence, etc.
- *
- * @param matrix_to_check: double[ptr]
- *      The matrix of values to check.
- * @param column_to_check: int
- *      The column (0-indexed) to check for all-zeros. Obviously should be in the range [0, (N-1)] where N is the number of columns in matrix_to_check.
- * @param num_rows: int
- *      The number of rows in matrix_to_check. Used for indexing the matrix_to_check data structure, as it is in a 1-D array format.
- * @param not_augmented_matrix: int
- *
- * @return contains_all_zeros: int
- *      A boolean flag indicating whether or not the column contains all zeros.
- */
-static inline int column_has_all_zeros(const double *matrix_to_check, int column_to_check, int num_rows, int num_cols)
-{
-    for (int row = 0; row < num_rows; row++)
-    {
-        double value_to_check = matrix_to_check[(row * num_cols) + column_to_check];
-        if (value_to_check != 0 && (value_to_check < (-1 * MARGIN_OF_ERROR) || value_to_check > MARGIN_OF_ERROR))
-        {
-            return 0;
-        }
-    }
-    return 1;
-}
-
-/**
- * @brief Calculate the row rank of the matrix.
- *
- * @param matrix_to_check: double[ptr]
- *      The matrix to calculate the rank for.
- * @param metadata: struct MatrixMetadata[ptr]
- *      The metadata associated with the matrix_to_check data structure. Should contain the dimensions of the matrix.
- * @return int The rank of the matrix.
- */
-static inline int calculate_matrix_row_rank(double *matrix_to_check, struct MatrixMetadata *metadata)
-{
-    int row_rank = 0;
-    for (int row = 0; row < metadata->num_rows; row++)
-    {
-        if (!row_has_all_zeros(matrix_to_check, row, metadata->num_cols))
-        {
-            row_rank++;
-        }
-    }
-    return row_rank;
-}
-
-/**
- * @brief Calculate the column rank of the matrix. Used for determining if a matrix has full rank, and if all variables are linearly independent.
- *
- * @param matrix_to_check: double[ptr]
- *      The matrix to calculate the rank for.
- * @param metadata: struct MatrixMetadata[ptr]
- *      The metadata associated with the matrix_to_check data structure. Should contain the dimensions of the matrix.
- * @return int The column rank of the matrix.
- */
-static inline int calculate_matrix_column_rank(double *matrix_to_check, struct MatrixMetadata *metadata)
-{
-    int column_rank = 0;
-    for (int col = 0; col < metadata->num_cols; col++)
-    {
-        if (!column_has_all_zeros(matrix_to_check, col, metadata->num_rows, metadata->num_cols))
-        {
-            column_rank++;
-        }
-    }
-    return column_rank;
-}
-
-/**
- *  @brief Check if a matrix is consistent and how many solutions it has using the Rouché–Capelli theorem. Note that since row and column rank are equivalent, only row rank is considered by the theorem.
- *
- *  @param matrix_to_check: double[ptr]
- *      The matrix to determine consistency for.
- *  @param augmented_matrix_to_check double[ptr]
- *      The augmented matrix used to determine if the matrix_to_check is consistent.
- *  @param matrix_to_check_metadata struct MatrixMetadata[ptr]
- *      The metadata of the matrix_to_check data structure. Should contain the dimensions of the matrix, and the consistency value will be written to it.
- *  @param augmented_matrix_to_check_metadata struct MatrixMetadata[ptr]
- *      The metadata of the augmented_matrix_to_check data structure. Should contain the dimensions of the matrix.
- *
- *  @return None
- */
-static inline void is_matrix_consistent_rouche_capelli(double *matrix_to_check, double *augmented_matrix_to_check, struct MatrixMetadata *matrix_to_check_metadata, struct MatrixMetadata *augmented_matrix_to_check_metadata, struct String *message_buffer)
-{
-    // NOTE: It appears that you can prove that the column and row rank are equivalent, and since row rank is simpler to calculate we'll use only that.
-    int matrix_row_rank = calculate_matrix_row_rank(matrix_to_check, matrix_to_check_metadata);
-    int augmented_matrix_row_rank = calculate_matrix_row_rank(augmented_matrix_to_check, augmented_matrix_to_check_metadata);
-    if (matrix_row_rank < augmented_matrix_row_rank)
-    {
-        if (!message_buffer)
-        {
-            printf("System of Equations is not Consistent. No solution exists.\n");
-        }
-        else
-        {
-            writeNulTerminatedString("System of Equations is not Consistent. No solution exists.\n", message_buffer);
-        }
-        matrix_to_check_metadata->is_consistent = 0;
-    }
-    else if (matrix_row_rank == augmented_matrix_row_rank)
-    {
-        if (matrix_row_rank < matrix_to_check_metadata->num_rows)
-        {
-            if (!message_buffer)
-            {
-                printf("System of Equations is Consistent. Infinite solutions exist.\n");
-            }
-            else
-            {
-                writeNulTerminatedString("System of Equations is Consistent. Infinite solutions exist.\n", message_buffer);
-            }
-            matrix_to_check_metadata->is_consistent = 1;
-        }
-        else if (matrix_row_rank == matrix_to_check_metadata->num_rows)
-        {
-            if (!message_buffer)
-            {
-                printf("System of Equations is Consistent. Unique solution exists.\n");
-            }
-            else
-            {
-                writeNulTerminatedString("System of Equations is Consistent. Unique solution exists.\n", message_buffer);
-            }
-            matrix_to_check_metadata->is_consistent = 1;
-        }
-        else
-        {
-            if (!message_buffer)
-            {
-                printf("System of Equations is Consistent. Row Rank exceeds number of rows in matrix.\n");
-            }
-            else
-            {
-                writeNulTerminatedString("System of Equations is Consistent. Row Rank exceeds number of rows in matrix.\n", message_buffer);
-            }
-            matrix_to_check_metadata->is_consistent = 1;
-        }
-    }
-    else
-    {
-        if (!message_buffer)
-        {
-            printf("Somehow rank(A|b) > n. Don't know what to do.\n");
-        }
-        else
-        {
-            writeNulTerminatedString("Somehow rank(A|b) > n. Don't know what to do.\n", message_buffer);
-        }
-        matrix_to_check_metadata->is_consistent = 1;
-    }
-}
-
-/**********************************************************************************
- *                                                                                *
- *                                                                                *
- *                                                                                *
- *                               PRINT FUNCTIONS                                  *
- *                                                                                *
- *                                                                                *
- *                                                                                *
- **********************************************************************************/
-
-/**
- * @brief Helper function to print out the matrix metadata.
- *
- * @param matrix_metadata_to_print: struct MatrixMetadata[ptr]
- *      The matrix metadata structure to print out.
- *
- * @returns None.
- */
-static inline void print_matrix_metadata(struct MatrixMetadata *matrix_metadata_to_print)
-{
-    printf(
-        "Num Rows: %3d\nNum Columns: %3d\nMatrix Rank: %d\nIs Consistent? %d\nMatrix Determinant: %03.6f\n",
-        matrix_metadata_to_print->num_rows,
-        matrix_metadata_to_print->num_cols,
-        matrix_metadata_to_print->matrix_rank,
-        matrix_metadata_to_print->is_consistent,
-        matrix_metadata_to_print->matrix_determinant);
-}
-
-/**
- *  @brief Print the matrix. If a buffer is not provided, it prints to STDOUT instead.
- *
- *  @param matrix_to_print: double[ptr]
- *      The matrix to print the values of.
- *  @param num_rows: int
- *      The number of rows in the matrix_to_print data structure.
- *  @param num_cols: int
- *      The number of columns in the matrix_to_print data structure.
- *  @param message_buffer: struct String[ptr]
- *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component. Otherwise, values will be printed out to STDOUT.
- *
- *  @return None
- *
- */
-static inline void print_matrix(double *matrix_to_print, int num_rows, int num_cols, struct String *message_buffer)
-{
-    for (int row = 0; row < num_rows; row++)
-    {
-        for (int col = 0; col < num_cols; col++)
-        {
-            if (!message_buffer)
-            {
-                printf("% f\t", matrix_to_print[(row * num_cols) + col]);
-            }
-            else
-            {
-                writeDecimalNumber((int64_t)(matrix_to_print[(row * num_cols) + col] * 1e6), 6, message_buffer);
-                writeStringNoNullTerminator("\t", message_buffer);
-            }
-        }
-        if (!message_buffer)
-        {
-            printf("\n");
-        }
-        else
-        {
-            writeNulTerminatedString("\n", message_buffer);
-        }
-    }
-}
-
-/**
- *  @brief Print the augmented matrix with a dividing line. If a buffer is not provided, it prints to STDOUT instead.
- *
- *  @param matrix_to_print: double[ptr]
- *      The matrix to print the values of.
- *  @param num_rows: int
- *      The number of rows in the matrix_to_print data structure.
- *  @param num_cols: int
- *      The number of columns in the matrix_to_print data structure.
- *  @param message_buffer: struct String[ptr]
- *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component. Otherwise, values will be printed out to STDOUT.
- *
- *  @return None
- *
- */
-static inline void print_augmented_matrix(double *matrix_to_print, int num_rows, int num_cols, int num_augmented_cols, struct String *message_buffer)
-{
-    for (int row = 0; row < num_rows; row++)
-    {
-        for (int col = 0; col < num_cols; col++)
-        {
-            if (!message_buffer)
-            {
-                printf("% f\t", matrix_to_print[(row * num_cols) + col]);
-            }
-            else
-            {
-                writeDecimalNumber((int64_t)(matrix_to_print[(row * num_cols) + col] * 1e6), 6, message_buffer);
-                writeStringNoNullTerminator("\t", message_buffer);
-            }
-            if (col == ((num_cols - num_augmented_cols) - 1))
-            {
-                if (!message_buffer)
-                {
-                    printf("|\t");
-                }
-                else
-                {
-                    writeStringNoNullTerminator("|\t", message_buffer);
-                }
-            }
-        }
-        if (!message_buffer)
-        {
-            printf("\n");
-        }
-        else
-        {
-            writeNulTerminatedString("\n", message_buffer);
-        }
-    }
-}
-
-/**********************************************************************************
- *                                                                                *
- *                                                                                *
- *                                                                                *
- *                          ELEMENTARY ROW OPERATIONS                             *
- *                                                                                *
- *                                                                                *
- *                                                                                *
- **********************************************************************************/
-
-/**
- *  @brief Multiply a row of values in a matrix by some scalar value.
- *
- *  @param matrix_to_scale: double[ptr]
- *      The matrix whose row needs scaling. Note that the matrix is assumed to be in a 1-D format.
- *  @param row_to_scale: int
- *      The row of the matrix to scale by the scalar value.
- *  @param num_cols: int
- *      The number of columns in the matrix. Used for iterating through the array.
- *  @param scalar: double
- *      The value that the row of values in the matrix will be scaled by.
- *
- *  @returns None.
- *
- */
-static inline void multiply_row_by_scalar(double *matrix_to_scale, int row_to_scale, int num_cols, double scalar)
-{
-    for (int col = 0; col < num_cols; col++)
-    {
-        matrix_to_scale[(row_to_scale * num_cols) + col] *= scalar;
-    }
-}
-
-/**
- *  @brief Subtract a row of values, potentially multiplied by some scalar value, from another row in the matrix.
- *
- *  @param matrix_to_modify: double[ptr]
- *      The matrix to perform the operation on. Note that the matrix is assumed to be in a 1-D format.
- *  @param row_index_to_modify: int
- *      The row of the matrix whose value will be modified by the operation.
- *  @param row_to_use_for_subtraction: int
- *      The row of the matrix whose value will be the subtractor. Values might be modified by some scalar value.
- *  @param num_cols: int
- *      The number of columns in the matrix. Used for iterating through the array.
- *  @param scalar: double
- *      The value that the row_to_use_for_subtraction in the matrix will be scaled by.
- *
- *  @returns None.
- *
- */
-static inline void subtract_scaled_row(double *matrix_to_modify, int row_index_to_modify, int row_to_use_for_subtraction, int num_cols, double scalar)
-{
-    for (int col = 0; col < num_cols; col++)
-    {
-        matrix_to_modify[(row_index_to_modify * num_cols) + col] -= (scalar * matrix_to_modify[(row_to_use_for_subtraction * num_cols) + col]);
-    }
-}
-
-/**
- *  @brief Add a row of values, potentially multiplied by some scalar value, to another row in the matrix.
- *
- *  @param matrix_to_modify: double[ptr]
- *      The matrix to perform the operation on. Note that the matrix is assumed to be in a 1-D format.
- *  @param row_index_to_modify: int
- *      The row of the matrix whose value will be modified by the operation.
- *  @param row_to_use_for_addition: int
- *      The row of the matrix whose value will be the subtractor. Values might be modified by some scalar value.
- *  @param num_cols: int
- *      The number of columns in the matrix. Used for iterating through the array.
- *  @param scalar: double
- *      The value that the row_to_use_for_addition in the matrix will be scaled by.
- *
- *  @returns None.
- *
- */
-static inline void add_scaled_row(double *matrix_to_modify, int row_index_to_modify, int row_to_use_for_addition, int num_cols, double scalar)
-{
-    for (int col = 0; col < num_cols; col++)
-    {
-        matrix_to_modify[(row_index_to_modify * num_cols) + col] += (scalar * matrix_to_modify[(row_to_use_for_addition * num_cols) + col]);
-    }
-}
-
-/**
- *  @brief Swap two rows in a matrix.
- *
- *  @param matrix_to_swap_rows: double[ptr]
- *      The matrix to swap rows of. Note that the matrix is assumed to be in a 1-D format.
- *  @param row_to_swap_index_a: int
- *      The row of the matrix that serves as one half of the swap operation.
- *  @param row_to_swap_index_b: int
- *      The row of the matrix that serves as one half of the swap operation.
- *  @param num_cols: int
- *      The number of columns in the matrix. Used for iterating through the array.
- *
- *  @returns None.
- *
- */
-static inline void swap_rows(double *matrix_to_swap_rows, int row_to_swap_index_a, int row_to_swap_index_b, int num_cols)
-{
-    double row_holder[16];
-    size_t num_bytes_per_row = sizeof(double) * num_cols;
-    memcpy(&row_holder, &matrix_to_swap_rows[(row_to_swap_index_a * num_cols) + 0], num_bytes_per_row);
-    memcpy(&matrix_to_swap_rows[(row_to_swap_index_a * num_cols) + 0], &matrix_to_swap_rows[(row_to_swap_index_b * num_cols) + 0], num_bytes_per_row);
-    memcpy(&matrix_to_swap_rows[(row_to_swap_index_b * num_cols) + 0], &row_holder, num_bytes_per_row);
-}
-
-/**
- *  @brief Attempt row reduction using the Gauss-Jordan algorithm.
- *
- *  @param matrix_to_reduce: double[ptr]
- *      The matrix to reduce into reduced row echelon form. Note that the matrix is assumed to be in a 1-D format.
- *  @param matrix_augment: double[ptr]
- *      The augment portion of the matrix (i.e., the b portion of Ax = b). Used in row reduction to solve for x.
- *  @param message_buffer: struct String[ptr]
- *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component.
- *  @param metadata: struct MatrixMetadata[ptr]
- *      The metadata associated with the matrix_to_reduce data structure. Should contain the dimensions of the matrix.
- *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
- *      The metadata associated with the matrix_augment data structure. Should contain the dimensions of the matrix.
- *
- *  @return None
- *
- */
-EXPORT void python_perform_gauss_jordan_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata)
-{
-    // Generate the augmented matrix from the matrix to reduce and its augment
-    double *augmented_matrix = (double *)malloc(sizeof(double) * (metadata->num_rows * (metadata->num_cols + matrix_augment_metadata->num_cols)));
-    struct MatrixMetadata augmented_matrix_metadata;
-    augmented_matrix_metadata.num_rows = metadata->num_rows;
-    augmented_matrix_metadata.num_cols = metadata->num_cols + matrix_augment_metadata->num_cols;
-    hstack(matrix_to_reduce, matrix_augment, augmented_matrix, metadata, matrix_augment_metadata, &augmented_matrix_metadata);
-
-    int size_main_diagonal;
-    int swap_rows_flag = 0;
-    if ((augmented_matrix_metadata.num_cols - matrix_augment_metadata->num_cols) <= augmented_matrix_metadata.num_rows)
-    {
-        size_main_diagonal = (augmented_matrix_metadata.num_cols - matrix_augment_metadata->num_cols);
-    }
-    else
-    {
-        size_main_diagonal = augmented_matrix_metadata.num_rows;
-    }
-
-    // Iterate down the main diagonal to begin conversion to echelon form
-    double product_of_diagonal_elements = 1.0;
-    double denominator_value = 1;
-    int swap_multiplier = 1;
-    for (int i = 0; i < size_main_diagonal; i++)
-    {
-        double pivot_element = augmented_matrix[(i * augmented_matrix_metadata.num_cols) + i];
-        // BUG?: The possibility of a pivot element not having any rows to swap with it is not accounted for here
-        // BUG?: If we need to swap rows, then it might be an issue that I don't check rows above me.
-        if (pivot_element == 0)
-        {
-            // See if there is a nonzero element in the same column (below it) and swap the rows.
-            swap_rows_flag = 1;
-        }
-        double value_below_pivot_element;
-        for (int row = (i + 1); row < augmented_matrix_metadata.num_rows; row++)
-        {
-            value_below_pivot_element = augmented_matrix[(row * augmented_matrix_metadata.num_cols) + i];
-            if (value_below_pivot_element != 0)
-            {
-                if (swap_rows_flag == 1)
-                {
-                    // Swap the rows instead.
-                    if (!message_buffer)
-                    {
-                        printf("[SWP] Row %d = (R%d) <=> (R%d)\n", (row + 1), (row + 1), (i + 1));
-                    }
-                    else
-                    {
-                        writeStringNoNullTerminator("[SWP] Row ", message_buffer);
-                        writeNumber((row + 1), message_buffer);
-                        writeStringNoNullTerminator(" = (R", message_buffer);
-                        writeNumber((row + 1), message_buffer);
-                        writeStringNoNullTerminator(") <=> (R", message_buffer);
-                        writeNumber((i + 1), message_buffer);
-                        writeNulTerminatedString(")\n", message_buffer);
-                    }
-                    swap_rows(augmented_matrix, row, i, augmented_matrix_metadata.num_cols);
-                    swap_rows_flag = 0;
-                    pivot_element = augmented_matrix[(i * augmented_matrix_metadata.num_cols) + i];
-                    if (!message_buffer)
-                    {
-                        printf("New Pivot Element: % .6f\n", pivot_element);
-                    }
-                    else
-                    {
-                        writeStringNoNullTerminator("New Pivot Element: ", message_buffer);
-                        writeDecimalNumber((int64_t)(pivot_element * 1e9), 9, message_buffer);
-                        writeNulTerminatedString("\n", message_buffer);
-                    }
-                    swap_multiplier *= -1;
-                }
-                else
-                {
-                    double reciprocal_fraction_scalar;
-                    if (value_below_pivot_element < 0)
-                    {
-                        reciprocal_fraction_scalar = (-1.0) * (value_below_pivot_element / pivot_element);
-                        if (!message_buffer)
-                        {
-                            printf("[ADD] Row %d = (R%d) + % .6f*(R%d)\n", row, row, reciprocal_fraction_scalar, i);
-                        }
-                        else
-                        {
-                            writeStringNoNullTerminator("[ADD] Row ", message_buffer);
-                            writeNumber(row, message_buffer);
-                            writeStringNoNullTerminator(" = (R", message_buffer);
-                            writeNumber(row, message_buffer);
-                            writeStringNoNullTerminator(") + ", message_buffer);
-                            writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
-                            writeStringNoNullTerminator("*(R", message_buffer);
-                            writeNumber(i, message_buffer);
-                            writeNulTerminatedString(")\n", message_buffer);
-                        }
-                        add_scaled_row(augmented_matrix, row, i, augmented_matrix_metadata.num_cols, reciprocal_fraction_scalar);
-                    }
-                    else
-                    {
-                        reciprocal_fraction_scalar = (value_below_pivot_element / pivot_element);
-                        if (!message_buffer)
-                        {
-                            printf("[SUB] Row %d = (R%d) + % .6f*(R%d)\n", row, row, reciprocal_fraction_scalar, i);
-                        }
-                        else
-                        {
-                            writeStringNoNullTerminator("[SUB] Row ", message_buffer);
-                            writeNumber(row, message_buffer);
-                            writeStringNoNullTerminator(" = (R", message_buffer);
-                            writeNumber(row, message_buffer);
-                            writeStringNoNullTerminator(") - ", message_buffer);
-                            writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
-                            writeStringNoNullTerminator("*(R", message_buffer);
-                            writeNumber(i, message_buffer);
-                            writeNulTerminatedString(")\n", message_buffer);
-                        }
-                        subtract_scaled_row(augmented_matrix, row, i, augmented_matrix_metadata.num_cols, reciprocal_fraction_scalar);
-                    }
-                }
-            }
-            print_augmented_matrix(augmented_matrix, augmented_matrix_metadata.num_rows, augmented_matrix_metadata.num_cols, matrix_augment_metadata->num_cols, message_buffer);
-        }
-        product_of_diagonal_elements *= pivot_element;
-    }
-
-    // Next perform the second half
-    if (!message_buffer)
-    {
-        printf("Shifting to Reduced Row Echelon Portion of Algorithm.\n");
-    }
-    else
-    {
-        writeNulTerminatedString("Shifting to Reduced Row Echelon Portion of Algorithm\n", message_buffer);
-    }
-    /**
-     * Start from the last element in the main diagonal (i.e., pivot element) and try to solve such that
-     * the pivot element is 1 and all elements above it are 0. Transformations that occur in this step don't
-     * affect the determinant so we do not keep track of them.
-     *
-     * NOTE: I don't refer to the variable diagonal_index as the pivot element since it is just an index to the pivot element.
-     */
-    for (int diagonal_index = (size_main_diagonal - 1); diagonal_index > -1; diagonal_index--)
-    {
-        // Try to convert the pivot element to 1
-        double pivot_element = augmented_matrix[(diagonal_index * augmented_matrix_metadata.num_cols) + diagonal_index];
-        double pivot_reciprocal;
-        if (pivot_element == 0)
-        {
-        }
-        else
-        {
-            if (pivot_element != 1)
-            {
-                pivot_reciprocal = (1.0 / pivot_element);
-                if (!message_buffer)
-                {
-                    printf("[SCL] Row %d = % .6f*(R%d)\n", (diagonal_index + 1), pivot_reciprocal, (diagonal_index + 1));
-                }
-                else
-                {
-                    writeStringNoNullTerminator("[SCL] Row ", message_buffer);
-                    writeNumber((diagonal_index + 1), message_buffer);
-                    writeStringNoNullTerminator(" = ", message_buffer);
-                    writeDecimalNumber((int64_t)(pivot_reciprocal * 1e9), 9, message_buffer);
-                    writeStringNoNullTerminator(" * (R", message_buffer);
-                    writeNumber((diagonal_index + 1), message_buffer);
-                    writeNulTerminatedString(")\n", message_buffer);
-                }
-                multiply_row_by_scalar(augmented_matrix, diagonal_index, augmented_matrix_metadata.num_cols, pivot_reciprocal);
-                print_augmented_matrix(augmented_matrix, augmented_matrix_metadata.num_rows, augmented_matrix_metadata.num_cols, matrix_augment_metadata->num_cols, message_buffer);
-                pivot_element = augmented_matrix[(diagonal_index * augmented_matrix_metadata.num_cols) + diagonal_index];
-            }
-            for (int row = (diagonal_index - 1); row > -1; row--)
-            {
-                double value_above_pivot_element = augmented_matrix[(row * augmented_matrix_metadata.num_cols) + diagonal_index];
-                if (value_above_pivot_element != 0)
-                {
-                    double reciprocal_fraction_scalar;
-                    reciprocal_fraction_scalar = (value_above_pivot_element / pivot_element);
-                    if (!message_buffer)
-                    {
-                        printf("Reciprocal Fraction Scalar: % .6f\n", reciprocal_fraction_scalar);
-                        printf("[SUB] Row %d = (R%d) + % .6f*(R%d)\n", (row + 1), (row + 1), reciprocal_fraction_scalar, (diagonal_index + 1));
-                    }
-                    else
-                    {
-                        writeStringNoNullTerminator("Reciprocal Fraction Scalar: ", message_buffer);
-                        writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
-                        writeStringNoNullTerminator(" / ", message_buffer);
-                        writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
-                        writeStringNoNullTerminator(" = ", message_buffer);
-                        writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
-                        writeNulTerminatedString("\n", message_buffer);
-                        writeStringNoNullTerminator("[SUB] Row ", message_buffer);
-                        writeNumber((row + 1), message_buffer);
-                        writeStringNoNullTerminator(" = (R", message_buffer);
-                        writeNumber((row + 1), message_buffer);
-                        writeStringNoNullTerminator(") - ", message_buffer);
-                        writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
-                        writeStringNoNullTerminator("*(R", message_buffer);
-                        writeNumber((diagonal_index + 1), message_buffer);
-                        writeNulTerminatedString(")\n", message_buffer);
-                    }
-                    subtract_scaled_row(augmented_matrix, row, diagonal_index, augmented_matrix_metadata.num_cols, reciprocal_fraction_scalar);
-                }
-                print_augmented_matrix(augmented_matrix, augmented_matrix_metadata.num_rows, augmented_matrix_metadata.num_cols, matrix_augment_metadata->num_cols, message_buffer);
-            }
-        }
-    }
-
-    /**
-     * Having finished performing the Gauss-Jordan algorithm, this section covers the metadata of the data structure.
-     * This includes finding out whether the matrix is consistent and the matrix determinant.
-     */
-    is_matrix_consistent_rouche_capelli(matrix_to_reduce, augmented_matrix, metadata, &augmented_matrix_metadata, message_buffer);
-    print_matrix_metadata(metadata);
-    if (metadata->is_consistent == 1)
-    {
-        if (!message_buffer)
-        {
-            printf("Product of Diagonal Elements is: % .6f\n", product_of_diagonal_elements);
-            printf("Denominator Value is: % .6f\n", denominator_value);
-            printf("Swap Multiplier is: %d\n", swap_multiplier);
-        }
-        else
-        {
-            writeStringNoNullTerminator("Product of Diagonal Elements is: ", message_buffer);
-            writeDecimalNumber((int64_t)(product_of_diagonal_elements * 1e9), 9, message_buffer);
-            writeNulTerminatedString("\n", message_buffer);
-            // BUG?: Denominator value is product of all scalar multiplications performed during gaussian elimination (reduced echelon); Currently remains at default value 1
-            writeStringNoNullTerminator("Denominator Value is: ", message_buffer);
-            writeDecimalNumber((int64_t)(denominator_value * 1e9), 9, message_buffer);
-            writeNulTerminatedString("\n", message_buffer);
-
-            writeStringNoNullTerminator("Swap Multiplier is: ", message_buffer);
-            writeNumber(swap_multiplier, message_buffer);
-            writeNulTerminatedString("\n", message_buffer);
-        }
-        metadata->matrix_determinant = (product_of_diagonal_elements / denominator_value) * swap_multiplier;
-        if (!message_buffer)
-        {
-            printf("Determinant of matrix A is: % .6f\n", metadata->matrix_determinant);
-        }
-        else
-        {
-            writeStringNoNullTerminator("Determinant of non-augmented matrix A is: ", message_buffer);
-            writeDecimalNumber((int64_t)(metadata->matrix_determinant * 1e9), 9, message_buffer);
-            writeNulTerminatedString("\n", message_buffer);
-        }
-    }
-    // Free allocated resources, end of function
-    free(augmented_matrix);
-}
-
-/**
- *  @brief Attempt to invert a square matrix.
- *
- *  @param matrix_to_invert: double[ptr]
- *      The matrix to invert. Note that the matrix is assumed to be in a 1-D format.
- *  @param matrix_to_invert_metadata: struct MatrixMetadata[ptr]
- *      The metadata associated with the matrix_to_reduce data structure. Should contain the dimensions of the matrix.
- *  @param message_buffer: struct String[ptr]
- *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component.
- *
- *  @return None
- *
- */
-EXPORT void python_perform_square_matrix_inversion_gaussian_reduction(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct String *message_buffer)
-{
-    int matrix_column_rank = calculate_matrix_column_rank(matrix_to_invert, matrix_to_invert_metadata);
-    int matrix_row_rank = calculate_matrix_row_rank(matrix_to_invert, matrix_to_invert_metadata);
-    // This also covers if there is a row or column of zero values
-    if (matrix_to_invert_metadata->matrix_determinant == 0)
-    {
-        if (!message_buffer)
-        {
-            printf("The matrix provided has a determinant of 0, meaning it is not invertible.\n");
-        }
-        else
-        {
-            writeNulTerminatedString("The matrix provided has a determinant of 0, meaning it is not invertible.", message_buffer);
-        }
-        return;
-    }
-    else if ((matrix_column_rank != matrix_to_invert_metadata->num_cols) || (matrix_row_rank != matrix_to_invert_metadata->num_rows) || (matrix_column_rank != matrix_row_rank))
-    {
-        if (!message_buffer)
-        {
-            printf("The matrix provided does not have full rank and thus it is not invertible.\n");
-        }
-        else
-        {
-            writeNulTerminatedString("The matrix provided does not have full rank and thus it is not invertible.", message_buffer);
-        }
-        return;
-    }
-    else
-    {
-        double *identity_matrix = generate_square_identity_matrix(matrix_to_invert_metadata->num_rows, matrix_to_invert_metadata->num_cols);
-        struct MatrixMetadata identity_matrix_metadata;
-        identity_matrix_metadata.num_rows = matrix_to_invert_metadata->num_rows;
-        identity_matrix_metadata.num_cols = matrix_to_invert_metadata->num_rows;
-        python_perform_gauss_jordan_reduction(matrix_to_invert, identity_matrix, message_buffer, matrix_to_invert_metadata, &identity_matrix_metadata);
-        // Free the matrices
-        free(identity_matrix);
-    }
-}
-
-// int main()
-// {
-//     double matrix_to_reduce[9] = {
-//         2, 1, -1,
-//         -3, -1, 2,
-//         -2, 1, 2};
-//     double matrix_to_reduce_augment[3] = {8, -11, -3};
-//     struct String *buffer = 0x0;
-//     struct MatrixMetadata matrix_to_reduce_metadata;
-//     matrix_to_reduce_metadata.num_rows = 3;
-//     matrix_to_reduce_metadata.num_cols = 3;
-//     struct MatrixMetadata matrix_to_reduce_augment_metadata;
-//     matrix_to_reduce_augment_metadata.num_rows = 3;
-//     matrix_to_reduce_augment_metadata.num_cols = 1;
-//     python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_to_reduce_augment, buffer, &matrix_to_reduce_metadata, &matrix_to_reduce_augment_metadata);
-//     printf("\n\n\n");
-//     printf("Performing First Matrix Inversion\n");
-//     python_perform_square_matrix_inversion_gaussian_reduction(matrix_to_reduce, &matrix_to_reduce_metadata, buffer);
-//     printf("\n\n\n");
-//     // printf("Performing Second Matrix Reduction\n");
-//     // double two_matrix_to_reduce[12] = {
-//     //     0, 1, 5, -4,
-//     //     1, 4, 3, -2,
-//     //     2, 7, 1, -2};
-//     // perform_gauss_jordan_reduction(two_matrix_to_reduce, 3, 4, 1);
-//     // printf("\n\n\n");
-//     // double two_matrix_to_invert[9] = {
-//     //     0, 1, 5,
-//     //     1, 4, 3,
-//     //     2, 7, 1};
-//     // printf("Performing Second Matrix Inversion\n");
-//     // perform_square_matrix_inversion_gaussian_reduction(two_matrix_to_invert, 3, 3);
-//     // printf("\n\n\n");
-//     // double three_matrix_to_reduce[12] = {
-//     //     2, 0, -6, -8,
-//     //     0, 1, 2, 3,
-//     //     3, 6, -2, -4};
-//     // perform_gauss_jordan_reduction(three_matrix_to_reduce, 3, 4, 1);
-//     // printf("\n\n\n");
-//     // printf("Performing Third Matrix Inversion\n");
-//     // double three_matrix_to_invert[9] = {
-//     //     2, 0, -6,
-//     //     0, 1, 2,
-//     //     3, 6, -2};
-//     // perform_square_matrix_inversion_gaussian_reduction(three_matrix_to_invert, 3, 3);
-//     // printf("\n\n\n");
-
-//     printf("Press Any Key to Continue\n");
-//     getch();
+// glibc only declares the CPU affinity calls ThreadPool.c pins workers with under _GNU_SOURCE, which must come before any system header
+#if defined(linux) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include "String.c"
+#include "stdlib.h"
+#include <math.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#define EXPORT __declspec(dllexport)
+#endif
+#ifdef linux
+#include <unistd.h>
+#define EXPORT
+#endif
+#include "LogBuffer.c"
+#include "LogRing.c"
+#include "ThreadPool.c"
+#include "LUFactorization.c"
+#include "MatrixStructure.c"
+#include "ToeplitzSolvers.c"
+#include "SmallMatrix.c"
+#include "Transpose.c"
+#include "TypedKernels.c"
+#include "PackedMatrix.c"
+#include "AlignedMemory.c"
+#include "WorkspacePool.c"
+
+// This is used for mitigating non-zero values caused by floating point error.
+const double MARGIN_OF_ERROR = 1e-6;
+
+/**
+ * @brief Read a monotonic clock, for timing parts of the solver.
+ *
+ * @return seconds: double
+ *      The current time in seconds, relative to some fixed point in the past.
+ */
+static inline double get_time_in_seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#elif defined(linux)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+#else
+    // C11's wall clock, which is not monotonic, for platforms without a monotonic clock here
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+#endif
+}
+
+/**
+ * @brief How the values of a matrix are laid out, when its strides are not given.
+ * @param MATRIX_LAYOUT_ROW_MAJOR:
+ *      Row after row, as in C (and numpy's default order). This is the default.
+ * @param MATRIX_LAYOUT_COLUMN_MAJOR:
+ *      Column after column, as in Fortran (and numpy's order="F").
+ * @param MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR:
+ *      An upper triangular matrix with only its upper triangle stored, row after row (see PackedMatrix.c). The strides are ignored.
+ * @param MATRIX_LAYOUT_PACKED_LOWER_TRIANGULAR:
+ *      A lower triangular matrix with only its lower triangle stored, row after row.
+ * @param MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC:
+ *      A symmetric matrix with only its upper triangle stored, row after row.
+ * @param MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC:
+ *      A symmetric matrix with only its lower triangle stored, row after row.
+ *
+ * The packed layouts are for square float64 matrices, and save half the memory. The automatic engine solves them on the packed values; the
+ * other engines read them into a full matrix first. They cannot be written to (by python_factor_lu, or as a result).
+ */
+enum MatrixLayout
+{
+    MATRIX_LAYOUT_ROW_MAJOR = 0,
+    MATRIX_LAYOUT_COLUMN_MAJOR = 1,
+    MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR = 2,
+    MATRIX_LAYOUT_PACKED_LOWER_TRIANGULAR = 3,
+    MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC = 4,
+    MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC = 5
+};
+
+/**
+ * @brief The type of the values of a matrix. Complex values are (real, imaginary) pairs, as in numpy and C99.
+ * @param MATRIX_DTYPE_FLOAT64:
+ *      double. This is the default, and the only type every engine supports.
+ * @param MATRIX_DTYPE_FLOAT32:
+ *      float. Twice as many values per SIMD instruction as float64, at single precision.
+ * @param MATRIX_DTYPE_COMPLEX64:
+ *      float complex (numpy's complex64).
+ * @param MATRIX_DTYPE_COMPLEX128:
+ *      double complex (numpy's complex128).
+ */
+enum MatrixDtype
+{
+    MATRIX_DTYPE_FLOAT64 = 0,
+    MATRIX_DTYPE_FLOAT32 = 1,
+    MATRIX_DTYPE_COMPLEX64 = 2,
+    MATRIX_DTYPE_COMPLEX128 = 3
+};
+
+/**
+ * @brief The metadata associated with a given matrix.
+ * @param num_rows: int
+ *      The number of rows in the matrix.
+ * @param num_cols: int
+ *      The number of columns in the matrix.
+ * @param matrix_rank: int
+ *      The rank of the matrix, or the number of linearly independent variables present in the matrix.
+ * @param is_consistent: int
+ *      A boolean flag that indicates whether the matrix is consistent, meaning there exists some set of values that satisfy all equations in the matrix.
+ * @param matrix_determinant: double
+ *      The determinant of the matrix. A nonzero determinant indicates the matrix is invertible.
+ * @param row_stride: int
+ *      The distance, in values, between the starts of two neighbouring rows (value (row, col) is at row * row_stride + col * col_stride).
+ *      0 means packed: num_cols for a row-major layout, 1 for a column-major one. Lets numpy slices and padded buffers be passed without copying them.
+ * @param col_stride: int
+ *      The distance, in values, between two neighbouring values of a row. 0 means packed: 1 for a row-major layout, num_rows for a column-major one.
+ *      A transposed numpy view has a col_stride other than 1.
+ * @param layout: int
+ *      One of the MatrixLayout values. Decides what strides of 0 mean, or that only one triangle is stored.
+ * @param dtype: int
+ *      One of the MatrixDtype values. Strides are counted in values of this type. Only the Gauss-Jordan engine, the inversions and
+ *      python_compute_determinant handle types other than float64 (the other engines hand them over to the Gauss-Jordan engine).
+ * @param matrix_determinant_imag: double
+ *      The imaginary part of the determinant of a complex matrix (0 otherwise).
+ */
+struct MatrixMetadata
+{
+    int num_rows;
+    int num_cols;
+    int matrix_rank;
+    int is_consistent;
+    double matrix_determinant;
+    int row_stride;
+    int col_stride;
+    int layout;
+    int dtype;
+    double matrix_determinant_imag;
+} MatrixMetadata;
+
+/**
+ * @brief Whether only one triangle of a matrix is stored (one of the MATRIX_LAYOUT_PACKED_* layouts).
+ */
+static inline int is_packed_layout(const struct MatrixMetadata *metadata)
+{
+    return metadata->layout >= MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR && metadata->layout <= MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC;
+}
+
+/**
+ * @brief Whether a packed matrix stores its upper triangle.
+ */
+static inline int is_upper_packed_layout(const struct MatrixMetadata *metadata)
+{
+    return metadata->layout == MATRIX_LAYOUT_PACKED_UPPER_TRIANGULAR || metadata->layout == MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC;
+}
+
+/**
+ * @brief Whether a packed matrix is symmetric (rather than triangular).
+ */
+static inline int is_symmetric_packed_layout(const struct MatrixMetadata *metadata)
+{
+    return metadata->layout == MATRIX_LAYOUT_PACKED_UPPER_SYMMETRIC || metadata->layout == MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC;
+}
+
+/**
+ * @brief The row stride of a matrix, resolving 0 to a packed layout.
+ */
+static inline int get_row_stride(const struct MatrixMetadata *metadata)
+{
+    if (metadata->row_stride)
+    {
+        return metadata->row_stride;
+    }
+    return (metadata->layout == MATRIX_LAYOUT_COLUMN_MAJOR) ? 1 : metadata->num_cols;
+}
+
+/**
+ * @brief The column stride of a matrix, resolving 0 to a packed layout.
+ */
+static inline int get_col_stride(const struct MatrixMetadata *metadata)
+{
+    if (metadata->col_stride)
+    {
+        return metadata->col_stride;
+    }
+    return (metadata->layout == MATRIX_LAYOUT_COLUMN_MAJOR) ? metadata->num_rows : 1;
+}
+
+/**
+ * @brief Copy one row of a matrix with any strides into consecutive values.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to copy from.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The dimensions and strides of matrix.
+ * @param row: int
+ *      The row to copy.
+ * @param destination: double[ptr]
+ *      Receives the num_cols values of the row.
+ *
+ * @return None
+ */
+static inline void copy_strided_row(const double *matrix, const struct MatrixMetadata *metadata, int row, double *destination)
+{
+    if (is_packed_layout(metadata))
+    {
+        int is_upper = is_upper_packed_layout(metadata);
+        for (int col = 0; col < metadata->num_cols; col++)
+        {
+            // Values outside the stored triangle are 0, or mirror the stored one
+            int is_stored = is_upper ? (col >= row) : (col <= row);
+            int packed_row = is_stored ? row : col;
+            int packed_col = is_stored ? col : row;
+            int is_mirrored = !is_stored && is_symmetric_packed_layout(metadata);
+            destination[col] = (is_stored || is_mirrored) ? matrix[get_packed_row_offset(packed_row, metadata->num_rows, is_upper) + (is_upper ? packed_col - packed_row : packed_col)] : 0.0;
+        }
+        return;
+    }
+    const double *source_row = &matrix[(int64_t)row * get_row_stride(metadata)];
+    int col_stride = get_col_stride(metadata);
+    if (col_stride == 1)
+    {
+        memcpy(destination, source_row, sizeof(double) * metadata->num_cols);
+        return;
+    }
+    for (int col = 0; col < metadata->num_cols; col++)
+    {
+        destination[col] = source_row[(int64_t)col * col_stride];
+    }
+}
+
+/**
+ * @brief Copy a matrix with any strides into a buffer with any strides. Copies between a row-major and a column-major layout (in either
+ *        direction) are blocked transposes (see transpose_matrix_blocked); copies within one layout are a memcpy per row or column.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to copy. Must not overlap destination.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The dimensions and strides of matrix. A packed matrix is expanded into the full matrix.
+ * @param destination: double[ptr]
+ *      Receives the values of matrix.
+ * @param destination_row_stride: int
+ *      The distance between the starts of two rows of destination.
+ * @param destination_col_stride: int
+ *      The distance between two neighbouring values of a row of destination.
+ * @param num_threads: int
+ *      The most threads to use for a transpose.
+ *
+ * @return None
+ */
+static void copy_strided_matrix(const double *matrix, const struct MatrixMetadata *metadata, double *destination, int destination_row_stride, int destination_col_stride, int num_threads)
+{
+    if (is_packed_layout(metadata))
+    {
+        unpack_packed_matrix(matrix, metadata->num_rows, is_upper_packed_layout(metadata), is_symmetric_packed_layout(metadata), destination, destination_row_stride, destination_col_stride);
+        return;
+    }
+    int num_rows = metadata->num_rows;
+    int num_cols = metadata->num_cols;
+    int row_stride = get_row_stride(metadata);
+    int col_stride = get_col_stride(metadata);
+    if (destination_col_stride == 1 && col_stride == 1)
+    {
+        for (int row = 0; row < num_rows; row++)
+        {
+            memcpy(&destination[(int64_t)row * destination_row_stride], &matrix[(int64_t)row * row_stride], sizeof(double) * num_cols);
+        }
+    }
+    else if (destination_row_stride == 1 && row_stride == 1)
+    {
+        for (int col = 0; col < num_cols; col++)
+        {
+            memcpy(&destination[(int64_t)col * destination_col_stride], &matrix[(int64_t)col * col_stride], sizeof(double) * num_rows);
+        }
+    }
+    else if (destination_col_stride == 1 && row_stride == 1)
+    {
+        // The columns of matrix are the rows of its transpose
+        transpose_matrix_blocked(matrix, num_cols, num_rows, col_stride, destination, destination_row_stride, num_threads);
+    }
+    else if (destination_row_stride == 1 && col_stride == 1)
+    {
+        transpose_matrix_blocked(matrix, num_rows, num_cols, row_stride, destination, destination_col_stride, num_threads);
+    }
+    else
+    {
+        for (int row = 0; row < num_rows; row++)
+        {
+            for (int col = 0; col < num_cols; col++)
+            {
+                destination[(int64_t)row * destination_row_stride + (int64_t)col * destination_col_stride] = matrix[(int64_t)row * row_stride + (int64_t)col * col_stride];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copy a matrix with any strides into a row-major buffer.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix to copy.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The dimensions and strides of matrix.
+ * @param destination: double[ptr]
+ *      Receives the values of matrix, row after row.
+ * @param destination_leading_dimension: int
+ *      The distance between the starts of two rows of destination.
+ *
+ * @return None
+ */
+static void gather_strided_matrix(const double *matrix, const struct MatrixMetadata *metadata, double *destination, int destination_leading_dimension)
+{
+    copy_strided_matrix(matrix, metadata, destination, destination_leading_dimension, 1, 1);
+}
+
+/**
+ * @brief Copy a row-major buffer back into a matrix with any strides. The inverse of gather_strided_matrix.
+ *
+ * @return None
+ */
+static void scatter_strided_matrix(const double *source, int source_leading_dimension, double *matrix, const struct MatrixMetadata *metadata)
+{
+    struct MatrixMetadata source_metadata = {metadata->num_rows, metadata->num_cols, 0, 0, 0.0, source_leading_dimension, 1, MATRIX_LAYOUT_ROW_MAJOR, MATRIX_DTYPE_FLOAT64, 0.0};
+    copy_strided_matrix(source, &source_metadata, matrix, get_row_stride(metadata), get_col_stride(metadata), 1);
+}
+
+/**
+ * @brief Get a matrix as rows of consecutive values with a leading dimension, which is what the factorizations, the multiplication and the
+ *        structure analysis read. A row stride (a slice or padded rows) becomes the leading dimension, so nothing is copied. Only a column stride
+ *        other than 1 (e.g., a transposed view) or a packed layout needs a row-major copy.
+ *
+ * @param matrix: double[ptr]
+ *      The matrix.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The dimensions and strides of matrix.
+ * @param leading_dimension: int[ptr]
+ *      Receives the distance between the starts of two rows of the returned matrix.
+ *
+ * @return row_major_matrix: double[ptr]
+ *      matrix itself, or a copy that the caller must free. NULL if the copy could not be allocated.
+ */
+static double *get_row_major_matrix(double *matrix, const struct MatrixMetadata *metadata, int *leading_dimension)
+{
+    if (get_col_stride(metadata) == 1 && !is_packed_layout(metadata))
+    {
+        *leading_dimension = get_row_stride(metadata);
+        return matrix;
+    }
+    *leading_dimension = metadata->num_cols;
+    double *row_major_matrix = (double *)malloc(sizeof(double) * ((int64_t)metadata->num_rows * metadata->num_cols));
+    if (row_major_matrix)
+    {
+        gather_strided_matrix(matrix, metadata, row_major_matrix, metadata->num_cols);
+    }
+    return row_major_matrix;
+}
+
+/**
+ * @brief The size of one value of a matrix, in bytes.
+ *
+ * @return value_size: int
+ *      The size of a value of the given MatrixDtype, or 0 if it is not one.
+ */
+static inline int get_dtype_size(int dtype)
+{
+    if (dtype == MATRIX_DTYPE_FLOAT64)
+    {
+        return sizeof(double);
+    }
+    else if (dtype == MATRIX_DTYPE_FLOAT32)
+    {
+        return sizeof(float);
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX64)
+    {
+        return 2 * sizeof(float);
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX128)
+    {
+        return 2 * sizeof(double);
+    }
+    return 0;
+}
+
+/**
+ * @brief The numpy name of a MatrixDtype, for the step log.
+ */
+static inline const char *get_dtype_name(int dtype)
+{
+    if (dtype == MATRIX_DTYPE_FLOAT32)
+    {
+        return "float32";
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX64)
+    {
+        return "complex64";
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX128)
+    {
+        return "complex128";
+    }
+    return "float64";
+}
+
+/**
+ * @brief Copy a matrix of any MatrixDtype with any strides into a row-major buffer. The values are copied as bytes, so this works for every type.
+ *
+ * @param matrix: void[ptr]
+ *      The matrix to copy.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The dimensions, strides and type of matrix.
+ * @param destination: void[ptr]
+ *      Receives the values of matrix, row after row.
+ * @param destination_leading_dimension: int
+ *      The distance, in values, between the starts of two rows of destination.
+ *
+ * @return None
+ */
+static void gather_typed_matrix(const void *matrix, const struct MatrixMetadata *metadata, void *destination, int destination_leading_dimension)
+{
+    if (is_packed_layout(metadata))
+    {
+        // Only float64 matrices are packed
+        gather_strided_matrix((const double *)matrix, metadata, (double *)destination, destination_leading_dimension);
+        return;
+    }
+    int value_size = get_dtype_size(metadata->dtype);
+    int row_stride = get_row_stride(metadata);
+    int col_stride = get_col_stride(metadata);
+    for (int row = 0; row < metadata->num_rows; row++)
+    {
+        const char *source_row = (const char *)matrix + (int64_t)row * row_stride * value_size;
+        char *destination_row = (char *)destination + (int64_t)row * destination_leading_dimension * value_size;
+        if (col_stride == 1)
+        {
+            memcpy(destination_row, source_row, (size_t)value_size * metadata->num_cols);
+            continue;
+        }
+        for (int col = 0; col < metadata->num_cols; col++)
+        {
+            memcpy(&destination_row[(int64_t)col * value_size], &source_row[(int64_t)col * col_stride * value_size], value_size);
+        }
+    }
+}
+
+/**
+ * @brief A matrix held by the library: its values together with the metadata that describes them, so the two cannot disagree. Callers only ever
+ *        hold a pointer to it, and read its values and metadata through python_get_matrix_values and python_get_matrix_metadata.
+ *
+ *        python_create_matrix allocates the values itself, 64-byte aligned with every row (every column, for a column-major matrix) padded to
+ *        whole cache lines, so each row starts on a cache line and SIMD loads never straddle two. python_view_matrix describes memory someone else
+ *        owns instead. Either way it is freed with python_destroy_matrix.
+ * @param values: void[ptr]
+ *      The first value, of metadata.dtype.
+ * @param metadata: struct MatrixMetadata
+ *      The dimensions, strides, layout and dtype of values. The solvers write the rank, consistency and determinant to it.
+ * @param is_owner: int
+ *      1 if values were allocated by python_create_matrix, and are freed with the matrix.
+ * @param has_structure: int
+ *      1 if structure holds the analysis of the current values. Cleared by python_invalidate_matrix_structure.
+ * @param structure: struct MatrixStructure
+ *      The cached structure of a float64 matrix (see python_get_matrix_structure), so the automatic engine only has to analyze it once.
+ */
+struct Matrix
+{
+    void *values;
+    struct MatrixMetadata metadata;
+    int is_owner;
+    int has_structure;
+    struct MatrixStructure structure;
+};
+
+/**
+ * @brief Create a matrix of zeros with library-owned, aligned values. It must be released with python_destroy_matrix.
+ *
+ * @param num_rows: int
+ *      The number of rows.
+ * @param num_cols: int
+ *      The number of columns.
+ * @param dtype: int
+ *      One of the MatrixDtype values.
+ * @param layout: int
+ *      One of the MatrixLayout values. Packed layouts need a square float64 matrix, and are not padded.
+ *
+ * @return matrix: struct Matrix[ptr]
+ *      The new matrix, or NULL if the arguments are not valid or the allocation failed.
+ */
+EXPORT struct Matrix *python_create_matrix(int num_rows, int num_cols, int dtype, int layout)
+{
+    int value_size = get_dtype_size(dtype);
+    struct MatrixMetadata metadata = {num_rows, num_cols, 0, 0, 0.0, 0, 0, layout, dtype, 0.0};
+    int is_packed = is_packed_layout(&metadata);
+    if (num_rows < 1 || num_cols < 1 || !value_size || layout < MATRIX_LAYOUT_ROW_MAJOR || layout > MATRIX_LAYOUT_PACKED_LOWER_SYMMETRIC ||
+        (is_packed && (num_rows != num_cols || dtype != MATRIX_DTYPE_FLOAT64)))
+    {
+        return NULL;
+    }
+    int64_t num_values;
+    if (is_packed)
+    {
+        num_values = get_packed_size(num_rows);
+    }
+    else if (layout == MATRIX_LAYOUT_COLUMN_MAJOR)
+    {
+        metadata.row_stride = 1;
+        metadata.col_stride = get_padded_stride(num_rows, value_size);
+        num_values = (int64_t)metadata.col_stride * num_cols;
+    }
+    else
+    {
+        metadata.row_stride = get_padded_stride(num_cols, value_size);
+        metadata.col_stride = 1;
+        num_values = (int64_t)metadata.row_stride * num_rows;
+    }
+    struct Matrix *matrix = (struct Matrix *)calloc(1, sizeof(struct Matrix));
+    if (!matrix)
+    {
+        return NULL;
+    }
+    matrix->values = allocate_aligned((size_t)num_values * value_size, 1);
+    if (!matrix->values)
+    {
+        free(matrix);
+        return NULL;
+    }
+    matrix->metadata = metadata;
+    matrix->is_owner = 1;
+    return matrix;
+}
+
+/**
+ * @brief Wrap memory the caller owns (e.g., a numpy array) in a matrix, without copying it. The memory must outlive the matrix, which must be
+ *        released with python_destroy_matrix.
+ *
+ * @param values: void[ptr]
+ *      The first value of the matrix.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      Describes values. It is copied into the matrix.
+ *
+ * @return matrix: struct Matrix[ptr]
+ *      The new matrix, or NULL if the allocation failed or the dtype is not supported.
+ */
+EXPORT struct Matrix *python_view_matrix(void *values, struct MatrixMetadata *metadata)
+{
+    if (!values || !get_dtype_size(metadata->dtype))
+    {
+        return NULL;
+    }
+    struct Matrix *matrix = (struct Matrix *)calloc(1, sizeof(struct Matrix));
+    if (!matrix)
+    {
+        return NULL;
+    }
+    matrix->values = values;
+    matrix->metadata = *metadata;
+    return matrix;
+}
+
+/**
+ * @brief Free a matrix, and its values if the library allocated them.
+ *
+ * @param matrix: struct Matrix[ptr]
+ *      The matrix to free. Passing NULL does nothing.
+ *
+ * @return None
+ */
+EXPORT void python_destroy_matrix(struct Matrix *matrix)
+{
+    if (!matrix)
+    {
+        return;
+    }
+    if (matrix->is_owner)
+    {
+        free_aligned(matrix->values);
+    }
+    free(matrix);
+}
+
+/**
+ * @brief The values of a matrix, laid out as its metadata says.
+ */
+EXPORT void *python_get_matrix_values(struct Matrix *matrix)
+{
+    return matrix->values;
+}
+
+/**
+ * @brief The metadata of a matrix. It belongs to the matrix, so it is read and updated in place, and lives as long as the matrix.
+ */
+EXPORT struct MatrixMetadata *python_get_matrix_metadata(struct Matrix *matrix)
+{
+    return &matrix->metadata;
+}
+
+/**
+ * @brief Forget the cached structure of a matrix. Must be called after its values are changed (the solvers never change them, but e.g.
+ *        python_factor_lu on its values does).
+ */
+EXPORT void python_invalidate_matrix_structure(struct Matrix *matrix)
+{
+    matrix->has_structure = 0;
+}
+
+/**
+ * @brief How much of the step log the solver writes.
+ * @param LOG_VERBOSITY_SUMMARY:
+ *      Only the consistency of the system and the determinant.
+ * @param LOG_VERBOSITY_STEPS:
+ *      The summary, plus every row operation that is performed.
+ * @param LOG_VERBOSITY_MATRICES:
+ *      The steps, plus the whole augmented matrix after each row operation. This is the default.
+ */
+enum LogVerbosity
+{
+    LOG_VERBOSITY_SUMMARY = 0,
+    LOG_VERBOSITY_STEPS = 1,
+    LOG_VERBOSITY_MATRICES = 2
+};
+
+/**
+ * @brief How the solver picks the pivot element of each column during forward elimination.
+ * @param PIVOT_STRATEGY_NONE:
+ *      Use the diagonal element, and only swap (with the first nonzero row below) when it is exactly 0. This is the default, as it keeps the steps closest to working by hand.
+ * @param PIVOT_STRATEGY_PARTIAL:
+ *      Swap in the row with the largest absolute value in the pivot column.
+ * @param PIVOT_STRATEGY_ROOK:
+ *      Alternate between searching the column and the row until the element is the largest in both, swapping rows and columns.
+ *      Usually about as stable as complete pivoting while looking at far fewer elements.
+ * @param PIVOT_STRATEGY_COMPLETE:
+ *      Swap in the largest absolute value of the whole remaining submatrix, swapping rows and columns.
+ */
+enum PivotStrategy
+{
+    PIVOT_STRATEGY_NONE = 0,
+    PIVOT_STRATEGY_PARTIAL = 1,
+    PIVOT_STRATEGY_ROOK = 2,
+    PIVOT_STRATEGY_COMPLETE = 3
+};
+
+/**
+ * @brief Options that change how the solver runs. Passing NULL wherever a struct SolverOptions[ptr] is expected uses the defaults from default_solver_options.
+ * @param verbosity: int
+ *      How much of the step log to write. Should be one of the LogVerbosity values.
+ * @param pivot_strategy: int
+ *      How pivot elements are chosen. Should be one of the PivotStrategy values. The LU engines pick their own pivots and ignore it, and
+ *      types other than float64 are always reduced with partial pivoting (see perform_typed_reduction).
+ * @param num_threads: int
+ *      The most threads a parallel engine may use. 0 means one per hardware thread.
+ */
+struct SolverOptions
+{
+    int verbosity;
+    int pivot_strategy;
+    int num_threads;
+};
+
+/**
+ * @brief Caller-provided buffers the solver copies its results into, so they never have to be parsed back out of the step log.
+ *        Any of the pointers may be NULL, in which case that result is skipped. Passing NULL for the whole structure skips all of them.
+ * @param reduced_matrix: double[ptr]
+ *      Receives the reduced row echelon form of the matrix (without the augment). Must hold num_rows * num_cols values.
+ * @param solution: double[ptr]
+ *      Receives the augment after reduction, i.e., the solution x of Ax = b, or the inverse when inverting. Must hold num_rows * num_augment_cols values.
+ * @param pivot_permutation: int[ptr]
+ *      Receives the row permutation applied by pivoting: row i of the results came from row pivot_permutation[i] of the input. Must hold num_rows values.
+ * @param elapsed_seconds: double
+ *      Set to how long the reduction took, not counting the consistency check and determinant summary at the end.
+ * @param pivot_search_seconds: double
+ *      Set to how much of elapsed_seconds was spent searching for pivots. Used to compare the cost of the PivotStrategy values.
+ */
+struct SolverOutputs
+{
+    double *reduced_matrix;
+    double *solution;
+    int *pivot_permutation;
+    double elapsed_seconds;
+    double pivot_search_seconds;
+};
+
+/**
+ * @brief Get the options used when the caller does not provide any.
+ *
+ * @return options: struct SolverOptions
+ *      The default options.
+ */
+static inline struct SolverOptions default_solver_options(void)
+{
+    struct SolverOptions options;
+    options.verbosity = LOG_VERBOSITY_MATRICES;
+    options.pivot_strategy = PIVOT_STRATEGY_NONE;
+    options.num_threads = 0;
+    return options;
+}
+
+/**
+ * @brief Two matrices side by side (hstack_view) or one above the other (vstack_view), read through their own buffers and strides instead of
+ *        being copied into one. It only holds pointers and metadata, so it is as cheap to make as it is to pass around.
+ * @param parts: double[ptr][2]
+ *      The two matrices, left then right (or top then bottom).
+ * @param part_metadata: struct MatrixMetadata[2]
+ *      Their dimensions and strides.
+ * @param is_horizontal: int
+ *      1 if the parts are side by side, 0 if they are stacked vertically.
+ * @param num_rows: int
+ *      The number of rows of the whole view, or -1 if it cannot exist.
+ * @param num_cols: int
+ *      The number of columns of the whole view, or -1 if it cannot exist.
+ */
+struct StackedMatrix
+{
+    double *parts[2];
+    struct MatrixMetadata part_metadata[2];
+    int is_horizontal;
+    int num_rows;
+    int num_cols;
+};
+
+/**
+ * @brief View matrix_one and matrix_two as one matrix, side by side. Nothing is copied. The view has the rows of matrix_one.
+ *
+ * @return view: struct StackedMatrix
+ *      The view. Its dimensions are -1 if it would have no values.
+ */
+static inline struct StackedMatrix hstack_view(double *matrix_one, double *matrix_two, const struct MatrixMetadata *matrix_one_metadata, const struct MatrixMetadata *matrix_two_metadata)
+{
+    struct StackedMatrix view;
+    view.parts[0] = matrix_one;
+    view.parts[1] = matrix_two;
+    view.part_metadata[0] = *matrix_one_metadata;
+    view.part_metadata[1] = *matrix_two_metadata;
+    view.is_horizontal = 1;
+    view.num_rows = matrix_one_metadata->num_rows;
+    view.num_cols = matrix_one_metadata->num_cols + matrix_two_metadata->num_cols;
+    if (view.num_rows < 1 || view.num_cols < 1)
+    {
+        // This array cannot exist
+        view.num_rows = -1;
+        view.num_cols = -1;
+    }
+    return view;
+}
+
+/**
+ * @brief View matrix_one and matrix_two as one matrix, matrix_one above matrix_two. Nothing is copied. The view has the columns of matrix_one.
+ *
+ * @return view: struct StackedMatrix
+ *      The view. Its dimensions are -1 if it would have no values.
+ */
+static inline struct StackedMatrix vstack_view(double *matrix_one, double *matrix_two, const struct MatrixMetadata *matrix_one_metadata, const struct MatrixMetadata *matrix_two_metadata)
+{
+    struct StackedMatrix view;
+    view.parts[0] = matrix_one;
+    view.parts[1] = matrix_two;
+    view.part_metadata[0] = *matrix_one_metadata;
+    view.part_metadata[1] = *matrix_two_metadata;
+    view.is_horizontal = 0;
+    view.num_rows = matrix_one_metadata->num_rows + matrix_two_metadata->num_rows;
+    view.num_cols = matrix_one_metadata->num_cols;
+    if (view.num_rows < 1 || view.num_cols < 1)
+    {
+        // This array cannot exist
+        view.num_rows = -1;
+        view.num_cols = -1;
+    }
+    return view;
+}
+
+/**
+ * @brief Copy the values of a stacked view into one row-major buffer. This is the only time a view's values are ever copied.
+ *
+ * @param view: struct StackedMatrix[ptr]
+ *      The view to copy. Must have dimensions other than -1.
+ * @param destination: double[ptr]
+ *      Receives the values of the view, row after row.
+ * @param destination_leading_dimension: int
+ *      The distance between the starts of two rows of destination.
+ *
+ * @return None
+ */
+static void gather_stacked_matrix(const struct StackedMatrix *view, double *destination, int destination_leading_dimension)
+{
+    gather_strided_matrix(view->parts[0], &view->part_metadata[0], destination, destination_leading_dimension);
+    if (view->is_horizontal)
+    {
+        gather_strided_matrix(view->parts[1], &view->part_metadata[1], &destination[view->part_metadata[0].num_cols], destination_leading_dimension);
+    }
+    else
+    {
+        gather_strided_matrix(view->parts[1], &view->part_metadata[1], &destination[(int64_t)view->part_metadata[0].num_rows * destination_leading_dimension], destination_leading_dimension);
+    }
+}
+
+/**
+ * @brief Stack two arrays vertically like the diagram below:
+ *  ------------------
+ *  |                |                     ------------------
+ *  |   ARRAY ONE    |                     |                |
+ *  |                |                     |                |
+ *  ------------------                     | COMBINED ARRAY |
+ *          +                 =====>       |                |
+ *  ------------------                     |                |
+ *  |                |                     |                |
+ *  |   ARRAY TWO    |                     ------------------
+ *  |                |
+ *  ------------------
+ *
+ *  @param matrix_one: double[ptr]
+ *      The data structure of the left-hand side of the vstack operation, and should have dimensions MxN.
+ *  @param matrix_two: double[ptr]
+ *      The data structure of the right-hand side of the vstack operation, and should have dimensions QxN.
+ *  @param result_matrix: double[ptr]
+ *      The data structure of the combination of matrix_one and matrix_two. It should have dimensions (Q+M)xN.
+ *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix_one data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix_two data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the result_matrix data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *
+ *  @returns None
+ *
+ **/
+void vstack(double *matrix_one, double *matrix_two, double *result_matrix, struct MatrixMetadata *matrix_one_metadata, struct MatrixMetadata *matrix_two_metadata, struct MatrixMetadata *result_matrix_metadata)
+{
+    struct StackedMatrix view = vstack_view(matrix_one, matrix_two, matrix_one_metadata, matrix_two_metadata);
+    result_matrix_metadata->num_rows = view.num_rows;
+    result_matrix_metadata->num_cols = view.num_cols;
+    if (view.num_rows < 1)
+    {
+        return;
+    }
+    result_matrix_metadata->row_stride = 0;
+    result_matrix_metadata->col_stride = 0;
+    result_matrix_metadata->layout = MATRIX_LAYOUT_ROW_MAJOR;
+    result_matrix_metadata->dtype = MATRIX_DTYPE_FLOAT64;
+    gather_stacked_matrix(&view, result_matrix, view.num_cols);
+}
+
+/**
+ * @brief Stack two arrays horizontally like the diagram below:
+ *  ------------------             ------------------               ------------------------------------
+ *  |                |             |                |               |                                  |
+ *  |   ARRAY ONE    |      +      |   ARRAY TWO    |     =====>    |          COMBINED ARRAY          |
+ *  |                |             |                |               |                                  |
+ *  ------------------             ------------------               ------------------------------------
+ *
+ *  @param matrix_one: double[ptr]
+ *      The data structure of the left-hand side of the hstack operation, and should have dimensions MxN.
+ *  @param matrix_two: double[ptr]
+ *      The data structure of the right-hand side of the hstack operation, and should have dimensions QxN.
+ *  @param result_matrix: double[ptr]
+ *      The data structure of the combination of matrix_one and matrix_two. It should have dimensions (Q+M)xN.
+ *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix_one data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *  @param matrix_two_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix_two data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *  @param result_matrix_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the result_matrix data structure.
+ *      Must contain the number of rows and columns (i.e., the dimensions) of the matrix.
+ *      For more information, consult the MatrixMetadata documentation.
+ *
+ *  @returns None
+ *
+ **/
+void hstack(double *matrix_one, double *matrix_two, double *result_matrix, struct MatrixMetadata *matrix_one_metadata, struct MatrixMetadata *matrix_two_metadata, struct MatrixMetadata *result_matrix_metadata)
+{
+    struct StackedMatrix view = hstack_view(matrix_one, matrix_two, matrix_one_metadata, matrix_two_metadata);
+    result_matrix_metadata->num_rows = view.num_rows;
+    result_matrix_metadata->num_cols = view.num_cols;
+    if (view.num_rows < 1)
+    {
+        return;
+    }
+    result_matrix_metadata->row_stride = 0;
+    result_matrix_metadata->col_stride = 0;
+    result_matrix_metadata->layout = MATRIX_LAYOUT_ROW_MAJOR;
+    result_matrix_metadata->dtype = MATRIX_DTYPE_FLOAT64;
+    // The inputs may be strided views; the result is always packed
+    gather_stacked_matrix(&view, result_matrix, view.num_cols);
+}
+
+/**
+ * @brief Write a square Identity matrix (i.e., 1 along main diagonal elements, 0 otherwise).
+ *
+ * @param identity_matrix: double[ptr]
+ *      Receives the identity matrix, as a 1-D array. Must hold size * size values.
+ * @param size: int
+ *      The number of rows (and of columns) of the identity matrix.
+ * @return None
+ */
+static inline void fill_square_identity_matrix(double *identity_matrix, int size)
+{
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            if (row == col)
+            {
+                identity_matrix[((int64_t)row * size) + col] = 1;
+            }
+            else
+            {
+                identity_matrix[((int64_t)row * size) + col] = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check if a row in a matrix contains only zeros. This is used for determining things like matrix rank, linear independence, etc.
+ *
+ * @param matrix_to_check: double[ptr]
+ *      The matrix of values to check.
+ * @param row_to_check: int
+ *      The row (0-indexed) to check for all-zeros. Obviously should be in the range [0, (N-1)] where N is the number of rows in matrix_to_check.
+ * @param num_cols: int
+ *      The number of columns in matrix_to_check.
+ * @param row_stride: int
+ *      The distance between the starts of two rows of matrix_to_check. Used for indexing, as it is in a 1-D array format.
+ * @param col_stride: int
+ *      The distance between two neighbouring values of a row of matrix_to_check.
+ * @param not_augmented_matrix: int
+ *
+ * @return contains_all_zeros: int
+ *      A boolean flag indicating whether or not the row contains all zeros.
+ */
+static inline int row_has_all_zeros(const double *matrix_to_check, int row_to_check, int num_cols, int row_stride, int col_stride)
+{
+    for (int col = 0; col < num_cols; ++col)
+    {
+        double value_to_check = matrix_to_check[((int64_t)row_to_check * row_stride) + (int64_t)col * col_stride];
+        // The second condition is to try and ameliorate floating point errors.
+        if (value_to_check != 0 && (value_to_check < (-1 * MARGIN_OF_ERROR) || value_to_check > MARGIN_OF_ERROR))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Check whether a row of a packed matrix (see PackedMatrix.c) consists entirely of zeros, reading the packed values in place.
+ *
+ * @param packed_matrix: double[ptr]
+ *      The packed triangle.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of packed_matrix, with one of the packed layouts.
+ * @param row_to_check: int
+ *      The row to check.
+ * @return int 1 if the row is all zeros, 0 otherwise.
+ */
+static inline int packed_row_has_all_zeros(const double *packed_matrix, const struct MatrixMetadata *metadata, int row_to_check)
+{
+    int size = metadata->num_rows;
+    int is_upper = is_upper_packed_layout(metadata);
+    // The stored part of a row is contiguous: from the diagonal on in the upper triangle, up to it in the lower one
+    if (!row_has_all_zeros(&packed_matrix[get_packed_row_offset(row_to_check, size, is_upper)], 0, is_upper ? size - row_to_check : row_to_check + 1, 0, 1))
+    {
+        return 0;
+    }
+    if (!is_symmetric_packed_layout(metadata))
+    {
+        return 1;
+    }
+    // The rest of a symmetric row mirrors the same column of the stored triangle
+    int first_col = is_upper ? 0 : row_to_check + 1;
+    int last_col = is_upper ? row_to_check : size;
+    for (int col = first_col; col < last_col; col++)
+    {
+        if (!row_has_all_zeros(&packed_matrix[get_packed_row_offset(col, size, is_upper) + (is_upper ? row_to_check - col : row_to_check)], 0, 1, 0, 1))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Calculate the row rank of the matrix.
+ *
+ * @param matrix_to_check: double[ptr]
+ *      The matrix to calculate the rank for.
+ * @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_to_check data structure. Should contain the dimensions of the matrix.
+ * @return int The rank of the matrix.
+ */
+static inline int calculate_matrix_row_rank(double *matrix_to_check, struct MatrixMetadata *metadata)
+{
+    int row_rank = 0;
+    for (int row = 0; row < metadata->num_rows; row++)
+    {
+        // A packed matrix's rows are not strided, so they are read from the packed triangle
+        int is_zero_row = is_packed_layout(metadata) ? packed_row_has_all_zeros(matrix_to_check, metadata, row) : row_has_all_zeros(matrix_to_check, row, metadata->num_cols, get_row_stride(metadata), get_col_stride(metadata));
+        if (!is_zero_row)
+        {
+            row_rank++;
+        }
+    }
+    return row_rank;
+}
+
+/**
+ *  @brief Decide from the ranks of A and of [A | B] whether the system is consistent and how many solutions it has (the Rouché–Capelli theorem),
+ *         write that to the step log and set the consistency flag.
+ *
+ *  @param matrix_row_rank: int
+ *      The rank of A.
+ *  @param augmented_matrix_row_rank: int
+ *      The rank of [A | B].
+ *  @param matrix_to_check_metadata struct MatrixMetadata[ptr]
+ *      The metadata of A. Should contain the dimensions of the matrix, and the consistency value will be written to it.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the result is printed instead.
+ *
+ *  @return None
+ */
+static inline void report_matrix_consistency(int matrix_row_rank, int augmented_matrix_row_rank, struct MatrixMetadata *matrix_to_check_metadata, struct String *message_buffer)
+{
+    if (matrix_row_rank < augmented_matrix_row_rank)
+    {
+        if (!message_buffer)
+        {
+            printf("System of Equations is not Consistent. No solution exists.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("System of Equations is not Consistent. No solution exists.\n", message_buffer);
+        }
+        matrix_to_check_metadata->is_consistent = 0;
+    }
+    else if (matrix_row_rank == augmented_matrix_row_rank)
+    {
+        if (matrix_row_rank < matrix_to_check_metadata->num_rows)
+        {
+            if (!message_buffer)
+            {
+                printf("System of Equations is Consistent. Infinite solutions exist.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("System of Equations is Consistent. Infinite solutions exist.\n", message_buffer);
+            }
+            matrix_to_check_metadata->is_consistent = 1;
+        }
+        else if (matrix_row_rank == matrix_to_check_metadata->num_rows)
+        {
+            if (!message_buffer)
+            {
+                printf("System of Equations is Consistent. Unique solution exists.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("System of Equations is Consistent. Unique solution exists.\n", message_buffer);
+            }
+            matrix_to_check_metadata->is_consistent = 1;
+        }
+        else
+        {
+            if (!message_buffer)
+            {
+                printf("System of Equations is Consistent. Row Rank exceeds number of rows in matrix.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("System of Equations is Consistent. Row Rank exceeds number of rows in matrix.\n", message_buffer);
+            }
+            matrix_to_check_metadata->is_consistent = 1;
+        }
+    }
+    else
+    {
+        if (!message_buffer)
+        {
+            printf("Somehow rank(A|b) > n. Don't know what to do.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("Somehow rank(A|b) > n. Don't know what to do.\n", message_buffer);
+        }
+        matrix_to_check_metadata->is_consistent = 1;
+    }
+}
+
+/**
+ *  @brief Check if a matrix is consistent and how many solutions it has using the Rouché–Capelli theorem. Note that since row and column rank are equivalent, only row rank is considered by the theorem.
+ *
+ *  @param matrix_to_check: double[ptr]
+ *      The matrix to determine consistency for.
+ *  @param augmented_matrix_to_check double[ptr]
+ *      The augmented matrix used to determine if the matrix_to_check is consistent.
+ *  @param matrix_to_check_metadata struct MatrixMetadata[ptr]
+ *      The metadata of the matrix_to_check data structure. Should contain the dimensions of the matrix, and the consistency value will be written to it.
+ *  @param augmented_matrix_to_check_metadata struct MatrixMetadata[ptr]
+ *      The metadata of the augmented_matrix_to_check data structure. Should contain the dimensions of the matrix.
+ *
+ *  @return None
+ */
+static inline void is_matrix_consistent_rouche_capelli(double *matrix_to_check, double *augmented_matrix_to_check, struct MatrixMetadata *matrix_to_check_metadata, struct MatrixMetadata *augmented_matrix_to_check_metadata, struct String *message_buffer)
+{
+    // NOTE: It appears that you can prove that the column and row rank are equivalent, and since row rank is simpler to calculate we'll use only that.
+    int matrix_row_rank = calculate_matrix_row_rank(matrix_to_check, matrix_to_check_metadata);
+    int augmented_matrix_row_rank = calculate_matrix_row_rank(augmented_matrix_to_check, augmented_matrix_to_check_metadata);
+    report_matrix_consistency(matrix_row_rank, augmented_matrix_row_rank, matrix_to_check_metadata, message_buffer);
+}
+
+/**********************************************************************************
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ *                               PRINT FUNCTIONS                                  *
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ **********************************************************************************/
+
+/**
+ * @brief Helper function to print out the matrix metadata.
+ *
+ * @param matrix_metadata_to_print: struct MatrixMetadata[ptr]
+ *      The matrix metadata structure to print out.
+ *
+ * @returns None.
+ */
+static inline void print_matrix_metadata(struct MatrixMetadata *matrix_metadata_to_print)
+{
+    printf(
+        "Num Rows: %3d\nNum Columns: %3d\nMatrix Rank: %d\nIs Consistent? %d\nMatrix Determinant: %03.6f\n",
+        matrix_metadata_to_print->num_rows,
+        matrix_metadata_to_print->num_cols,
+        matrix_metadata_to_print->matrix_rank,
+        matrix_metadata_to_print->is_consistent,
+        matrix_metadata_to_print->matrix_determinant);
+}
+
+/**
+ *  @brief Print the matrix. If a buffer is not provided, it prints to STDOUT instead.
+ *
+ *  @param matrix_to_print: double[ptr]
+ *      The matrix to print the values of.
+ *  @param num_rows: int
+ *      The number of rows in the matrix_to_print data structure.
+ *  @param num_cols: int
+ *      The number of columns in the matrix_to_print data structure.
+ *  @param message_buffer: struct String[ptr]
+ *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component. Otherwise, values will be printed out to STDOUT.
+ *
+ *  @return None
+ *
+ */
+static inline void print_matrix(double *matrix_to_print, int num_rows, int num_cols, struct String *message_buffer)
+{
+    for (int row = 0; row < num_rows; row++)
+    {
+        for (int col = 0; col < num_cols; col++)
+        {
+            if (!message_buffer)
+            {
+                printf("% f\t", matrix_to_print[(row * num_cols) + col]);
+            }
+            else
+            {
+                writeDecimalNumber((int64_t)(matrix_to_print[(row * num_cols) + col] * 1e6), 6, message_buffer);
+                writeStringNoNullTerminator("\t", message_buffer);
+            }
+        }
+        if (!message_buffer)
+        {
+            printf("\n");
+        }
+        else
+        {
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+}
+
+/**
+ *  @brief Print an augmented matrix whose matrix and augment parts are held in separate row tables, with a dividing line between them.
+ *         If a buffer is not provided, it prints to STDOUT instead.
+ *
+ *  @param matrix_rows_to_print: double[ptr][ptr]
+ *      The rows of the matrix part, in the order they should be printed.
+ *  @param augment_rows_to_print: double[ptr][ptr]
+ *      The rows of the augment part, in the same order. If NULL, each augment row follows its matrix row in memory.
+ *  @param num_rows: int
+ *      The number of rows to print.
+ *  @param num_matrix_cols: int
+ *      The number of columns of the matrix part.
+ *  @param num_augmented_cols: int
+ *      The number of columns of the augment part. The dividing line is printed before them.
+ *  @param message_buffer: struct String[ptr]
+ *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component. Otherwise, values will be printed out to STDOUT.
+ *
+ *  @return None
+ *
+ */
+static inline void print_augmented_rows(double **matrix_rows_to_print, double **augment_rows_to_print, int num_rows, int num_matrix_cols, int num_augmented_cols, struct String *message_buffer)
+{
+    for (int row = 0; row < num_rows; row++)
+    {
+        const double *parts[2];
+        parts[0] = matrix_rows_to_print[row];
+        parts[1] = augment_rows_to_print ? augment_rows_to_print[row] : &matrix_rows_to_print[row][num_matrix_cols];
+        int num_part_cols[2] = {num_matrix_cols, num_augmented_cols};
+        for (int part = 0; part < 2; part++)
+        {
+            for (int col = 0; col < num_part_cols[part]; col++)
+            {
+                if (!message_buffer)
+                {
+                    printf("% f\t", parts[part][col]);
+                }
+                else
+                {
+                    writeDecimalNumber((int64_t)(parts[part][col] * 1e6), 6, message_buffer);
+                    writeStringNoNullTerminator("\t", message_buffer);
+                }
+            }
+            if (part == 0 && num_matrix_cols > 0)
+            {
+                if (!message_buffer)
+                {
+                    printf("|\t");
+                }
+                else
+                {
+                    writeStringNoNullTerminator("|\t", message_buffer);
+                }
+            }
+        }
+        if (!message_buffer)
+        {
+            printf("\n");
+        }
+        else
+        {
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+}
+
+/**
+ *  @brief Print the augmented matrix with a dividing line. If a buffer is not provided, it prints to STDOUT instead.
+ *
+ *  @param rows_to_print: double[ptr][ptr]
+ *      The rows of the matrix to print, in the order they should be printed.
+ *  @param num_rows: int
+ *      The number of rows in the rows_to_print data structure.
+ *  @param num_cols: int
+ *      The number of columns in each row.
+ *  @param num_augmented_cols: int
+ *      The number of columns at the end of each row that belong to the augment. The dividing line is printed before them.
+ *  @param message_buffer: struct String[ptr]
+ *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component. Otherwise, values will be printed out to STDOUT.
+ *
+ *  @return None
+ *
+ */
+static inline void print_augmented_matrix(double **rows_to_print, int num_rows, int num_cols, int num_augmented_cols, struct String *message_buffer)
+{
+    print_augmented_rows(rows_to_print, NULL, num_rows, num_cols - num_augmented_cols, num_augmented_cols, message_buffer);
+}
+
+/**********************************************************************************
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ *                          ELEMENTARY ROW OPERATIONS                             *
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ **********************************************************************************/
+
+/**
+ *  NOTE: The row operations work on row pointers rather than on (matrix, row index) pairs, so the solver can reorder rows through a
+ *  table of row pointers (see swap_rows) instead of moving their values around in memory.
+ */
+
+/**
+ *  @brief Multiply a row of values in a matrix by some scalar value.
+ *
+ *  @param row_to_scale: double[ptr]
+ *      The row of the matrix to scale by the scalar value.
+ *  @param num_cols: int
+ *      The number of columns in the matrix. Used for iterating through the array.
+ *  @param scalar: double
+ *      The value that the row of values in the matrix will be scaled by.
+ *
+ *  @returns None.
+ *
+ */
+static inline void multiply_row_by_scalar(double *row_to_scale, int num_cols, double scalar)
+{
+    for (int col = 0; col < num_cols; col++)
+    {
+        row_to_scale[col] *= scalar;
+    }
+}
+
+/**
+ *  @brief Subtract a row of values, potentially multiplied by some scalar value, from another row in the matrix.
+ *
+ *  @param row_to_modify: double[ptr]
+ *      The row of the matrix whose value will be modified by the operation.
+ *  @param row_to_use_for_subtraction: double[ptr]
+ *      The row of the matrix whose value will be the subtractor. Values might be modified by some scalar value.
+ *  @param num_cols: int
+ *      The number of columns in the matrix. Used for iterating through the array.
+ *  @param scalar: double
+ *      The value that the row_to_use_for_subtraction in the matrix will be scaled by.
+ *
+ *  @returns None.
+ *
+ */
+static inline void subtract_scaled_row(double *row_to_modify, const double *row_to_use_for_subtraction, int num_cols, double scalar)
+{
+    for (int col = 0; col < num_cols; col++)
+    {
+        row_to_modify[col] -= (scalar * row_to_use_for_subtraction[col]);
+    }
+}
+
+/**
+ *  @brief Add a row of values, potentially multiplied by some scalar value, to another row in the matrix.
+ *
+ *  @param row_to_modify: double[ptr]
+ *      The row of the matrix whose value will be modified by the operation.
+ *  @param row_to_use_for_addition: double[ptr]
+ *      The row of the matrix whose value will be the addend. Values might be modified by some scalar value.
+ *  @param num_cols: int
+ *      The number of columns in the matrix. Used for iterating through the array.
+ *  @param scalar: double
+ *      The value that the row_to_use_for_addition in the matrix will be scaled by.
+ *
+ *  @returns None.
+ *
+ */
+static inline void add_scaled_row(double *row_to_modify, const double *row_to_use_for_addition, int num_cols, double scalar)
+{
+    for (int col = 0; col < num_cols; col++)
+    {
+        row_to_modify[col] += (scalar * row_to_use_for_addition[col]);
+    }
+}
+
+// The most rows subtract_scaled_row_from_rows updates per pass over the row it subtracts.
+#define ELIMINATION_BLOCK_ROWS 8
+// The number of values of the row being subtracted that subtract_scaled_row_from_rows holds (in registers) at a time.
+#define ELIMINATION_SEGMENT_COLS 8
+
+/**
+ *  @brief Subtract one row, multiplied by a different scalar for each, from several rows at once. Same result, bit for bit, as calling
+ *         subtract_scaled_row on each row, but each segment of row_to_use_for_subtraction is loaded once for all of the rows instead of once per row.
+ *
+ *  @param rows_to_modify: double[ptr][ptr]
+ *      The rows of the matrix whose values will be modified by the operation. Must not include row_to_use_for_subtraction.
+ *  @param scalars: double[ptr]
+ *      The value that row_to_use_for_subtraction is scaled by for each of rows_to_modify.
+ *  @param num_rows_to_modify: int
+ *      The number of rows to modify. At most ELIMINATION_BLOCK_ROWS.
+ *  @param row_to_use_for_subtraction: double[ptr]
+ *      The row of the matrix whose value will be the subtractor (e.g., the pivot row).
+ *  @param num_cols: int
+ *      The number of columns in the matrix. Used for iterating through the array.
+ *
+ *  @returns None.
+ *
+ */
+static inline void subtract_scaled_row_from_rows(double **rows_to_modify, const double *scalars, int num_rows_to_modify, const double *row_to_use_for_subtraction, int num_cols)
+{
+    double segment[ELIMINATION_SEGMENT_COLS];
+    int first_col = 0;
+    for (; first_col + ELIMINATION_SEGMENT_COLS <= num_cols; first_col += ELIMINATION_SEGMENT_COLS)
+    {
+        for (int col = 0; col < ELIMINATION_SEGMENT_COLS; col++)
+        {
+            segment[col] = row_to_use_for_subtraction[first_col + col];
+        }
+        for (int row = 0; row < num_rows_to_modify; row++)
+        {
+            double *row_segment = &rows_to_modify[row][first_col];
+            double scalar = scalars[row];
+            for (int col = 0; col < ELIMINATION_SEGMENT_COLS; col++)
+            {
+                row_segment[col] -= (scalar * segment[col]);
+            }
+        }
+    }
+    for (int row = 0; row < num_rows_to_modify; row++)
+    {
+        subtract_scaled_row(&rows_to_modify[row][first_col], &row_to_use_for_subtraction[first_col], num_cols - first_col, scalars[row]);
+    }
+}
+
+/**
+ *  @brief Swap two rows in a matrix by swapping their entries in the row pointer table and the row permutation. This is O(1) no matter how wide the rows are.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix.
+ *  @param row_permutation: int[ptr]
+ *      The input row that each entry of rows came from. Swapped along with rows.
+ *  @param row_to_swap_index_a: int
+ *      The row of the matrix that serves as one half of the swap operation.
+ *  @param row_to_swap_index_b: int
+ *      The row of the matrix that serves as one half of the swap operation.
+ *
+ *  @returns None.
+ *
+ */
+static inline void swap_rows(double **rows, int *row_permutation, int row_to_swap_index_a, int row_to_swap_index_b)
+{
+    double *row_holder = rows[row_to_swap_index_a];
+    rows[row_to_swap_index_a] = rows[row_to_swap_index_b];
+    rows[row_to_swap_index_b] = row_holder;
+    int permutation_holder = row_permutation[row_to_swap_index_a];
+    row_permutation[row_to_swap_index_a] = row_permutation[row_to_swap_index_b];
+    row_permutation[row_to_swap_index_b] = permutation_holder;
+}
+
+/**
+ *  @brief Swap two rows of an augmented matrix whose matrix and augment parts are held in separate row tables, like swap_rows.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix part.
+ *  @param augment_rows: double[ptr][ptr]
+ *      The row pointer table of the augment part. Swapped along with rows.
+ *
+ *  The other parameters are those of swap_rows.
+ *
+ *  @returns None.
+ *
+ */
+static inline void swap_augmented_rows(double **rows, double **augment_rows, int *row_permutation, int row_to_swap_index_a, int row_to_swap_index_b)
+{
+    double *row_holder = augment_rows[row_to_swap_index_a];
+    augment_rows[row_to_swap_index_a] = augment_rows[row_to_swap_index_b];
+    augment_rows[row_to_swap_index_b] = row_holder;
+    swap_rows(rows, row_permutation, row_to_swap_index_a, row_to_swap_index_b);
+}
+
+/**********************************************************************************
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ *                                    PIVOTING                                    *
+ *                                                                                *
+ *                                                                                *
+ *                                                                                *
+ **********************************************************************************/
+
+/**
+ *  @brief Find the largest absolute value in a contiguous run of values (e.g., part of a row).
+ *         The first pass is a branch-free max reduction over independent lanes, which the compiler turns into SIMD code.
+ *         The second pass stops at the first value that reaches that maximum.
+ *
+ *  @param values: double[ptr]
+ *      The values to search.
+ *  @param count: int
+ *      The number of values to search.
+ *  @param max_abs_value: double[ptr]
+ *      Receives the largest absolute value found (0 if count is 0).
+ *
+ *  @return index: int
+ *      The index of the first value with the largest absolute value (0 if count is 0).
+ */
+static inline int find_max_abs_index(const double *values, int count, double *max_abs_value)
+{
+    double lane_max[4] = {0.0, 0.0, 0.0, 0.0};
+    int index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            double abs_value = fabs(values[index + lane]);
+            lane_max[lane] = (abs_value > lane_max[lane]) ? abs_value : lane_max[lane];
+        }
+    }
+    double max_value = lane_max[0];
+    for (int lane = 1; lane < 4; lane++)
+    {
+        max_value = (lane_max[lane] > max_value) ? lane_max[lane] : max_value;
+    }
+    for (; index < count; index++)
+    {
+        double abs_value = fabs(values[index]);
+        max_value = (abs_value > max_value) ? abs_value : max_value;
+    }
+    *max_abs_value = max_value;
+    for (index = 0; index < count; index++)
+    {
+        if (fabs(values[index]) == max_value)
+        {
+            return index;
+        }
+    }
+    return 0;
+}
+
+// The column pivot search gathers this many values at a time into a contiguous buffer for find_max_abs_index.
+#define PIVOT_SEARCH_CHUNK_ROWS 256
+
+/**
+ *  @brief Find the row with the largest absolute value in one column, from first_row down. The column is reached through the row pointer
+ *         table, so it is gathered into a contiguous buffer a chunk at a time, and each chunk is searched with the lane-split reduction
+ *         of find_max_abs_index. A later chunk only wins with a strictly larger value, so ties still go to the first row.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix.
+ *  @param first_row: int
+ *      The first row to search.
+ *  @param num_rows: int
+ *      The number of rows in the matrix.
+ *  @param col: int
+ *      The (physical) column to search.
+ *  @param max_abs_value: double[ptr]
+ *      Receives the largest absolute value found.
+ *
+ *  @return row: int
+ *      The first row with the largest absolute value.
+ */
+static inline int find_max_abs_row_in_column(double **rows, int first_row, int num_rows, int col, double *max_abs_value)
+{
+    double column_values[PIVOT_SEARCH_CHUNK_ROWS];
+    int max_row = first_row;
+    double max_value = 0.0;
+    for (int chunk_row = first_row; chunk_row < num_rows; chunk_row += PIVOT_SEARCH_CHUNK_ROWS)
+    {
+        int num_chunk_rows = (num_rows - chunk_row < PIVOT_SEARCH_CHUNK_ROWS) ? (num_rows - chunk_row) : PIVOT_SEARCH_CHUNK_ROWS;
+        for (int row = 0; row < num_chunk_rows; row++)
+        {
+            column_values[row] = rows[chunk_row + row][col];
+        }
+        double chunk_max_value;
+        int index = find_max_abs_index(column_values, num_chunk_rows, &chunk_max_value);
+        if (chunk_max_value > max_value)
+        {
+            max_value = chunk_max_value;
+            max_row = chunk_row + index;
+        }
+    }
+    *max_abs_value = max_value;
+    return max_row;
+}
+
+/**
+ *  @brief Choose the pivot for a column of the forward elimination.
+ *
+ *         Rows are searched in the row pointer table, and columns in physical (memory) order. Searching whole physical rows is
+ *         safe because every column that was already used as a pivot is exactly 0 from diagonal_index down.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the augmented matrix.
+ *  @param num_rows: int
+ *      The number of rows in the matrix.
+ *  @param num_matrix_cols: int
+ *      The number of columns that belong to the matrix (pivots are never taken from the augment).
+ *  @param diagonal_index: int
+ *      The step of the forward elimination. Only rows (and, for rook/complete pivoting, columns) that have not been used as pivots yet are searched.
+ *  @param pivot_col_of_step: int
+ *      The physical column that the step would use without column pivoting.
+ *  @param pivot_strategy: int
+ *      One of the PivotStrategy values. PIVOT_STRATEGY_NONE is handled by the elimination itself and is not expected here.
+ *  @param pivot_row: int[ptr]
+ *      Receives the row of the chosen pivot.
+ *  @param pivot_col: int[ptr]
+ *      Receives the physical column of the chosen pivot.
+ *
+ *  @return None
+ */
+static inline void select_pivot(double **rows, int num_rows, int num_matrix_cols, int diagonal_index, int pivot_col_of_step, int pivot_strategy, int *pivot_row, int *pivot_col)
+{
+    double max_abs_value;
+    if (pivot_strategy == PIVOT_STRATEGY_COMPLETE)
+    {
+        double best_abs_value = -1.0;
+        for (int row = diagonal_index; row < num_rows; row++)
+        {
+            int col = find_max_abs_index(rows[row], num_matrix_cols, &max_abs_value);
+            if (max_abs_value > best_abs_value)
+            {
+                best_abs_value = max_abs_value;
+                *pivot_row = row;
+                *pivot_col = col;
+            }
+        }
+        if (best_abs_value <= 0.0)
+        {
+            // The rest of the matrix is all zeros, so there is nothing to gain from a swap
+            *pivot_row = diagonal_index;
+            *pivot_col = pivot_col_of_step;
+        }
+        return;
+    }
+
+    *pivot_col = pivot_col_of_step;
+    *pivot_row = find_max_abs_row_in_column(rows, diagonal_index, num_rows, *pivot_col, &max_abs_value);
+    if (pivot_strategy != PIVOT_STRATEGY_ROOK || max_abs_value <= 0.0)
+    {
+        return;
+    }
+    // Rook pivoting: stop once the element is the largest in both its row and its column
+    for (;;)
+    {
+        double row_max_abs_value;
+        int col = find_max_abs_index(rows[*pivot_row], num_matrix_cols, &row_max_abs_value);
+        if (row_max_abs_value <= max_abs_value)
+        {
+            return;
+        }
+        *pivot_col = col;
+        max_abs_value = row_max_abs_value;
+        double col_max_abs_value;
+        int row = find_max_abs_row_in_column(rows, diagonal_index, num_rows, *pivot_col, &col_max_abs_value);
+        if (col_max_abs_value <= max_abs_value)
+        {
+            return;
+        }
+        *pivot_row = row;
+        max_abs_value = col_max_abs_value;
+    }
+}
+
+/**
+ *  @brief Write the step log line for a row swap.
+ *
+ *  @param row: int
+ *      The (0-based) row being swapped into the pivot position.
+ *  @param diagonal_index: int
+ *      The (0-based) pivot row.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the line is printed instead.
+ *
+ *  @return None
+ */
+static inline void log_row_swap(int row, int diagonal_index, struct String *message_buffer)
+{
+    if (!message_buffer)
+    {
+        printf("[SWP] Row %d = (R%d) <=> (R%d)\n", (row + 1), (row + 1), (diagonal_index + 1));
+    }
+    else
+    {
+        writeStringNoNullTerminator("[SWP] Row ", message_buffer);
+        writeNumber((row + 1), message_buffer);
+        writeStringNoNullTerminator(" = (R", message_buffer);
+        writeNumber((row + 1), message_buffer);
+        writeStringNoNullTerminator(") <=> (R", message_buffer);
+        writeNumber((diagonal_index + 1), message_buffer);
+        writeNulTerminatedString(")\n", message_buffer);
+    }
+}
+
+/**
+ *  @brief Write the step log line for a column swap. Columns are only swapped in the order pivots are taken in; the matrix itself keeps its column order.
+ *
+ *  @param col: int
+ *      The (0-based) column that becomes the pivot column.
+ *  @param previous_col: int
+ *      The (0-based) column that would have been the pivot column.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the line is printed instead.
+ *
+ *  @return None
+ */
+static inline void log_column_swap(int col, int previous_col, struct String *message_buffer)
+{
+    if (!message_buffer)
+    {
+        printf("[CSW] Column %d <=> Column %d\n", (col + 1), (previous_col + 1));
+    }
+    else
+    {
+        writeStringNoNullTerminator("[CSW] Column ", message_buffer);
+        writeNumber((col + 1), message_buffer);
+        writeStringNoNullTerminator(" <=> Column ", message_buffer);
+        writeNumber((previous_col + 1), message_buffer);
+        writeNulTerminatedString("\n", message_buffer);
+    }
+}
+
+/**
+ *  @brief Write the step log line for the pivot element chosen after a swap.
+ *
+ *  @param pivot_element: double
+ *      The new pivot element.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the line is printed instead.
+ *
+ *  @return None
+ */
+static inline void log_new_pivot_element(double pivot_element, struct String *message_buffer)
+{
+    if (!message_buffer)
+    {
+        printf("New Pivot Element: % .6f\n", pivot_element);
+    }
+    else
+    {
+        writeStringNoNullTerminator("New Pivot Element: ", message_buffer);
+        writeDecimalNumber((int64_t)(pivot_element * 1e9), 9, message_buffer);
+        writeNulTerminatedString("\n", message_buffer);
+    }
+}
+
+/**
+ *  @brief Write the step log line for the solver the automatic dispatcher picked, with the structure it picked it for.
+ *
+ *  @param solver_name: char[ptr]
+ *      The name of the solver.
+ *  @param structure: struct MatrixStructure[ptr]
+ *      The structure profile of the matrix, or NULL if it could not be analyzed (only the solver is logged then).
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the line is printed instead.
+ *
+ *  @return None
+ */
+static inline void log_solver_plan(const char *solver_name, const struct MatrixStructure *structure, struct String *message_buffer)
+{
+    if (!structure)
+    {
+        if (!message_buffer)
+        {
+            printf("Structure: not analyzed. Dispatching to %s.\n", solver_name);
+        }
+        else
+        {
+            writeStringNoNullTerminator("Structure: not analyzed. Dispatching to ", message_buffer);
+            writeStringNoNullTerminator(solver_name, message_buffer);
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+    else if (!message_buffer)
+    {
+        printf("Structure: %lld nonzeros, bandwidths (%d, %d), %s. Dispatching to %s.\n", (long long)structure->num_nonzeros, structure->lower_bandwidth, structure->upper_bandwidth, structure->is_symmetric ? "symmetric" : "not symmetric", solver_name);
+    }
+    else
+    {
+        writeStringNoNullTerminator("Structure: ", message_buffer);
+        writeNumber(structure->num_nonzeros, message_buffer);
+        writeStringNoNullTerminator(" nonzeros, bandwidths (", message_buffer);
+        writeNumber(structure->lower_bandwidth, message_buffer);
+        writeStringNoNullTerminator(", ", message_buffer);
+        writeNumber(structure->upper_bandwidth, message_buffer);
+        writeStringNoNullTerminator("), ", message_buffer);
+        writeStringNoNullTerminator(structure->is_symmetric ? "symmetric" : "not symmetric", message_buffer);
+        writeStringNoNullTerminator(". Dispatching to ", message_buffer);
+        writeStringNoNullTerminator(solver_name, message_buffer);
+        writeNulTerminatedString("\n", message_buffer);
+    }
+}
+
+/**
+ *  @brief Once the reduction is done, put the pivot rows in the order of their pivot columns, so that the reduced matrix and the solution
+ *         are in the natural order of the variables even when columns were swapped. Rows without a pivot go after the pivot rows.
+ *         Every pivot column is all zeros except at its pivot by then, so this only moves rows around.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix part of the augmented matrix.
+ *  @param augment_rows: double[ptr][ptr]
+ *      The row pointer table of the augment part, reordered along with rows.
+ *  @param row_permutation: int[ptr]
+ *      The row permutation, reordered along with rows.
+ *  @param col_position: int[ptr]
+ *      For each (physical) column, the step of the elimination it was the pivot column of.
+ *  @param num_pivot_rows: int
+ *      The number of elimination steps (the size of the main diagonal).
+ *  @param num_matrix_cols: int
+ *      The number of columns that belong to the matrix.
+ *  @param ordered_rows: double[ptr][ptr]
+ *      Scratch space for num_pivot_rows row pointers.
+ *  @param ordered_augment_rows: double[ptr][ptr]
+ *      Scratch space for num_pivot_rows row pointers.
+ *  @param ordered_permutation: int[ptr]
+ *      Scratch space for num_pivot_rows values.
+ *
+ *  @return None
+ */
+static inline void order_rows_by_pivot_column(double **rows, double **augment_rows, int *row_permutation, const int *col_position, int num_pivot_rows, int num_matrix_cols, double **ordered_rows, double **ordered_augment_rows, int *ordered_permutation)
+{
+    int num_ordered_rows = 0;
+    for (int col = 0; col < num_matrix_cols; col++)
+    {
+        int step = col_position[col];
+        if (step < num_pivot_rows && rows[step][col] != 0)
+        {
+            ordered_rows[num_ordered_rows] = rows[step];
+            ordered_augment_rows[num_ordered_rows] = augment_rows[step];
+            ordered_permutation[num_ordered_rows] = row_permutation[step];
+            num_ordered_rows++;
+        }
+    }
+    for (int col = 0; col < num_matrix_cols; col++)
+    {
+        int step = col_position[col];
+        if (step < num_pivot_rows && rows[step][col] == 0)
+        {
+            ordered_rows[num_ordered_rows] = rows[step];
+            ordered_augment_rows[num_ordered_rows] = augment_rows[step];
+            ordered_permutation[num_ordered_rows] = row_permutation[step];
+            num_ordered_rows++;
+        }
+    }
+    memcpy(rows, ordered_rows, sizeof(double *) * num_pivot_rows);
+    memcpy(augment_rows, ordered_augment_rows, sizeof(double *) * num_pivot_rows);
+    memcpy(row_permutation, ordered_permutation, sizeof(int) * num_pivot_rows);
+}
+
+/**
+ *  @brief Reduce the rows once more, in the natural order of the columns, so every pivot leads its row. Column pivoting picks pivot columns
+ *         by size, so when a matrix has fewer pivots than columns, a pivot can end up to the right of a nonzero entry of its row (A = [[1, 2, 3],
+ *         [2, 4, 6], [1, 1, 1]] with complete pivoting gives the rows [1, 0.5, 0] and [0, 0.5, 1]), which is not reduced row echelon form.
+ *         The rows are already reduced, so this is one more Gauss-Jordan pass over them, with partial pivoting.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix part of the reduced augmented matrix.
+ *  @param augment_rows: double[ptr][ptr]
+ *      The row pointer table of the augment part, reduced along with rows.
+ *  @param row_permutation: int[ptr]
+ *      The row permutation, reordered along with rows.
+ *  @param num_rows: int
+ *      The number of rows.
+ *  @param num_matrix_cols: int
+ *      The number of columns that belong to the matrix.
+ *  @param num_augment_cols: int
+ *      The number of columns that belong to the augment.
+ *
+ *  @return None
+ */
+static void move_pivots_to_leading_columns(double **rows, double **augment_rows, int *row_permutation, int num_rows, int num_matrix_cols, int num_augment_cols)
+{
+    int lead_row = 0;
+    for (int col = 0; col < num_matrix_cols && lead_row < num_rows; col++)
+    {
+        double max_abs_value;
+        int pivot_row = find_max_abs_row_in_column(rows, lead_row, num_rows, col, &max_abs_value);
+        if (!(max_abs_value > 0.0))
+        {
+            continue;
+        }
+        if (pivot_row != lead_row)
+        {
+            swap_augmented_rows(rows, augment_rows, row_permutation, pivot_row, lead_row);
+        }
+        double pivot_reciprocal = 1.0 / rows[lead_row][col];
+        multiply_row_by_scalar(rows[lead_row], num_matrix_cols, pivot_reciprocal);
+        multiply_row_by_scalar(augment_rows[lead_row], num_augment_cols, pivot_reciprocal);
+        rows[lead_row][col] = 1.0;
+        for (int row = 0; row < num_rows; row++)
+        {
+            double scalar = rows[row][col];
+            if (row != lead_row && scalar != 0)
+            {
+                subtract_scaled_row_from_rows(&rows[row], &scalar, 1, rows[lead_row], num_matrix_cols);
+                subtract_scaled_row_from_rows(&augment_rows[row], &scalar, 1, augment_rows[lead_row], num_augment_cols);
+                rows[row][col] = 0.0;
+            }
+        }
+        lead_row++;
+    }
+}
+
+/**
+ *  @brief Copy the results of a reduction out of the augmented matrix into the caller's buffers, in the pivoted row order.
+ *
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of the reduced augmented matrix.
+ *  @param augment_rows: double[ptr][ptr]
+ *      The row pointer table of the augment part, if it is held apart from the matrix part. If NULL, each augment row follows its row of rows.
+ *  @param row_permutation: int[ptr]
+ *      The input row that each entry of rows came from.
+ *  @param augmented_matrix_metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the augmented_matrix data structure. Should contain the dimensions of the matrix.
+ *  @param num_matrix_cols: int
+ *      The number of columns that belong to the matrix (the rest belong to the augment).
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      The buffers to copy into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+static inline void copy_solver_outputs(double **rows, double **augment_rows, const int *row_permutation, struct MatrixMetadata *augmented_matrix_metadata, int num_matrix_cols, struct SolverOutputs *outputs)
+{
+    if (!outputs)
+    {
+        return;
+    }
+    int num_augment_cols = augmented_matrix_metadata->num_cols - num_matrix_cols;
+    for (int row = 0; row < augmented_matrix_metadata->num_rows; row++)
+    {
+        const double *augmented_row = rows[row];
+        const double *augment_row = augment_rows ? augment_rows[row] : &augmented_row[num_matrix_cols];
+        if (outputs->reduced_matrix)
+        {
+            memcpy(&outputs->reduced_matrix[(int64_t)row * num_matrix_cols], augmented_row, sizeof(double) * num_matrix_cols);
+        }
+        if (outputs->solution)
+        {
+            memcpy(&outputs->solution[(int64_t)row * num_augment_cols], augment_row, sizeof(double) * num_augment_cols);
+        }
+        if (outputs->pivot_permutation)
+        {
+            outputs->pivot_permutation[row] = row_permutation[row];
+        }
+    }
+}
+
+/**
+ *  @brief Work out the determinant of a consistent system from the products of its reduction and write it to the step log.
+ *
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix that was reduced, with its consistency already set. The determinant is written to it.
+ *
+ *  The other parameters are those of report_reduction_results.
+ *
+ *  @return None
+ *
+ */
+static void report_determinant(struct MatrixMetadata *metadata, double product_of_diagonal_elements, double denominator_value, int swap_multiplier, int log_steps, struct String *message_buffer)
+{
+    if (metadata->is_consistent == 1)
+    {
+        if (log_steps)
+        {
+            if (!message_buffer)
+            {
+                printf("Product of Diagonal Elements is: % .6f\n", product_of_diagonal_elements);
+                printf("Denominator Value is: % .6f\n", denominator_value);
+                printf("Swap Multiplier is: %d\n", swap_multiplier);
+            }
+            else
+            {
+                writeStringNoNullTerminator("Product of Diagonal Elements is: ", message_buffer);
+                writeDecimalNumber((int64_t)(product_of_diagonal_elements * 1e9), 9, message_buffer);
+                writeNulTerminatedString("\n", message_buffer);
+                // BUG?: Denominator value is product of all scalar multiplications performed during gaussian elimination (reduced echelon); Currently remains at default value 1
+                writeStringNoNullTerminator("Denominator Value is: ", message_buffer);
+                writeDecimalNumber((int64_t)(denominator_value * 1e9), 9, message_buffer);
+                writeNulTerminatedString("\n", message_buffer);
+
+                writeStringNoNullTerminator("Swap Multiplier is: ", message_buffer);
+                writeNumber(swap_multiplier, message_buffer);
+                writeNulTerminatedString("\n", message_buffer);
+            }
+        }
+        metadata->matrix_determinant = (product_of_diagonal_elements / denominator_value) * swap_multiplier;
+        if (!message_buffer)
+        {
+            printf("Determinant of matrix A is: % .6f\n", metadata->matrix_determinant);
+        }
+        else
+        {
+            writeStringNoNullTerminator("Determinant of non-augmented matrix A is: ", message_buffer);
+            writeDecimalNumber((int64_t)(metadata->matrix_determinant * 1e9), 9, message_buffer);
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+}
+
+/**
+ *  @brief Finish a reduction: check whether the system is consistent, work out the determinant and write both to the step log, then copy the results into the outputs.
+ *         Every engine ends with this, so they all report their results the same way. The rank of A is the number of rows of the reduced A that are not zero.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix that was reduced, as it was passed in.
+ *  @param augmented_matrix: double[ptr]
+ *      The reduced augmented matrix.
+ *  @param rows: double[ptr][ptr]
+ *      The row pointer table of augmented_matrix, in the order of the results.
+ *  @param row_permutation: int[ptr]
+ *      Which input row each row of the results came from.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce. The rank, the consistency and the determinant are written to it.
+ *  @param augmented_matrix_metadata: struct MatrixMetadata[ptr]
+ *      The dimensions of augmented_matrix.
+ *  @param product_of_diagonal_elements: double
+ *      The product of the pivots.
+ *  @param denominator_value: double
+ *      What the product of the pivots has to be divided by to get the determinant.
+ *  @param swap_multiplier: int
+ *      -1 if an odd number of row/column swaps were made, 1 otherwise.
+ *  @param log_steps: int
+ *      Whether the determinant's parts are written to the log.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, the results are printed instead.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      The buffers to copy into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+static void report_reduction_results(double *matrix_to_reduce, double *augmented_matrix, double **rows, const int *row_permutation, struct MatrixMetadata *metadata, struct MatrixMetadata *augmented_matrix_metadata, double product_of_diagonal_elements, double denominator_value, int swap_multiplier, int log_steps, struct String *message_buffer, struct SolverOutputs *outputs)
+{
+    metadata->matrix_rank = 0;
+    for (int row = 0; row < augmented_matrix_metadata->num_rows; row++)
+    {
+        metadata->matrix_rank += !row_has_all_zeros(rows[row], 0, metadata->num_cols, 0, 1);
+    }
+    is_matrix_consistent_rouche_capelli(matrix_to_reduce, augmented_matrix, metadata, augmented_matrix_metadata, message_buffer);
+    if (!message_buffer)
+    {
+        print_matrix_metadata(metadata);
+    }
+    report_determinant(metadata, product_of_diagonal_elements, denominator_value, swap_multiplier, log_steps, message_buffer);
+    copy_solver_outputs(rows, NULL, row_permutation, augmented_matrix_metadata, metadata->num_cols, outputs);
+}
+
+/**
+ *  @brief Reduce a packed augmented matrix of any MatrixDtype with the instantiation of TypedElimination.c for that type.
+ *
+ *  The parameters are those of reduce_typed_rows_float64 (see TypedElimination.c), with augmented as untyped memory and its dtype.
+ *
+ *  @return rank: int
+ *      The rank of the first num_cols columns.
+ *
+ */
+static int reduce_typed_matrix(int dtype, void *augmented, int num_rows, int num_cols, int num_total_cols, int forward_only, int *row_permutation, int *pivot_cols, double *determinant_real, double *determinant_imag, int num_threads)
+{
+    if (dtype == MATRIX_DTYPE_FLOAT32)
+    {
+        return reduce_typed_rows_float32((float *)augmented, num_rows, num_cols, num_total_cols, forward_only, row_permutation, pivot_cols, determinant_real, determinant_imag, num_threads);
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX64)
+    {
+        return reduce_typed_rows_complex64((float *)augmented, num_rows, num_cols, num_total_cols, forward_only, row_permutation, pivot_cols, determinant_real, determinant_imag, num_threads);
+    }
+    else if (dtype == MATRIX_DTYPE_COMPLEX128)
+    {
+        return reduce_typed_rows_complex128((double *)augmented, num_rows, num_cols, num_total_cols, forward_only, row_permutation, pivot_cols, determinant_real, determinant_imag, num_threads);
+    }
+    return reduce_typed_rows_float64((double *)augmented, num_rows, num_cols, num_total_cols, forward_only, row_permutation, pivot_cols, determinant_real, determinant_imag, num_threads);
+}
+
+/**
+ *  @brief Read one real of a typed matrix (a real value, or either part of a complex one) as a double.
+ */
+static inline double get_typed_real(const void *values, int64_t index, int is_single_precision)
+{
+    return is_single_precision ? (double)((const float *)values)[index] : ((const double *)values)[index];
+}
+
+/**
+ *  @brief Write the determinant of a matrix to the step log, as "re + im i" for complex matrices.
+ */
+static inline void log_typed_determinant(const struct MatrixMetadata *metadata, struct String *message_buffer)
+{
+    int is_complex = (metadata->dtype == MATRIX_DTYPE_COMPLEX64 || metadata->dtype == MATRIX_DTYPE_COMPLEX128);
+    if (!message_buffer)
+    {
+        if (is_complex)
+        {
+            printf("Determinant of matrix A is: % .6f + % .6fi\n", metadata->matrix_determinant, metadata->matrix_determinant_imag);
+        }
+        else
+        {
+            printf("Determinant of matrix A is: % .6f\n", metadata->matrix_determinant);
+        }
+        return;
+    }
+    writeStringNoNullTerminator("Determinant of non-augmented matrix A is: ", message_buffer);
+    writeDecimalNumber((int64_t)(metadata->matrix_determinant * 1e9), 9, message_buffer);
+    if (is_complex)
+    {
+        writeStringNoNullTerminator(" + ", message_buffer);
+        writeDecimalNumber((int64_t)(metadata->matrix_determinant_imag * 1e9), 9, message_buffer);
+        writeStringNoNullTerminator("i", message_buffer);
+    }
+    writeNulTerminatedString("\n", message_buffer);
+}
+
+/**
+ *  @brief Row reduction for matrices of any MatrixDtype: Gauss-Jordan elimination with partial pivoting in the matrix's own arithmetic (see
+ *         TypedKernels.c), so float32 systems move half the bytes of float64 ones and complex systems are solved directly. The step log has the
+ *         same summary as the float64 engines (the consistency of the system and the determinant), but no individual row operations.
+ *         TypedElimination.c only searches columns, so PIVOT_STRATEGY_ROOK and PIVOT_STRATEGY_COMPLETE are not available: the step log says
+ *         so (at every verbosity), and the matrix is reduced with partial pivoting, which gives the same reduced row echelon form.
+ *
+ *  @param matrix_to_reduce: void[ptr]
+ *      The matrix to reduce, with values of metadata->dtype.
+ *  @param matrix_augment: void[ptr]
+ *      The augment, with values of the same type.
+ *  @param require_full_rank: int
+ *      1 when inverting: a matrix without full rank is reported as not invertible, and the outputs are left untouched.
+ *
+ *  The other parameters are those of python_perform_gauss_jordan_reduction, except that the reduced matrix and the solution are written to the
+ *  outputs as values of metadata->dtype.
+ *
+ *  @return None
+ *
+ */
+static void perform_typed_reduction(void *matrix_to_reduce, void *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, int require_full_rank)
+{
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int dtype = metadata->dtype;
+    int value_size = get_dtype_size(dtype);
+    int num_rows = metadata->num_rows;
+    int num_cols = metadata->num_cols;
+    int num_augment_cols = matrix_augment_metadata->num_cols;
+    int num_total_cols = num_cols + num_augment_cols;
+    if (!value_size || matrix_augment_metadata->dtype != dtype || matrix_augment_metadata->num_rows != num_rows || num_rows < 1 || num_cols < 1 || is_packed_layout(metadata) || is_packed_layout(matrix_augment_metadata))
+    {
+        if (!message_buffer)
+        {
+            printf("The matrix and its augment must have the same number of rows and the same supported dtype (only float64 may be packed).\n");
+        }
+        else
+        {
+            writeNulTerminatedString("The matrix and its augment must have the same number of rows and the same supported dtype (only float64 may be packed).\n", message_buffer);
+        }
+        return;
+    }
+    char *augmented_matrix = (char *)allocate_pooled((size_t)value_size * ((int64_t)num_rows * num_total_cols));
+    int *row_permutation = (int *)allocate_pooled(sizeof(int) * num_rows);
+    int *pivot_cols = (int *)allocate_pooled(sizeof(int) * ((num_rows < num_cols) ? num_rows : num_cols));
+    if (!augmented_matrix || !row_permutation || !pivot_cols)
+    {
+        free_pooled(augmented_matrix);
+        free_pooled(row_permutation);
+        free_pooled(pivot_cols);
+        return;
+    }
+    gather_typed_matrix(matrix_to_reduce, metadata, augmented_matrix, num_total_cols);
+    gather_typed_matrix(matrix_augment, matrix_augment_metadata, &augmented_matrix[(int64_t)num_cols * value_size], num_total_cols);
+    if (resolved_options.pivot_strategy == PIVOT_STRATEGY_ROOK || resolved_options.pivot_strategy == PIVOT_STRATEGY_COMPLETE)
+    {
+        const char *strategy_name = (resolved_options.pivot_strategy == PIVOT_STRATEGY_ROOK) ? "Rook" : "Complete";
+        if (!message_buffer)
+        {
+            printf("%s pivoting is only available for float64 matrices, so partial pivoting is used instead.\n", strategy_name);
+        }
+        else
+        {
+            writeStringNoNullTerminator(strategy_name, message_buffer);
+            writeNulTerminatedString(" pivoting is only available for float64 matrices, so partial pivoting is used instead.\n", message_buffer);
+        }
+    }
+    if (resolved_options.verbosity >= LOG_VERBOSITY_STEPS)
+    {
+        if (!message_buffer)
+        {
+            printf("Reducing in %s arithmetic with partial pivoting.\n", get_dtype_name(dtype));
+        }
+        else
+        {
+            writeStringNoNullTerminator("Reducing in ", message_buffer);
+            writeStringNoNullTerminator(get_dtype_name(dtype), message_buffer);
+            writeNulTerminatedString(" arithmetic with partial pivoting.\n", message_buffer);
+        }
+    }
+    double determinant_real, determinant_imag;
+    int rank = reduce_typed_matrix(dtype, augmented_matrix, num_rows, num_cols, num_total_cols, 0, row_permutation, pivot_cols, &determinant_real, &determinant_imag, resolve_num_threads(resolved_options.num_threads));
+    if (outputs)
+    {
+        outputs->elapsed_seconds = get_time_in_seconds() - start_seconds;
+        outputs->pivot_search_seconds = 0.0;
+    }
+    // The rows without a pivot are zero in A, so [A | B] has a higher rank exactly when one of them has a value left in B.
+    // What counts as a value is relative to the rest of B and to the precision of the type, so float32 rounding is not taken for one.
+    int is_single_precision = (dtype == MATRIX_DTYPE_FLOAT32 || dtype == MATRIX_DTYPE_COMPLEX64);
+    int reals_per_row = num_total_cols * ((dtype == MATRIX_DTYPE_COMPLEX64 || dtype == MATRIX_DTYPE_COMPLEX128) ? 2 : 1);
+    int first_augment_real = num_cols * ((dtype == MATRIX_DTYPE_COMPLEX64 || dtype == MATRIX_DTYPE_COMPLEX128) ? 2 : 1);
+    double largest_augment_value = 0.0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        for (int real = first_augment_real; real < reals_per_row; real++)
+        {
+            largest_augment_value = fmax(largest_augment_value, fabs(get_typed_real(augmented_matrix, (int64_t)row * reals_per_row + real, is_single_precision)));
+        }
+    }
+    double augment_tolerance = fmax(MARGIN_OF_ERROR, largest_augment_value * ((num_rows > num_cols) ? num_rows : num_cols) * (is_single_precision ? FLT_EPSILON : DBL_EPSILON));
+    int augmented_rank = rank;
+    for (int row = rank; row < num_rows && augmented_rank == rank; row++)
+    {
+        for (int real = first_augment_real; real < reals_per_row; real++)
+        {
+            if (fabs(get_typed_real(augmented_matrix, (int64_t)row * reals_per_row + real, is_single_precision)) > augment_tolerance)
+            {
+                augmented_rank++;
+                break;
+            }
+        }
+    }
+    metadata->matrix_rank = rank;
+    metadata->matrix_determinant = determinant_real;
+    metadata->matrix_determinant_imag = determinant_imag;
+    if (require_full_rank && (rank != num_rows || rank != num_cols))
+    {
+        if (!message_buffer)
+        {
+            printf("The matrix provided does not have full rank and thus it is not invertible.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("The matrix provided does not have full rank and thus it is not invertible.", message_buffer);
+        }
+        free_pooled(augmented_matrix);
+        free_pooled(row_permutation);
+        free_pooled(pivot_cols);
+        return;
+    }
+    report_matrix_consistency(rank, augmented_rank, metadata, message_buffer);
+    if (!message_buffer)
+    {
+        print_matrix_metadata(metadata);
+    }
+    if (metadata->is_consistent == 1)
+    {
+        log_typed_determinant(metadata, message_buffer);
+    }
+    for (int row = 0; outputs && row < num_rows; row++)
+    {
+        const char *augmented_row = &augmented_matrix[(int64_t)row * num_total_cols * value_size];
+        if (outputs->reduced_matrix)
+        {
+            memcpy((char *)outputs->reduced_matrix + (int64_t)row * num_cols * value_size, augmented_row, (size_t)value_size * num_cols);
+        }
+        if (outputs->solution)
+        {
+            memcpy((char *)outputs->solution + (int64_t)row * num_augment_cols * value_size, &augmented_row[(int64_t)num_cols * value_size], (size_t)value_size * num_augment_cols);
+        }
+        if (outputs->pivot_permutation)
+        {
+            outputs->pivot_permutation[row] = row_permutation[row];
+        }
+    }
+    free_pooled(augmented_matrix);
+    free_pooled(row_permutation);
+    free_pooled(pivot_cols);
+}
+
+/**
+ *  @brief Whether a system only has float64 values, which is what every engine but perform_typed_reduction works on.
+ */
+static inline int is_float64_system(const struct MatrixMetadata *metadata, const struct MatrixMetadata *matrix_augment_metadata)
+{
+    return metadata->dtype == MATRIX_DTYPE_FLOAT64 && (!matrix_augment_metadata || matrix_augment_metadata->dtype == MATRIX_DTYPE_FLOAT64);
+}
+
+/**
+ * @brief The temporaries of a Gauss-Jordan solve, all carved out of one workspace by layout_gauss_jordan_workspace, so a solve makes no heap
+ *        allocations of its own once it has the workspace.
+ * @param augmented_matrix: double[ptr]
+ *      The working copy of [A | B], row after row. NULL when reducing in place.
+ * @param part_copies: double[ptr][2]
+ *      When reducing in place, row-major copies of A and B for those with a column stride other than 1, and NULL for the others.
+ * @param spare_row: double[ptr]
+ *      When reducing in place, room for one row of A or of B, to put the reduced rows in order with.
+ * @param rows: double[ptr][ptr]
+ *      The row pointer table of the matrix part.
+ * @param augment_rows: double[ptr][ptr]
+ *      The row pointer table of the augment part.
+ * @param ordered_rows: double[ptr][ptr]
+ *      Scratch space for order_rows_by_pivot_column.
+ * @param ordered_augment_rows: double[ptr][ptr]
+ *      Scratch space for order_rows_by_pivot_column.
+ * @param row_permutation: int[ptr]
+ *      Which input row each entry of the tables holds.
+ * @param ordered_permutation: int[ptr]
+ *      Scratch space for order_rows_by_pivot_column, and for permute_rows_in_place once the reduction is done.
+ * @param col_permutation: int[ptr]
+ *      The column each step of the elimination pivots on.
+ * @param col_position: int[ptr]
+ *      The inverse of col_permutation.
+ */
+struct GaussJordanWorkspace
+{
+    double *augmented_matrix;
+    double *part_copies[2];
+    double *spare_row;
+    double **rows;
+    double **augment_rows;
+    double **ordered_rows;
+    double **ordered_augment_rows;
+    int *row_permutation;
+    int *ordered_permutation;
+    int *col_permutation;
+    int *col_position;
+};
+
+/**
+ *  @brief Lay out the temporaries of a Gauss-Jordan solve in a workspace, or measure how big that workspace has to be.
+ *
+ *  @param workspace: char[ptr]
+ *      The workspace, or NULL to only measure it.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix to reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of its augment.
+ *  @param is_in_place: int
+ *      1 for python_perform_gauss_jordan_reduction_in_place, which needs no working copy.
+ *  @param parts: struct GaussJordanWorkspace[ptr]
+ *      Receives the temporaries (all NULL if workspace is NULL).
+ *
+ *  @return num_bytes: int64_t
+ *      The size of the workspace.
+ *
+ */
+static int64_t layout_gauss_jordan_workspace(char *workspace, const struct MatrixMetadata *metadata, const struct MatrixMetadata *matrix_augment_metadata, int is_in_place, struct GaussJordanWorkspace *parts)
+{
+    int64_t num_bytes = 0;
+    int num_rows = metadata->num_rows;
+    int num_part_cols[2] = {metadata->num_cols, matrix_augment_metadata->num_cols};
+    const struct MatrixMetadata *part_metadata[2] = {metadata, matrix_augment_metadata};
+    parts->augmented_matrix = is_in_place ? NULL : (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * num_rows * (num_part_cols[0] + num_part_cols[1]));
+    for (int part = 0; part < 2; part++)
+    {
+        int needs_copy = is_in_place && get_col_stride(part_metadata[part]) != 1;
+        parts->part_copies[part] = needs_copy ? (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * num_rows * num_part_cols[part]) : NULL;
+    }
+    parts->spare_row = is_in_place ? (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * ((num_part_cols[0] > num_part_cols[1]) ? num_part_cols[0] : num_part_cols[1])) : NULL;
+    parts->rows = (double **)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double *) * num_rows);
+    parts->augment_rows = (double **)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double *) * num_rows);
+    parts->ordered_rows = (double **)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double *) * num_rows);
+    parts->ordered_augment_rows = (double **)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double *) * num_rows);
+    parts->row_permutation = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * num_rows);
+    parts->ordered_permutation = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * num_rows);
+    parts->col_permutation = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * num_part_cols[0]);
+    parts->col_position = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * num_part_cols[0]);
+    return num_bytes;
+}
+
+/**
+ *  @brief The Gauss-Jordan loop itself, run on an augmented matrix whose matrix and augment parts are held in separate row tables. The rows are
+ *         reduced where they are, so the parts can be copies (python_perform_gauss_jordan_reduction) or the caller's own buffers
+ *         (python_perform_gauss_jordan_reduction_in_place). Row swaps only swap the entries of the tables and row_permutation.
+ *
+ *  @param workspace: struct GaussJordanWorkspace[ptr]
+ *      The temporaries. Its rows and augment_rows must point at the rows of the matrix and the augment, each holding num_matrix_cols
+ *      (or num_augment_cols) consecutive values, and its row_permutation must be the identity. The permutation is reordered along with the tables.
+ *  @param num_rows: int
+ *      The number of rows.
+ *  @param num_matrix_cols: int
+ *      The number of columns of the matrix part.
+ *  @param num_augment_cols: int
+ *      The number of columns of the augment part.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix. The rank (the number of rows of the reduced matrix that are not zero), the consistency and the determinant
+ *      are written to it.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param options: struct SolverOptions[ptr]
+ *      The resolved options.
+ *  @param start_seconds: double
+ *      When the solve started, for outputs->elapsed_seconds.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+static void reduce_gauss_jordan_rows(const struct GaussJordanWorkspace *workspace, int num_rows, int num_matrix_cols, int num_augment_cols, struct MatrixMetadata *metadata, struct String *message_buffer, const struct SolverOptions *options, double start_seconds, struct SolverOutputs *outputs)
+{
+    double pivot_search_seconds = 0.0;
+    int log_steps = options->verbosity >= LOG_VERBOSITY_STEPS;
+    int log_matrices = options->verbosity >= LOG_VERBOSITY_MATRICES;
+    int pivot_strategy = options->pivot_strategy;
+    double **rows = workspace->rows;
+    double **augment_rows = workspace->augment_rows;
+    int *row_permutation = workspace->row_permutation;
+    // The consistency check compares the rank of A as it was passed in, so it is counted before anything is reduced
+    int matrix_row_rank = 0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        if (!row_has_all_zeros(rows[row], 0, num_matrix_cols, 0, 1))
+        {
+            matrix_row_rank++;
+        }
+    }
+
+    // Rook and complete pivoting also swap columns. Like rows, columns are never moved: col_permutation maps each step of the
+    // elimination to the (physical) column it pivots on, and col_position is its inverse.
+    int *col_permutation = workspace->col_permutation;
+    int *col_position = workspace->col_position;
+    for (int col = 0; col < num_matrix_cols; col++)
+    {
+        col_permutation[col] = col;
+        col_position[col] = col;
+    }
+    int num_column_swaps = 0;
+    int num_nonzero_pivots = 0;
+
+    int size_main_diagonal;
+    int swap_rows_flag = 0;
+    if (num_matrix_cols <= num_rows)
+    {
+        size_main_diagonal = num_matrix_cols;
+    }
+    else
+    {
+        size_main_diagonal = num_rows;
+    }
+
+    // Iterate down the main diagonal to begin conversion to echelon form
+    double product_of_diagonal_elements = 1.0;
+    double denominator_value = 1;
+    int swap_multiplier = 1;
+    // Rows that are waiting for the pivot row to be subtracted from them, so it can be subtracted from several at once
+    double *pending_rows[ELIMINATION_BLOCK_ROWS];
+    double *pending_augment_rows[ELIMINATION_BLOCK_ROWS];
+    double pending_scalars[ELIMINATION_BLOCK_ROWS];
+    int num_pending_rows = 0;
+    for (int i = 0; i < size_main_diagonal; i++)
+    {
+        int pivot_col = col_permutation[i];
+        if (pivot_strategy != PIVOT_STRATEGY_NONE)
+        {
+            int pivot_row = i;
+            int swapped = 0;
+            double search_start_seconds = get_time_in_seconds();
+            select_pivot(rows, num_rows, num_matrix_cols, i, col_permutation[i], pivot_strategy, &pivot_row, &pivot_col);
+            pivot_search_seconds += get_time_in_seconds() - search_start_seconds;
+            if (pivot_row != i)
+            {
+                if (log_steps)
+                {
+                    log_row_swap(pivot_row, i, message_buffer);
+                }
+                swap_augmented_rows(rows, augment_rows, row_permutation, pivot_row, i);
+                swap_multiplier *= -1;
+                swapped = 1;
+            }
+            if (pivot_col != col_permutation[i])
+            {
+                if (log_steps)
+                {
+                    log_column_swap(pivot_col, col_permutation[i], message_buffer);
+                }
+                int step_of_pivot_col = col_position[pivot_col];
+                col_permutation[step_of_pivot_col] = col_permutation[i];
+                col_position[col_permutation[i]] = step_of_pivot_col;
+                col_permutation[i] = pivot_col;
+                col_position[pivot_col] = i;
+                num_column_swaps++;
+                swap_multiplier *= -1;
+                swapped = 1;
+            }
+            if (log_steps && swapped)
+            {
+                log_new_pivot_element(rows[i][pivot_col], message_buffer);
+            }
+        }
+        double pivot_element = rows[i][pivot_col];
+        // BUG?: The possibility of a pivot element not having any rows to swap with it is not accounted for here
+        // BUG?: If we need to swap rows, then it might be an issue that I don't check rows above me.
+        if (pivot_element == 0 && pivot_strategy == PIVOT_STRATEGY_NONE)
+        {
+            // See if there is a nonzero element in the same column (below it) and swap the rows.
+            swap_rows_flag = 1;
+        }
+        double value_below_pivot_element;
+        for (int row = (i + 1); row < num_rows; row++)
+        {
+            value_below_pivot_element = rows[row][pivot_col];
+            if (value_below_pivot_element != 0)
+            {
+                if (swap_rows_flag == 1)
+                {
+                    // Swap the rows instead.
+                    if (log_steps)
+                    {
+                        log_row_swap(row, i, message_buffer);
+                    }
+                    swap_augmented_rows(rows, augment_rows, row_permutation, row, i);
+                    swap_rows_flag = 0;
+                    pivot_element = rows[i][pivot_col];
+                    if (log_steps)
+                    {
+                        log_new_pivot_element(pivot_element, message_buffer);
+                    }
+                    swap_multiplier *= -1;
+                }
+                else
+                {
+                    double reciprocal_fraction_scalar;
+                    if (value_below_pivot_element < 0)
+                    {
+                        reciprocal_fraction_scalar = (-1.0) * (value_below_pivot_element / pivot_element);
+                        if (log_steps)
+                        {
+                            if (!message_buffer)
+                            {
+                                printf("[ADD] Row %d = (R%d) + % .6f*(R%d)\n", row, row, reciprocal_fraction_scalar, i);
+                            }
+                            else
+                            {
+                                writeStringNoNullTerminator("[ADD] Row ", message_buffer);
+                                writeNumber(row, message_buffer);
+                                writeStringNoNullTerminator(" = (R", message_buffer);
+                                writeNumber(row, message_buffer);
+                                writeStringNoNullTerminator(") + ", message_buffer);
+                                writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
+                                writeStringNoNullTerminator("*(R", message_buffer);
+                                writeNumber(i, message_buffer);
+                                writeNulTerminatedString(")\n", message_buffer);
+                            }
+                        }
+                        // Adding reciprocal_fraction_scalar times the pivot row is (exactly) subtracting its negation
+                        pending_rows[num_pending_rows] = rows[row];
+                        pending_augment_rows[num_pending_rows] = augment_rows[row];
+                        pending_scalars[num_pending_rows++] = -reciprocal_fraction_scalar;
+                    }
+                    else
+                    {
+                        reciprocal_fraction_scalar = (value_below_pivot_element / pivot_element);
+                        if (log_steps)
+                        {
+                            if (!message_buffer)
+                            {
+                                printf("[SUB] Row %d = (R%d) + % .6f*(R%d)\n", row, row, reciprocal_fraction_scalar, i);
+                            }
+                            else
+                            {
+                                writeStringNoNullTerminator("[SUB] Row ", message_buffer);
+                                writeNumber(row, message_buffer);
+                                writeStringNoNullTerminator(" = (R", message_buffer);
+                                writeNumber(row, message_buffer);
+                                writeStringNoNullTerminator(") - ", message_buffer);
+                                writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
+                                writeStringNoNullTerminator("*(R", message_buffer);
+                                writeNumber(i, message_buffer);
+                                writeNulTerminatedString(")\n", message_buffer);
+                            }
+                        }
+                        pending_rows[num_pending_rows] = rows[row];
+                        pending_augment_rows[num_pending_rows] = augment_rows[row];
+                        pending_scalars[num_pending_rows++] = reciprocal_fraction_scalar;
+                    }
+                }
+            }
+            // Rows only ever wait while nothing is looking at them, so the log reads the same as if each row were updated on its own
+            if (num_pending_rows > 0 && (num_pending_rows == ELIMINATION_BLOCK_ROWS || log_matrices || row == num_rows - 1))
+            {
+                subtract_scaled_row_from_rows(pending_rows, pending_scalars, num_pending_rows, rows[i], num_matrix_cols);
+                subtract_scaled_row_from_rows(pending_augment_rows, pending_scalars, num_pending_rows, augment_rows[i], num_augment_cols);
+                // The partial, rook and complete searches rely on eliminated entries being exactly 0, not a rounding error away from it.
+                // Without a search, the entries are left as computed, so the default step log and reduced matrix do not change.
+                for (int pending_row = 0; pivot_strategy != PIVOT_STRATEGY_NONE && pending_row < num_pending_rows; pending_row++)
+                {
+                    pending_rows[pending_row][pivot_col] = 0.0;
+                }
+                num_pending_rows = 0;
+            }
+            if (log_matrices)
+            {
+                print_augmented_rows(rows, augment_rows, num_rows, num_matrix_cols, num_augment_cols, message_buffer);
+            }
+        }
+        product_of_diagonal_elements *= pivot_element;
+        num_nonzero_pivots += (pivot_element != 0);
+    }
+
+    // Next perform the second half
+    if (log_steps)
+    {
+        if (!message_buffer)
+        {
+            printf("Shifting to Reduced Row Echelon Portion of Algorithm.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("Shifting to Reduced Row Echelon Portion of Algorithm\n", message_buffer);
+        }
+    }
+    /**
+     * Start from the last element in the main diagonal (i.e., pivot element) and try to solve such that
+     * the pivot element is 1 and all elements above it are 0. Transformations that occur in this step don't
+     * affect the determinant so we do not keep track of them.
+     *
+     * NOTE: I don't refer to the variable diagonal_index as the pivot element since it is just an index to the pivot element.
+     */
+    for (int diagonal_index = (size_main_diagonal - 1); diagonal_index > -1; diagonal_index--)
+    {
+        // Try to convert the pivot element to 1
+        int pivot_col = col_permutation[diagonal_index];
+        double pivot_element = rows[diagonal_index][pivot_col];
+        double pivot_reciprocal;
+        if (pivot_element == 0)
+        {
+        }
+        else
+        {
+            if (pivot_element != 1)
+            {
+                pivot_reciprocal = (1.0 / pivot_element);
+                if (log_steps)
+                {
+                    if (!message_buffer)
+                    {
+                        printf("[SCL] Row %d = % .6f*(R%d)\n", (diagonal_index + 1), pivot_reciprocal, (diagonal_index + 1));
+                    }
+                    else
+                    {
+                        writeStringNoNullTerminator("[SCL] Row ", message_buffer);
+                        writeNumber((diagonal_index + 1), message_buffer);
+                        writeStringNoNullTerminator(" = ", message_buffer);
+                        writeDecimalNumber((int64_t)(pivot_reciprocal * 1e9), 9, message_buffer);
+                        writeStringNoNullTerminator(" * (R", message_buffer);
+                        writeNumber((diagonal_index + 1), message_buffer);
+                        writeNulTerminatedString(")\n", message_buffer);
+                    }
+                }
+                multiply_row_by_scalar(rows[diagonal_index], num_matrix_cols, pivot_reciprocal);
+                multiply_row_by_scalar(augment_rows[diagonal_index], num_augment_cols, pivot_reciprocal);
+                if (log_matrices)
+                {
+                    print_augmented_rows(rows, augment_rows, num_rows, num_matrix_cols, num_augment_cols, message_buffer);
+                }
+                pivot_element = rows[diagonal_index][pivot_col];
+            }
+            for (int row = (diagonal_index - 1); row > -1; row--)
+            {
+                double value_above_pivot_element = rows[row][pivot_col];
+                if (value_above_pivot_element != 0)
+                {
+                    double reciprocal_fraction_scalar;
+                    reciprocal_fraction_scalar = (value_above_pivot_element / pivot_element);
+                    if (log_steps)
+                    {
+                        if (!message_buffer)
+                        {
+                            printf("Reciprocal Fraction Scalar: % .6f\n", reciprocal_fraction_scalar);
+                            printf("[SUB] Row %d = (R%d) + % .6f*(R%d)\n", (row + 1), (row + 1), reciprocal_fraction_scalar, (diagonal_index + 1));
+                        }
+                        else
+                        {
+                            writeStringNoNullTerminator("Reciprocal Fraction Scalar: ", message_buffer);
+                            writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
+                            writeStringNoNullTerminator(" / ", message_buffer);
+                            writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
+                            writeStringNoNullTerminator(" = ", message_buffer);
+                            writeDecimalNumber((int64_t)(value_above_pivot_element * 1e9), 9, message_buffer);
+                            writeNulTerminatedString("\n", message_buffer);
+                            writeStringNoNullTerminator("[SUB] Row ", message_buffer);
+                            writeNumber((row + 1), message_buffer);
+                            writeStringNoNullTerminator(" = (R", message_buffer);
+                            writeNumber((row + 1), message_buffer);
+                            writeStringNoNullTerminator(") - ", message_buffer);
+                            writeDecimalNumber((int64_t)(reciprocal_fraction_scalar * 1e9), 9, message_buffer);
+                            writeStringNoNullTerminator("*(R", message_buffer);
+                            writeNumber((diagonal_index + 1), message_buffer);
+                            writeNulTerminatedString(")\n", message_buffer);
+                        }
+                    }
+                    pending_rows[num_pending_rows] = rows[row];
+                    pending_augment_rows[num_pending_rows] = augment_rows[row];
+                    pending_scalars[num_pending_rows++] = reciprocal_fraction_scalar;
+                }
+                if (num_pending_rows > 0 && (num_pending_rows == ELIMINATION_BLOCK_ROWS || log_matrices || row == 0))
+                {
+                    subtract_scaled_row_from_rows(pending_rows, pending_scalars, num_pending_rows, rows[diagonal_index], num_matrix_cols);
+                    subtract_scaled_row_from_rows(pending_augment_rows, pending_scalars, num_pending_rows, augment_rows[diagonal_index], num_augment_cols);
+                    num_pending_rows = 0;
+                }
+                if (log_matrices)
+                {
+                    print_augmented_rows(rows, augment_rows, num_rows, num_matrix_cols, num_augment_cols, message_buffer);
+                }
+            }
+        }
+    }
+
+    if (num_column_swaps > 0)
+    {
+        if (log_steps)
+        {
+            if (!message_buffer)
+            {
+                printf("Ordering Rows by Pivot Column.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("Ordering Rows by Pivot Column\n", message_buffer);
+            }
+        }
+        order_rows_by_pivot_column(rows, augment_rows, row_permutation, col_position, size_main_diagonal, num_matrix_cols, workspace->ordered_rows, workspace->ordered_augment_rows, workspace->ordered_permutation);
+        if (log_matrices)
+        {
+            print_augmented_rows(rows, augment_rows, num_rows, num_matrix_cols, num_augment_cols, message_buffer);
+        }
+    }
+    // Rook and complete pivoting choose pivot columns by size. With a pivot in every column, the rows are in reduced row echelon form once
+    // they are in column order; with fewer, the pivots may not lead their rows, so the rows are reduced once more in column order.
+    if ((pivot_strategy == PIVOT_STRATEGY_ROOK || pivot_strategy == PIVOT_STRATEGY_COMPLETE) && num_nonzero_pivots < num_matrix_cols)
+    {
+        if (log_steps)
+        {
+            if (!message_buffer)
+            {
+                printf("Moving Pivots to Leading Columns.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("Moving Pivots to Leading Columns\n", message_buffer);
+            }
+        }
+        move_pivots_to_leading_columns(rows, augment_rows, row_permutation, num_rows, num_matrix_cols, num_augment_cols);
+        if (log_matrices)
+        {
+            print_augmented_rows(rows, augment_rows, num_rows, num_matrix_cols, num_augment_cols, message_buffer);
+        }
+    }
+    double elapsed_seconds = get_time_in_seconds() - start_seconds;
+
+    /**
+     * Having finished performing the Gauss-Jordan algorithm, this section covers the metadata of the data structure.
+     * This includes finding out whether the matrix is consistent and the matrix determinant.
+     */
+    int augmented_matrix_row_rank = 0;
+    metadata->matrix_rank = 0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        int is_zero_matrix_row = row_has_all_zeros(rows[row], 0, num_matrix_cols, 0, 1);
+        metadata->matrix_rank += !is_zero_matrix_row;
+        if (!is_zero_matrix_row || !row_has_all_zeros(augment_rows[row], 0, num_augment_cols, 0, 1))
+        {
+            augmented_matrix_row_rank++;
+        }
+    }
+    report_matrix_consistency(matrix_row_rank, augmented_matrix_row_rank, metadata, message_buffer);
+    if (!message_buffer)
+    {
+        print_matrix_metadata(metadata);
+    }
+    report_determinant(metadata, product_of_diagonal_elements, denominator_value, swap_multiplier, log_steps, message_buffer);
+    struct MatrixMetadata augmented_matrix_metadata = {num_rows, num_matrix_cols + num_augment_cols, 0, 0, 0.0, 0, 0, MATRIX_LAYOUT_ROW_MAJOR, MATRIX_DTYPE_FLOAT64, 0.0};
+    copy_solver_outputs(rows, augment_rows, row_permutation, &augmented_matrix_metadata, num_matrix_cols, outputs);
+    if (outputs)
+    {
+        outputs->elapsed_seconds = elapsed_seconds;
+        outputs->pivot_search_seconds = pivot_search_seconds;
+    }
+}
+
+/**
+ *  @brief Gauss-Jordan reduction of a float64 system in a working copy, with every temporary taken from a workspace laid out by
+ *         layout_gauss_jordan_workspace (with is_in_place 0). The parameters are those of python_perform_gauss_jordan_reduction.
+ *
+ *  @return None
+ *
+ */
+static void perform_gauss_jordan_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, const struct GaussJordanWorkspace *workspace)
+{
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int num_rows = metadata->num_rows;
+    int num_matrix_cols = metadata->num_cols;
+    int num_augment_cols = matrix_augment_metadata->num_cols;
+
+    // The inputs are not modified, so the reduction works on a copy of them (python_perform_gauss_jordan_reduction_in_place does not)
+    struct StackedMatrix augmented_view = hstack_view(matrix_to_reduce, matrix_augment, metadata, matrix_augment_metadata);
+    double *augmented_matrix = workspace->augmented_matrix;
+    if (augmented_view.num_rows > 0)
+    {
+        gather_stacked_matrix(&augmented_view, augmented_matrix, augmented_view.num_cols);
+    }
+    // The elimination works through tables of row pointers, so swapping rows never moves their values.
+    // The permutation keeps track of which input row ends up where, so it can be reported through the outputs.
+    for (int row = 0; row < num_rows; row++)
+    {
+        workspace->rows[row] = &augmented_matrix[(int64_t)row * (num_matrix_cols + num_augment_cols)];
+        workspace->augment_rows[row] = &workspace->rows[row][num_matrix_cols];
+        workspace->row_permutation[row] = row;
+    }
+    reduce_gauss_jordan_rows(workspace, num_rows, num_matrix_cols, num_augment_cols, metadata, message_buffer, &resolved_options, start_seconds, outputs);
+}
+
+/**
+ *  @brief Attempt row reduction using the Gauss-Jordan algorithm. Matrices with a dtype other than float64 are reduced by perform_typed_reduction.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix to reduce into reduced row echelon form. Note that the matrix is assumed to be in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment portion of the matrix (i.e., the b portion of Ax = b). Used in row reduction to solve for x.
+ *  @param message_buffer: struct String[ptr]
+ *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_to_reduce data structure. Should contain the dimensions of the matrix.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_augment data structure. Should contain the dimensions of the matrix.
+ *  @param options: struct SolverOptions[ptr]
+ *      Options such as the verbosity of the step log. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the reduced matrix, the solution and the pivot permutation into. If NULL, the results are only written to the log.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_gauss_jordan_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    // Other types are reduced in their own arithmetic
+    if (!is_float64_system(metadata, matrix_augment_metadata))
+    {
+        perform_typed_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, 0);
+        return;
+    }
+    // All of the temporaries come from one block of the thread's workspace pool
+    struct GaussJordanWorkspace parts;
+    char *workspace = (char *)allocate_pooled(layout_gauss_jordan_workspace(NULL, metadata, matrix_augment_metadata, 0, &parts));
+    if (!workspace)
+    {
+        return;
+    }
+    layout_gauss_jordan_workspace(workspace, metadata, matrix_augment_metadata, 0, &parts);
+    perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, &parts);
+    free_pooled(workspace);
+}
+
+/**
+ *  @brief How big a workspace python_perform_gauss_jordan_reduction_with_workspace needs for a system.
+ *
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix to reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of its augment.
+ *
+ *  @return num_bytes: int64_t
+ *      The size of the workspace, or -1 if the system is not float64 (other types cannot be reduced in a workspace).
+ *
+ */
+EXPORT int64_t python_get_gauss_jordan_workspace_size(struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata)
+{
+    struct GaussJordanWorkspace parts;
+    return is_float64_system(metadata, matrix_augment_metadata) ? layout_gauss_jordan_workspace(NULL, metadata, matrix_augment_metadata, 0, &parts) : -1;
+}
+
+/**
+ *  @brief python_perform_gauss_jordan_reduction, with every temporary taken from a workspace the caller provides. Apart from the step log (whose
+ *         buffer may grow), the solve makes no heap allocations, so a caller that solves many systems of one size can allocate the workspace once.
+ *
+ *  @param workspace: void[ptr]
+ *      At least python_get_gauss_jordan_workspace_size bytes, aligned for a double (MATRIX_ALIGNMENT bytes is best). Its contents do not matter.
+ *  @param workspace_size: int64_t
+ *      The size of workspace, in bytes.
+ *
+ *  The other parameters are those of python_perform_gauss_jordan_reduction.
+ *
+ *  @return is_reduced: int
+ *      1 if the system was reduced, 0 if it is not float64 or the workspace is too small, in which case nothing is done.
+ *
+ */
+EXPORT int python_perform_gauss_jordan_reduction_with_workspace(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, void *workspace, int64_t workspace_size)
+{
+    int64_t num_workspace_bytes = python_get_gauss_jordan_workspace_size(metadata, matrix_augment_metadata);
+    if (num_workspace_bytes < 0 || !workspace || workspace_size < num_workspace_bytes)
+    {
+        return 0;
+    }
+    struct GaussJordanWorkspace parts;
+    layout_gauss_jordan_workspace((char *)workspace, metadata, matrix_augment_metadata, 0, &parts);
+    perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, &parts);
+    return 1;
+}
+
+/**
+ *  @brief Free the temporaries the calling thread keeps between solves (see WorkspacePool.c). The solvers that do not take a workspace reuse
+ *         them instead of allocating, and a thread's are freed anyway when it exits, so this is only needed to give the memory back sooner.
+ *
+ *  @return num_bytes: int64_t
+ *      How many bytes were freed.
+ *
+ */
+EXPORT int64_t python_trim_workspace_pool(void)
+{
+    return trim_workspace_pool();
+}
+
+/**
+ * @brief Where the library places the memory and threads of large solves, for machines with more than one NUMA node. Set with
+ *        python_set_memory_placement.
+ * @param huge_page_min_bytes: int64_t
+ *      Solver temporaries of at least this many bytes are mapped in huge pages, which cuts the TLB misses of sweeping over a large matrix.
+ *      0 or less maps none. The default is 32 MiB.
+ * @param is_first_touch_enabled: int
+ *      1 (the default) to have the thread pool write a new huge page temporary first, a band of pages per thread, so its pages are spread
+ *      over the nodes the threads run on. 0 leaves all of them on the node of the thread that allocated it.
+ * @param is_pinned_to_numa_nodes: int
+ *      1 to pin each worker thread to the processors of one NUMA node, splitting the workers evenly between the nodes, so a worker keeps using
+ *      the memory local to it. 0 (the default) lets the operating system move them.
+ */
+struct MemoryPlacementOptions
+{
+    int64_t huge_page_min_bytes;
+    int is_first_touch_enabled;
+    int is_pinned_to_numa_nodes;
+};
+
+/**
+ *  @brief Change where the memory and threads of large solves are placed. It applies to the temporaries allocated after it, and pins (or
+ *         unpins) the worker threads once any parallel work that is running has finished. Safe to call from any thread.
+ *
+ *  @param options: struct MemoryPlacementOptions[ptr]
+ *      The new placement.
+ *
+ *  @return num_nodes: int
+ *      The number of NUMA nodes the worker threads are pinned across, or 0 if they are not pinned.
+ *
+ */
+EXPORT int python_set_memory_placement(struct MemoryPlacementOptions *options)
+{
+    set_workspace_placement(options->huge_page_min_bytes, options->is_first_touch_enabled);
+    return pin_thread_pool_workers(options->is_pinned_to_numa_nodes);
+}
+
+/**
+ *  @brief Get where the memory and threads of large solves are placed.
+ *
+ *  @param options: struct MemoryPlacementOptions[ptr]
+ *      Receives the current placement.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_get_memory_placement(struct MemoryPlacementOptions *options)
+{
+    get_workspace_placement(&options->huge_page_min_bytes, &options->is_first_touch_enabled);
+    options->is_pinned_to_numa_nodes = get_thread_pool_pinned_node_count() > 0;
+}
+
+/**
+ *  @brief Move the rows of a matrix so that row i holds what row row_permutation[i] held, following each cycle of the permutation with one spare row.
+ *
+ *  @param matrix: double[ptr]
+ *      The matrix, as rows of consecutive values.
+ *  @param leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ *  @param num_rows: int
+ *      The number of rows of matrix, and of row_permutation.
+ *  @param num_cols: int
+ *      The number of columns of matrix.
+ *  @param row_permutation: int[ptr]
+ *      The permutation to apply.
+ *  @param is_placed: int[ptr]
+ *      Scratch space for num_rows flags.
+ *  @param spare_row: double[ptr]
+ *      Scratch space for one row.
+ *
+ *  @return None
+ *
+ */
+static void permute_rows_in_place(double *matrix, int leading_dimension, int num_rows, int num_cols, const int *row_permutation, int *is_placed, double *spare_row)
+{
+    if (num_cols < 1)
+    {
+        return;
+    }
+    memset(is_placed, 0, sizeof(int) * num_rows);
+    for (int first_row = 0; first_row < num_rows; first_row++)
+    {
+        if (is_placed[first_row] || row_permutation[first_row] == first_row)
+        {
+            continue;
+        }
+        memcpy(spare_row, &matrix[(int64_t)first_row * leading_dimension], sizeof(double) * num_cols);
+        int destination_row = first_row;
+        int source_row = row_permutation[first_row];
+        while (source_row != first_row)
+        {
+            memcpy(&matrix[(int64_t)destination_row * leading_dimension], &matrix[(int64_t)source_row * leading_dimension], sizeof(double) * num_cols);
+            is_placed[destination_row] = 1;
+            destination_row = source_row;
+            source_row = row_permutation[source_row];
+        }
+        memcpy(&matrix[(int64_t)destination_row * leading_dimension], spare_row, sizeof(double) * num_cols);
+        is_placed[destination_row] = 1;
+    }
+}
+
+/**
+ *  @brief Whether python_perform_gauss_jordan_reduction_in_place can reduce a system: both parts must be float64, not packed, and have the same number of rows.
+ */
+static inline int is_in_place_system(const struct MatrixMetadata *metadata, const struct MatrixMetadata *matrix_augment_metadata)
+{
+    return is_float64_system(metadata, matrix_augment_metadata) && matrix_augment_metadata->num_rows == metadata->num_rows && !is_packed_layout(metadata) && !is_packed_layout(matrix_augment_metadata);
+}
+
+/**
+ *  @brief Gauss-Jordan reduction of the caller's matrix and augment where they are, with every temporary taken from a workspace laid out by
+ *         layout_gauss_jordan_workspace (with is_in_place 1). The parameters are those of python_perform_gauss_jordan_reduction_in_place, and
+ *         the system must pass is_in_place_system.
+ *
+ *  @return None
+ *
+ */
+static void perform_in_place_gauss_jordan_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, const struct GaussJordanWorkspace *workspace)
+{
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    struct StackedMatrix augmented_view = hstack_view(matrix_to_reduce, matrix_augment, metadata, matrix_augment_metadata);
+    int num_rows = metadata->num_rows;
+    int num_part_cols[2] = {metadata->num_cols, matrix_augment_metadata->num_cols};
+
+    // A row stride is only a leading dimension, so the row tables point straight into the caller's buffers
+    double *row_major_parts[2];
+    int leading_dimensions[2];
+    for (int part = 0; part < 2; part++)
+    {
+        row_major_parts[part] = augmented_view.parts[part];
+        leading_dimensions[part] = get_row_stride(&augmented_view.part_metadata[part]);
+        if (workspace->part_copies[part])
+        {
+            row_major_parts[part] = workspace->part_copies[part];
+            leading_dimensions[part] = num_part_cols[part];
+            gather_strided_matrix(augmented_view.parts[part], &augmented_view.part_metadata[part], row_major_parts[part], leading_dimensions[part]);
+        }
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        workspace->rows[row] = &row_major_parts[0][(int64_t)row * leading_dimensions[0]];
+        workspace->augment_rows[row] = &row_major_parts[1][(int64_t)row * leading_dimensions[1]];
+        workspace->row_permutation[row] = row;
+    }
+    reduce_gauss_jordan_rows(workspace, num_rows, num_part_cols[0], num_part_cols[1], metadata, message_buffer, &resolved_options, start_seconds, outputs);
+    // The tables only say where each reduced row is; the rows themselves are put in order once, at the end
+    for (int part = 0; part < 2; part++)
+    {
+        permute_rows_in_place(row_major_parts[part], leading_dimensions[part], num_rows, num_part_cols[part], workspace->row_permutation, workspace->ordered_permutation, workspace->spare_row);
+        if (workspace->part_copies[part])
+        {
+            scatter_strided_matrix(row_major_parts[part], leading_dimensions[part], augmented_view.parts[part], &augmented_view.part_metadata[part]);
+        }
+    }
+}
+
+/**
+ *  @brief Write the step log line for a system python_perform_gauss_jordan_reduction_in_place cannot reduce.
+ */
+static inline void log_in_place_system_rejected(struct String *message_buffer)
+{
+    if (!message_buffer)
+    {
+        printf("The matrix and its augment must have the same number of rows, be float64 and not be packed to be reduced in place.\n");
+    }
+    else
+    {
+        writeNulTerminatedString("The matrix and its augment must have the same number of rows, be float64 and not be packed to be reduced in place.\n", message_buffer);
+    }
+}
+
+/**
+ *  @brief Gauss-Jordan reduction that reduces the caller's matrix and augment where they are, instead of in a combined copy of both. The two are
+ *         read through an hstack_view, and each row operation is applied to a row of the matrix and the same row of the augment, so the extra
+ *         memory is a few tables of num_rows entries however wide the augment is. The step log, the summary and the outputs are those of
+ *         python_perform_gauss_jordan_reduction. A matrix or augment with a column stride other than 1 (e.g., column-major) is reduced in a
+ *         row-major copy that is written back at the end.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B. Replaced by its reduced row echelon form.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B. Replaced by the reduced augment, i.e., the solution when A is square and not singular. Must not overlap A.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce. Must be float64 and not packed.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment. Must have as many rows as matrix_to_reduce, be float64 and not be packed, or nothing is reduced.
+ *  @param options: struct SolverOptions[ptr]
+ *      Options such as the verbosity of the step log. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into, as for python_perform_gauss_jordan_reduction. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_gauss_jordan_reduction_in_place(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    if (!is_in_place_system(metadata, matrix_augment_metadata))
+    {
+        log_in_place_system_rejected(message_buffer);
+        return;
+    }
+    struct GaussJordanWorkspace parts;
+    char *workspace = (char *)allocate_pooled(layout_gauss_jordan_workspace(NULL, metadata, matrix_augment_metadata, 1, &parts));
+    if (!workspace)
+    {
+        return;
+    }
+    layout_gauss_jordan_workspace(workspace, metadata, matrix_augment_metadata, 1, &parts);
+    perform_in_place_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, &parts);
+    free_pooled(workspace);
+}
+
+/**
+ *  @brief How big a workspace python_perform_gauss_jordan_reduction_in_place_with_workspace needs for a system. It only holds tables of
+ *         num_rows entries, unless A or B has a column stride other than 1 and has to be copied.
+ *
+ *  @return num_bytes: int64_t
+ *      The size of the workspace, or -1 if the system cannot be reduced in place.
+ *
+ */
+EXPORT int64_t python_get_gauss_jordan_in_place_workspace_size(struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata)
+{
+    struct GaussJordanWorkspace parts;
+    return is_in_place_system(metadata, matrix_augment_metadata) ? layout_gauss_jordan_workspace(NULL, metadata, matrix_augment_metadata, 1, &parts) : -1;
+}
+
+/**
+ *  @brief python_perform_gauss_jordan_reduction_in_place, with every temporary taken from a workspace the caller provides, so the solve makes no
+ *         heap allocations apart from the step log's.
+ *
+ *  @param workspace: void[ptr]
+ *      At least python_get_gauss_jordan_in_place_workspace_size bytes, aligned for a double. Its contents do not matter.
+ *  @param workspace_size: int64_t
+ *      The size of workspace, in bytes.
+ *
+ *  The other parameters are those of python_perform_gauss_jordan_reduction_in_place.
+ *
+ *  @return is_reduced: int
+ *      1 if the system was reduced, 0 if it cannot be reduced in place or the workspace is too small, in which case nothing is done.
+ *
+ */
+EXPORT int python_perform_gauss_jordan_reduction_in_place_with_workspace(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, void *workspace, int64_t workspace_size)
+{
+    int64_t num_workspace_bytes = python_get_gauss_jordan_in_place_workspace_size(metadata, matrix_augment_metadata);
+    if (num_workspace_bytes < 0 || !workspace || workspace_size < num_workspace_bytes)
+    {
+        return 0;
+    }
+    struct GaussJordanWorkspace parts;
+    layout_gauss_jordan_workspace((char *)workspace, metadata, matrix_augment_metadata, 1, &parts);
+    perform_in_place_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, &parts);
+    return 1;
+}
+
+/**
+ *  @brief Solve a square system with an LU factorization instead of the Gauss-Jordan loop. The step log and the outputs follow the same contract as
+ *         python_perform_gauss_jordan_reduction: the reduced matrix is the identity, the solution is in the augment, and the summary is identical.
+ *         Systems the factorization cannot finish (non-square or singular matrices) are handed to python_perform_gauss_jordan_reduction instead, as
+ *         only the Gauss-Jordan loop describes their rank and consistency. So are systems whose buffers cannot be allocated.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *  @param factor: int (*)(double *, int, int, int, int *, int)
+ *      The factorization to use. It has the signature of factor_lu_calu.
+ *  @param factorization_name: char[ptr]
+ *      How the factorization is described in the step log.
+ *
+ *  @return None
+ *
+ */
+static void perform_lu_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, int (*factor)(double *, int, int, int, int *, int), const char *factorization_name)
+{
+    // The LU engines are float64 only; other types go to the type-generic Gauss-Jordan engine
+    if (!is_float64_system(metadata, matrix_augment_metadata))
+    {
+        perform_typed_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, 0);
+        return;
+    }
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int log_steps = resolved_options.verbosity >= LOG_VERBOSITY_STEPS;
+    int log_matrices = resolved_options.verbosity >= LOG_VERBOSITY_MATRICES;
+    if (metadata->num_rows != metadata->num_cols || matrix_augment_metadata->num_rows != metadata->num_rows || matrix_augment_metadata->num_cols < 1)
+    {
+        python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+
+    int size = metadata->num_rows;
+    struct MatrixMetadata augmented_matrix_metadata;
+    double *augmented_matrix = (double *)allocate_pooled(sizeof(double) * ((int64_t)size * (size + matrix_augment_metadata->num_cols)));
+    int *pivots = (int *)allocate_pooled(sizeof(int) * size);
+    double **rows = (double **)allocate_pooled(sizeof(double *) * size);
+    int *row_permutation = (int *)allocate_pooled(sizeof(int) * size);
+    if (!augmented_matrix || !pivots || !rows || !row_permutation)
+    {
+        free_pooled(row_permutation);
+        free_pooled(rows);
+        free_pooled(pivots);
+        free_pooled(augmented_matrix);
+        python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+    hstack(matrix_to_reduce, matrix_augment, augmented_matrix, metadata, matrix_augment_metadata, &augmented_matrix_metadata);
+    int num_cols = augmented_matrix_metadata.num_cols;
+    double largest_value = 0.0;
+    for (int row = 0; row < size; row++)
+    {
+        double row_largest_value;
+        find_max_abs_index(&augmented_matrix[(int64_t)row * num_cols], size, &row_largest_value);
+        largest_value = fmax(largest_value, row_largest_value);
+    }
+    int is_factored = factor(augmented_matrix, num_cols, size, num_cols, pivots, resolve_num_threads(resolved_options.num_threads));
+    // A pivot that is only rounding error away from 0 (by the tolerance of TypedElimination.c) leaves A just as singular as a 0 does. The
+    // identity this engine reports would then claim a full rank, so the Gauss-Jordan engine works out the rank A really has.
+    double zero_tolerance = largest_value * size * DBL_EPSILON;
+    for (int row = 0; row < size && is_factored; row++)
+    {
+        is_factored = fabs(augmented_matrix[(int64_t)row * num_cols + row]) > zero_tolerance;
+    }
+    if (!is_factored)
+    {
+        free_pooled(row_permutation);
+        free_pooled(rows);
+        free_pooled(pivots);
+        free_pooled(augmented_matrix);
+        python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+
+    for (int row = 0; row < size; row++)
+    {
+        rows[row] = &augmented_matrix[(int64_t)row * num_cols];
+        row_permutation[row] = row;
+    }
+    int swap_multiplier = 1;
+    double product_of_diagonal_elements = 1.0;
+    if (log_steps)
+    {
+        if (!message_buffer)
+        {
+            printf("Factoring P*A = L*U using %s.\n", factorization_name);
+        }
+        else
+        {
+            writeStringNoNullTerminator("Factoring P*A = L*U using ", message_buffer);
+            writeNulTerminatedString(factorization_name, message_buffer);
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+    for (int row = 0; row < size; row++)
+    {
+        if (pivots[row] != row)
+        {
+            if (log_steps)
+            {
+                log_row_swap(pivots[row], row, message_buffer);
+            }
+            int temp = row_permutation[row];
+            row_permutation[row] = row_permutation[pivots[row]];
+            row_permutation[pivots[row]] = temp;
+            swap_multiplier *= -1;
+        }
+        product_of_diagonal_elements *= rows[row][row];
+    }
+    if (log_matrices)
+    {
+        print_augmented_matrix(rows, size, num_cols, matrix_augment_metadata->num_cols, message_buffer);
+    }
+
+    if (log_steps)
+    {
+        if (!message_buffer)
+        {
+            printf("Solving U*X = inverse(L)*P*B by Back Substitution.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("Solving U*X = inverse(L)*P*B by Back Substitution\n", message_buffer);
+        }
+    }
+    solve_upper_triangular_in_place(augmented_matrix, num_cols, size, matrix_augment_metadata->num_cols, resolve_num_threads(resolved_options.num_threads));
+    // What is left of the matrix is its reduced row echelon form, the identity
+    for (int row = 0; row < size; row++)
+    {
+        memset(rows[row], 0, sizeof(double) * size);
+        rows[row][row] = 1.0;
+    }
+    if (log_matrices)
+    {
+        print_augmented_matrix(rows, size, num_cols, matrix_augment_metadata->num_cols, message_buffer);
+    }
+    double elapsed_seconds = get_time_in_seconds() - start_seconds;
+
+    report_reduction_results(matrix_to_reduce, augmented_matrix, rows, row_permutation, metadata, &augmented_matrix_metadata, product_of_diagonal_elements, 1.0, swap_multiplier, log_steps, message_buffer, outputs);
+    if (outputs)
+    {
+        outputs->elapsed_seconds = elapsed_seconds;
+        outputs->pivot_search_seconds = 0.0;
+    }
+    free_pooled(row_permutation);
+    free_pooled(rows);
+    free_pooled(pivots);
+    free_pooled(augmented_matrix);
+}
+
+/**
+ *  @brief Solve a square system with CALU, a blocked LU factorization that picks each panel's pivot rows with a tournament across threads
+ *         (see factor_lu_calu). Has the same parameters, step log contract and outputs as python_perform_gauss_jordan_reduction, to which it hands
+ *         non-square and singular systems.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_calu_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    perform_lu_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, factor_lu_calu, "Tournament Pivoting (CALU)");
+}
+
+/**
+ *  @brief Solve a square system with a tiled LU factorization whose panels, triangular solves and trailing updates run as a task graph on a
+ *         work-stealing scheduler (see factor_lu_tiled). Has the same parameters, step log contract and outputs as python_perform_gauss_jordan_reduction,
+ *         to which it hands non-square and singular systems.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_tiled_lu_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    perform_lu_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, factor_lu_tiled, "Tiled Partial Pivoting (Task Graph)");
+}
+
+/**
+ *  @brief Solve a square system with a cache-oblivious recursive LU factorization (see factor_lu_recursive). Has the same parameters, step log
+ *         contract and outputs as python_perform_gauss_jordan_reduction, so the two can be benchmarked head to head, and hands it non-square and
+ *         singular systems.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_recursive_lu_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    perform_lu_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, factor_lu_recursive, "Recursive Partial Pivoting (Cache-Oblivious)");
+}
+
+// A fast structured solve is only kept when its residual is at most this, relative to the sizes of A, X and B (see solution_has_small_residual)
+#define STRUCTURED_SOLVE_MAX_RELATIVE_RESIDUAL 1e-10
+
+/**
+ *  @brief Check a solution X of A * X = B by its residual, for solvers without pivoting that can lose accuracy without breaking down.
+ *
+ *  @param matrix: double[ptr]
+ *      The square matrix A, in a 1-D format.
+ *  @param matrix_leading_dimension: int
+ *      The distance between the starts of two rows of matrix.
+ *  @param size: int
+ *      The number of rows (and columns) of A.
+ *  @param augment: double[ptr]
+ *      The right-hand sides B, in a 1-D format.
+ *  @param augment_metadata: struct MatrixMetadata[ptr]
+ *      The dimensions and strides of augment.
+ *  @param solution: double[ptr]
+ *      The solution X.
+ *  @param solution_leading_dimension: int
+ *      The distance between the starts of two rows of solution.
+ *  @param num_threads: int
+ *      The most threads to use for A * X.
+ *
+ *  @return is_accurate: int
+ *      1 if the largest value of B - A * X is at most STRUCTURED_SOLVE_MAX_RELATIVE_RESIDUAL * (|A| * |X| + |B|) in the infinity norm, 0 otherwise.
+ */
+static int solution_has_small_residual(const double *matrix, int matrix_leading_dimension, int size, const double *augment, const struct MatrixMetadata *augment_metadata, const double *solution, int solution_leading_dimension, int num_threads)
+{
+    int num_rhs = augment_metadata->num_cols;
+    double *residual = (double *)malloc(sizeof(double) * size * num_rhs);
+    if (!residual)
+    {
+        return 0;
+    }
+    gather_strided_matrix(augment, augment_metadata, residual, num_rhs);
+    double augment_norm = 0.0;
+    for (int64_t index = 0; index < (int64_t)size * num_rhs; index++)
+    {
+        augment_norm = fmax(augment_norm, fabs(residual[index]));
+    }
+    multiply_matrices_blocked(size, num_rhs, size, -1.0, matrix, matrix_leading_dimension, solution, solution_leading_dimension, 1.0, residual, num_rhs, num_threads);
+    double matrix_norm = 0.0;
+    double solution_norm = 0.0;
+    double residual_norm = 0.0;
+    for (int row = 0; row < size; row++)
+    {
+        double row_sum = 0.0;
+        for (int col = 0; col < size; col++)
+        {
+            row_sum += fabs(matrix[(int64_t)row * matrix_leading_dimension + col]);
+        }
+        matrix_norm = (row_sum > matrix_norm) ? row_sum : matrix_norm;
+        for (int col = 0; col < num_rhs; col++)
+        {
+            solution_norm = fmax(solution_norm, fabs(solution[row * solution_leading_dimension + col]));
+            residual_norm = fmax(residual_norm, fabs(residual[row * num_rhs + col]));
+        }
+    }
+    free(residual);
+    // fmax drops NaNs, so a solution that overflowed has to be caught separately
+    return isfinite(solution_norm) && residual_norm <= STRUCTURED_SOLVE_MAX_RELATIVE_RESIDUAL * (matrix_norm * solution_norm + augment_norm);
+}
+
+/**
+ *  @brief The end the Toeplitz and packed engines share, once they have solved A*X = B into the augment of augmented_matrix. A solve that worked
+ *         is reported as perform_lu_reduction reports one: the reduced matrix is the identity, the solution is in the augment and no rows are
+ *         swapped. A solve that broke down (or a row table that could not be allocated) goes to the recursive LU engine instead. Frees
+ *         augmented_matrix.
+ *
+ *  @param solved: int
+ *      1 if the solution in augmented_matrix can be reported, 0 if the system has to be solved by the recursive LU engine.
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, as it was passed in.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, as it was passed in.
+ *  @param augmented_matrix: double[ptr]
+ *      The augmented matrix holding the solution. May be NULL if it could not be allocated (solved is 0 then).
+ *  @param augmented_matrix_metadata: struct MatrixMetadata[ptr]
+ *      The dimensions of augmented_matrix.
+ *  @param determinant: double
+ *      The determinant of A, found by the solve.
+ *  @param solver_name: char[ptr]
+ *      How the solver is described in the step log.
+ *  @param start_seconds: double
+ *      When the engine started, from get_time_in_seconds.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The options the engine was called with. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+static void finish_direct_solve(int solved, double *matrix_to_reduce, double *matrix_augment, double *augmented_matrix, struct MatrixMetadata *augmented_matrix_metadata, double determinant, const char *solver_name, double start_seconds, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int log_steps = resolved_options.verbosity >= LOG_VERBOSITY_STEPS;
+    int log_matrices = resolved_options.verbosity >= LOG_VERBOSITY_MATRICES;
+    int size = metadata->num_rows;
+    double **rows = solved ? (double **)malloc(sizeof(double *) * size) : NULL;
+    int *row_permutation = solved ? (int *)malloc(sizeof(int) * size) : NULL;
+    if (!rows || !row_permutation)
+    {
+        free(row_permutation);
+        free(rows);
+        free(augmented_matrix);
+        if (log_steps)
+        {
+            if (!message_buffer)
+            {
+                printf("%s Broke Down. Falling Back to Recursive Partial Pivoting.\n", solver_name);
+            }
+            else
+            {
+                writeStringNoNullTerminator(solver_name, message_buffer);
+                writeNulTerminatedString(" Broke Down. Falling Back to Recursive Partial Pivoting\n", message_buffer);
+            }
+        }
+        perform_lu_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, factor_lu_recursive, "Recursive Partial Pivoting (Cache-Oblivious)");
+        return;
+    }
+
+    if (log_steps)
+    {
+        if (!message_buffer)
+        {
+            printf("Solving A*X = B using %s.\n", solver_name);
+        }
+        else
+        {
+            writeStringNoNullTerminator("Solving A*X = B using ", message_buffer);
+            writeNulTerminatedString(solver_name, message_buffer);
+            writeNulTerminatedString("\n", message_buffer);
+        }
+    }
+    // What is left of the matrix is its reduced row echelon form, the identity
+    for (int row = 0; row < size; row++)
+    {
+        rows[row] = &augmented_matrix[(int64_t)row * augmented_matrix_metadata->num_cols];
+        row_permutation[row] = row;
+        memset(rows[row], 0, sizeof(double) * size);
+        rows[row][row] = 1.0;
+    }
+    if (log_matrices)
+    {
+        print_augmented_matrix(rows, size, augmented_matrix_metadata->num_cols, matrix_augment_metadata->num_cols, message_buffer);
+    }
+    double elapsed_seconds = get_time_in_seconds() - start_seconds;
+
+    report_reduction_results(matrix_to_reduce, augmented_matrix, rows, row_permutation, metadata, augmented_matrix_metadata, determinant, 1.0, 1, log_steps, message_buffer, outputs);
+    if (outputs)
+    {
+        outputs->elapsed_seconds = elapsed_seconds;
+        outputs->pivot_search_seconds = 0.0;
+    }
+    free(row_permutation);
+    free(rows);
+    free(augmented_matrix);
+}
+
+/**
+ *  @brief Solve a Toeplitz system with the Levinson recursion, or a circulant one by diagonalizing it with the FFT (see ToeplitzSolvers.c), instead of
+ *         eliminating it. The step log and the outputs follow the same contract as perform_lu_reduction: the reduced matrix is the identity, the solution
+ *         is in the augment, no rows are swapped, and the summary is identical. If the fast solver breaks down (a singular circulant matrix, a singular
+ *         leading minor, or a Levinson solution that fails its residual check), the system goes to the recursive LU engine instead.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The Toeplitz matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format. Must have as many rows as A and at least one column.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *  @param is_circulant: int
+ *      1 to use the FFT (A must be circulant), 0 to use the Levinson recursion.
+ *  @param solver_name: char[ptr]
+ *      How the solver is described in the step log.
+ *
+ *  @return None
+ *
+ */
+static void perform_toeplitz_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, int is_circulant, const char *solver_name)
+{
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int size = metadata->num_rows;
+    int num_augment_cols = matrix_augment_metadata->num_cols;
+    struct MatrixMetadata augmented_matrix_metadata;
+    double *augmented_matrix = (double *)malloc(sizeof(double) * ((int64_t)size * (size + num_augment_cols)));
+    // The first column and the first row of A, which are all the fast solvers read
+    double *first_col = (double *)malloc(sizeof(double) * 2 * size);
+    int solved = 0;
+    double determinant = 0.0;
+    if (augmented_matrix && first_col)
+    {
+        double *first_row = &first_col[size];
+        hstack(matrix_to_reduce, matrix_augment, augmented_matrix, metadata, matrix_augment_metadata, &augmented_matrix_metadata);
+        for (int index = 0; index < size; index++)
+        {
+            first_col[index] = matrix_to_reduce[(int64_t)index * get_row_stride(metadata)];
+            first_row[index] = matrix_to_reduce[(int64_t)index * get_col_stride(metadata)];
+        }
+        double *solution = &augmented_matrix[size];
+        if (is_circulant)
+        {
+            solved = solve_circulant_fft(first_col, size, solution, augmented_matrix_metadata.num_cols, num_augment_cols, &determinant);
+        }
+        else if (solve_toeplitz_levinson(first_col, first_row, size, solution, augmented_matrix_metadata.num_cols, num_augment_cols, &determinant))
+        {
+            int leading_dimension;
+            double *row_major_matrix = get_row_major_matrix(matrix_to_reduce, metadata, &leading_dimension);
+            solved = row_major_matrix && solution_has_small_residual(row_major_matrix, leading_dimension, size, matrix_augment, matrix_augment_metadata, solution, augmented_matrix_metadata.num_cols, resolve_num_threads(resolved_options.num_threads));
+            if (row_major_matrix != matrix_to_reduce)
+            {
+                free(row_major_matrix);
+            }
+        }
+    }
+    free(first_col);
+    finish_direct_solve(solved, matrix_to_reduce, matrix_augment, augmented_matrix, &augmented_matrix_metadata, determinant, solver_name, start_seconds, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+}
+
+/**
+ *  @brief Solve a system whose A is a packed triangle (see PackedMatrix.c) on the packed values themselves: substitution for a triangular A, and
+ *         packed LDL^T elimination for a symmetric one. A triangular A with a 0 on its diagonal, or a symmetric A that is not positive definite,
+ *         falls back to the recursive LU engine on the expanded matrix. Has the same step log contract and outputs as perform_lu_reduction.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The packed triangle of A.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce, with one of the packed layouts.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+static void perform_packed_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int size = metadata->num_rows;
+    int num_augment_cols = matrix_augment_metadata->num_cols;
+    int is_upper = is_upper_packed_layout(metadata);
+    int is_symmetric = is_symmetric_packed_layout(metadata);
+    const char *solver_name = is_symmetric ? "Symmetric Positive Definite Elimination (Packed LDL^T)" : "Triangular Substitution (Packed)";
+    struct MatrixMetadata augmented_matrix_metadata;
+    double *augmented_matrix = (double *)malloc(sizeof(double) * ((int64_t)size * (size + num_augment_cols)));
+    // The elimination overwrites the triangle it factors, so a symmetric A is factored in an (upper packed) copy
+    double *packed_factors = is_symmetric ? (double *)malloc(sizeof(double) * get_packed_size(size)) : NULL;
+    int solved = 0;
+    double determinant = 1.0;
+    if (augmented_matrix && (packed_factors || !is_symmetric))
+    {
+        hstack(matrix_to_reduce, matrix_augment, augmented_matrix, metadata, matrix_augment_metadata, &augmented_matrix_metadata);
+        double *solution = &augmented_matrix[size];
+        if (is_symmetric)
+        {
+            copy_packed_symmetric_to_upper(matrix_to_reduce, size, is_upper, packed_factors);
+            solved = solve_packed_symmetric_positive_definite(packed_factors, size, solution, augmented_matrix_metadata.num_cols, num_augment_cols, &determinant, resolve_num_threads(resolved_options.num_threads));
+        }
+        else
+        {
+            solved = 1;
+            for (int diagonal = 0; diagonal < size; diagonal++)
+            {
+                double diagonal_value = matrix_to_reduce[get_packed_row_offset(diagonal, size, is_upper) + (is_upper ? 0 : diagonal)];
+                determinant *= diagonal_value;
+                solved = solved && diagonal_value != 0.0;
+            }
+            if (solved)
+            {
+                solve_packed_triangular(matrix_to_reduce, size, is_upper, solution, augmented_matrix_metadata.num_cols, num_augment_cols);
+            }
+        }
+    }
+    free(packed_factors);
+    finish_direct_solve(solved, matrix_to_reduce, matrix_augment, augmented_matrix, &augmented_matrix_metadata, determinant, solver_name, start_seconds, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+}
+
+/**
+ *  @brief analyze_matrix_structure for a matrix with any strides. Row strides are read in place; a column stride other than 1 is analyzed
+ *         from a row-major copy (see get_row_major_matrix).
+ *
+ *  @return is_analyzed: int
+ *      1 if the structure was filled in, 0 if the matrix is empty, is not float64 or a buffer could not be allocated.
+ */
+static int analyze_strided_matrix_structure(double *matrix, const struct MatrixMetadata *metadata, struct MatrixStructure *structure)
+{
+    if (metadata->dtype != MATRIX_DTYPE_FLOAT64)
+    {
+        return 0;
+    }
+    int leading_dimension;
+    double *row_major_matrix = get_row_major_matrix(matrix, metadata, &leading_dimension);
+    if (!row_major_matrix)
+    {
+        return 0;
+    }
+    int is_analyzed = analyze_matrix_structure(row_major_matrix, metadata->num_rows, metadata->num_cols, leading_dimension, MARGIN_OF_ERROR, structure);
+    if (row_major_matrix != matrix)
+    {
+        free(row_major_matrix);
+    }
+    return is_analyzed;
+}
+
+/**
+ *  @brief Profile the structure of a matrix (see analyze_matrix_structure) and pick the solver the automatic dispatcher would use for it.
+ *
+ *  @param matrix_to_analyze: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_analyze.
+ *  @param structure: struct MatrixStructure[ptr]
+ *      Receives the structure profile.
+ *
+ *  @return plan: int
+ *      One of the SOLVER_PLAN_* values, or -1 if the matrix could not be analyzed.
+ *
+ */
+EXPORT int python_analyze_matrix_structure(double *matrix_to_analyze, struct MatrixMetadata *metadata, struct MatrixStructure *structure)
+{
+    if (!analyze_strided_matrix_structure(matrix_to_analyze, metadata, structure))
+    {
+        return -1;
+    }
+    return choose_solver_plan(structure);
+}
+
+/**
+ *  @brief python_perform_automatic_reduction, with the structure of A already known.
+ *
+ *  @param known_structure: struct MatrixStructure[ptr]
+ *      The structure of A (e.g., cached in a struct Matrix), or NULL to analyze it.
+ *
+ *  The other parameters are those of python_perform_automatic_reduction.
+ *
+ *  @return None
+ *
+ */
+static void perform_automatic_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs, const struct MatrixStructure *known_structure)
+{
+    // The structure analysis is float64 only; other types go to the type-generic Gauss-Jordan engine
+    if (!is_float64_system(metadata, matrix_augment_metadata))
+    {
+        perform_typed_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, 0);
+        return;
+    }
+    // A packed A already says what its structure is
+    if (is_packed_layout(metadata) && metadata->num_cols == metadata->num_rows && matrix_augment_metadata->num_rows == metadata->num_rows && matrix_augment_metadata->num_cols >= 1)
+    {
+        perform_packed_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    struct MatrixStructure structure = {0};
+    int is_analyzed = 0;
+    int plan = SOLVER_PLAN_GAUSS_JORDAN;
+    if (known_structure)
+    {
+        structure = *known_structure;
+        is_analyzed = 1;
+    }
+    else
+    {
+        is_analyzed = analyze_strided_matrix_structure(matrix_to_reduce, metadata, &structure);
+    }
+    if (is_analyzed)
+    {
+        plan = choose_solver_plan(&structure);
+    }
+    if (matrix_augment_metadata->num_rows != metadata->num_rows || matrix_augment_metadata->num_cols < 1)
+    {
+        plan = SOLVER_PLAN_GAUSS_JORDAN;
+    }
+    const char *solver_names[] = {"Gauss-Jordan Elimination", "Triangular Substitution (Already Factored)", "Banded Partial Pivoting",
+                                  "Symmetric Positive Definite Elimination (LDL^T)", "Recursive Partial Pivoting (Cache-Oblivious)",
+                                  "Levinson Recursion (Toeplitz)", "FFT Diagonalization (Circulant)"};
+    if (resolved_options.verbosity >= LOG_VERBOSITY_STEPS)
+    {
+        log_solver_plan(solver_names[plan], is_analyzed ? &structure : NULL, message_buffer);
+    }
+    int (*factor)(double *, int, int, int, int *, int) = NULL;
+    if (plan == SOLVER_PLAN_TRIANGULAR)
+    {
+        factor = factor_triangular;
+    }
+    else if (plan == SOLVER_PLAN_BANDED_LU)
+    {
+        factor = factor_lu_banded;
+    }
+    else if (plan == SOLVER_PLAN_SYMMETRIC_POSITIVE_DEFINITE)
+    {
+        factor = factor_symmetric_positive_definite;
+    }
+    else if (plan == SOLVER_PLAN_DENSE_LU)
+    {
+        factor = factor_lu_recursive;
+    }
+    if (plan == SOLVER_PLAN_TOEPLITZ || plan == SOLVER_PLAN_CIRCULANT)
+    {
+        perform_toeplitz_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, plan == SOLVER_PLAN_CIRCULANT, solver_names[plan]);
+    }
+    else if (factor)
+    {
+        perform_lu_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, factor, solver_names[plan]);
+    }
+    else
+    {
+        python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+    }
+}
+
+/**
+ *  @brief Solve a system with whichever solver suits the structure of A best: substitution only for triangular systems, the FFT for circulant ones,
+ *         the Levinson recursion for Toeplitz ones, banded LU for banded ones, symmetric elimination for symmetric positive definite ones, the recursive
+ *         LU engine for other square ones, and the Gauss-Jordan loop for the rest (see choose_solver_plan). A packed A is solved on its packed values
+ *         (see perform_packed_reduction). Has the same parameters, step log contract and outputs as python_perform_gauss_jordan_reduction;
+ *         at STEPS verbosity the log starts with the structure and the solver picked.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity, pivot strategy (for the Gauss-Jordan loop) and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_automatic_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    perform_automatic_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, NULL);
+}
+
+/**
+ *  @brief The structure of a matrix (see python_analyze_matrix_structure), analyzed the first time it is asked for and cached in the matrix.
+ *
+ *  @param matrix: struct Matrix[ptr]
+ *      The matrix to analyze.
+ *  @param structure: struct MatrixStructure[ptr]
+ *      Receives the structure. May be NULL to only fill the cache.
+ *
+ *  @return plan: int
+ *      One of the SolverPlan values, or -1 if the matrix could not be analyzed (it is not float64, or memory ran out).
+ *
+ */
+EXPORT int python_get_matrix_structure(struct Matrix *matrix, struct MatrixStructure *structure)
+{
+    if (!matrix->has_structure)
+    {
+        matrix->has_structure = analyze_strided_matrix_structure((double *)matrix->values, &matrix->metadata, &matrix->structure);
+        if (!matrix->has_structure)
+        {
+            return -1;
+        }
+    }
+    if (structure)
+    {
+        *structure = matrix->structure;
+    }
+    return choose_solver_plan(&matrix->structure);
+}
+
+/**
+ *  @brief Solve A*X = B held in two struct Matrix with the automatic engine (see python_perform_automatic_reduction). The structure of A is
+ *         taken from (or analyzed into) its cache, so solving against it again skips the analysis. The rank, consistency and determinant are
+ *         written to A's metadata.
+ *
+ *  @param matrix: struct Matrix[ptr]
+ *      A.
+ *  @param augment: struct Matrix[ptr]
+ *      B. It is not modified.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity, pivot strategy and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_solve_matrices(struct Matrix *matrix, struct Matrix *augment, struct String *message_buffer, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    // Only float64, unpacked matrices are analyzed; the engine routes the others without a structure
+    int is_analyzable = is_float64_system(&matrix->metadata, &augment->metadata) && !is_packed_layout(&matrix->metadata);
+    if (is_analyzable && python_get_matrix_structure(matrix, NULL) < 0)
+    {
+        is_analyzable = 0;
+    }
+    perform_automatic_reduction((double *)matrix->values, (double *)augment->values, message_buffer, &matrix->metadata, &augment->metadata, options, outputs, is_analyzable ? &matrix->structure : NULL);
+}
+
+/**
+ *  @brief One independent diagonal block of a system, gathered into its own dense system so it can be solved on its own.
+ *
+ *  @param num_rows: int
+ *      The number of rows (equations) of the block.
+ *  @param num_cols: int
+ *      The number of columns (variables) of the block.
+ *  @param rows: int[ptr]
+ *      The input row of each row of the block, in increasing order.
+ *  @param cols: int[ptr]
+ *      The input column of each column of the block, in increasing order.
+ *  @param matrix: double[ptr]
+ *      The block of A, in a 1-D format.
+ *  @param augment: double[ptr]
+ *      The rows of B that belong to the block, in a 1-D format.
+ *  @param reduced_matrix: double[ptr]
+ *      Receives the reduced row echelon form of the block.
+ *  @param solution: double[ptr]
+ *      Receives the reduced augment of the block.
+ *  @param pivot_permutation: int[ptr]
+ *      Receives the row of the block each row of the results came from.
+ *  @param metadata: struct MatrixMetadata
+ *      The metadata of the block of A. The solver writes its consistency and determinant to it.
+ *  @param augment_metadata: struct MatrixMetadata
+ *      The metadata of the block's augment.
+ *  @param log: struct LogBuffer[ptr]
+ *      The block's own step log, spliced into the step log once every block is solved. NULL when no steps are logged.
+ *  @param pivot_search_seconds: double
+ *      The pivot search time reported by the block's solver.
+ *  @param work: double
+ *      An estimate of how long the block takes to solve, used to balance the blocks across threads.
+ */
+struct DiagonalBlock
+{
+    int num_rows;
+    int num_cols;
+    int *rows;
+    int *cols;
+    double *matrix;
+    double *augment;
+    double *reduced_matrix;
+    double *solution;
+    int *pivot_permutation;
+    struct MatrixMetadata metadata;
+    struct MatrixMetadata augment_metadata;
+    struct LogBuffer *log;
+    double pivot_search_seconds;
+    double work;
+};
+
+/**
+ *  @brief The blocks that are solved side by side, each on a single thread.
+ *
+ *  @param blocks: struct DiagonalBlock[ptr]
+ *      Every block of the system.
+ *  @param task_blocks: int[ptr]
+ *      The block each task solves, largest first so the small ones fill in the gaps at the end.
+ *  @param options: struct SolverOptions
+ *      The options each block is solved with.
+ */
+struct BlockDiagonalSolve
+{
+    struct DiagonalBlock *blocks;
+    const int *task_blocks;
+    struct SolverOptions options;
+};
+
+/**
+ *  @brief A block and the work estimate it is sorted by.
+ */
+struct DiagonalBlockWork
+{
+    double work;
+    int block;
+};
+
+/**
+ *  @brief qsort comparison that puts the blocks with the most work first, and blocks with the same work in the order of their numbers.
+ */
+static int compare_diagonal_block_work(const void *a, const void *b)
+{
+    const struct DiagonalBlockWork *block_a = (const struct DiagonalBlockWork *)a;
+    const struct DiagonalBlockWork *block_b = (const struct DiagonalBlockWork *)b;
+    if (block_a->work != block_b->work)
+    {
+        return (block_a->work > block_b->work) ? -1 : 1;
+    }
+    return block_a->block - block_b->block;
+}
+
+/**
+ *  @brief Solve one block with the automatic dispatcher, writing its step log to the block's own log (or nowhere if it has none).
+ *
+ *  @param block: struct DiagonalBlock[ptr]
+ *      The block to solve.
+ *  @param options: struct SolverOptions[ptr]
+ *      The options to solve it with.
+ *
+ *  @return None
+ */
+static void solve_diagonal_block_system(struct DiagonalBlock *block, struct SolverOptions *options)
+{
+    // A String without bytes only counts what is written to it, so the block's log is dropped without being printed
+    struct String discarded_log = String(NULL, INT64_MAX);
+    struct String *block_log = block->log ? &block->log->string : &discarded_log;
+    struct SolverOutputs block_outputs = {block->reduced_matrix, block->solution, block->pivot_permutation, 0.0, 0.0};
+    block->metadata.matrix_determinant = 0.0;
+    python_perform_automatic_reduction(block->matrix, block->augment, block_log, &block->metadata, &block->augment_metadata, options, &block_outputs);
+    block->pivot_search_seconds = block_outputs.pivot_search_seconds;
+}
+
+/**
+ *  @brief One of the blocks that are solved side by side.
+ */
+static void solve_diagonal_block(void *context, int task_index)
+{
+    struct BlockDiagonalSolve *solve = (struct BlockDiagonalSolve *)context;
+    solve_diagonal_block_system(&solve->blocks[solve->task_blocks[task_index]], &solve->options);
+}
+
+/**
+ *  @brief Get the sign of a permutation by counting its cycles.
+ *
+ *  @param permutation: int[ptr]
+ *      The permutation of 0 to size - 1.
+ *  @param size: int
+ *      The number of values in the permutation.
+ *  @param visited: int[ptr]
+ *      Scratch space for size values.
+ *
+ *  @return sign: int
+ *      1 if the permutation is made of an even number of swaps, -1 otherwise.
+ */
+static inline int get_permutation_sign(const int *permutation, int size, int *visited)
+{
+    int sign = 1;
+    memset(visited, 0, sizeof(int) * size);
+    for (int start = 0; start < size; start++)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        // A cycle of length L is L - 1 swaps
+        for (int index = permutation[start]; index != start; index = permutation[index])
+        {
+            visited[index] = 1;
+            sign = -sign;
+        }
+        visited[start] = 1;
+    }
+    return sign;
+}
+
+/**
+ *  @brief Solve a system whose matrix is a permuted block-diagonal matrix, i.e., several independent systems glued together. The rows and columns
+ *         are split into independent blocks (see find_diagonal_blocks), and every block is solved with the automatic dispatcher: blocks with at least
+ *         a thread's share of the work one after another with all of the threads, the rest side by side with one thread each. The blocks' results are
+ *         then stitched back into the reduced row echelon form of the whole system. Systems with only one block go straight to the automatic dispatcher.
+ *
+ *         Has the same parameters, step log contract and outputs as python_perform_gauss_jordan_reduction. At STEPS verbosity, the log lists every
+ *         block followed by its own step log, in block order, so it is the same no matter how the blocks were spread across threads. The rank of the
+ *         whole system is written to metadata->matrix_rank, and the determinant is the product of the blocks' determinants, signed by the permutation
+ *         that makes the matrix block-diagonal (0 if the matrix is not square, or any block is not square).
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix A of Ax = B, in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment B of Ax = B, in a 1-D format.
+ *  @param message_buffer: struct String[ptr]
+ *      The step log. If NULL, it is printed instead.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_to_reduce.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment.
+ *  @param options: struct SolverOptions[ptr]
+ *      The verbosity, pivot strategy (for blocks solved by the Gauss-Jordan loop) and number of threads. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_block_diagonal_reduction(double *matrix_to_reduce, double *matrix_augment, struct String *message_buffer, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    // The block search is float64 only; other types go to the type-generic Gauss-Jordan engine
+    if (!is_float64_system(metadata, matrix_augment_metadata))
+    {
+        perform_typed_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs, 0);
+        return;
+    }
+    double start_seconds = get_time_in_seconds();
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int log_steps = resolved_options.verbosity >= LOG_VERBOSITY_STEPS;
+    int log_matrices = resolved_options.verbosity >= LOG_VERBOSITY_MATRICES;
+    int num_rows = metadata->num_rows;
+    int num_cols = metadata->num_cols;
+    int num_augment_cols = matrix_augment_metadata->num_cols;
+    int num_blocks = -1;
+    int *row_blocks = NULL;
+    int *col_blocks = NULL;
+    // The blocks are found in, and later gathered from, a row-major view of A (a copy if A is column-major or packed)
+    int leading_dimension = 0;
+    double *row_major_matrix = NULL;
+    if (num_rows > 0 && num_cols > 0 && matrix_augment_metadata->num_rows == num_rows && num_augment_cols > 0)
+    {
+        row_blocks = (int *)malloc(sizeof(int) * num_rows);
+        col_blocks = (int *)malloc(sizeof(int) * num_cols);
+        row_major_matrix = (row_blocks && col_blocks) ? get_row_major_matrix(matrix_to_reduce, metadata, &leading_dimension) : NULL;
+        if (row_major_matrix)
+        {
+            num_blocks = find_diagonal_blocks(row_major_matrix, num_rows, num_cols, leading_dimension, row_blocks, col_blocks);
+        }
+    }
+    struct DiagonalBlock *blocks = (num_blocks > 1) ? (struct DiagonalBlock *)calloc(num_blocks, sizeof(struct DiagonalBlock)) : NULL;
+    if (!blocks)
+    {
+        if (row_major_matrix != matrix_to_reduce)
+        {
+            free(row_major_matrix);
+        }
+        free(col_blocks);
+        free(row_blocks);
+        python_perform_automatic_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+
+    // Every block's values are gathered into a slice of a few shared arrays. The blocks do not overlap, so they need at most as much as the system.
+    int64_t num_block_values = 0;
+    for (int row = 0; row < num_rows; row++)
+    {
+        if (row_blocks[row] != -1)
+        {
+            blocks[row_blocks[row]].num_rows++;
+        }
+    }
+    for (int col = 0; col < num_cols; col++)
+    {
+        if (col_blocks[col] != -1)
+        {
+            blocks[col_blocks[col]].num_cols++;
+        }
+    }
+    for (int block = 0; block < num_blocks; block++)
+    {
+        num_block_values += (int64_t)blocks[block].num_rows * blocks[block].num_cols;
+    }
+    int *block_rows = (int *)malloc(sizeof(int) * num_rows);
+    int *block_cols = (int *)malloc(sizeof(int) * num_cols);
+    int *block_pivots = (int *)malloc(sizeof(int) * num_rows);
+    double *block_matrices = (double *)malloc(sizeof(double) * 2 * num_block_values);
+    double *block_augments = (double *)malloc(sizeof(double) * 2 * (int64_t)num_rows * num_augment_cols);
+    int num_augmented_cols = num_cols + num_augment_cols;
+    double *augmented_matrix = (double *)calloc((size_t)num_rows * num_augmented_cols, sizeof(double));
+    double **rows = (double **)malloc(sizeof(double *) * num_rows);
+    int *row_permutation = (int *)malloc(sizeof(int) * num_rows);
+    int *source_rows = (int *)malloc(sizeof(int) * num_rows);
+    int *col_sources = (int *)malloc(sizeof(int) * num_cols);
+    int *visited = (int *)malloc(sizeof(int) * (num_rows > num_cols ? num_rows : num_cols));
+    struct DiagonalBlockWork *block_order = (struct DiagonalBlockWork *)malloc(sizeof(struct DiagonalBlockWork) * num_blocks);
+    int *task_blocks = (int *)malloc(sizeof(int) * num_blocks);
+    int allocated = block_rows && block_cols && block_pivots && block_matrices && block_augments && augmented_matrix && rows && row_permutation &&
+                    source_rows && col_sources && visited && block_order && task_blocks;
+
+    int64_t matrix_offset = 0;
+    int row_offset = 0;
+    int col_offset = 0;
+    for (int block = 0; block < num_blocks && allocated; block++)
+    {
+        struct DiagonalBlock *diagonal_block = &blocks[block];
+        diagonal_block->rows = &block_rows[row_offset];
+        diagonal_block->cols = &block_cols[col_offset];
+        diagonal_block->pivot_permutation = &block_pivots[row_offset];
+        diagonal_block->matrix = &block_matrices[matrix_offset];
+        diagonal_block->reduced_matrix = &block_matrices[num_block_values + matrix_offset];
+        diagonal_block->augment = &block_augments[(int64_t)row_offset * num_augment_cols];
+        diagonal_block->solution = &block_augments[((int64_t)num_rows + row_offset) * num_augment_cols];
+        diagonal_block->metadata.num_rows = diagonal_block->num_rows;
+        diagonal_block->metadata.num_cols = diagonal_block->num_cols;
+        diagonal_block->augment_metadata.num_rows = diagonal_block->num_rows;
+        diagonal_block->augment_metadata.num_cols = num_augment_cols;
+        int min_dimension = (diagonal_block->num_rows < diagonal_block->num_cols) ? diagonal_block->num_rows : diagonal_block->num_cols;
+        diagonal_block->work = (double)diagonal_block->num_rows * (diagonal_block->num_cols + num_augment_cols) * min_dimension;
+        if (log_steps)
+        {
+            diagonal_block->log = python_create_log_buffer();
+            allocated = diagonal_block->log != NULL;
+        }
+        matrix_offset += (int64_t)diagonal_block->num_rows * diagonal_block->num_cols;
+        row_offset += diagonal_block->num_rows;
+        col_offset += diagonal_block->num_cols;
+        // The counts are rebuilt as the rows and columns are gathered below
+        diagonal_block->num_rows = 0;
+        diagonal_block->num_cols = 0;
+    }
+    if (!allocated)
+    {
+        for (int block = 0; block < num_blocks; block++)
+        {
+            python_destroy_log_buffer(blocks[block].log);
+        }
+        free(task_blocks);
+        free(block_order);
+        free(visited);
+        free(col_sources);
+        free(source_rows);
+        free(row_permutation);
+        free(rows);
+        free(augmented_matrix);
+        free(block_augments);
+        free(block_matrices);
+        free(block_pivots);
+        free(block_cols);
+        free(block_rows);
+        free(blocks);
+        free(col_blocks);
+        free(row_blocks);
+        if (row_major_matrix != matrix_to_reduce)
+        {
+            free(row_major_matrix);
+        }
+        python_perform_automatic_reduction(matrix_to_reduce, matrix_augment, message_buffer, metadata, matrix_augment_metadata, options, outputs);
+        return;
+    }
+    for (int col = 0; col < num_cols; col++)
+    {
+        if (col_blocks[col] != -1)
+        {
+            struct DiagonalBlock *diagonal_block = &blocks[col_blocks[col]];
+            diagonal_block->cols[diagonal_block->num_cols++] = col;
+        }
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        if (row_blocks[row] != -1)
+        {
+            struct DiagonalBlock *diagonal_block = &blocks[row_blocks[row]];
+            int block_row = diagonal_block->num_rows++;
+            diagonal_block->rows[block_row] = row;
+            const double *input_row = &row_major_matrix[(int64_t)row * leading_dimension];
+            double *gathered_row = &diagonal_block->matrix[(int64_t)block_row * diagonal_block->num_cols];
+            for (int col = 0; col < diagonal_block->num_cols; col++)
+            {
+                gathered_row[col] = input_row[diagonal_block->cols[col]];
+            }
+            copy_strided_row(matrix_augment, matrix_augment_metadata, row, &diagonal_block->augment[(int64_t)block_row * num_augment_cols]);
+        }
+    }
+    if (row_major_matrix != matrix_to_reduce)
+    {
+        free(row_major_matrix);
+    }
+
+    if (log_steps)
+    {
+        if (!message_buffer)
+        {
+            printf("Decomposing into %d Independent Diagonal Blocks.\n", num_blocks);
+        }
+        else
+        {
+            writeStringNoNullTerminator("Decomposing into ", message_buffer);
+            writeNumber(num_blocks, message_buffer);
+            writeNulTerminatedString(" Independent Diagonal Blocks\n", message_buffer);
+        }
+    }
+    double total_work = 0.0;
+    for (int block = 0; block < num_blocks; block++)
+    {
+        block_order[block].work = blocks[block].work;
+        block_order[block].block = block;
+        total_work += blocks[block].work;
+    }
+    qsort(block_order, num_blocks, sizeof(struct DiagonalBlockWork), compare_diagonal_block_work);
+    int num_threads = resolve_num_threads(resolved_options.num_threads);
+    struct BlockDiagonalSolve solve = {blocks, task_blocks, resolved_options};
+    solve.options.num_threads = 1;
+    int num_tasks = 0;
+    for (int block = 0; block < num_blocks; block++)
+    {
+        // A block with at least one thread's share of the work would hold up the others if it ran on a single thread
+        if (num_threads > 1 && block_order[block].work * num_threads >= total_work)
+        {
+            solve_diagonal_block_system(&blocks[block_order[block].block], &resolved_options);
+        }
+        else
+        {
+            task_blocks[num_tasks++] = block_order[block].block;
+        }
+    }
+    parallel_for(num_tasks, solve_diagonal_block, &solve);
+
+    // Stitch the blocks back together. Every row of a block's results is spread back over the block's columns, and the pivot rows are then put in the
+    // order of their pivot columns. Blocks share no columns, so this is the reduced row echelon form of the whole matrix. Rows of A that are all 0 belong
+    // to no block, and keep their row of B.
+    double product_of_diagonal_elements = (num_rows == num_cols) ? 1.0 : 0.0;
+    double pivot_search_seconds = 0.0;
+    int *is_pivot_source = visited;
+    int source = 0;
+    for (int col = 0; col < num_cols; col++)
+    {
+        col_sources[col] = -1;
+    }
+    for (int block = 0; block < num_blocks; block++)
+    {
+        struct DiagonalBlock *diagonal_block = &blocks[block];
+        for (int block_row = 0; block_row < diagonal_block->num_rows; block_row++)
+        {
+            double *row = &augmented_matrix[(int64_t)source * num_augmented_cols];
+            const double *reduced_row = &diagonal_block->reduced_matrix[(int64_t)block_row * diagonal_block->num_cols];
+            int leading_col = -1;
+            for (int col = 0; col < diagonal_block->num_cols; col++)
+            {
+                row[diagonal_block->cols[col]] = reduced_row[col];
+                if (leading_col == -1 && fabs(reduced_row[col]) > MARGIN_OF_ERROR)
+                {
+                    leading_col = diagonal_block->cols[col];
+                }
+            }
+            memcpy(&row[num_cols], &diagonal_block->solution[(int64_t)block_row * num_augment_cols], sizeof(double) * num_augment_cols);
+            source_rows[source] = diagonal_block->rows[diagonal_block->pivot_permutation[block_row]];
+            if (leading_col != -1 && col_sources[leading_col] == -1)
+            {
+                col_sources[leading_col] = source;
+            }
+            source++;
+        }
+        if (diagonal_block->num_rows != diagonal_block->num_cols)
+        {
+            product_of_diagonal_elements = 0.0;
+        }
+        product_of_diagonal_elements *= diagonal_block->metadata.matrix_determinant;
+        pivot_search_seconds += diagonal_block->pivot_search_seconds;
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        if (row_blocks[row] == -1)
+        {
+            copy_strided_row(matrix_augment, matrix_augment_metadata, row, &augmented_matrix[(int64_t)source * num_augmented_cols + num_cols]);
+            source_rows[source++] = row;
+            product_of_diagonal_elements = 0.0;
+        }
+    }
+    for (int row = 0; row < num_rows; row++)
+    {
+        is_pivot_source[row] = 0;
+    }
+    int num_pivot_rows = 0;
+    for (int col = 0; col < num_cols; col++)
+    {
+        if (col_sources[col] != -1)
+        {
+            rows[num_pivot_rows] = &augmented_matrix[(int64_t)col_sources[col] * num_augmented_cols];
+            row_permutation[num_pivot_rows++] = source_rows[col_sources[col]];
+            is_pivot_source[col_sources[col]] = 1;
+        }
+    }
+    int next_row = num_pivot_rows;
+    for (int row = 0; row < num_rows; row++)
+    {
+        if (!is_pivot_source[row])
+        {
+            rows[next_row] = &augmented_matrix[(int64_t)row * num_augmented_cols];
+            row_permutation[next_row++] = source_rows[row];
+        }
+    }
+
+    // The blocks' rows and columns, one block after another, are the permutations that make A block-diagonal
+    int swap_multiplier = 1;
+    if (product_of_diagonal_elements != 0.0)
+    {
+        swap_multiplier = get_permutation_sign(block_rows, num_rows, visited) * get_permutation_sign(block_cols, num_cols, visited);
+    }
+
+    if (log_steps)
+    {
+        for (int block = 0; block < num_blocks; block++)
+        {
+            if (!message_buffer)
+            {
+                printf("Block %d of %d: %d Rows, %d Columns.\n", block + 1, num_blocks, blocks[block].num_rows, blocks[block].num_cols);
+            }
+            else
+            {
+                writeStringNoNullTerminator("Block ", message_buffer);
+                writeNumber(block + 1, message_buffer);
+                writeStringNoNullTerminator(" of ", message_buffer);
+                writeNumber(num_blocks, message_buffer);
+                writeStringNoNullTerminator(": ", message_buffer);
+                writeNumber(blocks[block].num_rows, message_buffer);
+                writeStringNoNullTerminator(" Rows, ", message_buffer);
+                writeNumber(blocks[block].num_cols, message_buffer);
+                writeNulTerminatedString(" Columns\n", message_buffer);
+            }
+            append_log_buffer(blocks[block].log, message_buffer);
+        }
+        if (!message_buffer)
+        {
+            printf("Stitching the Blocks Back Together.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("Stitching the Blocks Back Together\n", message_buffer);
+        }
+    }
+    if (log_matrices)
+    {
+        print_augmented_matrix(rows, num_rows, num_augmented_cols, num_augment_cols, message_buffer);
+    }
+    double elapsed_seconds = get_time_in_seconds() - start_seconds;
+
+    struct MatrixMetadata augmented_matrix_metadata = {num_rows, num_augmented_cols, 0, 0, 0.0, 0, 0, MATRIX_LAYOUT_ROW_MAJOR, MATRIX_DTYPE_FLOAT64, 0.0};
+    report_reduction_results(matrix_to_reduce, augmented_matrix, rows, row_permutation, metadata, &augmented_matrix_metadata, product_of_diagonal_elements, 1.0, swap_multiplier, log_steps, message_buffer, outputs);
+    if (outputs)
+    {
+        outputs->elapsed_seconds = elapsed_seconds;
+        outputs->pivot_search_seconds = pivot_search_seconds;
+    }
+    for (int block = 0; block < num_blocks; block++)
+    {
+        python_destroy_log_buffer(blocks[block].log);
+    }
+    free(task_blocks);
+    free(block_order);
+    free(visited);
+    free(col_sources);
+    free(source_rows);
+    free(row_permutation);
+    free(rows);
+    free(augmented_matrix);
+    free(block_augments);
+    free(block_matrices);
+    free(block_pivots);
+    free(block_cols);
+    free(block_rows);
+    free(blocks);
+    free(col_blocks);
+    free(row_blocks);
+}
+
+/**
+ *  @brief Multiply two matrices with the packed, register-blocked matrix product (see multiply_matrices_blocked), split across threads.
+ *
+ *  @param matrix_one: double[ptr]
+ *      The left-hand side A, with dimensions MxK, in a 1-D format.
+ *  @param matrix_two: double[ptr]
+ *      The right-hand side B, with dimensions KxN, in a 1-D format.
+ *  @param result_matrix: double[ptr]
+ *      The product A*B, with dimensions MxN. Must not overlap matrix_one or matrix_two.
+ *  @param matrix_one_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_one.
+ *  @param matrix_two_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_two.
+ *  @param result_matrix_metadata: struct MatrixMetadata[ptr]
+ *      Receives the dimensions of the product, or -1 for both if the inner dimensions do not match, a matrix is not float64 or the result is packed
+ *      (result_matrix is then left untouched).
+ *      Its strides, if set, are where the product is written (e.g., into a slice of a larger array).
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_multiply_matrices(double *matrix_one, double *matrix_two, double *result_matrix, struct MatrixMetadata *matrix_one_metadata, struct MatrixMetadata *matrix_two_metadata, struct MatrixMetadata *result_matrix_metadata, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int num_rows = matrix_one_metadata->num_rows;
+    int num_inner = matrix_one_metadata->num_cols;
+    int num_cols = matrix_two_metadata->num_cols;
+    if (num_rows < 1 || num_cols < 1 || num_inner != matrix_two_metadata->num_rows || !is_float64_system(matrix_one_metadata, matrix_two_metadata) || result_matrix_metadata->dtype != MATRIX_DTYPE_FLOAT64 || is_packed_layout(result_matrix_metadata))
+    {
+        // This product cannot exist
+        result_matrix_metadata->num_rows = -1;
+        result_matrix_metadata->num_cols = -1;
+        return;
+    }
+    result_matrix_metadata->num_rows = num_rows;
+    result_matrix_metadata->num_cols = num_cols;
+    if (get_row_stride(matrix_one_metadata) == 1 && get_row_stride(matrix_two_metadata) == 1 && get_row_stride(result_matrix_metadata) == 1 &&
+        (get_col_stride(matrix_one_metadata) != 1 || get_col_stride(matrix_two_metadata) != 1 || get_col_stride(result_matrix_metadata) != 1))
+    {
+        // Column-major operands are the row-major transposes, and (A*B)^T = B^T * A^T, so nothing needs to be copied
+        multiply_matrices_blocked(num_cols, num_rows, num_inner, 1.0, matrix_two, get_col_stride(matrix_two_metadata), matrix_one, get_col_stride(matrix_one_metadata), 0.0, result_matrix, get_col_stride(result_matrix_metadata), resolve_num_threads(resolved_options.num_threads));
+        return;
+    }
+    // Strided inputs are read in place, and the product is written straight into a strided result, unless a column stride is not 1
+    int matrix_one_leading_dimension, matrix_two_leading_dimension, result_leading_dimension;
+    double *row_major_one = get_row_major_matrix(matrix_one, matrix_one_metadata, &matrix_one_leading_dimension);
+    double *row_major_two = get_row_major_matrix(matrix_two, matrix_two_metadata, &matrix_two_leading_dimension);
+    double *row_major_result = (get_col_stride(result_matrix_metadata) == 1) ? result_matrix : (double *)malloc(sizeof(double) * ((int64_t)num_rows * num_cols));
+    result_leading_dimension = (row_major_result == result_matrix) ? get_row_stride(result_matrix_metadata) : num_cols;
+    if (row_major_one && row_major_two && row_major_result)
+    {
+        multiply_matrices_blocked(num_rows, num_cols, num_inner, 1.0, row_major_one, matrix_one_leading_dimension, row_major_two, matrix_two_leading_dimension, 0.0, row_major_result, result_leading_dimension, resolve_num_threads(resolved_options.num_threads));
+        if (row_major_result != result_matrix)
+        {
+            scatter_strided_matrix(row_major_result, result_leading_dimension, result_matrix, result_matrix_metadata);
+        }
+    }
+    else
+    {
+        result_matrix_metadata->num_rows = -1;
+        result_matrix_metadata->num_cols = -1;
+    }
+    if (row_major_one != matrix_one)
+    {
+        free(row_major_one);
+    }
+    if (row_major_two != matrix_two)
+    {
+        free(row_major_two);
+    }
+    if (row_major_result != result_matrix)
+    {
+        free(row_major_result);
+    }
+}
+
+/**
+ *  @brief Transpose a matrix with the blocked, SIMD transpose (see Transpose.c), either into another buffer or in place.
+ *
+ *  @param matrix: double[ptr]
+ *      The matrix to transpose, in any layout (see MatrixMetadata).
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix. When transposing in place, it is updated to describe the transpose.
+ *  @param result_matrix: double[ptr]
+ *      Receives the transpose, laid out as result_matrix_metadata says. NULL (or matrix itself) to transpose in place, which needs a row-major
+ *      or column-major matrix that is square (with any leading dimension) or packed, or a packed symmetric one. The matrix keeps its layout.
+ *  @param result_matrix_metadata: struct MatrixMetadata[ptr]
+ *      The layout or strides of result_matrix, and receives its dimensions. Ignored when transposing in place.
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return is_transposed: int
+ *      1 if the matrix was transposed, 0 if it could not be transposed in place, is not float64 or the result would be packed.
+ *
+ */
+EXPORT int python_transpose_matrix(double *matrix, struct MatrixMetadata *metadata, double *result_matrix, struct MatrixMetadata *result_matrix_metadata, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int num_threads = resolve_num_threads(resolved_options.num_threads);
+    int row_stride = get_row_stride(metadata);
+    int col_stride = get_col_stride(metadata);
+    int num_rows = metadata->num_rows;
+    int num_cols = metadata->num_cols;
+    if (metadata->dtype != MATRIX_DTYPE_FLOAT64 || (result_matrix && result_matrix != matrix && (result_matrix_metadata->dtype != MATRIX_DTYPE_FLOAT64 || is_packed_layout(result_matrix_metadata))))
+    {
+        return 0;
+    }
+    if (is_packed_layout(metadata))
+    {
+        if (result_matrix && result_matrix != matrix)
+        {
+            // Expanding a packed triangle with the result's strides swapped writes its transpose
+            result_matrix_metadata->num_rows = num_cols;
+            result_matrix_metadata->num_cols = num_rows;
+            copy_strided_matrix(matrix, metadata, result_matrix, get_col_stride(result_matrix_metadata), get_row_stride(result_matrix_metadata), num_threads);
+            return 1;
+        }
+        // A symmetric matrix is its own transpose; a triangle would change which one is stored
+        return is_symmetric_packed_layout(metadata);
+    }
+    if (result_matrix && result_matrix != matrix)
+    {
+        // The transpose of matrix is matrix with its dimensions and strides swapped, copied into the result's layout
+        struct MatrixMetadata transposed_metadata = {num_cols, num_rows, 0, 0, 0.0, col_stride, row_stride, MATRIX_LAYOUT_ROW_MAJOR, MATRIX_DTYPE_FLOAT64, 0.0};
+        result_matrix_metadata->num_rows = num_cols;
+        result_matrix_metadata->num_cols = num_rows;
+        copy_strided_matrix(matrix, &transposed_metadata, result_matrix, get_row_stride(result_matrix_metadata), get_col_stride(result_matrix_metadata), num_threads);
+        return 1;
+    }
+    int is_row_major = (col_stride == 1);
+    if (!is_row_major && row_stride != 1)
+    {
+        return 0;
+    }
+    // A column-major matrix is its transpose in row-major order, so it is transposed as that, and keeps its layout
+    if (!transpose_matrix_in_place(matrix, is_row_major ? num_rows : num_cols, is_row_major ? num_cols : num_rows, is_row_major ? row_stride : col_stride, num_threads))
+    {
+        return 0;
+    }
+    metadata->num_rows = num_cols;
+    metadata->num_cols = num_rows;
+    if (num_rows != num_cols)
+    {
+        // The matrix was packed, and still is
+        if (is_row_major)
+        {
+            metadata->row_stride = metadata->num_cols;
+        }
+        else
+        {
+            metadata->col_stride = metadata->num_rows;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief The temporaries of a float64 inversion, all carved out of one workspace by layout_inversion_workspace.
+ * @param identity_matrix: double[ptr]
+ *      The identity, i.e., the augment of A*X = I. The solve then writes the inverse over it.
+ * @param reduced_matrix: double[ptr]
+ *      Receives the reduced A of the solve, until A is known to be invertible.
+ * @param pivot_permutation: int[ptr]
+ *      Receives the pivot permutation of the solve, until A is known to be invertible.
+ * @param row_values: double[ptr]
+ *      One row of A at a time, for the rank check.
+ * @param is_significant_col: int[ptr]
+ *      For the rank check, whether each column of A has a value that is not 0.
+ * @param gauss_jordan: struct GaussJordanWorkspace
+ *      The temporaries of the Gauss-Jordan solve, when that is the solver.
+ */
+struct InversionWorkspace
+{
+    double *identity_matrix;
+    double *reduced_matrix;
+    int *pivot_permutation;
+    double *row_values;
+    int *is_significant_col;
+    struct GaussJordanWorkspace gauss_jordan;
+};
+
+/**
+ *  @brief Lay out the temporaries of a float64 inversion in a workspace, or measure how big that workspace has to be.
+ *
+ *  @param workspace: char[ptr]
+ *      The workspace, or NULL to only measure it.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix to invert.
+ *  @param is_gauss_jordan: int
+ *      1 if the inversion solves with perform_gauss_jordan_reduction, whose temporaries then come from the workspace too.
+ *  @param parts: struct InversionWorkspace[ptr]
+ *      Receives the temporaries (all NULL if workspace is NULL).
+ *
+ *  @return num_bytes: int64_t
+ *      The size of the workspace.
+ *
+ */
+static int64_t layout_inversion_workspace(char *workspace, const struct MatrixMetadata *metadata, int is_gauss_jordan, struct InversionWorkspace *parts)
+{
+    int64_t num_bytes = 0;
+    int size = metadata->num_rows;
+    parts->identity_matrix = (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * size * size);
+    parts->reduced_matrix = (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * size * size);
+    parts->pivot_permutation = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * size);
+    parts->row_values = (double *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(double) * metadata->num_cols);
+    parts->is_significant_col = (int *)take_workspace_part(workspace, &num_bytes, (int64_t)sizeof(int) * metadata->num_cols);
+    memset(&parts->gauss_jordan, 0, sizeof(parts->gauss_jordan));
+    if (is_gauss_jordan)
+    {
+        struct MatrixMetadata identity_matrix_metadata = {0};
+        identity_matrix_metadata.num_rows = size;
+        identity_matrix_metadata.num_cols = size;
+        num_bytes += layout_gauss_jordan_workspace(workspace ? &workspace[num_bytes] : NULL, metadata, &identity_matrix_metadata, 0, &parts->gauss_jordan);
+    }
+    return num_bytes;
+}
+
+/**
+ *  @brief Count the rows and the columns of a matrix whose values are all within MARGIN_OF_ERROR of 0, the way analyze_matrix_structure counts
+ *         num_zero_rows and num_zero_cols, but in scratch space the caller provides.
+ *
+ *  @param matrix: double[ptr]
+ *      The matrix, with any layout.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix.
+ *  @param row_values: double[ptr]
+ *      Scratch space for one row.
+ *  @param is_significant_col: int[ptr]
+ *      Scratch space for one flag per column.
+ *  @param num_zero_rows: int[ptr]
+ *      Receives the number of zero rows.
+ *  @param num_zero_cols: int[ptr]
+ *      Receives the number of zero columns.
+ *
+ *  @return None
+ *
+ */
+static void count_zero_rows_and_cols(const double *matrix, const struct MatrixMetadata *metadata, double *row_values, int *is_significant_col, int *num_zero_rows, int *num_zero_cols)
+{
+    memset(is_significant_col, 0, sizeof(int) * metadata->num_cols);
+    *num_zero_rows = 0;
+    for (int row = 0; row < metadata->num_rows; row++)
+    {
+        copy_strided_row(matrix, metadata, row, row_values);
+        int is_significant_row = 0;
+        for (int col = 0; col < metadata->num_cols; col++)
+        {
+            int is_significant = fabs(row_values[col]) > MARGIN_OF_ERROR;
+            is_significant_row |= is_significant;
+            is_significant_col[col] |= is_significant;
+        }
+        *num_zero_rows += !is_significant_row;
+    }
+    *num_zero_cols = 0;
+    for (int col = 0; col < metadata->num_cols; col++)
+    {
+        *num_zero_cols += !is_significant_col[col];
+    }
+}
+
+/**
+ *  @brief Attempt to invert a square matrix by solving A*X = I with one of the solvers.
+ *
+ *  @param solver: function[ptr]
+ *      python_perform_recursive_lu_reduction, or one of the engines with the same parameters. NULL to solve with perform_gauss_jordan_reduction.
+ *  @param workspace: struct InversionWorkspace[ptr]
+ *      The temporaries of a float64 inversion, laid out for this solver. If NULL, they are allocated.
+ *
+ *  The other parameters are those of python_perform_square_matrix_inversion_gaussian_reduction.
+ *
+ *  @return None
+ *
+ */
+static void invert_square_matrix(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct String *message_buffer, struct SolverOptions *options, struct SolverOutputs *outputs, void (*solver)(double *, double *, struct String *, struct MatrixMetadata *, struct MatrixMetadata *, struct SolverOptions *, struct SolverOutputs *), const struct InversionWorkspace *workspace)
+{
+    if (matrix_to_invert_metadata->dtype != MATRIX_DTYPE_FLOAT64)
+    {
+        // Solve A*X = I in A's own arithmetic, which also finds out whether A has full rank
+        int size = matrix_to_invert_metadata->num_rows;
+        int value_size = get_dtype_size(matrix_to_invert_metadata->dtype);
+        char *identity_matrix = (char *)allocate_pooled((size_t)size * size * value_size);
+        if (!identity_matrix || size != matrix_to_invert_metadata->num_cols)
+        {
+            free_pooled(identity_matrix);
+            return;
+        }
+        memset(identity_matrix, 0, (size_t)size * size * value_size);
+        for (int diagonal = 0; diagonal < size; diagonal++)
+        {
+            // The real part of a complex value comes first, so it is the same as a real value of its real type
+            if (matrix_to_invert_metadata->dtype == MATRIX_DTYPE_FLOAT32 || matrix_to_invert_metadata->dtype == MATRIX_DTYPE_COMPLEX64)
+            {
+                *(float *)&identity_matrix[((int64_t)diagonal * size + diagonal) * value_size] = 1.0f;
+            }
+            else
+            {
+                *(double *)&identity_matrix[((int64_t)diagonal * size + diagonal) * value_size] = 1.0;
+            }
+        }
+        struct MatrixMetadata identity_matrix_metadata = {0};
+        identity_matrix_metadata.num_rows = size;
+        identity_matrix_metadata.num_cols = size;
+        identity_matrix_metadata.dtype = matrix_to_invert_metadata->dtype;
+        perform_typed_reduction(matrix_to_invert, identity_matrix, message_buffer, matrix_to_invert_metadata, &identity_matrix_metadata, options, outputs, 1);
+        free_pooled(identity_matrix);
+        return;
+    }
+    struct InversionWorkspace allocated_parts;
+    char *allocated_workspace = NULL;
+    if (!workspace)
+    {
+        allocated_workspace = (char *)allocate_pooled(layout_inversion_workspace(NULL, matrix_to_invert_metadata, !solver, &allocated_parts));
+        if (!allocated_workspace)
+        {
+            return;
+        }
+        layout_inversion_workspace(allocated_workspace, matrix_to_invert_metadata, !solver, &allocated_parts);
+        workspace = &allocated_parts;
+    }
+    int num_zero_rows, num_zero_cols;
+    count_zero_rows_and_cols(matrix_to_invert, matrix_to_invert_metadata, workspace->row_values, workspace->is_significant_col, &num_zero_rows, &num_zero_cols);
+    int matrix_column_rank = matrix_to_invert_metadata->num_cols - num_zero_cols;
+    int matrix_row_rank = matrix_to_invert_metadata->num_rows - num_zero_rows;
+    // This also covers if there is a row or column of zero values
+    if (matrix_to_invert_metadata->matrix_determinant == 0)
+    {
+        matrix_to_invert_metadata->matrix_rank = -1;
+        if (!message_buffer)
+        {
+            printf("The matrix provided has a determinant of 0, meaning it is not invertible.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("The matrix provided has a determinant of 0, meaning it is not invertible.", message_buffer);
+        }
+    }
+    else if ((matrix_column_rank != matrix_to_invert_metadata->num_cols) || (matrix_row_rank != matrix_to_invert_metadata->num_rows) || (matrix_column_rank != matrix_row_rank))
+    {
+        matrix_to_invert_metadata->matrix_rank = -1;
+        if (!message_buffer)
+        {
+            printf("The matrix provided does not have full rank and thus it is not invertible.\n");
+        }
+        else
+        {
+            writeNulTerminatedString("The matrix provided does not have full rank and thus it is not invertible.", message_buffer);
+        }
+    }
+    else
+    {
+        int size = matrix_to_invert_metadata->num_rows;
+        fill_square_identity_matrix(workspace->identity_matrix, size);
+        struct MatrixMetadata identity_matrix_metadata = {0};
+        identity_matrix_metadata.num_rows = size;
+        identity_matrix_metadata.num_cols = size;
+        // A matrix without a zero row or column can still be singular, which only the solve finds out. So the results go to the workspace
+        // first, and to the caller's outputs once the rank shows A is invertible. Every solver has copied the identity before it writes its
+        // results, so the inverse can take the identity's place.
+        struct SolverOutputs solver_outputs = {0};
+        solver_outputs.reduced_matrix = workspace->reduced_matrix;
+        solver_outputs.solution = workspace->identity_matrix;
+        solver_outputs.pivot_permutation = workspace->pivot_permutation;
+        if (solver)
+        {
+            solver(matrix_to_invert, workspace->identity_matrix, message_buffer, matrix_to_invert_metadata, &identity_matrix_metadata, options, &solver_outputs);
+        }
+        else
+        {
+            perform_gauss_jordan_reduction(matrix_to_invert, workspace->identity_matrix, message_buffer, matrix_to_invert_metadata, &identity_matrix_metadata, options, &solver_outputs, &workspace->gauss_jordan);
+        }
+        if (matrix_to_invert_metadata->matrix_rank != size)
+        {
+            if (!message_buffer)
+            {
+                printf("The matrix provided does not have full rank and thus it is not invertible.\n");
+            }
+            else
+            {
+                writeNulTerminatedString("The matrix provided does not have full rank and thus it is not invertible.", message_buffer);
+            }
+        }
+        else if (outputs)
+        {
+            if (outputs->reduced_matrix)
+            {
+                memcpy(outputs->reduced_matrix, workspace->reduced_matrix, sizeof(double) * size * size);
+            }
+            if (outputs->solution)
+            {
+                memcpy(outputs->solution, workspace->identity_matrix, sizeof(double) * size * size);
+            }
+            if (outputs->pivot_permutation)
+            {
+                memcpy(outputs->pivot_permutation, workspace->pivot_permutation, sizeof(int) * size);
+            }
+            outputs->elapsed_seconds = solver_outputs.elapsed_seconds;
+            outputs->pivot_search_seconds = solver_outputs.pivot_search_seconds;
+        }
+    }
+    free_pooled(allocated_workspace);
+}
+
+/**
+ *  @brief Attempt to invert a square matrix.
+ *
+ *  @param matrix_to_invert: double[ptr]
+ *      The matrix to invert. Note that the matrix is assumed to be in a 1-D format.
+ *  @param matrix_to_invert_metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_to_reduce data structure. Should contain the dimensions of the matrix.
+ *  @param message_buffer: struct String[ptr]
+ *      A string buffer that, if initialized, will house messages to be displayed to the Python GUI component.
+ *  @param options: struct SolverOptions[ptr]
+ *      Options such as the verbosity of the step log. If NULL, the defaults are used.
+ *  @param outputs: struct SolverOutputs[ptr]
+ *      Buffers to copy the results into. The solution buffer receives the inverse. Left untouched if the matrix is not invertible, which is
+ *      reported by a rank (in matrix_to_invert_metadata) other than its size: the rank A was found to have, or -1 if A was not solved
+ *      (a determinant of 0 was passed in, or A has a zero row or column). May be NULL.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_square_matrix_inversion_gaussian_reduction(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct String *message_buffer, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    invert_square_matrix(matrix_to_invert, matrix_to_invert_metadata, message_buffer, options, outputs, NULL, NULL);
+}
+
+/**
+ *  @brief How big a workspace python_perform_square_matrix_inversion_gaussian_reduction_with_workspace needs for a matrix.
+ *
+ *  @param matrix_to_invert_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of the matrix to invert.
+ *
+ *  @return num_bytes: int64_t
+ *      The size of the workspace, or -1 if the matrix is not float64.
+ *
+ */
+EXPORT int64_t python_get_square_matrix_inversion_workspace_size(struct MatrixMetadata *matrix_to_invert_metadata)
+{
+    struct InversionWorkspace parts;
+    return (matrix_to_invert_metadata->dtype == MATRIX_DTYPE_FLOAT64) ? layout_inversion_workspace(NULL, matrix_to_invert_metadata, 1, &parts) : -1;
+}
+
+/**
+ *  @brief python_perform_square_matrix_inversion_gaussian_reduction, with the identity and every other temporary taken from a workspace the
+ *         caller provides, so the inversion makes no heap allocations apart from the step log's.
+ *
+ *  @param workspace: void[ptr]
+ *      At least python_get_square_matrix_inversion_workspace_size bytes, aligned for a double. Its contents do not matter.
+ *  @param workspace_size: int64_t
+ *      The size of workspace, in bytes.
+ *
+ *  The other parameters are those of python_perform_square_matrix_inversion_gaussian_reduction.
+ *
+ *  @return is_checked: int
+ *      1 if the matrix was inverted or found not to be invertible, 0 if it is not float64 or the workspace is too small, in which case nothing is done.
+ *
+ */
+EXPORT int python_perform_square_matrix_inversion_gaussian_reduction_with_workspace(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct String *message_buffer, struct SolverOptions *options, struct SolverOutputs *outputs, void *workspace, int64_t workspace_size)
+{
+    int64_t num_workspace_bytes = python_get_square_matrix_inversion_workspace_size(matrix_to_invert_metadata);
+    if (num_workspace_bytes < 0 || !workspace || workspace_size < num_workspace_bytes)
+    {
+        return 0;
+    }
+    struct InversionWorkspace parts;
+    layout_inversion_workspace((char *)workspace, matrix_to_invert_metadata, 1, &parts);
+    invert_square_matrix(matrix_to_invert, matrix_to_invert_metadata, message_buffer, options, outputs, NULL, &parts);
+    return 1;
+}
+
+/**
+ *  @brief Attempt to invert a square matrix with the recursive LU engine: A is factored once, and the n columns of the identity are then solved
+ *         with the blocked triangular solves, split across threads by columns. Same parameters, checks and outputs as
+ *         python_perform_square_matrix_inversion_gaussian_reduction, with the step log of python_perform_recursive_lu_reduction.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_perform_square_matrix_inversion_lu(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct String *message_buffer, struct SolverOptions *options, struct SolverOutputs *outputs)
+{
+    invert_square_matrix(matrix_to_invert, matrix_to_invert_metadata, message_buffer, options, outputs, python_perform_recursive_lu_reduction, NULL);
+}
+
+/**
+ *  @brief Invert many 2x2, 3x3 or 4x4 matrices and take their determinants at once, with closed-form (adjugate) kernels that work on several
+ *         matrices per SIMD instruction. Unlike the inversion engines above there is no step log: singular matrices are flagged in singular_mask
+ *         instead, and get all zeros for an inverse.
+ *
+ *  @param matrices: double[ptr]
+ *      The matrices, one after another, each in a 1-D format (a C-contiguous num_matrices x size x size array).
+ *  @param size: int
+ *      The number of rows (and columns) of every matrix: 2, 3 or 4.
+ *  @param num_matrices: int
+ *      The number of matrices.
+ *  @param inverses: double[ptr]
+ *      Receives the inverses, in the same layout as matrices. May be NULL. May be matrices itself.
+ *  @param determinants: double[ptr]
+ *      Receives the determinants, one per matrix. May be NULL.
+ *  @param singular_mask: int[ptr]
+ *      Receives 1 for every singular matrix and 0 for the rest. May be NULL.
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return num_singular: int
+ *      The number of singular matrices, or -1 if size is not 2, 3 or 4.
+ *
+ */
+EXPORT int python_invert_small_matrices(double *matrices, int size, int num_matrices, double *inverses, double *determinants, int *singular_mask, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    return invert_small_matrices(matrices, size, num_matrices, inverses, determinants, singular_mask, resolve_num_threads(resolved_options.num_threads));
+}
+
+/**
+ *  @brief Compute the determinant and rank of a matrix of any MatrixDtype, with only the forward elimination of the type-generic kernels (see
+ *         TypedKernels.c). A packed triangle is read off its diagonal, and a packed positive definite matrix is factored on its packed values.
+ *         Unlike the solvers, nothing is logged and the matrix is left untouched.
+ *
+ *  @param matrix: void[ptr]
+ *      The matrix, with values of metadata->dtype.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix. Its rank and determinant (both parts, for complex matrices) are written to it.
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return is_computed: int
+ *      1 if the determinant was computed. 0 if the matrix is not square, its dtype is not supported or memory ran out.
+ *
+ */
+EXPORT int python_compute_determinant(void *matrix, struct MatrixMetadata *metadata, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int size = metadata->num_rows;
+    int value_size = get_dtype_size(metadata->dtype);
+    if (size < 1 || metadata->num_cols != size || !value_size)
+    {
+        return 0;
+    }
+    if (is_packed_layout(metadata))
+    {
+        if (metadata->dtype != MATRIX_DTYPE_FLOAT64)
+        {
+            return 0;
+        }
+        const double *packed = (const double *)matrix;
+        int is_upper = is_upper_packed_layout(metadata);
+        if (!is_symmetric_packed_layout(metadata))
+        {
+            // A triangle's determinant is the product of its diagonal, and its rank is full unless that has a 0 on it
+            double determinant = 1.0;
+            int is_singular = 0;
+            for (int diagonal = 0; diagonal < size; diagonal++)
+            {
+                double diagonal_value = packed[get_packed_row_offset(diagonal, size, is_upper) + (is_upper ? 0 : diagonal)];
+                determinant *= diagonal_value;
+                is_singular = is_singular || diagonal_value == 0.0;
+            }
+            if (!is_singular)
+            {
+                metadata->matrix_rank = size;
+                metadata->matrix_determinant = determinant;
+                metadata->matrix_determinant_imag = 0.0;
+                return 1;
+            }
+        }
+        else
+        {
+            // A positive definite matrix's determinant is the product of its LDL^T pivots; any other is eliminated with pivoting below
+            double *packed_factors = (double *)malloc(sizeof(double) * get_packed_size(size));
+            double determinant = 0.0;
+            int is_positive_definite = 0;
+            if (packed_factors)
+            {
+                copy_packed_symmetric_to_upper(packed, size, is_upper, packed_factors);
+                is_positive_definite = solve_packed_symmetric_positive_definite(packed_factors, size, NULL, 0, 0, &determinant, resolve_num_threads(resolved_options.num_threads));
+            }
+            free(packed_factors);
+            if (is_positive_definite)
+            {
+                metadata->matrix_rank = size;
+                metadata->matrix_determinant = determinant;
+                metadata->matrix_determinant_imag = 0.0;
+                return 1;
+            }
+        }
+    }
+    char *matrix_copy = (char *)malloc((size_t)value_size * ((int64_t)size * size));
+    int *row_permutation = (int *)malloc(sizeof(int) * size);
+    int *pivot_cols = (int *)malloc(sizeof(int) * size);
+    int is_computed = matrix_copy && row_permutation && pivot_cols;
+    if (is_computed)
+    {
+        gather_typed_matrix(matrix, metadata, matrix_copy, size);
+        metadata->matrix_rank = reduce_typed_matrix(metadata->dtype, matrix_copy, size, size, size, 1, row_permutation, pivot_cols, &metadata->matrix_determinant, &metadata->matrix_determinant_imag, resolve_num_threads(resolved_options.num_threads));
+    }
+    free(matrix_copy);
+    free(row_permutation);
+    free(pivot_cols);
+    return is_computed;
+}
+
+/**
+ *  @brief Factor a square matrix in place as P*A = L*U (with the recursive LU engine), so it can be solved against any number of right-hand
+ *         sides later with python_solve_lu without factoring it again.
+ *
+ *  @param matrix: double[ptr]
+ *      The square matrix A on entry, in a 1-D format. On return, L below the diagonal (its unit diagonal is not stored) and U on and above it.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix. Its determinant is set if the factorization succeeds.
+ *  @param pivots: int[ptr]
+ *      Receives the row interchanges: row i was swapped with row pivots[i], in order. Must hold num_rows values.
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return is_nonsingular: int
+ *      1 if the matrix was factored. 0 if it is not square, is not float64, is packed (the factors need both triangles) or is singular (the
+ *      contents of matrix are then undefined).
+ *
+ */
+EXPORT int python_factor_lu(double *matrix, struct MatrixMetadata *metadata, int *pivots, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    int size = metadata->num_rows;
+    if (size < 1 || metadata->num_cols != size || metadata->dtype != MATRIX_DTYPE_FLOAT64 || is_packed_layout(metadata))
+    {
+        return 0;
+    }
+    // A row stride is factored in place; a column stride other than 1 is factored in a row-major copy and written back
+    int leading_dimension;
+    double *row_major_matrix = get_row_major_matrix(matrix, metadata, &leading_dimension);
+    if (!row_major_matrix)
+    {
+        return 0;
+    }
+    int is_nonsingular = factor_lu_recursive(row_major_matrix, leading_dimension, size, size, pivots, resolve_num_threads(resolved_options.num_threads));
+    if (is_nonsingular)
+    {
+        double determinant = 1.0;
+        for (int row = 0; row < size; row++)
+        {
+            double diagonal_value = row_major_matrix[(int64_t)row * leading_dimension + row];
+            determinant *= (pivots[row] != row) ? -diagonal_value : diagonal_value;
+        }
+        metadata->matrix_determinant = determinant;
+    }
+    if (row_major_matrix != matrix)
+    {
+        scatter_strided_matrix(row_major_matrix, leading_dimension, matrix, metadata);
+        free(row_major_matrix);
+    }
+    return is_nonsingular;
+}
+
+/**
+ *  @brief Solve A*X = B in place with the factors from python_factor_lu. The right-hand sides are split across threads by columns, and each
+ *         thread applies the interchanges and runs blocked forward and back substitution on its own columns.
+ *
+ *  @param lu_matrix: double[ptr]
+ *      The factors from python_factor_lu.
+ *  @param pivots: int[ptr]
+ *      The row interchanges from python_factor_lu.
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata of lu_matrix.
+ *  @param matrix_augment: double[ptr]
+ *      B on entry and X on return, in a 1-D format.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata of matrix_augment. Must have as many rows as lu_matrix, both must be float64 and it must not be packed, or nothing is solved.
+ *  @param options: struct SolverOptions[ptr]
+ *      The number of threads. If NULL, the defaults are used.
+ *
+ *  @return None
+ *
+ */
+EXPORT void python_solve_lu(double *lu_matrix, int *pivots, struct MatrixMetadata *metadata, double *matrix_augment, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options)
+{
+    struct SolverOptions resolved_options = options ? *options : default_solver_options();
+    if (metadata->num_rows != metadata->num_cols || matrix_augment_metadata->num_rows != metadata->num_rows || !is_float64_system(metadata, matrix_augment_metadata) || is_packed_layout(matrix_augment_metadata))
+    {
+        return;
+    }
+    int lu_leading_dimension, augment_leading_dimension;
+    double *row_major_lu = get_row_major_matrix(lu_matrix, metadata, &lu_leading_dimension);
+    double *row_major_augment = get_row_major_matrix(matrix_augment, matrix_augment_metadata, &augment_leading_dimension);
+    if (row_major_lu && row_major_augment)
+    {
+        solve_with_lu_factors(row_major_lu, lu_leading_dimension, metadata->num_rows, pivots, row_major_augment, augment_leading_dimension, matrix_augment_metadata->num_cols, 1, 1, resolve_num_threads(resolved_options.num_threads));
+    }
+    if (row_major_lu != lu_matrix)
+    {
+        free(row_major_lu);
+    }
+    if (row_major_augment != matrix_augment)
+    {
+        if (row_major_augment)
+        {
+            scatter_strided_matrix(row_major_augment, augment_leading_dimension, matrix_augment, matrix_augment_metadata);
+        }
+        free(row_major_augment);
+    }
+}
+
+/**
+ *  @brief Count the exact number of bytes python_perform_gauss_jordan_reduction would write to its message buffer, without writing any of them.
+ *         The solve is run against a String in counting mode (NULL bytes), so the caller can allocate a buffer of exactly the right size once,
+ *         or lower the verbosity before committing to a huge log. Neither the matrices nor the metadata are modified.
+ *
+ *  @param matrix_to_reduce: double[ptr]
+ *      The matrix that will be reduced. Note that the matrix is assumed to be in a 1-D format.
+ *  @param matrix_augment: double[ptr]
+ *      The augment portion of the matrix (i.e., the b portion of Ax = b).
+ *  @param metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_to_reduce data structure. Should contain the dimensions of the matrix.
+ *  @param matrix_augment_metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_augment data structure. Should contain the dimensions of the matrix.
+ *  @param options: struct SolverOptions[ptr]
+ *      The options the real solve will use. The verbosity decides how much of the log is counted. If NULL, the defaults are used.
+ *
+ *  @return num_bytes: int64_t
+ *      The number of bytes the step log will need.
+ *
+ */
+EXPORT int64_t python_measure_gauss_jordan_reduction_log(double *matrix_to_reduce, double *matrix_augment, struct MatrixMetadata *metadata, struct MatrixMetadata *matrix_augment_metadata, struct SolverOptions *options)
+{
+    struct String counter = String(NULL, 0x7FFFFFFFFFFFFFFFll);
+    // The solve writes its results into the metadata, so it gets copies
+    struct MatrixMetadata metadata_copy = *metadata;
+    struct MatrixMetadata matrix_augment_metadata_copy = *matrix_augment_metadata;
+    python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_augment, &counter, &metadata_copy, &matrix_augment_metadata_copy, options, NULL);
+    return counter.length;
+}
+
+/**
+ *  @brief Count the exact number of bytes python_perform_square_matrix_inversion_gaussian_reduction would write to its message buffer, without writing any of them.
+ *
+ *  @param matrix_to_invert: double[ptr]
+ *      The matrix that will be inverted. Note that the matrix is assumed to be in a 1-D format.
+ *  @param matrix_to_invert_metadata: struct MatrixMetadata[ptr]
+ *      The metadata associated with the matrix_to_invert data structure. Should contain the dimensions of the matrix.
+ *  @param options: struct SolverOptions[ptr]
+ *      The options the real inversion will use. If NULL, the defaults are used.
+ *
+ *  @return num_bytes: int64_t
+ *      The number of bytes the step log will need.
+ *
+ */
+EXPORT int64_t python_measure_square_matrix_inversion_log(double *matrix_to_invert, struct MatrixMetadata *matrix_to_invert_metadata, struct SolverOptions *options)
+{
+    struct String counter = String(NULL, 0x7FFFFFFFFFFFFFFFll);
+    struct MatrixMetadata metadata_copy = *matrix_to_invert_metadata;
+    python_perform_square_matrix_inversion_gaussian_reduction(matrix_to_invert, &metadata_copy, &counter, options, NULL);
+    return counter.length;
+}
+
+// int main()
+// {
+//     double matrix_to_reduce[9] = {
+//         2, 1, -1,
+//         -3, -1, 2,
+//         -2, 1, 2};
+//     double matrix_to_reduce_augment[3] = {8, -11, -3};
+//     struct String *buffer = 0x0;
+//     struct MatrixMetadata matrix_to_reduce_metadata;
+//     matrix_to_reduce_metadata.num_rows = 3;
+//     matrix_to_reduce_metadata.num_cols = 3;
+//     struct MatrixMetadata matrix_to_reduce_augment_metadata;
+//     matrix_to_reduce_augment_metadata.num_rows = 3;
+//     matrix_to_reduce_augment_metadata.num_cols = 1;
+//     python_perform_gauss_jordan_reduction(matrix_to_reduce, matrix_to_reduce_augment, buffer, &matrix_to_reduce_metadata, &matrix_to_reduce_augment_metadata, NULL, NULL);
+//     printf("\n\n\n");
+//     printf("Performing First Matrix Inversion\n");
+//     python_perform_square_matrix_inversion_gaussian_reduction(matrix_to_reduce, &matrix_to_reduce_metadata, buffer, NULL, NULL);
+//     printf("\n\n\n");
+//     // printf("Performing Second Matrix Reduction\n");
+//     // double two_matrix_to_reduce[12] = {
+//     //     0, 1, 5, -4,
+//     //     1, 4, 3, -2,
+//     //     2, 7, 1, -2};
+//     // perform_gauss_jordan_reduction(two_matrix_to_reduce, 3, 4, 1);
+//     // printf("\n\n\n");
+//     // double two_matrix_to_invert[9] = {
+//     //     0, 1, 5,
+//     //     1, 4, 3,
+//     //     2, 7, 1};
+//     // printf("Performing Second Matrix Inversion\n");
+//     // perform_square_matrix_inversion_gaussian_reduction(two_matrix_to_invert, 3, 3);
+//     // printf("\n\n\n");
+//     // double three_matrix_to_reduce[12] = {
+//     //     2, 0, -6, -8,
+//     //     0, 1, 2, 3,
+//     //     3, 6, -2, -4};
+//     // perform_gauss_jordan_reduction(three_matrix_to_reduce, 3, 4, 1);
+//     // printf("\n\n\n");
+//     // printf("Performing Third Matrix Inversion\n");
+//     // double three_matrix_to_invert[9] = {
+//     //     2, 0, -6,
+//     //     0, 1, 2,
+//     //     3, 6, -2};
+//     // perform_square_matrix_inversion_gaussian_reduction(three_matrix_to_invert, 3, 3);
+//     // printf("\n\n\n");
+
+//     printf("Press Any Key to Continue\n");
+//     getch();
 // }
\ No newline at end of file
@@ -0,0 +1,124 @@
+"""
+    Regression tests for the solvers in row_reduction.c, through the ctypes bindings.
+
+    Run with: python -m unittest test_row_reduction
+"""
+
+import ctypes
+import unittest
+
+import numpy as np
+
+import ctypes_linear_algebra
+
+
+def reduce_with_pivoting(matrix_to_reduce, matrix_augment, pivot_strategy, engine=ctypes_linear_algebra.perform_gauss_jordan_reduction):
+    """
+        Run an engine (the Gauss-Jordan engine by default) on copies of the arrays and return the reduced matrix, the solution and the rank.
+    """
+    matrix_to_reduce = np.array(matrix_to_reduce, dtype=np.float64)
+    matrix_augment = np.array(matrix_augment, dtype=np.float64)
+    reduced_matrix = np.zeros_like(matrix_to_reduce)
+    solution = np.zeros_like(matrix_augment)
+    metadata = ctypes_linear_algebra.MatrixMetadata.from_array(matrix_to_reduce)
+    augment_metadata = ctypes_linear_algebra.MatrixMetadata.from_array(matrix_augment)
+    solver_outputs = ctypes_linear_algebra.SolverOutputs.from_arrays(reduced_matrix=reduced_matrix, solution=solution)
+    engine(
+        matrix_to_reduce.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        matrix_augment.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(ctypes_linear_algebra.String(0, 0, 0, None)),
+        ctypes.byref(metadata),
+        ctypes.byref(augment_metadata),
+        ctypes.byref(ctypes_linear_algebra.SolverOptions(verbosity=ctypes_linear_algebra.LOG_VERBOSITY_SUMMARY, pivot_strategy=pivot_strategy)),
+        ctypes.byref(solver_outputs),
+    )
+    return reduced_matrix, solution, metadata.matrix_rank
+
+
+def invert(matrix_to_invert, inversion_function):
+    """
+        Invert a copy of the array with one of the float64 inversions, into buffers filled with a sentinel, and return the buffers and the rank.
+    """
+    matrix_to_invert = np.array(matrix_to_invert, dtype=np.float64)
+    reduced_matrix = np.full_like(matrix_to_invert, 7.0)
+    solution = np.full_like(matrix_to_invert, 7.0)
+    pivot_permutation = np.full(matrix_to_invert.shape[0], 7, dtype=np.intc)
+    metadata = ctypes_linear_algebra.MatrixMetadata.from_array(matrix_to_invert)
+    solver_outputs = ctypes_linear_algebra.SolverOutputs.from_arrays(reduced_matrix=reduced_matrix, solution=solution, pivot_permutation=pivot_permutation)
+    inversion_function(
+        matrix_to_invert.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+        ctypes.byref(metadata),
+        ctypes.byref(ctypes_linear_algebra.String(0, 0, 0, None)),
+        ctypes.byref(ctypes_linear_algebra.SolverOptions(verbosity=ctypes_linear_algebra.LOG_VERBOSITY_SUMMARY)),
+        ctypes.byref(solver_outputs),
+    )
+    return reduced_matrix, solution, pivot_permutation, metadata.matrix_rank
+
+
+class ColumnPivotingTest(unittest.TestCase):
+    """Rook and complete pivoting swap columns, but must still return the reduced row echelon form."""
+
+    def test_rank_deficient_matrix_is_reduced_to_rref(self):
+        matrix_to_reduce = [[1.0, 2.0, 3.0], [2.0, 4.0, 6.0], [1.0, 1.0, 1.0]]
+        matrix_augment = [[1.0], [2.0], [0.0]]
+        for pivot_strategy in (ctypes_linear_algebra.PIVOT_STRATEGY_ROOK, ctypes_linear_algebra.PIVOT_STRATEGY_COMPLETE):
+            with self.subTest(pivot_strategy=pivot_strategy):
+                reduced_matrix, solution, _ = reduce_with_pivoting(matrix_to_reduce, matrix_augment, pivot_strategy)
+                np.testing.assert_allclose(reduced_matrix, [[1.0, 0.0, -1.0], [0.0, 1.0, 2.0], [0.0, 0.0, 0.0]], atol=1e-12)
+                np.testing.assert_allclose(solution, [[-1.0], [1.0], [0.0]], atol=1e-12)
+
+    def test_wide_matrix_pivots_lead_their_rows(self):
+        # Column pivoting would take the larger entry of each row as its pivot
+        matrix_to_reduce = [[1.0, 4.0, 0.0], [0.0, 0.0, 1.0]]
+        matrix_augment = [[2.0], [3.0]]
+        for pivot_strategy in (ctypes_linear_algebra.PIVOT_STRATEGY_ROOK, ctypes_linear_algebra.PIVOT_STRATEGY_COMPLETE):
+            with self.subTest(pivot_strategy=pivot_strategy):
+                reduced_matrix, solution, _ = reduce_with_pivoting(matrix_to_reduce, matrix_augment, pivot_strategy)
+                np.testing.assert_allclose(reduced_matrix, [[1.0, 4.0, 0.0], [0.0, 0.0, 1.0]], atol=1e-12)
+                np.testing.assert_allclose(solution, [[2.0], [3.0]], atol=1e-12)
+
+
+class LUEngineTest(unittest.TestCase):
+    """A pivot that is only rounding error away from 0 must not make the LU engines report a full rank."""
+
+    def test_singular_matrix_is_reduced_to_rref(self):
+        matrix_to_reduce = [[1.0, 2.0, 3.0], [4.0, 5.0, 6.0], [7.0, 8.0, 9.0]]
+        matrix_augment = [[1.0], [2.0], [3.0]]
+        for engine in (
+            ctypes_linear_algebra.perform_recursive_lu_reduction,
+            ctypes_linear_algebra.perform_tiled_lu_reduction,
+            ctypes_linear_algebra.perform_calu_reduction,
+        ):
+            with self.subTest(engine=engine.__name__):
+                reduced_matrix, _, matrix_rank = reduce_with_pivoting(matrix_to_reduce, matrix_augment, ctypes_linear_algebra.PIVOT_STRATEGY_NONE, engine)
+                self.assertEqual(matrix_rank, 2)
+                np.testing.assert_allclose(reduced_matrix, [[1.0, 0.0, -1.0], [0.0, 1.0, 2.0], [0.0, 0.0, 0.0]], atol=1e-12)
+
+
+class InversionTest(unittest.TestCase):
+    """A singular matrix must be reported as such, without writing a result."""
+
+    inversion_functions = (ctypes_linear_algebra.perform_square_matrix_inversion, ctypes_linear_algebra.perform_square_matrix_inversion_lu)
+
+    def test_singular_matrix_without_zero_lines_leaves_outputs_untouched(self):
+        matrix_to_invert = [[1.0, 2.0, 3.0], [2.0, 4.0, 6.0], [1.0, 0.0, 1.0]]
+        for inversion_function in self.inversion_functions:
+            with self.subTest(inversion_function=inversion_function.__name__):
+                reduced_matrix, solution, pivot_permutation, matrix_rank = invert(matrix_to_invert, inversion_function)
+                self.assertEqual(matrix_rank, 2)
+                self.assertTrue(np.all(reduced_matrix == 7.0))
+                self.assertTrue(np.all(solution == 7.0))
+                self.assertTrue(np.all(pivot_permutation == 7))
+
+    def test_invertible_matrix_is_inverted(self):
+        matrix_to_invert = [[2.0, 1.0, 0.0], [1.0, 3.0, 1.0], [0.0, 1.0, 4.0]]
+        for inversion_function in self.inversion_functions:
+            with self.subTest(inversion_function=inversion_function.__name__):
+                reduced_matrix, solution, _, matrix_rank = invert(matrix_to_invert, inversion_function)
+                self.assertEqual(matrix_rank, 3)
+                np.testing.assert_allclose(reduced_matrix, np.eye(3), atol=1e-12)
+                np.testing.assert_allclose(solution, np.linalg.inv(matrix_to_invert), atol=1e-12)
+
+
+if __name__ == "__main__":
+    unittest.main()